@@ -57,12 +57,53 @@ namespace codegen {
 namespace cxxnaiveico {
 
 ASTStencilBody::ASTStencilBody(const iir::StencilMetaInformation& metadata,
-                               StencilContext stencilContext)
+                               StencilContext stencilContext, bool neighborTables)
     : ASTCodeGenCXX(), metadata_(metadata), offsetPrinter_(",", "(", ")"),
-      currentFunction_(nullptr), nestingOfStencilFunArgLists_(0), stencilContext_(stencilContext) {}
+      currentFunction_(nullptr), nestingOfStencilFunArgLists_(0), stencilContext_(stencilContext),
+      neighborTables_(neighborTables) {}
 
 ASTStencilBody::~ASTStencilBody() {}
 
+std::string ASTStencilBody::NeighborTableName(const ast::NeighborChain& chain,
+                                              bool includeCenter) {
+  std::string name = "m_nbh_";
+  for(auto loc : chain) {
+    switch(loc) {
+    case ast::LocationType::Cells:
+      name += "c";
+      break;
+    case ast::LocationType::Edges:
+      name += "e";
+      break;
+    case ast::LocationType::Vertices:
+      name += "v";
+      break;
+    default:
+      dawn_unreachable("unknown location type");
+    }
+  }
+  return includeCenter ? name + "_center" : name;
+}
+
+std::string ASTStencilBody::MakeNeighborTable(const ast::NeighborChain& chain, bool includeCenter,
+                                              const std::string& meshName) {
+  return "::dawn::makeNeighborTable(LibTag{}, " + meshName + ", " +
+         nbhChainToVectorString(chain) + (includeCenter ? ", /*include center*/ true" : "") + ")";
+}
+
+std::string ASTStencilBody::ElementNeighborsName(const ast::NeighborChain& chain,
+                                                 bool includeCenter) {
+  // the name of the table without its prefix
+  return NeighborTableName(chain, includeCenter).substr(2);
+}
+
+std::string ASTStencilBody::neighbors(const ast::NeighborChain& chain, bool includeCenter,
+                                      const std::string& center) const {
+  if(elementNeighbors_ && center == ASTStencilBody::StageIndexVarName())
+    return ElementNeighborsName(chain, includeCenter);
+  return NeighborTableName(chain, includeCenter) + "(LibTag{}, " + center + ")";
+}
+
 std::string ASTStencilBody::getName(const std::shared_ptr<ast::VarDeclStmt>& stmt) const {
   if(currentFunction_)
     return currentFunction_->getFieldNameFromAccessID(iir::getAccessID(stmt));
@@ -118,10 +159,17 @@ void ASTStencilBody::visit(const std::shared_ptr<ast::LoopStmt>& stmt) {
 
   ss_ << "{";
   ss_ << "int " << ASTStencilBody::LoopLinearIndexVarName() << " = 0;";
-  ss_ << "for (auto " << ASTStencilBody::LoopNeighborIndexVarName()
-      << ": getNeighbors(LibTag{}, m_mesh," << nbhChainToVectorString(maybeChainPtr->getChain())
-      << ", " << ASTStencilBody::StageIndexVarName()
-      << (maybeChainPtr->getIncludeCenter() ? ",/*include center*/ true" : "") << "))";
+  if(neighborTables_) {
+    ss_ << "for (auto " << ASTStencilBody::LoopNeighborIndexVarName() << ": "
+        << neighbors(maybeChainPtr->getChain(), maybeChainPtr->getIncludeCenter(),
+                     ASTStencilBody::StageIndexVarName())
+        << ")";
+  } else {
+    ss_ << "for (auto " << ASTStencilBody::LoopNeighborIndexVarName()
+        << ": getNeighbors(LibTag{}, m_mesh," << nbhChainToVectorString(maybeChainPtr->getChain())
+        << ", " << ASTStencilBody::StageIndexVarName()
+        << (maybeChainPtr->getIncludeCenter() ? ",/*include center*/ true" : "") << "))";
+  }
   parentIsForLoop_ = true;
   currentChain_ = maybeChainPtr->getChain();
   stmt->getBlockStmt()->accept(*this);
@@ -366,10 +414,15 @@ void ASTStencilBody::visit(const std::shared_ptr<ast::ReductionOverNeighborExpr>
     }
   }
 
-  ss_ << std::string(indent_, ' ') << "reduce(LibTag{}, m_mesh," << sigArg << ", ";
-  expr->getInit()->accept(*this);
-
-  ss_ << ", " << nbhChainToVectorString(expr->getNbhChain());
+  if(neighborTables_) {
+    ss_ << std::string(indent_, ' ') << "::dawn::reduce("
+        << neighbors(expr->getNbhChain(), expr->getIncludeCenter(), sigArg) << ", ";
+    expr->getInit()->accept(*this);
+  } else {
+    ss_ << std::string(indent_, ' ') << "reduce(LibTag{}, m_mesh," << sigArg << ", ";
+    expr->getInit()->accept(*this);
+    ss_ << ", " << nbhChainToVectorString(expr->getNbhChain());
+  }
   if(hasWeights) {
     ss_ << ", [&, " + ASTStencilBody::ReductionSparseIndexVarName(reductionDepth_) +
                " = int(0)](auto& "
@@ -425,7 +478,11 @@ void ASTStencilBody::visit(const std::shared_ptr<ast::ReductionOverNeighborExpr>
     auto weights = expr->getWeights().value();
     bool first = true;
 
-    ss_ << ", std::vector<::dawn::float_type>({";
+    // the weights of the neighbor tables are on the stack
+    if(neighborTables_)
+      ss_ << ", std::array<::dawn::float_type, " << weights.size() << ">({";
+    else
+      ss_ << ", std::vector<::dawn::float_type>({";
     for(auto const& weight : weights) {
       if(!first) {
         ss_ << ", ";
@@ -436,7 +493,7 @@ void ASTStencilBody::visit(const std::shared_ptr<ast::ReductionOverNeighborExpr>
 
     ss_ << "})";
   }
-  if(expr->getIncludeCenter()) {
+  if(expr->getIncludeCenter() && !neighborTables_) {
     ss_ << ", /*include center*/ true";
   }
   ss_ << ")";
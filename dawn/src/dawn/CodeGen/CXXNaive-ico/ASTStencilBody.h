@@ -19,8 +19,10 @@
 #include "dawn/IIR/Interval.h"
 #include "dawn/Support/StringUtil.h"
 #include "driver-includes/unstructured_interface.hpp"
+#include <set>
 #include <stack>
 #include <unordered_map>
+#include <utility>
 
 namespace dawn {
 
@@ -48,6 +50,42 @@ public:
   }
 };
 
+// visitor collecting the neighbor chains of the reductions and loops over neighbors, with whether
+// they include the center. The element chains are the ones of the neighbors of the element of the
+// stage (not of a neighbor)
+class CollectNeighborChains : public ast::ASTVisitorForwardingNonConst {
+  std::set<std::pair<ast::NeighborChain, bool>> chains_;
+  std::set<std::pair<ast::NeighborChain, bool>> elementChains_;
+  int depth_ = 0;
+
+public:
+  void visit(const std::shared_ptr<ast::ReductionOverNeighborExpr>& expr) override {
+    chains_.emplace(expr->getNbhChain(), expr->getIncludeCenter());
+    if(depth_ == 0)
+      elementChains_.emplace(expr->getNbhChain(), expr->getIncludeCenter());
+    // the init is evaluated on the same element as the reduction, only the rhs on its neighbors
+    expr->getInit()->accept(*this);
+    ++depth_;
+    expr->getRhs()->accept(*this);
+    --depth_;
+  }
+  void visit(const std::shared_ptr<ast::LoopStmt>& stmt) override {
+    // loops are always over the neighbors of the element of the stage
+    if(const auto* chainPtr =
+           dynamic_cast<const ast::ChainIterationDescr*>(stmt->getIterationDescrPtr())) {
+      chains_.emplace(chainPtr->getChain(), chainPtr->getIncludeCenter());
+      elementChains_.emplace(chainPtr->getChain(), chainPtr->getIncludeCenter());
+    }
+    ++depth_;
+    ast::ASTVisitorForwardingNonConst::visit(stmt);
+    --depth_;
+  }
+  const std::set<std::pair<ast::NeighborChain, bool>>& getChains() const { return chains_; }
+  const std::set<std::pair<ast::NeighborChain, bool>>& getElementChains() const {
+    return elementChains_;
+  }
+};
+
 /// @brief ASTVisitor to generate C++ naive code for the stencil and stencil function bodies
 /// @ingroup cxxnaiveico
 class ASTStencilBody : public ASTCodeGenCXX {
@@ -73,6 +111,16 @@ protected:
 
   StencilContext stencilContext_;
 
+  /// Look up the neighbors in the tables of NeighborTableName instead of calling the interface
+  bool neighborTables_;
+  /// The neighbors of the element of the stage are looked up (in the tables) before the loop over
+  /// the levels, in the variables of ElementNeighborsName
+  bool elementNeighbors_ = false;
+
+  /// @brief Neighbors of `center` along `chain`, looked up in a neighbor table
+  std::string neighbors(const ast::NeighborChain& chain, bool includeCenter,
+                        const std::string& center) const;
+
   ///
   /// @brief produces a string of (i,j,k) accesses for the C++ generated naive code,
   /// from an array of offseted accesses
@@ -110,9 +158,17 @@ public:
     return "sparse_dimension_idx" + std::to_string(level);
   }
   static std::string StageIndexVarName() { return "loc"; }
+  /// @brief Member of the stencil holding the neighbor table of `chain`
+  static std::string NeighborTableName(const ast::NeighborChain& chain, bool includeCenter);
+  /// @brief Initializer of the neighbor table of `chain` from the mesh `meshName`
+  static std::string MakeNeighborTable(const ast::NeighborChain& chain, bool includeCenter,
+                                       const std::string& meshName);
+  /// @brief Variable holding the neighbors along `chain` of the element of the stage
+  static std::string ElementNeighborsName(const ast::NeighborChain& chain, bool includeCenter);
 
   /// @brief constructor
-  ASTStencilBody(const iir::StencilMetaInformation& metadata, StencilContext stencilContext);
+  ASTStencilBody(const iir::StencilMetaInformation& metadata, StencilContext stencilContext,
+                 bool neighborTables = false);
 
   virtual ~ASTStencilBody();
 
@@ -135,6 +191,10 @@ public:
   void visit(const std::shared_ptr<ast::ReductionOverNeighborExpr>& expr) override;
   /// @}
 
+  /// @brief Use the neighbors of the element of the stage looked up before the loop over the
+  /// levels (requires neighbor tables)
+  void setElementNeighbors(bool elementNeighbors) { elementNeighbors_ = elementNeighbors; }
+
   /// @brief Set the current stencil function (can be NULL)
   void setCurrentStencilFunction(
       const std::shared_ptr<iir::StencilFunctionInstantiation>& currentFunction);
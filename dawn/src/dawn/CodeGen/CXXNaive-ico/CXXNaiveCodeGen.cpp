@@ -27,6 +27,7 @@
 #include "dawn/Support/StringUtil.h"
 
 #include <algorithm>
+#include <functional>
 #include <optional>
 #include <vector>
 
@@ -57,6 +58,10 @@ namespace cxxnaiveico {
 // - A function `<Location>Type const& deref(X const& x)` should be defined,
 //   where X is decltype(*get<Locations>(...).begin())
 //
+// - With parallel element loops the elements are accessed by their position in
+//   dawn::indexableRange(get<Locations>(...)), X needs to be copyable if the iterators of the range
+//   are not random access.
+//
 // - The following functions should be defined, where Weight is an arithmetic type:
 //
 //   template<typename Init, typename Op>
@@ -69,6 +74,10 @@ namespace cxxnaiveico {
 //
 //   where Op must be callable as
 //     Op(Init, ValueType);
+//
+// - With neighbor tables the neighbors are looked up in dawn::makeNeighborTable(Tag, ...), built
+//   once per stencil from getNeighbors(Tag, MeshType const&, std::vector<dawn::LocationType>, X)
+//   and indexed by elementIndex(Tag, X), which needs to be specialized if X is not an int.
 
 namespace {
 std::string makeLoopImpl(int iExtent, int jExtent, const std::string& dim, const std::string& lower,
@@ -99,12 +108,17 @@ std::unique_ptr<TranslationUnit>
 run(const std::map<std::string, std::shared_ptr<iir::StencilInstantiation>>&
         stencilInstantiationMap,
     const Options& options) {
-  CXXNaiveIcoCodeGen CG(stencilInstantiationMap, options.MaxHaloSize);
+  CXXNaiveIcoCodeGen CG(stencilInstantiationMap, options.MaxHaloSize,
+                        options.ParallelElementLoops, options.NeighborTables,
+                        options.ColumnMajorLoops);
   return CG.generateCode();
 } // namespace cxxnaiveico
 
-CXXNaiveIcoCodeGen::CXXNaiveIcoCodeGen(const StencilInstantiationContext& ctx, int maxHaloPoint)
-    : CodeGen(ctx, maxHaloPoint) {}
+CXXNaiveIcoCodeGen::CXXNaiveIcoCodeGen(const StencilInstantiationContext& ctx, int maxHaloPoint,
+                                       bool parallelElementLoops, bool neighborTables,
+                                       bool columnMajorLoops)
+    : CodeGen(ctx, maxHaloPoint), parallelElementLoops_(parallelElementLoops),
+      neighborTables_(neighborTables), columnMajorLoops_(columnMajorLoops) {}
 
 CXXNaiveIcoCodeGen::~CXXNaiveIcoCodeGen() {}
 
@@ -395,7 +409,13 @@ void CXXNaiveIcoCodeGen::generateStencilClasses(
     Structure stencilClass = stencilWrapperClass.addStruct(stencilName);
 
     ASTStencilBody stencilBodyCXXVisitor(stencilInstantiation->getMetaData(),
-                                         StencilContext::SC_Stencil);
+                                         StencilContext::SC_Stencil, neighborTables_);
+
+    // neighbor tables of the chains of the stencil, computed once in its constructor
+    CollectNeighborChains neighborChains;
+    if(neighborTables_)
+      for(const auto& stmt : iterateIIROverStmt(*stencil))
+        stmt->accept(neighborChains);
 
     auto fieldInfoToDeclString = [](iir::Stencil::FieldInfo info) {
       if(info.field.getFieldDimensions().isVertical()) {
@@ -441,6 +461,10 @@ void CXXNaiveIcoCodeGen::generateStencilClasses(
     if(!globalsMap.empty()) {
       stencilClass.addMember("const globals &", " m_globals");
     }
+    for(const auto& chain : neighborChains.getChains()) {
+      stencilClass.addMember("::dawn::neighbor_table_t<LibTag>",
+                             ASTStencilBody::NeighborTableName(chain.first, chain.second));
+    }
 
     // addTmpStorageDeclaration(StencilClass, tempFields);
 
@@ -468,6 +492,11 @@ void CXXNaiveIcoCodeGen::generateStencilClasses(
     if(!globalsMap.empty()) {
       stencilClassCtr.addInit("m_globals(globals_)");
     }
+    for(const auto& chain : neighborChains.getChains()) {
+      stencilClassCtr.addInit(ASTStencilBody::NeighborTableName(chain.first, chain.second) + "(" +
+                              ASTStencilBody::MakeNeighborTable(chain.first, chain.second, "mesh") +
+                              ")");
+    }
 
     // addTmpStorageInit(stencilClassCtr, *stencil, tempFields);
     stencilClassCtr.commit();
@@ -543,71 +572,162 @@ void CXXNaiveIcoCodeGen::generateStencilClasses(
         }
       };
 
-      auto getLoop = [&](ast::LocationType type,
-                         std::optional<iir::Interval> iterSpace) -> std::string {
+      // get<Locations>(LibTag{}, m_mesh) or its restriction to the iteration space of a stage
+      auto getRange = [&](ast::LocationType type,
+                          std::optional<iir::Interval> iterSpace) -> std::string {
+        std::string locations;
         switch(type) {
         case ast::LocationType::Cells:
-          return (iterSpace.has_value()
-                      ? std::string("for(auto const& loc : getCells(LibTag{}, m_mesh, ") +
-                            "m_unstructured_domain({::dawn::LocationType::Cells," +
-                            spaceMagicNumToEnum(iterSpace->lowerBound()) + "," +
-                            std::to_string(iterSpace->lowerOffset()) + "})," +
-                            "m_unstructured_domain({::dawn::LocationType::Cells," +
-                            spaceMagicNumToEnum(iterSpace->upperBound()) + "," +
-                            std::to_string(iterSpace->upperOffset()) + "})))"
-                      : "for(auto const& loc : getCells(LibTag{}, m_mesh))");
+          locations = "Cells";
+          break;
         case ast::LocationType::Vertices:
-          return (iterSpace.has_value())
-                     ? std::string("for(auto const& loc : getVertices(LibTag{}, m_mesh, ") +
-                           "m_unstructured_domain({::dawn::LocationType::Vertices," +
-                           spaceMagicNumToEnum(iterSpace->lowerBound()) + "," +
-                           std::to_string(iterSpace->lowerOffset()) + "})," +
-                           "m_unstructured_domain({::dawn::LocationType::Vertices," +
-                           spaceMagicNumToEnum(iterSpace->upperBound()) + "," +
-                           std::to_string(iterSpace->upperOffset()) + "})))"
-                     : "for(auto const& loc : getVertices(LibTag{}, m_mesh))";
+          locations = "Vertices";
+          break;
         case ast::LocationType::Edges:
-          return (iterSpace.has_value())
-                     ? std::string("for(auto const& loc : getEdges(LibTag{}, m_mesh, ") +
-                           "m_unstructured_domain({::dawn::LocationType::Edges," +
-                           spaceMagicNumToEnum(iterSpace->lowerBound()) + "," +
-                           std::to_string(iterSpace->lowerOffset()) + "})," +
-                           "m_unstructured_domain({::dawn::LocationType::Edges," +
-                           spaceMagicNumToEnum(iterSpace->upperBound()) + "," +
-                           std::to_string(iterSpace->upperOffset()) + "})))"
-                     : "for(auto const& loc : getEdges(LibTag{}, m_mesh))";
+          locations = "Edges";
+          break;
         default:
           dawn_unreachable("invalid type");
-          return "";
         }
+        std::string range = "get" + locations + "(LibTag{}, m_mesh";
+        if(iterSpace.has_value())
+          range += ", m_unstructured_domain({::dawn::LocationType::" + locations + "," +
+                   spaceMagicNumToEnum(iterSpace->lowerBound()) + "," +
+                   std::to_string(iterSpace->lowerOffset()) + "})," +
+                   "m_unstructured_domain({::dawn::LocationType::" + locations + "," +
+                   spaceMagicNumToEnum(iterSpace->upperBound()) + "," +
+                   std::to_string(iterSpace->upperOffset()) + "})";
+        return range + ")";
+      };
+
+      auto generateStageBody = [&](const iir::Stage& stage, const iir::Interval& interval) {
+        // Generate Do-Method
+        for(const auto& doMethodPtr : stage.getChildren()) {
+          const iir::DoMethod& doMethod = *doMethodPtr;
+          if(!doMethod.getInterval().overlaps(interval))
+            continue;
+
+          for(const auto& stmt : doMethod.getAST().getStatements()) {
+            stmt->accept(stencilBodyCXXVisitor);
+            StencilRunMethod << stencilBodyCXXVisitor.getCodeAndResetStream();
+          }
+        }
+      };
+
+      // stages with a do-method in the interval
+      auto getStages = [&](const iir::Interval& interval) {
+        std::vector<const iir::Stage*> stages;
+        for(const auto& stagePtr : multiStage.getChildren())
+          if(std::any_of(stagePtr->getChildren().begin(), stagePtr->getChildren().end(),
+                         [&](const auto& doMethodPtr) {
+                           return doMethodPtr->getInterval().overlaps(interval);
+                         }))
+            stages.push_back(stagePtr.get());
+        return stages;
+      };
+
+      // In column-major order the element of a stage in a parallel multistage is computed on all
+      // levels of the interval before the next one, the loop over the levels is innermost. With
+      // neighbor tables its neighbors are looked up once for all levels.
+      const bool isBackward = multiStage.getLoopOrder() == iir::LoopOrderKind::Backward;
+      const bool isParallel = multiStage.getLoopOrder() == iir::LoopOrderKind::Parallel;
+      const bool columnMajor = columnMajorLoops_ && isParallel;
+      stencilBodyCXXVisitor.setElementNeighbors(columnMajor && neighborTables_);
+      auto generateColumn = [&](const iir::Stage& stage, const iir::Interval& interval) {
+        if(neighborTables_) {
+          CollectNeighborChains neighborChains;
+          for(const auto& doMethodPtr : stage.getChildren())
+            if(doMethodPtr->getInterval().overlaps(interval))
+              for(const auto& stmt : doMethodPtr->getAST().getStatements())
+                stmt->accept(neighborChains);
+          for(const auto& chain : neighborChains.getElementChains())
+            StencilRunMethod.addStatement(
+                "auto const " + ASTStencilBody::ElementNeighborsName(chain.first, chain.second) +
+                " = " + ASTStencilBody::NeighborTableName(chain.first, chain.second) +
+                "(LibTag{}, loc)");
+        }
+        StencilRunMethod.addBlockStatement(makeKLoop(isBackward, interval),
+                                           [&] { generateStageBody(stage, interval); });
       };
 
       for(auto interval : partitionIntervals) {
-        StencilRunMethod.addBlockStatement(
-            makeKLoop((multiStage.getLoopOrder() == iir::LoopOrderKind::Backward), interval), [&] {
-              // for each interval, we generate naive nested loops
-              for(const auto& stagePtr : multiStage.getChildren()) {
-                const iir::Stage& stage = *stagePtr;
-
-                DAWN_ASSERT_MSG(stage.getLocationType().has_value(),
-                                "Stage must have a location type");
-                std::string loopCode =
-                    getLoop(*stage.getLocationType(), stage.getUnstructuredIterationSpace());
-                StencilRunMethod.addBlockStatement(loopCode, [&] {
-                  // Generate Do-Method
-                  for(const auto& doMethodPtr : stage.getChildren()) {
-                    const iir::DoMethod& doMethod = *doMethodPtr;
-                    if(!doMethod.getInterval().overlaps(interval))
-                      continue;
-
-                    for(const auto& stmt : doMethod.getAST().getStatements()) {
-                      stmt->accept(stencilBodyCXXVisitor);
-                      StencilRunMethod << stencilBodyCXXVisitor.getCodeAndResetStream();
-                    }
-                  }
+        if(!parallelElementLoops_ && columnMajor) {
+          for(const iir::Stage* stage : getStages(interval)) {
+            DAWN_ASSERT_MSG(stage->getLocationType().has_value(),
+                            "Stage must have a location type");
+            StencilRunMethod.addBlockStatement(
+                "for(auto const& loc : " +
+                    getRange(*stage->getLocationType(), stage->getUnstructuredIterationSpace()) +
+                    ")",
+                [&] { generateColumn(*stage, interval); });
+          }
+          continue;
+        }
+        if(!parallelElementLoops_) {
+          StencilRunMethod.addBlockStatement(makeKLoop(isBackward, interval), [&] {
+            // for each interval, we generate naive nested loops
+            for(const auto& stagePtr : multiStage.getChildren()) {
+              const iir::Stage& stage = *stagePtr;
+
+              DAWN_ASSERT_MSG(stage.getLocationType().has_value(),
+                              "Stage must have a location type");
+              std::string loopCode =
+                  "for(auto const& loc : " +
+                  getRange(*stage.getLocationType(), stage.getUnstructuredIterationSpace()) + ")";
+              StencilRunMethod.addBlockStatement(loopCode,
+                                                 [&] { generateStageBody(stage, interval); });
+            }
+          });
+          continue;
+        }
+
+        // The elements of a stage are independent of each other (the stages are split at every
+        // horizontal dependency), their loop is split among the OpenMP threads. In a parallel
+        // multistage the levels are independent too: the loops are interchanged to run each stage
+        // on all levels of the interval, split among the threads with its elements. The ranges
+        // are made indexable once per interval (a copy for ranges without random access).
+        // Without OpenMP the pragmas are ignored and the loops run sequentially.
+        StencilRunMethod.addBlockStatement("", [&] {
+          const std::vector<const iir::Stage*> stages = getStages(interval);
+          for(std::size_t stageIdx = 0; stageIdx < stages.size(); ++stageIdx) {
+            const iir::Stage& stage = *stages[stageIdx];
+            DAWN_ASSERT_MSG(stage.getLocationType().has_value(), "Stage must have a location type");
+            StencilRunMethod.addStatement(
+                "auto const elements" + std::to_string(stageIdx) + " = ::dawn::indexableRange(" +
+                getRange(*stage.getLocationType(), stage.getUnstructuredIterationSpace()) + ")");
+          }
+          auto generateElementLoop = [&](std::size_t stageIdx, const std::string& pragma,
+                                         const std::function<void()>& generateElement) {
+            const std::string elements = "elements" + std::to_string(stageIdx);
+            StencilRunMethod.addBlockStatement(
+                pragma + "for(int elementIdx = 0; elementIdx < int(" + elements +
+                    ".size()); ++elementIdx)",
+                [&] {
+                  StencilRunMethod.addStatement("auto const& loc = " + elements + "[elementIdx]");
+                  generateElement();
+                });
+          };
+          if(columnMajor) {
+            for(std::size_t stageIdx = 0; stageIdx < stages.size(); ++stageIdx)
+              generateElementLoop(stageIdx, "\n#pragma omp parallel for\n",
+                                  [&] { generateColumn(*stages[stageIdx], interval); });
+          } else if(isParallel) {
+            for(std::size_t stageIdx = 0; stageIdx < stages.size(); ++stageIdx)
+              StencilRunMethod.addBlockStatement(
+                  "\n#pragma omp parallel for collapse(2)\n" + makeKLoop(isBackward, interval),
+                  [&] {
+                    generateElementLoop(stageIdx, "",
+                                        [&] { generateStageBody(*stages[stageIdx], interval); });
+                  });
+          } else {
+            StencilRunMethod.addBlockStatement(makeKLoop(isBackward, interval), [&] {
+              for(std::size_t stageIdx = 0; stageIdx < stages.size(); ++stageIdx)
+                generateElementLoop(stageIdx, "\n#pragma omp parallel for\n", [&] {
+                  generateStageBody(*stages[stageIdx], interval);
                 });
-              }
             });
+          }
+        });
       }
       StencilRunMethod.ss() << "}";
     }
@@ -43,7 +43,9 @@ run(const std::map<std::string, std::shared_ptr<iir::StencilInstantiation>>&
 class CXXNaiveIcoCodeGen : public CodeGen {
 public:
   ///@brief constructor
-  CXXNaiveIcoCodeGen(const StencilInstantiationContext& ctx, int maxHaloPoint);
+  CXXNaiveIcoCodeGen(const StencilInstantiationContext& ctx, int maxHaloPoint,
+                     bool parallelElementLoops = false, bool neighborTables = false,
+                     bool columnMajorLoops = false);
   virtual ~CXXNaiveIcoCodeGen();
   virtual std::unique_ptr<TranslationUnit> generateCode() override;
 
@@ -73,6 +75,10 @@ private:
   generateStencilWrapperRun(Class& stencilWrapperClass,
                             const std::shared_ptr<iir::StencilInstantiation> stencilInstantiation,
                             const CodeGenProperties& codeGenProperties) const;
+
+  bool parallelElementLoops_;
+  bool neighborTables_;
+  bool columnMajorLoops_;
 };
 } // namespace cxxnaiveico
 } // namespace codegen
@@ -19,6 +19,7 @@
 #include "dawn/IIR/ASTExpr.h"
 #include "dawn/IIR/StencilFunctionInstantiation.h"
 #include "dawn/Support/Unreachable.h"
+#include <vector>
 
 namespace dawn {
 namespace codegen {
@@ -172,12 +173,43 @@ void ASTStencilBody::visit(const std::shared_ptr<ast::FieldAccessExpr>& expr) {
       ss_ << accessName
           << ijkfyOffset(currentFunction_->evalOffsetOfFieldAccessExpr(expr, false), accessName);
     }
+  } else if(fieldPointers_.count(iir::getAccessID(expr)) &&
+            !expr->getOffset().hasVerticalIndirection()) {
+    const auto& pointer = fieldPointers_.at(iir::getAccessID(expr));
+    const auto& offset = expr->getOffset();
+    auto const& hOffset = ast::offset_cast<const ast::CartesianOffset&>(offset.horizontalOffset());
+    std::vector<std::string> terms;
+    if(pointer.I)
+      terms.push_back("(i+" + std::to_string(hOffset.offsetI()) + ")");
+    if(pointer.J)
+      terms.push_back("(j+" + std::to_string(hOffset.offsetJ()) + ")*" + pointer.Name +
+                      "_jstride");
+    if(pointer.K)
+      terms.push_back("(k+" + std::to_string(offset.verticalShift()) + ")*" + pointer.Name +
+                      "_kstride");
+    ss_ << pointer.Name << "_ptr[" << (terms.empty() ? "0" : RangeToString(" + ", "", "")(terms))
+        << "]";
+  } else if(tmpPlanes_.count(iir::getAccessID(expr))) {
+    DAWN_ASSERT(expr->getOffset().verticalShift() == 0 &&
+                !expr->getOffset().hasVerticalIndirection());
+    ss_ << getName(expr) << "("
+        << to_string(ast::cartesian, expr->getOffset(), ", ",
+                     [](std::string const& name, int offset) {
+                       return name == "k" ? std::string("0") : name + "+" + std::to_string(offset);
+                     })
+        << ")";
   } else {
     std::string accessName = getName(expr);
     ss_ << accessName << ijkfyOffset(expr->getOffset(), accessName);
   }
 }
 
+void ASTStencilBody::setTmpPlanes(std::set<int> tmpPlanes) { tmpPlanes_ = std::move(tmpPlanes); }
+
+void ASTStencilBody::setFieldPointers(std::unordered_map<int, FieldPointer> fieldPointers) {
+  fieldPointers_ = std::move(fieldPointers);
+}
+
 void ASTStencilBody::setCurrentStencilFunction(
     const std::shared_ptr<iir::StencilFunctionInstantiation>& currentFunction) {
   currentFunction_ = currentFunction;
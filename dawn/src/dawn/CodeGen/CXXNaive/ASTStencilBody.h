@@ -18,6 +18,7 @@
 #include "dawn/CodeGen/CodeGenProperties.h"
 #include "dawn/IIR/Interval.h"
 #include "dawn/Support/StringUtil.h"
+#include <set>
 #include <stack>
 #include <unordered_map>
 
@@ -31,6 +32,18 @@ class StencilMetaInformation;
 namespace codegen {
 namespace cxxnaive {
 
+/// @brief Field accessed through a raw pointer to its point `(0,0,0)` and its strides
+///
+/// The pointer is named `<Name>_ptr` and the strides `<Name>_jstride` and `<Name>_kstride`. The
+/// `i` dimension is the unit-stride one of the storages of the host backend.
+/// @ingroup cxxnaive
+struct FieldPointer {
+  std::string Name;
+  bool I; ///< The storage has an `i` dimension
+  bool J; ///< The storage has a `j` dimension
+  bool K; ///< The storage has a `k` dimension
+};
+
 /// @brief ASTVisitor to generate C++ naive code for the stencil and stencil function bodies
 /// @ingroup cxxnaive
 class ASTStencilBody : public ASTCodeGenCXX {
@@ -45,6 +58,12 @@ protected:
 
   StencilContext stencilContext_;
 
+  /// AccessIDs of the temporaries stored in an ij-plane, accessed at the current level only
+  std::set<int> tmpPlanes_;
+
+  /// AccessID to raw pointer of the multistage we are currently generating
+  std::unordered_map<int, FieldPointer> fieldPointers_;
+
   ///
   /// @brief produces a string of (i,j,k) accesses for the C++ generated naive code,
   /// from an array of offseted accesses
@@ -92,6 +111,12 @@ public:
   void setCurrentStencilFunction(
       const std::shared_ptr<iir::StencilFunctionInstantiation>& currentFunction);
 
+  /// @brief Set the temporaries demoted to ij-planes
+  void setTmpPlanes(std::set<int> tmpPlanes);
+
+  /// @brief Set the fields accessed through a raw pointer (empty if accesses go through views)
+  void setFieldPointers(std::unordered_map<int, FieldPointer> fieldPointers);
+
   /// @brief Mapping of VarDeclStmt and Var/FieldAccessExpr to their name
   std::string getName(const std::shared_ptr<ast::Expr>& expr) const override;
   std::string getName(const std::shared_ptr<ast::VarDeclStmt>& stmt) const override;
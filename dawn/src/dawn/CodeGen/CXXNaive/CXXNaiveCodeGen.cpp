@@ -13,6 +13,7 @@
 //===------------------------------------------------------------------------------------------===//
 
 #include "dawn/CodeGen/CXXNaive/CXXNaiveCodeGen.h"
+#include "dawn/AST/FieldDimension.h"
 #include "dawn/AST/GridType.h"
 #include "dawn/AST/Offsets.h"
 #include "dawn/CodeGen/CXXNaive/ASTStencilBody.h"
@@ -89,13 +90,26 @@ std::unique_ptr<TranslationUnit>
 run(const std::map<std::string, std::shared_ptr<iir::StencilInstantiation>>&
         stencilInstantiationMap,
     const Options& options) {
-  CXXNaiveCodeGen CG(stencilInstantiationMap, options.MaxHaloSize);
+  CXXNaiveCodeGen CG(stencilInstantiationMap, options.MaxHaloSize, options.SlimRuntime,
+                     options.PrecompiledHeader, options.TmpMemoryPlanning,
+                     options.ReduceTmpDimensions, options.RawPointerAccess,
+                     {options.DomainSizeI, options.DomainSizeJ, options.DomainSizeK});
 
   return CG.generateCode();
 }
 
-CXXNaiveCodeGen::CXXNaiveCodeGen(const StencilInstantiationContext& ctx, int maxHaloPoint)
-    : CodeGen(ctx, maxHaloPoint) {}
+CXXNaiveCodeGen::CXXNaiveCodeGen(const StencilInstantiationContext& ctx, int maxHaloPoint,
+                                 bool slimRuntime, const std::string& precompiledHeader,
+                                 bool tmpMemoryPlanning, bool reduceTmpDimensions,
+                                 bool rawPointerAccess, const Array3i& domainSize)
+    : CodeGen(ctx, maxHaloPoint) {
+  codeGenOptions.SlimRuntime = slimRuntime;
+  codeGenOptions.PrecompiledHeader = precompiledHeader;
+  codeGenOptions.TmpMemoryPlanning = tmpMemoryPlanning;
+  codeGenOptions.ReduceTmpDimensions = reduceTmpDimensions;
+  codeGenOptions.RawPointerAccess = rawPointerAccess;
+  codeGenOptions.DomainSize = domainSize;
+}
 
 CXXNaiveCodeGen::~CXXNaiveCodeGen() {}
 
@@ -135,6 +149,38 @@ std::string CXXNaiveCodeGen::generateStencilInstantiation(
   return ssSW.str();
 }
 
+FieldPointer CXXNaiveCodeGen::addFieldPointer(MemberFunction& function,
+                                              const iir::StencilMetaInformation& metadata,
+                                              int accessID, const std::string& storage,
+                                              bool isPlane) const {
+  FieldPointer pointer{metadata.getFieldNameFromAccessID(accessID), true, true, !isPlane};
+  if(!isPlane) {
+    const auto dims = metadata.getFieldDimensions(accessID);
+    pointer.K = dims.K();
+    if(dims.isVertical()) {
+      pointer.I = pointer.J = false;
+    } else {
+      const auto& hDims = ast::dimension_cast<const ast::CartesianFieldDimension&>(
+          dims.getHorizontalFieldDimension());
+      pointer.I = hDims.I();
+      pointer.J = hDims.J();
+    }
+  }
+
+  const std::string storageInfo = storage + ".get_storage_info_ptr()->template ";
+  function.addStatement("::dawn::float_type* __restrict__ " + pointer.Name + "_ptr = &" +
+                        pointer.Name + "(0, 0, 0)");
+  if(pointer.I)
+    function.addStatement("assert(" + storageInfo + "stride<0>() == 1)");
+  if(pointer.J)
+    function.addStatement("const int " + pointer.Name + "_jstride = " + storageInfo +
+                          "stride<1>()");
+  if(pointer.K)
+    function.addStatement("const int " + pointer.Name + "_kstride = " + storageInfo +
+                          "stride<2>()");
+  return pointer;
+}
+
 void CXXNaiveCodeGen::generateStencilWrapperRun(
     Class& stencilWrapperClass,
     const std::shared_ptr<iir::StencilInstantiation> stencilInstantiation,
@@ -217,6 +263,7 @@ void CXXNaiveCodeGen::generateStencilWrapperCtr(
   StencilWrapperConstructor.addStatement("assert(dom.jsize() >= dom.jminus() + dom.jplus())");
   StencilWrapperConstructor.addStatement("assert(dom.ksize() >= dom.kminus() + dom.kplus())");
   StencilWrapperConstructor.addStatement("assert(dom.ksize() >= 1)");
+  addDomainSizeAssertions(StencilWrapperConstructor, "dom");
   StencilWrapperConstructor.commit();
 
   StencilWrapperConstructor.commit();
@@ -286,15 +333,19 @@ void CXXNaiveCodeGen::generateStencilClasses(
         makeRange(stencilFields, [](std::pair<int, iir::Stencil::FieldInfo> const& p) {
           return !p.second.IsTemporary;
         });
-    auto tempFields =
-        makeRange(stencilFields, [](std::pair<int, iir::Stencil::FieldInfo> const& p) {
-          return p.second.IsTemporary;
+    // the vertical loop is sequential and encloses the stages in every multistage
+    const auto tmpPlanes =
+        getIJPlaneTemporaries(stencil, [](const iir::MultiStage&) { return true; });
+    auto tempFields = makeRange(
+        stencilFields, [&tmpPlanes](std::pair<int, iir::Stencil::FieldInfo> const& p) {
+          return p.second.IsTemporary && !tmpPlanes.count(p.first);
         });
 
     Structure stencilClass = stencilWrapperClass.addStruct(stencilName);
 
     ASTStencilBody stencilBodyCXXVisitor(stencilInstantiation->getMetaData(),
                                          StencilContext::SC_Stencil);
+    stencilBodyCXXVisitor.setTmpPlanes(tmpPlanes);
 
     stencilClass.addComment("Members");
     bool iterationSpaceSet = hasGlobalIndices(stencil);
@@ -304,6 +355,8 @@ void CXXNaiveCodeGen::generateStencilClasses(
 
     stencilClass.addComment("Temporary storages");
     addTempStorageTypedef(stencilClass, stencil);
+    if(!tmpPlanes.empty())
+      addTmpPlaneStorageTypedef(stencilClass);
 
     stencilClass.addMember("const " + c_dgt + "domain", "m_dom");
 
@@ -313,7 +366,9 @@ void CXXNaiveCodeGen::generateStencilClasses(
 
     stencilClass.addComment("Input/Output storages");
 
-    addTmpStorageDeclaration(stencilClass, tempFields);
+    const auto tmpStorages = planTmpStorages(stencil, tempFields);
+    addTmpStorageDeclaration(stencilClass, tmpStorages);
+    addTmpPlaneStorageDeclaration(stencilClass, stencil, tmpPlanes);
 
     stencilClass.changeAccessibility("public");
 
@@ -358,7 +413,8 @@ void CXXNaiveCodeGen::generateStencilClasses(
       stencilClassCtr.addInit("globalOffsets({computeGlobalOffsets(rank, m_dom, xcols, ycols)})");
     }
 
-    addTmpStorageInit(stencilClassCtr, stencil, tempFields);
+    addTmpStorageInit(stencilClassCtr, stencil, tmpStorages);
+    addTmpPlaneStorageInit(stencilClassCtr, stencil, tmpPlanes);
     stencilClassCtr.commit();
 
     // virtual dtor
@@ -379,12 +435,8 @@ void CXXNaiveCodeGen::generateStencilClasses(
 
     stencilRunMethod.startBody();
     // Compute the loop bounds for readability
-    stencilRunMethod.addStatement("int iMin = m_dom.iminus()");
-    stencilRunMethod.addStatement("int iMax = m_dom.isize() - m_dom.iplus() - 1");
-    stencilRunMethod.addStatement("int jMin = m_dom.jminus()");
-    stencilRunMethod.addStatement("int jMax = m_dom.jsize() - m_dom.jplus() - 1");
-    stencilRunMethod.addStatement("int kMin = m_dom.kminus()");
-    stencilRunMethod.addStatement("int kMax = m_dom.ksize() - m_dom.kplus() - 1");
+    for(int dim = 0; dim < 3; ++dim)
+      addDomainBounds(stencilRunMethod, dim, "m_dom");
 
     for(const auto& fieldPair : nonTempFields) {
       stencilRunMethod.addStatement(fieldPair.second.Name + "_" + ".sync()");
@@ -406,9 +458,36 @@ void CXXNaiveCodeGen::generateStencilClasses(
       for(const auto& fieldPair : tempFields) {
         const auto fieldName = fieldPair.second.Name;
         stencilRunMethod.addStatement(c_gt + "data_view<tmp_storage_t> " + fieldName + "= " + c_gt +
-                                      "make_host_view(m_" + fieldName + ")");
+                                      "make_host_view(" + tmpStorages.at(fieldPair.first) + ")");
         stencilRunMethod.addStatement("std::array<int,3> " + fieldName + "_offsets{0,0,0}");
       }
+      for(int accessID : tmpPlanes) {
+        const auto fieldName =
+            stencilInstantiation->getMetaData().getFieldNameFromAccessID(accessID);
+        stencilRunMethod.addStatement(c_gt + "data_view<tmp_plane_storage_t> " + fieldName + "= " +
+                                      c_gt + "make_host_view(m_" + fieldName + ")");
+        stencilRunMethod.addStatement("std::array<int,3> " + fieldName + "_offsets{0,0,0}");
+      }
+
+      // the stage bodies access the fields through raw pointers, the views are still used by the
+      // stencil functions
+      std::unordered_map<int, FieldPointer> fieldPointers;
+      if(codeGenOptions.RawPointerAccess) {
+        const auto& metadata = stencilInstantiation->getMetaData();
+        for(const auto& fieldPair : nonTempFields)
+          fieldPointers.emplace(fieldPair.first,
+                                addFieldPointer(stencilRunMethod, metadata, fieldPair.first,
+                                                fieldPair.second.Name + "_", false));
+        for(const auto& fieldPair : tempFields)
+          fieldPointers.emplace(fieldPair.first,
+                                addFieldPointer(stencilRunMethod, metadata, fieldPair.first,
+                                                tmpStorages.at(fieldPair.first), false));
+        for(int accessID : tmpPlanes)
+          fieldPointers.emplace(
+              accessID, addFieldPointer(stencilRunMethod, metadata, accessID,
+                                        "m_" + metadata.getFieldNameFromAccessID(accessID), true));
+      }
+      stencilBodyCXXVisitor.setFieldPointers(std::move(fieldPointers));
 
       auto intervals_set = multiStage.getIntervals();
       std::vector<iir::Interval> intervals_v;
@@ -613,23 +692,24 @@ std::unique_ptr<TranslationUnit> CXXNaiveCodeGen::generateCode() {
 
   std::string globals = generateGlobals(context_, "dawn_generated", "cxxnaive");
 
-  std::vector<std::string> ppDefines;
+  std::vector<std::string> preamble;
   auto makeDefine = [](std::string define, int value) {
     return "#define " + define + " " + std::to_string(value);
   };
 
-  ppDefines.push_back(makeDefine("DAWN_GENERATED", 1));
-  ppDefines.push_back("#undef DAWN_BACKEND_T");
-  ppDefines.push_back("#define DAWN_BACKEND_T CXXNAIVE");
+  preamble.push_back(makeDefine("DAWN_GENERATED", 1));
+  preamble.push_back("#undef DAWN_BACKEND_T");
+  preamble.push_back("#define DAWN_BACKEND_T CXXNAIVE");
   // ==============------------------------------------------------------------------------------===
   // BENCHMARKTODO: since we're importing two cpp files into the benchmark API we need to set
   // these variables also in the naive code-generation in order to not break it. Once the move to
   // different TU's is completed, this is no longer necessary.
   // [https://github.com/MeteoSwiss-APN/gtclang/issues/32]
   // ==============------------------------------------------------------------------------------===
-  CodeGen::addMplIfdefs(ppDefines, 30);
-  ppDefines.push_back("#include <driver-includes/gridtools_includes.hpp>");
-  ppDefines.push_back("using namespace gridtools::dawn;");
+  CodeGen::addGridToolsRuntimeIncludes(preamble, 30);
+
+  std::vector<std::string> ppDefines;
+  CodeGen::addPreamble(ppDefines, preamble);
   DAWN_LOG(INFO) << "Done generating code";
 
   std::string filename = generateFileName(context_);
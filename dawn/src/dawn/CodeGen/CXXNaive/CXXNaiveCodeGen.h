@@ -15,6 +15,7 @@
 #pragma once
 
 #include "dawn/CodeGen/CodeGen.h"
+#include "dawn/CodeGen/CXXNaive/ASTStencilBody.h"
 #include "dawn/CodeGen/CodeGenProperties.h"
 #include "dawn/CodeGen/Options.h"
 #include "dawn/IIR/Interval.h"
@@ -27,7 +28,8 @@
 namespace dawn {
 namespace iir {
 class StencilInstantiation;
-}
+class StencilMetaInformation;
+} // namespace iir
 
 namespace codegen {
 namespace cxxnaive {
@@ -43,7 +45,10 @@ run(const std::map<std::string, std::shared_ptr<iir::StencilInstantiation>>&
 class CXXNaiveCodeGen : public CodeGen {
 public:
   ///@brief constructor
-  CXXNaiveCodeGen(const StencilInstantiationContext& ctx, int maxHaloPoint);
+  CXXNaiveCodeGen(const StencilInstantiationContext& ctx, int maxHaloPoint,
+                  bool slimRuntime = false, const std::string& precompiledHeader = "",
+                  bool tmpMemoryPlanning = false, bool reduceTmpDimensions = false,
+                  bool rawPointerAccess = false, const Array3i& domainSize = {0, 0, 0});
   virtual ~CXXNaiveCodeGen();
   virtual std::unique_ptr<TranslationUnit> generateCode() override;
 
@@ -73,6 +78,12 @@ protected:
   generateStencilWrapperRun(Class& stencilWrapperClass,
                             const std::shared_ptr<iir::StencilInstantiation> stencilInstantiation,
                             const CodeGenProperties& codeGenProperties) const;
+
+  /// @brief Declare a raw pointer to the point `(0,0,0)` of the view of field `accessID` and the
+  /// strides of its `storage` (see `RawPointerAccess`), `isPlane` for ij-plane temporaries
+  FieldPointer addFieldPointer(MemberFunction& function,
+                               const iir::StencilMetaInformation& metadata, int accessID,
+                               const std::string& storage, bool isPlane) const;
 };
 } // namespace cxxnaive
 } // namespace codegen
@@ -0,0 +1,59 @@
+//===--------------------------------------------------------------------------------*- C++ -*-===//
+//                          _
+//                         | |
+//                       __| | __ ___      ___ ___
+//                      / _` |/ _` \ \ /\ / / '_  |
+//                     | (_| | (_| |\ V  V /| | | |
+//                      \__,_|\__,_| \_/\_/ |_| |_| - Compiler Toolchain
+//
+//
+//  This file is distributed under the MIT License (MIT).
+//  See LICENSE.txt for details.
+//
+//===------------------------------------------------------------------------------------------===//
+
+
+#include "dawn/CodeGen/CXXOpt/ASTStencilBody.h"
+#include "dawn/IIR/AST.h"
+#include "dawn/IIR/ASTExpr.h"
+
+namespace dawn {
+namespace codegen {
+namespace cxxopt {
+
+ASTStencilBody::ASTStencilBody(const iir::StencilMetaInformation& metadata,
+                               StencilContext stencilContext)
+    : Base(metadata, stencilContext) {}
+
+void ASTStencilBody::setKCaches(std::unordered_map<int, KCacheWindow> kcaches) {
+  kcaches_ = std::move(kcaches);
+}
+
+void ASTStencilBody::setKColumns(std::map<int, KColumnBuffer> kcolumns) {
+  kcolumns_ = std::move(kcolumns);
+}
+
+void ASTStencilBody::visit(const std::shared_ptr<ast::FieldAccessExpr>& expr) {
+  auto columnIt = currentFunction_ ? kcolumns_.end() : kcolumns_.find(iir::getAccessID(expr));
+  if(columnIt != kcolumns_.end()) {
+    const auto& offset = expr->getOffset();
+    DAWN_ASSERT(offset.horizontalOffset().isZero() && !offset.hasVerticalIndirection());
+    ss_ << columnIt->second.Name << "[k+" << columnIt->second.index(offset.verticalShift()) << "]";
+    return;
+  }
+
+  auto it = currentFunction_ ? kcaches_.end() : kcaches_.find(iir::getAccessID(expr));
+  if(it == kcaches_.end()) {
+    Base::visit(expr);
+    return;
+  }
+
+  // PassSetCaches only k-caches horizontally pointwise accesses
+  const auto& offset = expr->getOffset();
+  DAWN_ASSERT(offset.horizontalOffset().isZero() && !offset.hasVerticalIndirection());
+  ss_ << it->second.Name << "[" << it->second.index(offset.verticalShift()) << "]";
+}
+
+} // namespace cxxopt
+} // namespace codegen
+} // namespace dawn
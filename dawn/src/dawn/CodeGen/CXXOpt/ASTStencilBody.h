@@ -0,0 +1,93 @@
+//===--------------------------------------------------------------------------------*- C++ -*-===//
+//                          _
+//                         | |
+//                       __| | __ ___      ___ ___
+//                      / _` |/ _` \ \ /\ / / '_  |
+//                     | (_| | (_| |\ V  V /| | | |
+//                      \__,_|\__,_| \_/\_/ |_| |_| - Compiler Toolchain
+//
+//
+//  This file is distributed under the MIT License (MIT).
+//  See LICENSE.txt for details.
+//
+//===------------------------------------------------------------------------------------------===//
+
+
+#pragma once
+
+#include "dawn/CodeGen/CXXNaive/ASTStencilBody.h"
+#include "dawn/IIR/Cache.h"
+#include <map>
+#include <string>
+#include <unordered_map>
+
+namespace dawn {
+namespace codegen {
+namespace cxxopt {
+
+/// @brief Window of a k-cached field kept in a local ring buffer while walking an (i,j) column
+///
+/// Levels are addressed by their distance to `k` along the loop direction, the buffer holds the
+/// distances `[AheadMin, AheadMax]` (`AheadMin <= 0 <= AheadMax`).
+/// @ingroup cxxopt
+struct KCacheWindow {
+  std::string Name;            ///< Name of the local buffer
+  iir::Cache::IOPolicy Policy; ///< IO policy computed by PassSetCaches
+  int Direction;               ///< 1 for forward, -1 for backward loops
+  int AheadMin;
+  int AheadMax;
+
+  /// @brief Number of levels held in the buffer
+  int size() const { return AheadMax - AheadMin + 1; }
+
+  /// @brief Slot of the buffer holding level `k + kOffset`
+  int index(int kOffset) const { return Direction * kOffset - AheadMin; }
+
+  /// @brief Vertical offset of the level held in slot `idx`
+  int offset(int idx) const { return Direction * (idx + AheadMin); }
+};
+
+/// @brief Buffer holding a whole (i,j) column of a temporary, used instead of a 3D storage if the
+/// temporary is only accessed at the current (i,j) of a multistage walked column by column
+///
+/// The buffer holds the levels `[KMinus, ksize + KPlus)` (`KMinus <= 0 <= KPlus`).
+/// @ingroup cxxopt
+struct KColumnBuffer {
+  std::string Name; ///< Name of the local buffer
+  int KMinus;
+  int KPlus;
+
+  /// @brief Slot of the buffer holding level `k + kOffset`
+  int index(int kOffset) const { return kOffset - KMinus; }
+};
+
+/// @brief ASTVisitor to generate C++ optimized code for the stencil bodies
+///
+/// Accesses to k-cached fields and column temporaries are redirected to their local buffer,
+/// everything else is generated as in the naive backend.
+/// @ingroup cxxopt
+class ASTStencilBody : public cxxnaive::ASTStencilBody {
+  /// AccessID to k-cache window of the multistage we are currently generating
+  std::unordered_map<int, KCacheWindow> kcaches_;
+
+  /// AccessID to column buffer of the multistage we are currently generating
+  std::map<int, KColumnBuffer> kcolumns_;
+
+public:
+  using Base = cxxnaive::ASTStencilBody;
+  using Base::visit;
+
+  ASTStencilBody(const iir::StencilMetaInformation& metadata, StencilContext stencilContext);
+
+  /// @brief Set the k-caches held in local buffers (empty if accesses go to memory)
+  void setKCaches(std::unordered_map<int, KCacheWindow> kcaches);
+
+  /// @brief Set the temporaries held in column buffers
+  void setKColumns(std::map<int, KColumnBuffer> kcolumns);
+
+  void visit(const std::shared_ptr<ast::FieldAccessExpr>& expr) override;
+};
+
+} // namespace cxxopt
+} // namespace codegen
+} // namespace dawn
@@ -15,18 +15,27 @@
 #include "CXXOptCodeGen.h"
 #include "dawn/AST/GridType.h"
 #include "dawn/AST/Offsets.h"
-#include "dawn/CodeGen/CXXNaive/ASTStencilBody.h"
+#include "dawn/CodeGen/CXXNaive/ASTStencilDesc.h"
+#include "dawn/CodeGen/CXXOpt/ASTStencilBody.h"
 #include "dawn/CodeGen/CXXUtil.h"
 #include "dawn/CodeGen/CodeGenProperties.h"
+#include "dawn/IIR/ASTStmt.h"
 #include "dawn/IIR/Extents.h"
 #include "dawn/IIR/IIRNodeIterator.h"
 #include "dawn/IIR/Interval.h"
+#include "dawn/IIR/MultiStage.h"
 #include "dawn/IIR/Stage.h"
 #include "dawn/IIR/StencilInstantiation.h"
 #include "dawn/SIR/SIR.h"
+#include "dawn/Support/Casting.h"
 #include "dawn/Support/Exception.h"
 #include "dawn/Support/Logger.h"
 #include <algorithm>
+#include <cstdlib>
+#include <functional>
+#include <map>
+#include <optional>
+#include <set>
 #include <string>
 #include <vector>
 
@@ -89,18 +98,199 @@ std::string makeKLoop(bool isBackward, iir::Interval const& interval, bool isPar
   return isBackward ? makeLoopImpl(0, 0, "k", upper, lower, ">=", "--", isParallel)
                     : makeLoopImpl(0, 0, "k", lower, upper, "<=", "++", isParallel);
 }
+
+/// @brief Partition of the intervals of `ms`, in loop order
+std::vector<iir::Interval> makePartitionIntervals(const iir::MultiStage& ms) {
+  auto intervals_set = ms.getIntervals();
+  std::vector<iir::Interval> intervals_v;
+  std::copy(intervals_set.begin(), intervals_set.end(), std::back_inserter(intervals_v));
+
+  auto partitionIntervals = iir::Interval::computePartition(intervals_v);
+  if((ms.getLoopOrder() == iir::LoopOrderKind::Backward))
+    std::reverse(partitionIntervals.begin(), partitionIntervals.end());
+  return partitionIntervals;
+}
+
+/// @brief true if a statement of `ms` calls a stencil function
+bool callsStencilFunction(const iir::MultiStage& ms) {
+  class StencilFunCallFinder : public ast::ASTVisitorForwarding {
+  public:
+    bool Found = false;
+    void visit(const std::shared_ptr<const ast::StencilFunCallExpr>& expr) override {
+      Found = true;
+    }
+  };
+  StencilFunCallFinder finder;
+  for(const auto& doMethod : iterateIIROver<iir::DoMethod>(ms))
+    for(const auto& stmt : doMethod->getAST().getStatements())
+      stmt->accept(finder);
+  return finder.Found;
+}
+
+/// @brief Ring buffers of the k-caches of `ms`, none if the multistage can not be generated
+/// column by column
+std::optional<std::unordered_map<int, KCacheWindow>>
+makeKCacheWindows(const iir::StencilInstantiation& stencilInstantiation, const iir::MultiStage& ms,
+                  const std::vector<iir::Interval>& partitionIntervals) {
+  const auto& metadata = stencilInstantiation.getMetaData();
+  if(ms.getLoopOrder() == iir::LoopOrderKind::Parallel || ms.getChildren().empty())
+    return std::nullopt;
+  // the stencil functions access their arguments in memory, they would miss the levels held in
+  // the ring buffers
+  if(callsStencilFunction(ms)) {
+    DAWN_LOG(INFO) << stencilInstantiation.getName() << ": MultiStage " << ms.getID()
+                   << " calls stencil functions, it is not walked column by column";
+    return std::nullopt;
+  }
+
+  // columns are independent if no field written in the multistage is read with a horizontal
+  // offset, all the stages then need to share the same iteration space
+  const auto& extents = ms.getChildren().front()->getExtents().horizontalExtent();
+  for(const auto& stage : ms.getChildren()) {
+    if(!(stage->getExtents().horizontalExtent() == extents))
+      return std::nullopt;
+  }
+  for(const auto& fieldPair : ms.getFields()) {
+    const iir::Field& field = fieldPair.second;
+    if(field.getIntend() != iir::Field::IntendKind::Input &&
+       !field.getExtents().isHorizontalPointwise())
+      return std::nullopt;
+  }
+
+  // the windows slide by one level per iteration: the intervals need to be contiguous
+  for(std::size_t idx = 1; idx < partitionIntervals.size(); ++idx) {
+    if(!partitionIntervals[idx - 1].adjacent(partitionIntervals[idx]))
+      return std::nullopt;
+  }
+
+  std::unordered_map<int, KCacheWindow> kcaches;
+  const int direction = ms.getLoopOrder() == iir::LoopOrderKind::Backward ? -1 : 1;
+  for(const auto& cachePair : ms.getCaches()) {
+    const iir::Cache& cache = cachePair.second;
+    if(cache.getType() != iir::Cache::CacheType::K)
+      continue;
+    const int accessID = cachePair.first;
+    const iir::Extent vertExtent = ms.getKCacheVertExtent(accessID);
+    if(vertExtent.isUndefined())
+      return std::nullopt;
+    const int minus = direction * vertExtent.minus(), plus = direction * vertExtent.plus();
+    kcaches.emplace(accessID, KCacheWindow{metadata.getFieldNameFromAccessID(accessID) + "_kcache",
+                                           cache.getIOPolicy(), direction,
+                                           std::min({0, minus, plus}), std::max({0, minus, plus})});
+  }
+  return kcaches;
+}
+
+/// @brief Load slot `idx` of a k-cache from memory
+void generateKCacheFill(MemberFunction& function, const std::string& fieldName,
+                        const KCacheWindow& window, int idx) {
+  const std::string offset = std::to_string(window.offset(idx));
+  const std::string fill = window.Name + "[" + std::to_string(idx) + "] = " + fieldName +
+                           "(i+0, j+0, k+" + offset + ")";
+  if(window.offset(idx) == 0) {
+    function.addStatement(fill);
+  } else {
+    // levels outside of the storage can not be read by the stencil
+    function.addStatement("if(k+" + offset + " >= 0 && k+" + offset + " < m_dom.ksize()) " +
+                          fill);
+  }
+}
+
+/// @brief Write level `k + kOffset` of a k-cache back to memory. Levels in front of the interval of
+/// the cache have not been computed and are skipped, with a run-time check unless the distance of
+/// `interval` to the start of the cache interval tells they are always within.
+void generateKCacheFlush(MemberFunction& function, const std::string& fieldName,
+                         const KCacheWindow& window, const iir::Interval& cacheInterval,
+                         const iir::Interval& interval, int kOffset) {
+  DAWN_ASSERT(window.index(kOffset) >= 0 && window.index(kOffset) < window.size());
+  const std::string offset = std::to_string(kOffset);
+  const std::string flush = fieldName + "(i+0, j+0, k+" + offset + ") = " + window.Name + "[" +
+                            std::to_string(window.index(kOffset)) + "]";
+
+  const bool isBackward = window.Direction < 0;
+  auto dist = iir::distance(cacheInterval, interval,
+                            isBackward ? iir::LoopOrderKind::Backward
+                                       : iir::LoopOrderKind::Forward);
+  if(kOffset == 0 || (dist.rangeType_ == iir::IntervalDiff::RangeType::literal &&
+                      std::abs(dist.value) >= std::abs(kOffset))) {
+    function.addStatement(flush);
+  } else {
+    const std::string cacheBegin = makeIntervalBoundReadable(
+        "k", cacheInterval, isBackward ? iir::Interval::Bound::upper : iir::Interval::Bound::lower);
+    function.addStatement("if(k+" + offset + (isBackward ? " <= " : " >= ") + cacheBegin + ") " +
+                          flush);
+  }
+}
+
+/// @brief Write a k-cache back to memory at the end of an iteration of `interval`, before its
+/// window slides (same policies as the cuda backend)
+///
+/// flush and fill_and_flush caches write the level about to leave the window at every iteration
+/// within the cache interval, and the rest of the window after the last one. epflush caches only
+/// write their window, after the last iteration of the cache interval.
+void generateKCacheFlushes(MemberFunction& function, const std::string& fieldName,
+                           const KCacheWindow& window, const iir::Cache& cache,
+                           const iir::Interval& interval) {
+  const iir::Cache::IOPolicy policy = cache.getIOPolicy();
+  if(policy != iir::Cache::IOPolicy::flush && policy != iir::Cache::IOPolicy::epflush &&
+     policy != iir::Cache::IOPolicy::fill_and_flush)
+    return;
+
+  DAWN_ASSERT(cache.getInterval());
+  const iir::Interval& cacheInterval = *cache.getInterval();
+  if(!cacheInterval.contains(interval))
+    return;
+
+  const bool isBackward = window.Direction < 0;
+  if(policy != iir::Cache::IOPolicy::epflush)
+    generateKCacheFlush(function, fieldName, window, cacheInterval, interval, window.offset(0));
+
+  const auto endBound = isBackward ? iir::Interval::Bound::lower : iir::Interval::Bound::upper;
+  if(interval.bound(endBound) != cacheInterval.bound(endBound))
+    return;
+
+  // levels of the window which have been computed, but not written back yet
+  std::vector<int> offsets;
+  if(policy == iir::Cache::IOPolicy::epflush) {
+    DAWN_ASSERT(cache.getWindow());
+    for(int kOffset = cache.getWindow()->m_m; kOffset <= cache.getWindow()->m_p; ++kOffset)
+      if(window.Direction * kOffset <= 0)
+        offsets.push_back(kOffset);
+  } else {
+    for(int idx = 1; idx <= window.index(0); ++idx)
+      offsets.push_back(window.offset(idx));
+  }
+  if(offsets.empty())
+    return;
+
+  function.addBlockStatement(
+      "if(k == " + makeIntervalBoundReadable("k", cacheInterval, endBound) + ")", [&]() {
+        for(int kOffset : offsets)
+          generateKCacheFlush(function, fieldName, window, cacheInterval, interval, kOffset);
+      });
+}
 } // namespace
 
 std::unique_ptr<TranslationUnit>
 run(const std::map<std::string, std::shared_ptr<iir::StencilInstantiation>>&
         stencilInstantiationMap, const Options& options) {
-  CXXOptCodeGen CG(stencilInstantiationMap, options.MaxHaloSize);
+  CXXOptCodeGen CG(stencilInstantiationMap, options.MaxHaloSize, options.SlimRuntime,
+                   options.PrecompiledHeader, options.TmpMemoryPlanning,
+                   options.ReduceTmpDimensions, options.RawPointerAccess,
+                   options.FusedStencilTileSize, options.Vectorize,
+                   {options.DomainSizeI, options.DomainSizeJ, options.DomainSizeK});
 
   return CG.generateCode();
 }
 
-CXXOptCodeGen::CXXOptCodeGen(const StencilInstantiationContext& ctx, int maxHaloPoint)
-    : CXXNaiveCodeGen(ctx, maxHaloPoint) {}
+CXXOptCodeGen::CXXOptCodeGen(const StencilInstantiationContext& ctx, int maxHaloPoint,
+                             bool slimRuntime, const std::string& precompiledHeader,
+                             bool tmpMemoryPlanning, bool reduceTmpDimensions,
+                             bool rawPointerAccess, int fusedStencilTileSize, bool vectorize,
+                             const Array3i& domainSize)
+    : CXXNaiveCodeGen(ctx, maxHaloPoint, slimRuntime, precompiledHeader, tmpMemoryPlanning,
+                      reduceTmpDimensions, rawPointerAccess, domainSize),
+      fusedStencilTileSize_(fusedStencilTileSize), vectorize_(vectorize) {}
 
 CXXOptCodeGen::~CXXOptCodeGen() {}
 
@@ -122,7 +312,10 @@ std::string CXXOptCodeGen::generateStencilInstantiation(
 
   generateStencilFunctions(stencilWrapperClass, stencilInstantiation, codeGenProperties);
 
-  generateStencilClasses(stencilInstantiation, stencilWrapperClass, codeGenProperties);
+  const auto fusedStencilGroups = makeFusedStencilGroups(*stencilInstantiation);
+
+  generateStencilClasses(stencilInstantiation, stencilWrapperClass, codeGenProperties,
+                         fusedStencilGroups);
 
   generateStencilWrapperMembers(stencilWrapperClass, stencilInstantiation, codeGenProperties);
 
@@ -130,7 +323,8 @@ std::string CXXOptCodeGen::generateStencilInstantiation(
 
   generateGlobalsAPI(stencilWrapperClass, globalsMap, codeGenProperties);
 
-  generateStencilWrapperRun(stencilWrapperClass, stencilInstantiation, codeGenProperties);
+  generateStencilWrapperRun(stencilWrapperClass, stencilInstantiation, codeGenProperties,
+                            fusedStencilGroups);
 
   stencilWrapperClass.commit();
 
@@ -140,12 +334,252 @@ std::string CXXOptCodeGen::generateStencilInstantiation(
   return ssSW.str();
 }
 
+CXXOptCodeGen::FusedStencilGroups CXXOptCodeGen::makeFusedStencilGroups(
+    const iir::StencilInstantiation& stencilInstantiation) const {
+  FusedStencilGroups fusedStencilGroups;
+  if(fusedStencilTileSize_ <= 0)
+    return fusedStencilGroups;
+
+  const auto& metadata = stencilInstantiation.getMetaData();
+
+  // A stencil can be run tile by tile if its points are independent of the tiling: stencils with
+  // global indices depend on the absolute position and in-place updates would be applied several
+  // times to the overlapping halos of the tiles
+  auto getFusableStencil = [&](const std::shared_ptr<ast::Stmt>& stmt) -> const iir::Stencil* {
+    auto stencilCall = dyn_pointer_cast<ast::StencilCallDeclStmt>(stmt);
+    if(!stencilCall)
+      return nullptr;
+    const iir::Stencil& stencil = stencilInstantiation.getIIR()->getStencil(
+        metadata.getStencilIDFromStencilCallStmt(stencilCall));
+    if(stencil.isEmpty() || hasGlobalIndices(stencil))
+      return nullptr;
+    for(const auto& fieldPair : stencil.getFields())
+      if(!fieldPair.second.IsTemporary &&
+         fieldPair.second.field.getIntend() == iir::Field::IntendKind::InputOutput)
+        return nullptr;
+    return &stencil;
+  };
+
+  const ast::Stmt* groupBegin = nullptr;
+  std::vector<const iir::Stencil*> group;
+  std::set<int> readFields, writtenFields;
+
+  auto closeGroup = [&]() {
+    if(group.size() > 1) {
+      std::vector<FusedStencil> fusedStencils;
+      for(const iir::Stencil* stencil : group)
+        fusedStencils.push_back(
+            FusedStencil{stencil->getStencilID(), iir::Extents(ast::cartesian)});
+
+      // Each stencil computes the points of its outputs read by the next stencils of the group, for
+      // all the points these compute themselves
+      for(int idx = group.size() - 2; idx >= 0; --idx) {
+        iir::Extents& halo = fusedStencils[idx].Halo;
+        for(const auto& fieldPair : group[idx]->getFields()) {
+          if(fieldPair.second.IsTemporary ||
+             fieldPair.second.field.getIntend() != iir::Field::IntendKind::Output)
+            continue;
+          for(std::size_t next = idx + 1; next < group.size(); ++next) {
+            auto fieldIt = group[next]->getFields().find(fieldPair.first);
+            if(fieldIt == group[next]->getFields().end() ||
+               !fieldIt->second.field.getReadExtentsRB())
+              continue;
+            halo.merge(*fieldIt->second.field.getReadExtentsRB() + fusedStencils[next].Halo);
+          }
+        }
+        halo.resetVerticalExtent();
+      }
+      fusedStencilGroups.emplace(groupBegin, std::move(fusedStencils));
+    }
+    group.clear();
+    readFields.clear();
+    writtenFields.clear();
+  };
+
+  auto addToGroup = [&](const ast::Stmt* stmt, const iir::Stencil* stencil) {
+    // A tile of the stencil must not overwrite the fields used by the previous stencils of the
+    // group, which still access them in the next tiles
+    for(const auto& fieldPair : stencil->getFields()) {
+      if(!fieldPair.second.IsTemporary &&
+         fieldPair.second.field.getIntend() == iir::Field::IntendKind::Output &&
+         (readFields.count(fieldPair.first) || writtenFields.count(fieldPair.first))) {
+        closeGroup();
+        break;
+      }
+    }
+
+    if(group.empty())
+      groupBegin = stmt;
+    group.push_back(stencil);
+    for(const auto& fieldPair : stencil->getFields()) {
+      if(fieldPair.second.IsTemporary)
+        continue;
+      if(fieldPair.second.field.getIntend() == iir::Field::IntendKind::Output)
+        writtenFields.insert(fieldPair.first);
+      else
+        readFields.insert(fieldPair.first);
+    }
+  };
+
+  // Groups are formed by the consecutive calls of a statement list, the stencil splitter puts the
+  // stencils replacing a stencil in a block statement
+  std::function<void(const std::vector<std::shared_ptr<ast::Stmt>>&)> groupStatements =
+      [&](const std::vector<std::shared_ptr<ast::Stmt>>& statements) {
+        for(const auto& stmt : statements) {
+          const iir::Stencil* stencil = getFusableStencil(stmt);
+          if(!stencil) {
+            closeGroup();
+            if(auto blockStmt = dyn_pointer_cast<ast::BlockStmt>(stmt))
+              groupStatements(blockStmt->getStatements());
+            continue;
+          }
+          addToGroup(stmt.get(), stencil);
+        }
+        closeGroup();
+      };
+  groupStatements(stencilInstantiation.getIIR()->getControlFlowDescriptor().getStatements());
+
+  for(const auto& groupPair : fusedStencilGroups)
+    DAWN_LOG(INFO) << "Stencils " << groupPair.second.front().StencilID << " to "
+                   << groupPair.second.back().StencilID << " are run on tiles of "
+                   << fusedStencilTileSize_ << "x" << fusedStencilTileSize_ << " points";
+
+  return fusedStencilGroups;
+}
+
+void CXXOptCodeGen::generateStencilWrapperRun(
+    Class& stencilWrapperClass,
+    const std::shared_ptr<iir::StencilInstantiation> stencilInstantiation,
+    const CodeGenProperties& codeGenProperties,
+    const FusedStencilGroups& fusedStencilGroups) const {
+
+  const auto& metadata = stencilInstantiation->getMetaData();
+
+  // Generate the run method by generate code for the stencil description AST
+  MemberFunction runMethod = stencilWrapperClass.addMemberFunction("void", "run", "");
+
+  for(const auto& fieldID : metadata.getAPIFields()) {
+    std::string name = metadata.getFieldNameFromAccessID(fieldID);
+    runMethod.addArg(codeGenProperties.getParamType(stencilInstantiation, name) + " " + name);
+  }
+
+  runMethod.finishArgs();
+
+  // Storages passed to the stencil `stencilID` by the wrapper
+  auto getStencilArgs = [&](int stencilID) {
+    const iir::Stencil& stencil = stencilInstantiation->getIIR()->getStencil(stencilID);
+    std::vector<std::string> args;
+    for(const auto& fieldPair : stencil.getOrderedFields()) {
+      if(fieldPair.second.IsTemporary)
+        continue;
+      if(metadata.isAccessType(iir::FieldAccessType::InterStencilTemporary, fieldPair.first))
+        args.push_back("m_" + fieldPair.second.Name);
+      else
+        args.push_back(fieldPair.second.Name);
+    }
+    return args;
+  };
+
+  // Run a group of fused stencils one tile after the other
+  auto generateFusedStencils = [&](const std::vector<FusedStencil>& fusedStencils) {
+    std::vector<std::string> storages;
+    for(const auto& fusedStencil : fusedStencils)
+      for(const auto& arg : getStencilArgs(fusedStencil.StencilID))
+        if(std::find(storages.begin(), storages.end(), arg) == storages.end())
+          storages.push_back(arg);
+
+    const std::string tileSize = std::to_string(fusedStencilTileSize_);
+    const std::string tileLast = std::to_string(fusedStencilTileSize_ - 1);
+    runMethod.addBlockStatement("", [&]() {
+      runMethod.addStatement(
+          "const " + c_dgt + "domain& dom = m_" +
+          codeGenProperties.getStencilName(StencilContext::SC_Stencil,
+                                           fusedStencils.front().StencilID) +
+          ".m_dom");
+      for(const auto& storage : storages)
+        runMethod.addStatement(storage + ".sync()");
+      // A single parallel region for all the tiles: every thread walks the tiles, the loops of
+      // `run_tile` share out the points of a tile (`omp for`) and wait for each other at the end
+      runMethod.addBlockStatement("\n#pragma omp parallel\n", [&]() {
+        runMethod.addBlockStatement(
+            "for(int tileJ = " + getDomainBound(1, iir::Interval::Bound::lower, "dom") +
+                "; tileJ <= " + getDomainBound(1, iir::Interval::Bound::upper, "dom") +
+                "; tileJ += " + tileSize + ")",
+            [&]() {
+              runMethod.addBlockStatement(
+                  "for(int tileI = " + getDomainBound(0, iir::Interval::Bound::lower, "dom") +
+                      "; tileI <= " + getDomainBound(0, iir::Interval::Bound::upper, "dom") +
+                      "; tileI += " + tileSize + ")",
+                  [&]() {
+                    for(const auto& fusedStencil : fusedStencils) {
+                      std::string call =
+                          "m_" +
+                          codeGenProperties.getStencilName(StencilContext::SC_Stencil,
+                                                           fusedStencil.StencilID) +
+                          ".run_tile(";
+                      for(const auto& arg : getStencilArgs(fusedStencil.StencilID))
+                        call += arg + ", ";
+                      runMethod.addStatement(call + "tileI, tileI + " + tileLast +
+                                             ", tileJ, tileJ + " + tileLast + ")");
+                    }
+                  });
+            });
+      });
+      for(const auto& storage : storages)
+        runMethod.addStatement(storage + ".sync()");
+    });
+  };
+
+  // generate the control flow code executing each inner stencil
+  ASTStencilDesc stencilDescCGVisitor(stencilInstantiation, codeGenProperties);
+  stencilDescCGVisitor.setIndent(runMethod.getIndent());
+  std::function<void(const std::vector<std::shared_ptr<ast::Stmt>>&)> generateStatements =
+      [&](const std::vector<std::shared_ptr<ast::Stmt>>& statements) {
+        for(std::size_t stmtIdx = 0; stmtIdx < statements.size();) {
+          const auto& statement = statements[stmtIdx];
+          auto groupIt = fusedStencilGroups.find(statement.get());
+          if(groupIt != fusedStencilGroups.end()) {
+            generateFusedStencils(groupIt->second);
+            stmtIdx += groupIt->second.size();
+            continue;
+          }
+          ++stmtIdx;
+
+          // block statements may contain fused stencils
+          auto blockStmt = dyn_pointer_cast<ast::BlockStmt>(statement);
+          if(blockStmt && !fusedStencilGroups.empty()) {
+            runMethod.addBlockStatement("",
+                                        [&]() { generateStatements(blockStmt->getStatements()); });
+            continue;
+          }
+          statement->accept(stencilDescCGVisitor);
+          auto str = stencilDescCGVisitor.getCodeAndResetStream();
+          if(str.back() == ';')
+            str.pop_back();
+          runMethod.addStatement(str);
+        }
+      };
+  generateStatements(stencilInstantiation->getIIR()->getControlFlowDescriptor().getStatements());
+
+  runMethod.commit();
+}
+
 void CXXOptCodeGen::generateStencilClasses(
     const std::shared_ptr<iir::StencilInstantiation> stencilInstantiation,
-    Class& stencilWrapperClass, const CodeGenProperties& codeGenProperties) const {
+    Class& stencilWrapperClass, const CodeGenProperties& codeGenProperties,
+    const FusedStencilGroups& fusedStencilGroups) const {
 
   const auto& stencils = stencilInstantiation->getStencils();
   const auto& globalsMap = stencilInstantiation->getIIR()->getGlobalVariableMap();
+  const auto& metadata = stencilInstantiation->getMetaData();
+
+  auto findFusedStencil = [&](int stencilID) -> const FusedStencil* {
+    for(const auto& groupPair : fusedStencilGroups)
+      for(const auto& fusedStencil : groupPair.second)
+        if(fusedStencil.StencilID == stencilID)
+          return &fusedStencil;
+    return nullptr;
+  };
 
   // Stencil members:
   // generate the code for each of the stencils
@@ -168,15 +602,60 @@ void CXXOptCodeGen::generateStencilClasses(
         makeRange(stencilFields, [](std::pair<int, iir::Stencil::FieldInfo> const& p) {
           return !p.second.IsTemporary;
         });
+    // k-caches of the multistages which can be walked column by column
+    std::unordered_map<const iir::MultiStage*, std::unordered_map<int, KCacheWindow>>
+        columnMultiStages;
+    for(const auto& multiStage : stencil.getChildren()) {
+      auto kcaches = makeKCacheWindows(*stencilInstantiation, *multiStage,
+                                       makePartitionIntervals(*multiStage));
+      if(kcaches)
+        columnMultiStages.emplace(multiStage.get(), std::move(*kcaches));
+    }
+
+    // temporaries only accessed at the current (i,j) of a multistage walked column by column are
+    // kept in a column buffer
+    std::unordered_map<const iir::MultiStage*, std::map<int, KColumnBuffer>> columnBuffers;
+    std::set<int> tmpColumns;
+    for(const auto& [accessID, local] : getMultiStageLocalTemporaries(stencil)) {
+      const auto& [multiStage, extents] = local;
+      auto columnMultiStageIt = columnMultiStages.find(multiStage);
+      if(columnMultiStageIt == columnMultiStages.end() ||
+         columnMultiStageIt->second.count(accessID) || !extents.isHorizontalPointwise() ||
+         extents.verticalExtent().isUndefined())
+        continue;
+      columnBuffers[multiStage].emplace(
+          accessID, KColumnBuffer{metadata.getFieldNameFromAccessID(accessID) + "_column",
+                                  std::min(0, extents.verticalExtent().minus()),
+                                  std::max(0, extents.verticalExtent().plus())});
+      tmpColumns.insert(accessID);
+    }
+    if(!tmpColumns.empty())
+      DAWN_LOG(INFO) << "Stencil " << stencil.getStencilID() << ": " << tmpColumns.size()
+                     << " temporaries demoted to column buffers";
+    // the other multistages keep the loops level by level
+    for(auto it = columnMultiStages.begin(); it != columnMultiStages.end();) {
+      if(it->second.empty() && !columnBuffers.count(it->first))
+        it = columnMultiStages.erase(it);
+      else
+        ++it;
+    }
+
+    // parallel multistages distribute the vertical levels to threads and multistages walked
+    // column by column have the vertical loop innermost
+    const auto tmpPlanes = getIJPlaneTemporaries(stencil, [&](const iir::MultiStage& multiStage) {
+      return multiStage.getLoopOrder() != iir::LoopOrderKind::Parallel &&
+             !columnMultiStages.count(&multiStage);
+    });
     auto tempFields =
-        makeRange(stencilFields, [](std::pair<int, iir::Stencil::FieldInfo> const& p) {
-          return p.second.IsTemporary;
+        makeRange(stencilFields, [&](std::pair<int, iir::Stencil::FieldInfo> const& p) {
+          return p.second.IsTemporary && !tmpPlanes.count(p.first) && !tmpColumns.count(p.first);
         });
 
     Structure stencilClass = stencilWrapperClass.addStruct(stencilName);
 
     ASTStencilBody stencilBodyCXXVisitor(stencilInstantiation->getMetaData(),
                                          StencilContext::SC_Stencil);
+    stencilBodyCXXVisitor.setTmpPlanes(tmpPlanes);
 
     stencilClass.addComment("Members");
     bool iterationSpaceSet = hasGlobalIndices(stencil);
@@ -186,6 +665,8 @@ void CXXOptCodeGen::generateStencilClasses(
 
     stencilClass.addComment("Temporary storages");
     addTempStorageTypedef(stencilClass, stencil);
+    if(!tmpPlanes.empty())
+      addTmpPlaneStorageTypedef(stencilClass);
 
     stencilClass.addMember("const " + c_dgt + "domain", "m_dom");
 
@@ -195,7 +676,9 @@ void CXXOptCodeGen::generateStencilClasses(
 
     stencilClass.addComment("Input/Output storages");
 
-    addTmpStorageDeclaration(stencilClass, tempFields);
+    const auto tmpStorages = planTmpStorages(stencil, tempFields);
+    addTmpStorageDeclaration(stencilClass, tmpStorages);
+    addTmpPlaneStorageDeclaration(stencilClass, stencil, tmpPlanes);
 
     stencilClass.changeAccessibility("public");
 
@@ -240,7 +723,8 @@ void CXXOptCodeGen::generateStencilClasses(
       stencilClassCtr.addInit("globalOffsets({computeGlobalOffsets(rank, m_dom, xcols, ycols)})");
     }
 
-    addTmpStorageInit(stencilClassCtr, stencil, tempFields);
+    addTmpStorageInit(stencilClassCtr, stencil, tmpStorages);
+    addTmpPlaneStorageInit(stencilClassCtr, stencil, tmpPlanes);
     stencilClassCtr.commit();
 
     // virtual dtor
@@ -253,61 +737,256 @@ void CXXOptCodeGen::generateStencilClasses(
     //
     // Run-Method
     //
-    MemberFunction stencilRunMethod = stencilClass.addMemberFunction("void", "run", "");
-    for(auto it = nonTempFields.begin(); it != nonTempFields.end(); ++it) {
-      std::string type = stencilProperties->paramNameToType_.at((*it).second.Name);
-      stencilRunMethod.addArg(type + "& " + (*it).second.Name + "_");
-    }
-
-    stencilRunMethod.startBody();
-    // Compute the loop bounds for readability
-    stencilRunMethod.addStatement("int iMin = m_dom.iminus()");
-    stencilRunMethod.addStatement("int iMax = m_dom.isize() - m_dom.iplus() - 1");
-    stencilRunMethod.addStatement("int jMin = m_dom.jminus()");
-    stencilRunMethod.addStatement("int jMax = m_dom.jsize() - m_dom.jplus() - 1");
-    stencilRunMethod.addStatement("int kMin = m_dom.kminus()");
-    stencilRunMethod.addStatement("int kMax = m_dom.ksize() - m_dom.kplus() - 1");
-
-    for(const auto& fieldPair : nonTempFields) {
-      stencilRunMethod.addStatement(fieldPair.second.Name + "_" + ".sync()");
-    }
-    for(const auto& multiStagePtr : stencil.getChildren()) {
-
-      stencilRunMethod.ss() << "{";
-
-      const iir::MultiStage& multiStage = *multiStagePtr;
-
-      // create all the data views
+    // `run_tile` computes one tile of a fused stencil, see `FusedStencilTileSize`
+    auto generateRunMethod = [&](const FusedStencil* fusedStencil) {
+      MemberFunction stencilRunMethod =
+          stencilClass.addMemberFunction("void", fusedStencil ? "run_tile" : "run", "");
       for(auto it = nonTempFields.begin(); it != nonTempFields.end(); ++it) {
-        const auto fieldName = (*it).second.Name;
-        std::string type = stencilProperties->paramNameToType_.at(fieldName);
-        stencilRunMethod.addStatement(c_gt + "data_view<" + type + "> " + fieldName + "= " +
-                                      c_gt + "make_host_view(" + fieldName + "_)");
-        stencilRunMethod.addStatement("std::array<int,3> " + fieldName + "_offsets{0,0,0}");
+        std::string type = stencilProperties->paramNameToType_.at((*it).second.Name);
+        stencilRunMethod.addArg(type + "& " + (*it).second.Name + "_");
       }
-      for(const auto& fieldPair : tempFields) {
-        const auto fieldName = fieldPair.second.Name;
-        stencilRunMethod.addStatement(c_gt + "data_view<tmp_storage_t> " + fieldName + "= " +
-                                      c_gt + "make_host_view(m_" + fieldName + ")");
-        stencilRunMethod.addStatement("std::array<int,3> " + fieldName + "_offsets{0,0,0}");
+      if(fusedStencil) {
+        stencilRunMethod.addArg("int tileIMin");
+        stencilRunMethod.addArg("int tileIMax");
+        stencilRunMethod.addArg("int tileJMin");
+        stencilRunMethod.addArg("int tileJMax");
       }
 
-      auto intervals_set = multiStage.getIntervals();
-      std::vector<iir::Interval> intervals_v;
-      std::copy(intervals_set.begin(), intervals_set.end(), std::back_inserter(intervals_v));
+      stencilRunMethod.startBody();
+      // Compute the loop bounds for readability
+      if(fusedStencil) {
+        // the tile grown by the halo read by the next stencils of the group, within the domain
+        auto const& halo =
+            iir::extent_cast<iir::CartesianExtent const&>(fusedStencil->Halo.horizontalExtent());
+        // the domain bounds are unsigned
+        stencilRunMethod.addStatement("int iMin = std::max<int>(" +
+                                      getDomainBound(0, iir::Interval::Bound::lower, "m_dom") +
+                                      ", tileIMin - " + std::to_string(-halo.iMinus()) + ")");
+        stencilRunMethod.addStatement("int iMax = std::min<int>(" +
+                                      getDomainBound(0, iir::Interval::Bound::upper, "m_dom") +
+                                      ", tileIMax + " + std::to_string(halo.iPlus()) + ")");
+        stencilRunMethod.addStatement("int jMin = std::max<int>(" +
+                                      getDomainBound(1, iir::Interval::Bound::lower, "m_dom") +
+                                      ", tileJMin - " + std::to_string(-halo.jMinus()) + ")");
+        stencilRunMethod.addStatement("int jMax = std::min<int>(" +
+                                      getDomainBound(1, iir::Interval::Bound::upper, "m_dom") +
+                                      ", tileJMax + " + std::to_string(halo.jPlus()) + ")");
+      } else {
+        addDomainBounds(stencilRunMethod, 0, "m_dom");
+        addDomainBounds(stencilRunMethod, 1, "m_dom");
+      }
+      addDomainBounds(stencilRunMethod, 2, "m_dom");
 
-      // compute the partition of the intervals
-      auto partitionIntervals = iir::Interval::computePartition(intervals_v);
-      if((multiStage.getLoopOrder() == iir::LoopOrderKind::Backward))
-        std::reverse(partitionIntervals.begin(), partitionIntervals.end());
+      // the caller synchronizes the storages once for all the tiles
+      if(!fusedStencil) {
+        for(const auto& fieldPair : nonTempFields) {
+          stencilRunMethod.addStatement(fieldPair.second.Name + "_" + ".sync()");
+        }
+      }
+      for(const auto& multiStagePtr : stencil.getChildren()) {
+
+        stencilRunMethod.ss() << "{";
+
+        const iir::MultiStage& multiStage = *multiStagePtr;
+
+        // create all the data views
+        for(auto it = nonTempFields.begin(); it != nonTempFields.end(); ++it) {
+          const auto fieldName = (*it).second.Name;
+          std::string type = stencilProperties->paramNameToType_.at(fieldName);
+          stencilRunMethod.addStatement(c_gt + "data_view<" + type + "> " + fieldName + "= " +
+                                        c_gt + "make_host_view(" + fieldName + "_)");
+          stencilRunMethod.addStatement("std::array<int,3> " + fieldName + "_offsets{0,0,0}");
+        }
+        for(const auto& fieldPair : tempFields) {
+          const auto fieldName = fieldPair.second.Name;
+          stencilRunMethod.addStatement(c_gt + "data_view<tmp_storage_t> " + fieldName + "= " +
+                                        c_gt + "make_host_view(" +
+                                        tmpStorages.at(fieldPair.first) + ")");
+          stencilRunMethod.addStatement("std::array<int,3> " + fieldName + "_offsets{0,0,0}");
+        }
+        for(int accessID : tmpPlanes) {
+          const auto fieldName = metadata.getFieldNameFromAccessID(accessID);
+          stencilRunMethod.addStatement(c_gt + "data_view<tmp_plane_storage_t> " + fieldName +
+                                        "= " + c_gt + "make_host_view(m_" + fieldName + ")");
+          stencilRunMethod.addStatement("std::array<int,3> " + fieldName + "_offsets{0,0,0}");
+        }
+
+        // The stage bodies access the fields through raw pointers when requested and in the
+        // vectorized loops (multistages walked column by column are not vectorized), the views are
+        // still used by the stencil functions
+        std::unordered_map<int, FieldPointer> fieldPointers;
+        if(codeGenOptions.RawPointerAccess ||
+           (vectorize_ && !columnMultiStages.count(&multiStage))) {
+          for(const auto& fieldPair : nonTempFields)
+            fieldPointers.emplace(fieldPair.first,
+                                  addFieldPointer(stencilRunMethod, metadata, fieldPair.first,
+                                                  fieldPair.second.Name + "_", false));
+          for(const auto& fieldPair : tempFields)
+            fieldPointers.emplace(fieldPair.first,
+                                  addFieldPointer(stencilRunMethod, metadata, fieldPair.first,
+                                                  tmpStorages.at(fieldPair.first), false));
+          for(int accessID : tmpPlanes)
+            fieldPointers.emplace(accessID, addFieldPointer(
+                                                stencilRunMethod, metadata, accessID,
+                                                "m_" + metadata.getFieldNameFromAccessID(accessID),
+                                                true));
+        }
+        stencilBodyCXXVisitor.setFieldPointers(std::move(fieldPointers));
+
+        const auto partitionIntervals = makePartitionIntervals(multiStage);
+
+        // Generate the body of `stage` restricted to `interval` for the current (i,j,k) point
+        auto generateStageBody = [&](const iir::Stage& stage, const iir::Interval& interval) {
+          auto doMethodGenerator = [&]() {
+            // Generate Do-Method
+            for(const auto& doMethodPtr : stage.getChildren()) {
+              const iir::DoMethod& doMethod = *doMethodPtr;
+              if(!doMethod.getInterval().overlaps(interval))
+                continue;
+              for(const auto& stmt : doMethod.getAST().getStatements()) {
+                stmt->accept(stencilBodyCXXVisitor);
+                stencilRunMethod << stencilBodyCXXVisitor.getCodeAndResetStream();
+              }
+            }
+          };
+
+          if(std::any_of(stage.getIterationSpace().cbegin(), stage.getIterationSpace().cend(),
+                         [](const auto& p) -> bool { return p.has_value(); })) {
+            std::string conditional = "if(";
+            if(stage.getIterationSpace()[0]) {
+              conditional += "checkOffset(stage" + std::to_string(stage.getStageID()) +
+                             "GlobalIIndices[0], stage" + std::to_string(stage.getStageID()) +
+                             "GlobalIIndices[1], globalOffsets[0] + i)";
+            }
+            if(stage.getIterationSpace()[1]) {
+              if(stage.getIterationSpace()[0]) {
+                conditional += " && ";
+              }
+              conditional += "checkOffset(stage" + std::to_string(stage.getStageID()) +
+                             "GlobalJIndices[0], stage" + std::to_string(stage.getStageID()) +
+                             "GlobalJIndices[1], globalOffsets[1] + j)";
+            }
+            conditional += ")";
+            stencilRunMethod.addBlockStatement(conditional, doMethodGenerator);
+          } else {
+            doMethodGenerator();
+          }
+        };
+
+        auto hasOverlappingInterval = [](const iir::Stage& stage, const iir::Interval& interval) {
+          return std::any_of(stage.getChildren().begin(), stage.getChildren().end(),
+                             [&](const auto& doMethodPtr) {
+                               return doMethodPtr->getInterval().overlaps(interval);
+                             });
+        };
+
+        auto columnMultiStageIt = columnMultiStages.find(&multiStage);
+        if(columnMultiStageIt != columnMultiStages.end()) {
+          const auto& kcaches = columnMultiStageIt->second;
+          const auto& kcolumns = columnBuffers[&multiStage];
+          // Columns are independent: walk each of them through all the intervals, keeping the
+          // k-cached levels in local ring buffers
+          auto const& extents = iir::extent_cast<iir::CartesianExtent const&>(
+              multiStage.getChildren().front()->getExtents().horizontalExtent());
+          const bool isBackward = multiStage.getLoopOrder() == iir::LoopOrderKind::Backward;
+
+          stencilBodyCXXVisitor.setKCaches(kcaches);
+          stencilBodyCXXVisitor.setKColumns(kcolumns);
+          // Walk the column (i,j) through all the intervals
+          auto generateColumn = [&]() {
+            for(const auto& kcache : kcaches)
+              stencilRunMethod.addStatement("::dawn::float_type " + kcache.second.Name + "[" +
+                                            std::to_string(kcache.second.size()) + "]");
+
+            // Pre-fill all the levels but the head of the window
+            if(!kcaches.empty()) {
+              stencilRunMethod.addBlockStatement("", [&]() {
+                stencilRunMethod.addStatement(
+                    "int k = " +
+                    makeIntervalBoundReadable("k", partitionIntervals.front(),
+                                              isBackward ? iir::Interval::Bound::upper
+                                                         : iir::Interval::Bound::lower));
+                for(const auto& kcache : kcaches) {
+                  if(kcache.second.Policy == iir::Cache::IOPolicy::local)
+                    continue;
+                  for(int idx = 0; idx < kcache.second.size() - 1; ++idx)
+                    generateKCacheFill(stencilRunMethod,
+                                       metadata.getFieldNameFromAccessID(kcache.first),
+                                       kcache.second, idx);
+                }
+              });
+            }
+
+            for(const auto& interval : partitionIntervals) {
+              stencilRunMethod.addBlockStatement(makeKLoop(isBackward, interval), [&]() {
+                for(const auto& kcache : kcaches) {
+                  if(kcache.second.Policy != iir::Cache::IOPolicy::local)
+                    generateKCacheFill(stencilRunMethod,
+                                       metadata.getFieldNameFromAccessID(kcache.first),
+                                       kcache.second, kcache.second.size() - 1);
+                }
 
-      for(auto interval : partitionIntervals) {
+                for(const auto& stagePtr : multiStage.getChildren()) {
+                  if(hasOverlappingInterval(*stagePtr, interval))
+                    generateStageBody(*stagePtr, interval);
+                }
 
-        // for each interval, we generate naive nested loops
-        stencilRunMethod.addBlockStatement(
-            makeKLoop((multiStage.getLoopOrder() == iir::LoopOrderKind::Backward), interval,
-                      (multiStage.getLoopOrder() == iir::LoopOrderKind::Parallel)),
-            [&]() {
+                for(const auto& kcache : kcaches) {
+                  const auto& window = kcache.second;
+                  const std::string& name = window.Name;
+                  generateKCacheFlushes(stencilRunMethod,
+                                        metadata.getFieldNameFromAccessID(kcache.first), window,
+                                        multiStage.getCache(kcache.first), interval);
+                  // slide the window by one level
+                  for(int idx = 0; idx < window.size() - 1; ++idx)
+                    stencilRunMethod.addStatement(name + "[" + std::to_string(idx) + "] = " + name +
+                                                  "[" + std::to_string(idx + 1) + "]");
+                }
+              });
+            }
+          };
+          auto generateColumnLoops = [&](bool isParallel) {
+            stencilRunMethod.addBlockStatement(
+                (isParallel ? "" : "\n#pragma omp for\n") +
+                    makeLoopImpl(extents.iMinus(), extents.iPlus(), "i", "iMin", "iMax", " <= ",
+                                 "++", isParallel),
+                [&]() {
+                  stencilRunMethod.addBlockStatement(
+                      makeIJLoop(extents.jMinus(), extents.jPlus(), "m_dom", "j"), generateColumn);
+                });
+          };
+          // one column buffer per thread, reused by all the columns it walks
+          auto generateColumnBuffers = [&]() {
+            for(const auto& kcolumn : kcolumns)
+              stencilRunMethod.addStatement(
+                  "std::vector<::dawn::float_type> " + kcolumn.second.Name + "(" +
+                  getDomainSize(2, "m_dom") + " + " +
+                  std::to_string(kcolumn.second.KPlus - kcolumn.second.KMinus) + ")");
+          };
+          if(fusedStencil) {
+            generateColumnBuffers();
+            generateColumnLoops(false);
+          } else if(kcolumns.empty()) {
+            generateColumnLoops(true);
+          } else {
+            stencilRunMethod.addBlockStatement("\n#pragma omp parallel\n", [&]() {
+              generateColumnBuffers();
+              generateColumnLoops(false);
+            });
+          }
+          stencilBodyCXXVisitor.setKCaches({});
+          stencilBodyCXXVisitor.setKColumns({});
+        } else {
+          const bool isParallel = multiStage.getLoopOrder() == iir::LoopOrderKind::Parallel;
+          for(auto interval : partitionIntervals) {
+
+            // for each interval, we generate naive nested loops
+            std::string kLoop =
+                makeKLoop((multiStage.getLoopOrder() == iir::LoopOrderKind::Backward), interval,
+                          isParallel && !fusedStencil);
+            if(isParallel && fusedStencil)
+              kLoop = "\n#pragma omp for\n" + kLoop;
+            stencilRunMethod.addBlockStatement(kLoop, [&]() {
               for(const auto& stagePtr : multiStage.getChildren()) {
                 iir::Stage& stage = *stagePtr;
 
@@ -315,68 +994,43 @@ void CXXOptCodeGen::generateStencilClasses(
                     stage.getExtents().horizontalExtent());
 
                 // Check if we need to execute this statement:
-                bool hasOverlappingInterval = false;
-                for(const auto& doMethodPtr : stage.getChildren()) {
-                  hasOverlappingInterval |= (doMethodPtr->getInterval().overlaps(interval));
-                }
-
-                if(hasOverlappingInterval) {
-                  auto doMethodGenerator = [&]() {
-                    // Generate Do-Method
-                    for(const auto& doMethodPtr : stage.getChildren()) {
-                      const iir::DoMethod& doMethod = *doMethodPtr;
-                      if(!doMethod.getInterval().overlaps(interval))
-                        continue;
-                      for(const auto& stmt : doMethod.getAST().getStatements()) {
-                        stmt->accept(stencilBodyCXXVisitor);
-                        stencilRunMethod << stencilBodyCXXVisitor.getCodeAndResetStream();
-                      }
-                    }
-                  };
-
-                  stencilRunMethod.addBlockStatement(
-                      makeIJLoop(extents.iMinus(), extents.iPlus(), "m_dom", "i"), [&]() {
-                        stencilRunMethod.addBlockStatement(
-                            makeIJLoop(extents.jMinus(), extents.jPlus(), "m_dom", "j", true),
-                            [&] {
-                              if(std::any_of(stage.getIterationSpace().cbegin(),
-                                             stage.getIterationSpace().cend(),
-                                             [](const auto& p) -> bool { return p.has_value(); })) {
-                                std::string conditional = "if(";
-                                if(stage.getIterationSpace()[0]) {
-                                  conditional += "checkOffset(stage" +
-                                                 std::to_string(stage.getStageID()) +
-                                                 "GlobalIIndices[0], stage" +
-                                                 std::to_string(stage.getStageID()) +
-                                                 "GlobalIIndices[1], globalOffsets[0] + i)";
-                                }
-                                if(stage.getIterationSpace()[1]) {
-                                  if(stage.getIterationSpace()[0]) {
-                                    conditional += " && ";
-                                  }
-                                  conditional += "checkOffset(stage" +
-                                                 std::to_string(stage.getStageID()) +
-                                                 "GlobalJIndices[0], stage" +
-                                                 std::to_string(stage.getStageID()) +
-                                                 "GlobalJIndices[1], globalOffsets[1] + j)";
-                                }
-                                conditional += ")";
-                                stencilRunMethod.addBlockStatement(conditional, doMethodGenerator);
-                              } else {
-                                doMethodGenerator();
-                              }
-                            });
-                      });
+                if(hasOverlappingInterval(stage, interval)) {
+                  // the innermost loop is vectorized, with `Vectorize` it runs over the
+                  // unit-stride dimension i
+                  std::string outerLoop =
+                      makeIJLoop(extents.iMinus(), extents.iPlus(), "m_dom", "i");
+                  std::string innerLoop =
+                      makeIJLoop(extents.jMinus(), extents.jPlus(), "m_dom", "j", true);
+                  if(vectorize_) {
+                    outerLoop = makeIJLoop(extents.jMinus(), extents.jPlus(), "m_dom", "j");
+                    innerLoop = makeIJLoop(extents.iMinus(), extents.iPlus(), "m_dom", "i", true);
+                  }
+                  // the levels are walked one after the other by all the threads of the tile
+                  // loop, which share the points of each level
+                  if(!isParallel && fusedStencil)
+                    outerLoop = "\n#pragma omp for\n" + outerLoop;
+                  stencilRunMethod.addBlockStatement(outerLoop, [&]() {
+                    stencilRunMethod.addBlockStatement(
+                        innerLoop, [&] { generateStageBody(stage, interval); });
+                  });
                 }
               }
             });
+          }
+        }
+        stencilRunMethod.ss() << "}";
       }
-      stencilRunMethod.ss() << "}";
-    }
-    for(const auto& fieldPair : nonTempFields) {
-      stencilRunMethod.addStatement(fieldPair.second.Name + "_" + ".sync()");
-    }
-    stencilRunMethod.commit();
+      if(!fusedStencil) {
+        for(const auto& fieldPair : nonTempFields) {
+          stencilRunMethod.addStatement(fieldPair.second.Name + "_" + ".sync()");
+        }
+      }
+      stencilRunMethod.commit();
+    };
+
+    generateRunMethod(nullptr);
+    if(const FusedStencil* fusedStencil = findFusedStencil(stencil.getStencilID()))
+      generateRunMethod(fusedStencil);
   }
 }
 
@@ -394,19 +1048,20 @@ std::unique_ptr<TranslationUnit> CXXOptCodeGen::generateCode() {
 
   std::string globals = generateGlobals(context_, "dawn_generated", "cxxopt");
 
-  std::vector<std::string> ppDefines;
+  std::vector<std::string> preamble;
   auto makeDefine = [](std::string define, int value) {
     return "#define " + define + " " + std::to_string(value);
   };
 
-  ppDefines.push_back(makeDefine("DAWN_GENERATED", 1));
-  ppDefines.push_back("#undef DAWN_BACKEND_T");
-  ppDefines.push_back("#define DAWN_BACKEND_T CXXOPT");
+  preamble.push_back(makeDefine("DAWN_GENERATED", 1));
+  preamble.push_back("#undef DAWN_BACKEND_T");
+  preamble.push_back("#define DAWN_BACKEND_T CXXOPT");
+
+  CodeGen::addGridToolsRuntimeIncludes(preamble, 30);
+  preamble.push_back("#include <omp.h>");
 
-  CodeGen::addMplIfdefs(ppDefines, 30);
-  ppDefines.push_back("#include <driver-includes/gridtools_includes.hpp>");
-  ppDefines.push_back("using namespace gridtools::dawn;");
-  ppDefines.push_back("#include <omp.h>");
+  std::vector<std::string> ppDefines;
+  CodeGen::addPreamble(ppDefines, preamble);
   DAWN_LOG(INFO) << "Done generating code";
 
   std::string filename = generateFileName(context_);
@@ -14,12 +14,15 @@
 
 #pragma once
 
+#include "dawn/AST/ASTFwd.h"
 #include "dawn/CodeGen/CodeGen.h"
 #include "dawn/CodeGen/CodeGenProperties.h"
 #include "dawn/CodeGen/Options.h"
 #include "dawn/CodeGen/CXXNaive/CXXNaiveCodeGen.h"
+#include "dawn/IIR/Extents.h"
 #include "dawn/IIR/Interval.h"
 #include "dawn/Support/IndexRange.h"
+#include <map>
 #include <set>
 #include <unordered_map>
 #include <unordered_set>
@@ -45,17 +48,45 @@ run(const std::map<std::string, std::shared_ptr<iir::StencilInstantiation>>&
 class CXXOptCodeGen : public CXXNaiveCodeGen {
 public:
   ///@brief constructor
-  CXXOptCodeGen(const StencilInstantiationContext& ctx, int maxHaloPoint);
+  CXXOptCodeGen(const StencilInstantiationContext& ctx, int maxHaloPoint,
+                bool slimRuntime = false, const std::string& precompiledHeader = "",
+                bool tmpMemoryPlanning = false, bool reduceTmpDimensions = false,
+                bool rawPointerAccess = false, int fusedStencilTileSize = 0,
+                bool vectorize = false, const Array3i& domainSize = {0, 0, 0});
   virtual ~CXXOptCodeGen();
   virtual std::unique_ptr<TranslationUnit> generateCode() override;
 
 private:
+  /// @brief Stencil run tile by tile together with the stencils following it
+  struct FusedStencil {
+    int StencilID;
+    /// Points computed around each tile for the later stencils of the group reading its outputs
+    iir::Extents Halo;
+  };
+
+  /// @brief Groups of consecutive stencil calls of the control flow which are run tile by tile
+  /// (see `FusedStencilTileSize`), keyed by the first call
+  using FusedStencilGroups = std::map<const ast::Stmt*, std::vector<FusedStencil>>;
+
+  FusedStencilGroups
+  makeFusedStencilGroups(const iir::StencilInstantiation& stencilInstantiation) const;
+
   std::string generateStencilInstantiation(
       const std::shared_ptr<iir::StencilInstantiation> stencilInstantiation);
 
   void generateStencilClasses(const std::shared_ptr<iir::StencilInstantiation> stencilInstantiation,
                               Class& stencilWrapperClass,
-                              const CodeGenProperties& codeGenProperties) const;
+                              const CodeGenProperties& codeGenProperties,
+                              const FusedStencilGroups& fusedStencilGroups) const;
+
+  void
+  generateStencilWrapperRun(Class& stencilWrapperClass,
+                            const std::shared_ptr<iir::StencilInstantiation> stencilInstantiation,
+                            const CodeGenProperties& codeGenProperties,
+                            const FusedStencilGroups& fusedStencilGroups) const;
+
+  int fusedStencilTileSize_;
+  bool vectorize_;
 };
 } // namespace cxxopt
 } // namespace codegen
@@ -15,7 +15,15 @@
 #include "dawn/CodeGen/CodeGen.h"
 #include "dawn/CodeGen/StencilFunctionAsBCGenerator.h"
 #include "dawn/IIR/Extents.h"
+#include "dawn/Support/Logger.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
 #include <optional>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <tuple>
 
 namespace dawn {
 namespace codegen {
@@ -334,51 +342,236 @@ void CodeGen::addTempStorageTypedef(Structure& stencilClass, iir::Stencil const&
       .addType("storage_traits_t::data_store_t< ::dawn::float_type, " + tmpMetadataTypename_ + ">");
 }
 
-void CodeGen::addTmpStorageDeclaration(
-    Structure& stencilClass,
+std::map<int, std::string> CodeGen::planTmpStorages(
+    const iir::Stencil& stencil,
     IndexRange<const std::map<int, iir::Stencil::FieldInfo>>& tempFields) const {
-  if(!(tempFields.empty())) {
+  std::map<int, std::string> tmpStorages;
+  if(!codeGenOptions.TmpMemoryPlanning) {
+    for(const auto& field : tempFields)
+      tmpStorages.emplace(field.first, "m_" + field.second.Name);
+    return tmpStorages;
+  }
+
+  // (first multistage, AccessID, last multistage) of the temporaries, ordered by first use
+  std::vector<std::tuple<int, int, int>> lifetimes;
+  std::map<int, std::string> names;
+  for(const auto& field : tempFields) {
+    iir::Stencil::Lifetime lifetime = stencil.getLifetime(field.first);
+    lifetimes.emplace_back(lifetime.Begin.StagePos.MultiStageIndex, field.first,
+                           lifetime.End.StagePos.MultiStageIndex);
+    names.emplace(field.first, field.second.Name);
+  }
+  std::sort(lifetimes.begin(), lifetimes.end());
+
+  // Greedy coloring of the interval graph, which needs as many storages as there are temporaries
+  // alive at the same time
+  struct Storage {
+    std::string Name;
+    int LastMultiStage;
+  };
+  std::vector<Storage> storages;
+  for(const auto& [firstMultiStage, accessID, lastMultiStage] : lifetimes) {
+    auto storageIt = std::find_if(storages.begin(), storages.end(), [&](const Storage& storage) {
+      return storage.LastMultiStage < firstMultiStage;
+    });
+    if(storageIt == storages.end()) {
+      storages.push_back(Storage{"m_" + names.at(accessID), lastMultiStage});
+      storageIt = std::prev(storages.end());
+    } else {
+      storageIt->LastMultiStage = lastMultiStage;
+    }
+    tmpStorages.emplace(accessID, storageIt->Name);
+  }
+
+  // Peak number of temporaries alive in the same multistage, i.e. of storages which are live at
+  // the same time. Without planning every temporary keeps its own storage for the whole run
+  std::vector<int> aliveTemporaries(stencil.getChildren().size(), 0);
+  for(const auto& [firstMultiStage, accessID, lastMultiStage] : lifetimes)
+    for(int multiStageIdx = firstMultiStage; multiStageIdx <= lastMultiStage; ++multiStageIdx)
+      ++aliveTemporaries[multiStageIdx];
+  const int peakAlive =
+      aliveTemporaries.empty() ? 0
+                               : *std::max_element(aliveTemporaries.begin(), aliveTemporaries.end());
+  // greedy coloring is optimal for interval graphs
+  DAWN_ASSERT(storages.size() == static_cast<std::size_t>(peakAlive));
+
+  DAWN_LOG(INFO) << "Stencil " << stencil.getStencilID() << ": at most " << peakAlive
+                 << " temporaries alive in a multistage, temporary storages reduced from "
+                 << tmpStorages.size() << " to " << storages.size();
+
+  return tmpStorages;
+}
+
+void CodeGen::addTmpStorageDeclaration(Structure& stencilClass,
+                                       const std::map<int, std::string>& tmpStorages) const {
+  if(!(tmpStorages.empty())) {
     stencilClass.addMember(tmpMetadataTypename_, tmpMetadataName_);
 
-    for(const auto& field : tempFields) {
-      stencilClass.addMember(tmpStorageTypename_, "m_" + field.second.Name);
+    std::set<std::string> declared;
+    for(const auto& tmpStorage : tmpStorages) {
+      if(declared.insert(tmpStorage.second).second)
+        stencilClass.addMember(tmpStorageTypename_, tmpStorage.second);
     }
   }
 }
 
-void CodeGen::addTmpStorageInit(
-    MemberFunction& ctr, iir::Stencil const& stencil,
-    IndexRange<const std::map<int, iir::Stencil::FieldInfo>>& tempFields) const {
-  if(!(tempFields.empty())) {
-    iir::Extents maxExtents{ast::cartesian};
-    for(const auto& multiStage : stencil.getChildren())
-      for(const auto& stage : multiStage->getChildren())
-        maxExtents.merge(stage->getExtents());
-
-    int iMax, jMax;
-    try {
-      iir::CartesianExtent hMaxExtents =
-          iir::extent_cast<iir::CartesianExtent const&>(maxExtents.horizontalExtent());
-      iMax = hMaxExtents.iPlus();
-      jMax = hMaxExtents.jPlus();
-    } catch(const std::bad_cast& error) {
-      iMax = jMax = 0;
+namespace {
+std::string getDimName(int dim) { return std::string(1, "ijk"[dim]); }
+
+/// @brief Halo of `gridtools::dawn::domain` along `dim` if none is set
+std::string getDefaultDomainHalo(int dim) { return dim == 2 ? "0" : c_dgt + "halo::value"; }
+} // namespace
+
+std::string CodeGen::getDomainSize(int dim, const std::string& dom) const {
+  const int size = codeGenOptions.DomainSize[dim];
+  return size > 0 ? std::to_string(size) : dom + "." + getDimName(dim) + "size()";
+}
+
+std::string CodeGen::getDomainBound(int dim, iir::Interval::Bound bound,
+                                    const std::string& dom) const {
+  const std::string d = getDimName(dim);
+  const int size = codeGenOptions.DomainSize[dim];
+  if(bound == iir::Interval::Bound::lower)
+    return size > 0 ? getDefaultDomainHalo(dim) : dom + "." + d + "minus()";
+  if(size > 0)
+    return dim == 2 ? std::to_string(size - 1)
+                    : std::to_string(size) + " - " + getDefaultDomainHalo(dim) + " - 1";
+  return dom + "." + d + "size() - " + dom + "." + d + "plus() - 1";
+}
+
+void CodeGen::addDomainBounds(MemberFunction& function, int dim, const std::string& dom) const {
+  const std::string d = getDimName(dim);
+  const std::string type = codeGenOptions.DomainSize[dim] > 0 ? "constexpr int " : "int ";
+  function.addStatement(type + d + "Min = " +
+                        getDomainBound(dim, iir::Interval::Bound::lower, dom));
+  function.addStatement(type + d + "Max = " +
+                        getDomainBound(dim, iir::Interval::Bound::upper, dom));
+}
+
+void CodeGen::addDomainSizeAssertions(MemberFunction& function, const std::string& dom) const {
+  for(int dim = 0; dim < 3; ++dim) {
+    if(codeGenOptions.DomainSize[dim] <= 0)
+      continue;
+    const std::string d = getDimName(dim);
+    const std::string halo = getDefaultDomainHalo(dim);
+    function.addStatement("assert(" + dom + "." + d + "size() == " + getDomainSize(dim, dom) +
+                          " && " + dom + "." + d + "minus() == " + halo + " && " + dom + "." + d +
+                          "plus() == " + halo + ")");
+  }
+}
+
+std::string CodeGen::makeTmpMetadataInit(const std::string& metadataName,
+                                         const iir::Stencil& stencil,
+                                         const std::string& kSize) const {
+  iir::Extents maxExtents{ast::cartesian};
+  for(const auto& multiStage : stencil.getChildren())
+    for(const auto& stage : multiStage->getChildren())
+      maxExtents.merge(stage->getExtents());
+
+  int iMax, jMax;
+  try {
+    iir::CartesianExtent hMaxExtents =
+        iir::extent_cast<iir::CartesianExtent const&>(maxExtents.horizontalExtent());
+    iMax = hMaxExtents.iPlus();
+    jMax = hMaxExtents.jPlus();
+  } catch(const std::bad_cast& error) {
+    iMax = jMax = 0;
+  }
+
+  std::string tmpMetadataInit = metadataName + "(" + getDomainSize(0, "dom_");
+  if(iMax > 0)
+    tmpMetadataInit += " + " + std::to_string(iMax);
+  tmpMetadataInit += ", " + getDomainSize(1, "dom_");
+  if(jMax > 0)
+    tmpMetadataInit += " + " + std::to_string(jMax);
+  tmpMetadataInit += ", " + kSize + ")";
+  return tmpMetadataInit;
+}
+
+void CodeGen::addTmpStorageInit(MemberFunction& ctr, iir::Stencil const& stencil,
+                                const std::map<int, std::string>& tmpStorages) const {
+  if(!(tmpStorages.empty())) {
+    ctr.addInit(makeTmpMetadataInit(tmpMetadataName_, stencil,
+                                    getDomainSize(2, "dom_") + " + 2*" +
+                                        std::to_string(getVerticalTmpHaloSize(stencil))));
+    std::set<std::string> initialized;
+    for(const auto& tmpStorage : tmpStorages) {
+      if(initialized.insert(tmpStorage.second).second)
+        ctr.addInit(tmpStorage.second + "(" + tmpMetadataName_ + ")");
     }
+  }
+}
 
-    std::string tmpMetadataInit = tmpMetadataName_ + "(dom_.isize()";
-    if(iMax > 0)
-      tmpMetadataInit += " + " + std::to_string(iMax);
-    tmpMetadataInit += ", dom_.jsize()";
-    if(jMax > 0)
-      tmpMetadataInit += " + " + std::to_string(jMax);
-    tmpMetadataInit +=
-        ", dom_.ksize() + 2*" + std::to_string(getVerticalTmpHaloSize(stencil)) + ")";
-
-    ctr.addInit(tmpMetadataInit);
-    for(const auto& field : tempFields) {
-      ctr.addInit("m_" + field.second.Name + "(" + tmpMetadataName_ + ")");
+std::map<int, std::pair<const iir::MultiStage*, iir::Extents>>
+CodeGen::getMultiStageLocalTemporaries(const iir::Stencil& stencil) const {
+  std::map<int, std::pair<const iir::MultiStage*, iir::Extents>> localTemporaries;
+  // Accesses inside stencil functions are not visible in the extents of the caller
+  if(!codeGenOptions.ReduceTmpDimensions ||
+     !stencil.getMetadata().getStencilFunctionInstantiations().empty())
+    return localTemporaries;
+
+  std::set<int> sharedTemporaries;
+  for(const auto& multiStage : stencil.getChildren()) {
+    for(const auto& [accessID, field] : multiStage->getFields()) {
+      if(!stencil.getMetadata().isAccessType(iir::FieldAccessType::StencilTemporary, accessID) ||
+         sharedTemporaries.count(accessID))
+        continue;
+      if(!localTemporaries.emplace(accessID, std::make_pair(multiStage.get(), field.getExtents()))
+              .second) {
+        localTemporaries.erase(accessID);
+        sharedTemporaries.insert(accessID);
+      }
     }
   }
+  return localTemporaries;
+}
+
+std::set<int> CodeGen::getIJPlaneTemporaries(
+    const iir::Stencil& stencil,
+    const std::function<bool(const iir::MultiStage&)>& hasSequentialKLoop) const {
+  std::set<int> tmpPlanes;
+  for(const auto& [accessID, local] : getMultiStageLocalTemporaries(stencil)) {
+    const auto& [multiStage, extents] = local;
+    if(extents.isVerticalPointwise() && hasSequentialKLoop(*multiStage))
+      tmpPlanes.insert(accessID);
+  }
+
+  if(!tmpPlanes.empty())
+    DAWN_LOG(INFO) << "Stencil " << stencil.getStencilID() << ": " << tmpPlanes.size()
+                   << " temporaries demoted to ij-planes";
+  return tmpPlanes;
+}
+
+void CodeGen::addTmpPlaneStorageTypedef(Structure& stencilClass) const {
+  stencilClass.addTypeDef("tmp_plane_halo_t")
+      .addType("gridtools::halo< GRIDTOOLS_DAWN_HALO_EXTENT, GRIDTOOLS_DAWN_HALO_EXTENT, 0>");
+
+  stencilClass.addTypeDef(tmpPlaneMetadataTypename_)
+      .addType("storage_traits_t::storage_info_t< 1, 3, tmp_plane_halo_t >");
+
+  stencilClass.addTypeDef(tmpPlaneStorageTypename_)
+      .addType("storage_traits_t::data_store_t< ::dawn::float_type, " +
+               tmpPlaneMetadataTypename_ + ">");
+}
+
+void CodeGen::addTmpPlaneStorageDeclaration(Structure& stencilClass, const iir::Stencil& stencil,
+                                            const std::set<int>& tmpPlanes) const {
+  if(!(tmpPlanes.empty())) {
+    stencilClass.addMember(tmpPlaneMetadataTypename_, tmpPlaneMetadataName_);
+    for(int accessID : tmpPlanes)
+      stencilClass.addMember(tmpPlaneStorageTypename_,
+                             "m_" + stencil.getMetadata().getFieldNameFromAccessID(accessID));
+  }
+}
+
+void CodeGen::addTmpPlaneStorageInit(MemberFunction& ctr, const iir::Stencil& stencil,
+                                     const std::set<int>& tmpPlanes) const {
+  if(!(tmpPlanes.empty())) {
+    ctr.addInit(makeTmpMetadataInit(tmpPlaneMetadataName_, stencil, "1"));
+    for(int accessID : tmpPlanes)
+      ctr.addInit("m_" + stencil.getMetadata().getFieldNameFromAccessID(accessID) + "(" +
+                  tmpPlaneMetadataName_ + ")");
+  }
 }
 
 void CodeGen::addTmpStorageInitStencilWrapperCtr(
@@ -417,6 +610,51 @@ void CodeGen::addMplIfdefs(std::vector<std::string>& ppDefines, int mplContainer
       makeIfNotDefinedString("BOOST_MPL_LIMIT_VECTOR_SIZE", "GT_VECTOR_LIMIT_SIZE"));
 }
 
+void CodeGen::addGridToolsRuntimeIncludes(std::vector<std::string>& preamble,
+                                          int mplContainerMaxSize) const {
+  if(codeGenOptions.SlimRuntime) {
+    // The boost/mpl limits only matter for the stencil composition, which is not included
+    preamble.push_back("#define GRIDTOOLS_DAWN_SLIM_RUNTIME 1");
+    preamble.push_back("#ifndef GRIDTOOLS_DAWN_HALO_EXTENT\n #define GRIDTOOLS_DAWN_HALO_EXTENT " +
+                       std::to_string(codeGenOptions.MaxHaloPoints) + "\n#endif");
+  } else {
+    addMplIfdefs(preamble, mplContainerMaxSize);
+  }
+  preamble.push_back("#include <driver-includes/gridtools_includes.hpp>");
+  preamble.push_back("using namespace gridtools::dawn;");
+}
+
+void CodeGen::addPreamble(std::vector<std::string>& ppDefines,
+                          const std::vector<std::string>& preamble) const {
+  const std::string& headerPath = codeGenOptions.PrecompiledHeader;
+  if(headerPath.empty()) {
+    ppDefines.insert(ppDefines.end(), preamble.begin(), preamble.end());
+    return;
+  }
+
+  std::string content = "#pragma once\n";
+  for(const auto& line : preamble)
+    content += line + "\n";
+
+  // Rewriting the header (even with the same content) would invalidate the precompiled header
+  std::ifstream existingFile(headerPath);
+  std::stringstream existingContent;
+  if(existingFile)
+    existingContent << existingFile.rdbuf();
+  if(!existingFile || existingContent.str() != content) {
+    if(existingFile)
+      DAWN_LOG(WARNING) << "Overwriting precompiled header " << headerPath
+                        << ": the preamble differs (different backend or options?)";
+    std::ofstream headerFile(headerPath);
+    if(!headerFile)
+      throw std::runtime_error("Error writing to " + headerPath + ": " + strerror(errno));
+    headerFile << content;
+  }
+
+  // Has to be the first line of the file for the precompiled header to be picked up
+  ppDefines.insert(ppDefines.begin(), "#include \"" + headerPath + "\"");
+}
+
 std::string CodeGen::generateFileName(const StencilInstantiationContext& context) const {
   if(context.size() > 0) {
     return context_.begin()->second->getMetaData().getFileName();
@@ -464,9 +702,11 @@ void CodeGen::generateGlobalIndices(const iir::Stencil& stencil, Structure& sten
   globalOffsetFunc.startBody();
   globalOffsetFunc.addStatement("unsigned int rankOnDefaultFace = rank % (xcols * ycols)");
   globalOffsetFunc.addStatement("unsigned int row = rankOnDefaultFace / xcols");
-  globalOffsetFunc.addStatement("unsigned int col = rankOnDefaultFace % ycols");
-  globalOffsetFunc.addStatement(
-      "return {col * (dom.isize() - dom.iplus()), row * (dom.jsize() - dom.jplus())}");
+  globalOffsetFunc.addStatement("unsigned int col = rankOnDefaultFace % xcols");
+  // all ranks have the same compute domain, surrounded by the default halos
+  globalOffsetFunc.addStatement("return {col * (dom.isize() - 2 * " + c_dgt +
+                                "halo::value), row * (dom.jsize() - 2 * " + c_dgt +
+                                "halo::value)}");
   globalOffsetFunc.commit();
 
   if(genCheckOffset) {
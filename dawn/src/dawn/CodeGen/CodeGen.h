@@ -20,8 +20,12 @@
 #include "dawn/CodeGen/Options.h"
 #include "dawn/CodeGen/TranslationUnit.h"
 #include "dawn/IIR/StencilInstantiation.h"
+#include "dawn/Support/Array.h"
 #include "dawn/Support/IndexRange.h"
+#include <functional>
 #include <memory>
+#include <set>
+#include <string>
 
 namespace dawn {
 namespace codegen {
@@ -36,18 +40,71 @@ protected:
   const StencilInstantiationContext& context_;
   struct codeGenOption {
     int MaxHaloPoints;
+    bool SlimRuntime = false;
+    std::string PrecompiledHeader = "";
+    bool TmpMemoryPlanning = false;
+    bool ReduceTmpDimensions = false;
+    bool RawPointerAccess = false;
+    Array3i DomainSize = {0, 0, 0};
   } codeGenOptions;
 
+  /// @brief Size of the domain `dom` along dimension `dim` (0, 1 or 2)
+  ///
+  /// With `DomainSize` the size of the domain is known at compile time and the sizes and bounds
+  /// are constant expressions. The bounds then assume the default halos of the domain, which
+  /// `addDomainSizeAssertions` checks at runtime.
+  std::string getDomainSize(int dim, const std::string& dom) const;
+  /// @brief Bound `bound` (first or last point) of the compute domain `dom` along dimension `dim`
+  std::string getDomainBound(int dim, iir::Interval::Bound bound, const std::string& dom) const;
+  /// @brief Declare the bounds `<dim>Min` and `<dim>Max` of the compute domain `dom` along `dim`,
+  /// `constexpr` if the size of the domain is known (see `DomainSize`)
+  void addDomainBounds(MemberFunction& function, int dim, const std::string& dom) const;
+  /// @brief Assert that the runtime domain `dom` is the one the code is specialized for
+  void addDomainSizeAssertions(MemberFunction& function, const std::string& dom) const;
+
   static size_t getVerticalTmpHaloSize(iir::Stencil const& stencil);
   size_t getVerticalTmpHaloSizeForMultipleStencils(
       const std::vector<std::unique_ptr<iir::Stencil>>& stencils) const;
   virtual void addTempStorageTypedef(Structure& stencilClass, iir::Stencil const& stencil) const;
-  void addTmpStorageDeclaration(
-      Structure& stencilClass,
-      IndexRange<const std::map<int, iir::Stencil::FieldInfo>>& tmpFields) const;
-  virtual void
-  addTmpStorageInit(MemberFunction& ctr, const iir::Stencil& stencil,
-                    IndexRange<const std::map<int, iir::Stencil::FieldInfo>>& tempFields) const;
+
+  /// @brief Assign a storage to every temporary of `stencil`, returns the name of the storage
+  /// member for each temporary (by AccessID)
+  ///
+  /// With `TmpMemoryPlanning` temporaries which are not alive in a common multistage share their
+  /// storage. Lifetimes are rounded to whole multistages as the stages of a multistage are
+  /// interleaved over the vertical levels.
+  std::map<int, std::string>
+  planTmpStorages(const iir::Stencil& stencil,
+                  IndexRange<const std::map<int, iir::Stencil::FieldInfo>>& tempFields) const;
+  void addTmpStorageDeclaration(Structure& stencilClass,
+                                const std::map<int, std::string>& tmpStorages) const;
+  virtual void addTmpStorageInit(MemberFunction& ctr, const iir::Stencil& stencil,
+                                 const std::map<int, std::string>& tmpStorages) const;
+
+  /// @brief Temporaries of `stencil` which are only accessed at the current vertical level, inside
+  /// a single multistage (by AccessID)
+  ///
+  /// With `ReduceTmpDimensions` those temporaries are demoted to an ij-plane which is reused by all
+  /// the vertical levels. This is only valid if the vertical loop of their multistage is
+  /// sequential and encloses the stages in the generated code, which is what
+  /// `hasSequentialKLoop` tells.
+  std::set<int> getIJPlaneTemporaries(
+      const iir::Stencil& stencil,
+      const std::function<bool(const iir::MultiStage&)>& hasSequentialKLoop) const;
+  /// @brief Temporaries of `stencil` which are only accessed inside a single multistage, mapped to
+  /// their extents in that multistage (by AccessID, empty without `ReduceTmpDimensions`)
+  std::map<int, std::pair<const iir::MultiStage*, iir::Extents>>
+  getMultiStageLocalTemporaries(const iir::Stencil& stencil) const;
+  void addTmpPlaneStorageTypedef(Structure& stencilClass) const;
+  void addTmpPlaneStorageDeclaration(Structure& stencilClass, const iir::Stencil& stencil,
+                                     const std::set<int>& tmpPlanes) const;
+  void addTmpPlaneStorageInit(MemberFunction& ctr, const iir::Stencil& stencil,
+                              const std::set<int>& tmpPlanes) const;
+  /// @brief Initializer of the temporary metadata `metadataName`, the horizontal sizes cover the
+  /// extents of all the stages of `stencil`
+  std::string makeTmpMetadataInit(const std::string& metadataName, const iir::Stencil& stencil,
+                                  const std::string& kSize) const;
+
   void
   addTmpStorageInitStencilWrapperCtr(MemberFunction& ctr,
                                      const std::vector<std::unique_ptr<iir::Stencil>>& stencils,
@@ -57,6 +114,21 @@ protected:
 
   void addMplIfdefs(std::vector<std::string>& ppDefines, int mplContainerMaxSize) const;
 
+  /// @brief Add the defines and includes of the gridtools storage runtime to `preamble`
+  ///
+  /// With `SlimRuntime` only the storage and view parts of gridtools are included (sufficient for
+  /// the C++ backends, which do not use the stencil composition).
+  void addGridToolsRuntimeIncludes(std::vector<std::string>& preamble,
+                                   int mplContainerMaxSize) const;
+
+  /// @brief Add the stencil independent `preamble` (backend defines and runtime includes) to
+  /// `ppDefines`
+  ///
+  /// With `PrecompiledHeader` the preamble is written to that header, which is included as the
+  /// first line instead, such that it can be precompiled once and shared by all stencils.
+  void addPreamble(std::vector<std::string>& ppDefines,
+                   const std::vector<std::string>& preamble) const;
+
   bool
   hasGlobalIndices(const std::shared_ptr<iir::StencilInstantiation>& stencilInstantiation) const;
   bool hasGlobalIndices(const iir::Stencil& stencil) const;
@@ -73,6 +145,9 @@ protected:
   const std::string tmpMetadataTypename_ = "tmp_meta_data_t";
   const std::string tmpMetadataName_ = "m_tmp_meta_data";
   const std::string tmpStorageName_ = "m_tmp_storage";
+  const std::string tmpPlaneStorageTypename_ = "tmp_plane_storage_t";
+  const std::string tmpPlaneMetadataTypename_ = "tmp_plane_meta_data_t";
+  const std::string tmpPlaneMetadataName_ = "m_tmp_plane_meta_data";
   const std::string bigWrapperMetadata_ = "m_meta_data";
 
 public:
@@ -75,7 +75,7 @@ void CudaCodeGen::generateAllCudaKernels(
     DAWN_ASSERT(cachePropertyMap_.count(ms->getID()));
 
     MSCodeGen msCodeGen(ssSW, ms, stencilInstantiation, cachePropertyMap_.at(ms->getID()),
-                        codeGenOptions_, hasGlobalIndices(stencilInstantiation));
+                        codeGenOptions_, globalNames_, hasGlobalIndices(stencilInstantiation));
     msCodeGen.generateCudaKernelCode();
   }
 }
@@ -260,7 +260,7 @@ void CudaCodeGen::generateStencilClassMembers(
 
   if(!tempFields.empty()) {
     stencilClass.addComment("temporary storage declarations");
-    addTmpStorageDeclaration(stencilClass, tempFields);
+    addTmpStorageDeclaration(stencilClass, planTmpStorages(stencil, tempFields));
   }
 }
 
@@ -311,7 +311,7 @@ void CudaCodeGen::generateStencilClassCtr(
     stencilClassCtr.addInit("globalOffsets({computeGlobalOffsets(rank, m_dom, xcols, ycols)})");
   }
 
-  addTmpStorageInit(stencilClassCtr, stencil, tempFields);
+  addTmpStorageInit(stencilClassCtr, stencil, planTmpStorages(stencil, tempFields));
   stencilClassCtr.commit();
 }
 
@@ -669,14 +669,13 @@ void CudaCodeGen::addTempStorageTypedef(Structure& stencilClass,
       .addType("storage_traits_t::data_store_t< ::dawn::float_type, " + tmpMetadataTypename_ + ">");
 }
 
-void CudaCodeGen::addTmpStorageInit(
-    MemberFunction& ctr, iir::Stencil const& stencil,
-    IndexRange<const std::map<int, iir::Stencil::FieldInfo>>& tempFields) const {
+void CudaCodeGen::addTmpStorageInit(MemberFunction& ctr, iir::Stencil const& stencil,
+                                    const std::map<int, std::string>& tmpStorages) const {
   auto maxExtents = CodeGeneratorHelper::computeTempMaxWriteExtent(stencil);
 
   const auto blockSize = stencil.getParent()->getBlockSize();
 
-  if(!(tempFields.empty())) {
+  if(!(tmpStorages.empty())) {
     auto const& hMaxExtents =
         iir::extent_cast<iir::CartesianExtent const&>(maxExtents.horizontalExtent());
     ctr.addInit(tmpMetadataName_ + "(" + std::to_string(blockSize[0]) + "+" +
@@ -687,8 +686,8 @@ void CudaCodeGen::addTmpStorageInit(
                 ", (dom_.jsize()+ " + std::to_string(blockSize[1]) + " - 1) / " +
                 std::to_string(blockSize[1]) + ", dom_.ksize() + 2 * " +
                 std::to_string(getVerticalTmpHaloSize(stencil)) + ")");
-    for(const auto& fieldPair : tempFields) {
-      ctr.addInit("m_" + fieldPair.second.Name + "(" + tmpMetadataName_ + ")");
+    for(const auto& tmpStorage : tmpStorages) {
+      ctr.addInit(tmpStorage.second + "(" + tmpMetadataName_ + ")");
     }
   }
 }
@@ -21,6 +21,7 @@
 #include "dawn/Support/Array.h"
 #include "dawn/Support/IndexRange.h"
 #include <unordered_map>
+#include <unordered_set>
 
 namespace dawn {
 namespace iir {
@@ -40,6 +41,8 @@ run(const std::map<std::string, std::shared_ptr<iir::StencilInstantiation>>&
 /// @ingroup cxxnaive cartesian
 class CudaCodeGen : public CodeGen {
   std::unordered_map<int, CacheProperties> cachePropertyMap_;
+  /// Globals already declared in the translation unit by the kernels
+  std::unordered_set<std::string> globalNames_;
 
 public:
   ///@brief constructor
@@ -62,9 +65,8 @@ private:
 
   void addTempStorageTypedef(Structure& stencilClass, iir::Stencil const& stencil) const override;
 
-  void addTmpStorageInit(
-      MemberFunction& ctr, iir::Stencil const& stencil,
-      IndexRange<const std::map<int, iir::Stencil::FieldInfo>>& tempFields) const override;
+  void addTmpStorageInit(MemberFunction& ctr, iir::Stencil const& stencil,
+                         const std::map<int, std::string>& tmpStorages) const override;
 
   void addCudaCopySymbol(MemberFunction& runMethod, const std::string& arrName,
                          const std::string dataType) const;
@@ -28,12 +28,11 @@ namespace dawn {
 namespace codegen {
 namespace cuda {
 
-std::unordered_set<std::string> MSCodeGen::globalNames_;
-
 MSCodeGen::MSCodeGen(std::stringstream& ss, const std::unique_ptr<iir::MultiStage>& ms,
                      const std::shared_ptr<iir::StencilInstantiation>& stencilInstantiation,
                      const CacheProperties& cacheProperties,
-                     CudaCodeGen::CudaCodeGenOptions options, bool iterationSpaceSet)
+                     CudaCodeGen::CudaCodeGenOptions options,
+                     std::unordered_set<std::string>& globalNames, bool iterationSpaceSet)
     : ss_(ss), ms_(ms), stencilInstantiation_(stencilInstantiation),
       metadata_(stencilInstantiation->getMetaData()), cacheProperties_(cacheProperties),
       useCodeGenTemporaries_(CodeGeneratorHelper::useTemporaries(
@@ -42,7 +41,7 @@ MSCodeGen::MSCodeGen(std::stringstream& ss, const std::unique_ptr<iir::MultiStag
       cudaKernelName_(CodeGeneratorHelper::buildCudaKernelName(stencilInstantiation_, ms_)),
       blockSize_(stencilInstantiation_->getIIR()->getBlockSize()),
       solveKLoopInParallel_(CodeGeneratorHelper::solveKLoopInParallel(ms_)), options_(options),
-      iterationSpaceSet_(iterationSpaceSet) {}
+      iterationSpaceSet_(iterationSpaceSet), globalNames_(globalNames) {}
 
 void MSCodeGen::generateIJCacheDecl(MemberFunction& kernel) const {
   for(const auto& cacheP : ms_->getCaches()) {
@@ -58,20 +58,20 @@ private:
   const bool solveKLoopInParallel_;
   CudaCodeGen::CudaCodeGenOptions options_;
   bool iterationSpaceSet_;
-  static std::unordered_set<std::string> globalNames_;
+  std::unordered_set<std::string>& globalNames_;
 
 public:
   MSCodeGen(std::stringstream& ss, const std::unique_ptr<iir::MultiStage>& ms,
             const std::shared_ptr<iir::StencilInstantiation>& stencilInstantiation,
             const CacheProperties& cacheProperties, CudaCodeGen::CudaCodeGenOptions options,
-            bool iterationSpaceSet = false);
+            std::unordered_set<std::string>& globalNames, bool iterationSpaceSet = false);
 
   void generateCudaKernelCode();
 
 private:
   std::vector<std::string> generateStrideArguments(
-      const IndexRange<const std::unordered_map<int, iir::Field>>& nonTempFields,
-      const IndexRange<const std::unordered_map<int, iir::Field>>& tempFields,
+      const IndexRange<const iir::FieldMap>& nonTempFields,
+      const IndexRange<const iir::FieldMap>& tempFields,
       CodeGeneratorHelper::FunctionArgType funArg) const;
 
   /// @brief generate all IJ cache declarations
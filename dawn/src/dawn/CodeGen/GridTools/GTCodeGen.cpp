@@ -82,15 +82,17 @@ run(const std::map<std::string, std::shared_ptr<iir::StencilInstantiation>>&
         stencilInstantiationMap,
     const Options& options) {
   GTCodeGen CG(stencilInstantiationMap, options.UseParallelEP, options.MaxHaloSize,
-               options.RunWithSync);
+               options.RunWithSync, options.PrecompiledHeader);
 
   return CG.generateCode();
 }
 
 GTCodeGen::GTCodeGen(const StencilInstantiationContext& ctx, bool useParallelEP, int maxHaloPoints,
-                     bool runWithSync)
+                     bool runWithSync, const std::string& precompiledHeader)
     : CodeGen(ctx, maxHaloPoints),
-      mplContainerMaxSize_(20), codeGenOptions_{useParallelEP, runWithSync} {}
+      mplContainerMaxSize_(20), codeGenOptions_{useParallelEP, runWithSync} {
+  codeGenOptions.PrecompiledHeader = precompiledHeader;
+}
 
 GTCodeGen::~GTCodeGen() {}
 
@@ -1045,14 +1047,13 @@ std::unique_ptr<TranslationUnit> GTCodeGen::generateCode() {
     return "#define " + define + " " + std::to_string(value);
   };
 
-  ppDefines.push_back(makeDefine("DAWN_GENERATED", 1));
-  ppDefines.push_back("#undef DAWN_BACKEND_T");
-  ppDefines.push_back("#define DAWN_BACKEND_T GT");
-
-  CodeGen::addMplIfdefs(ppDefines, mplContainerMaxSize_);
+  std::vector<std::string> preamble;
+  preamble.push_back(makeDefine("DAWN_GENERATED", 1));
+  preamble.push_back("#undef DAWN_BACKEND_T");
+  preamble.push_back("#define DAWN_BACKEND_T GT");
 
-  ppDefines.push_back("#include <driver-includes/gridtools_includes.hpp>");
-  ppDefines.push_back("using namespace gridtools::dawn;");
+  CodeGen::addGridToolsRuntimeIncludes(preamble, mplContainerMaxSize_);
+  CodeGen::addPreamble(ppDefines, preamble);
 
   generateBCHeaders(ppDefines);
 
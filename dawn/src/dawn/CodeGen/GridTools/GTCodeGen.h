@@ -44,7 +44,7 @@ run(const std::map<std::string, std::shared_ptr<iir::StencilInstantiation>>&
 class GTCodeGen : public CodeGen {
 public:
   GTCodeGen(const StencilInstantiationContext& ctx, bool useParallelEP, int maxHaloPoints,
-            bool runWithSync = true);
+            bool runWithSync = true, const std::string& precompiledHeader = "");
   virtual ~GTCodeGen();
 
   virtual std::unique_ptr<TranslationUnit> generateCode() override;
@@ -18,9 +18,8 @@ namespace dawn {
 
 namespace AccessUtils {
 
-void recordWriteAccess(std::unordered_map<int, iir::Field>& inputOutputFields,
-                       std::unordered_map<int, iir::Field>& inputFields,
-                       std::unordered_map<int, iir::Field>& outputFields, int AccessID,
+void recordWriteAccess(iir::FieldMap& inputOutputFields, iir::FieldMap& inputFields,
+                       iir::FieldMap& outputFields, int AccessID,
                        const std::optional<iir::Extents>& writeExtents,
                        iir::Interval const& doMethodInterval,
                        ast::FieldDimensions&& fieldDimensions) {
@@ -50,9 +49,8 @@ void recordWriteAccess(std::unordered_map<int, iir::Field>& inputOutputFields,
   }
 }
 
-void recordReadAccess(std::unordered_map<int, iir::Field>& inputOutputFields,
-                      std::unordered_map<int, iir::Field>& inputFields,
-                      std::unordered_map<int, iir::Field>& outputFields, int AccessID,
+void recordReadAccess(iir::FieldMap& inputOutputFields, iir::FieldMap& inputFields,
+                      iir::FieldMap& outputFields, int AccessID,
                       std::optional<iir::Extents> const& readExtents,
                       const iir::Interval& doMethodInterval,
                       ast::FieldDimensions&& fieldDimensions) {
@@ -17,7 +17,6 @@
 #include "dawn/IIR/Accesses.h"
 #include "dawn/IIR/Field.h"
 #include <optional>
-#include <unordered_map>
 
 namespace dawn {
 namespace AccessUtils {
@@ -27,9 +26,8 @@ namespace AccessUtils {
 /// depending on previous accesses to the same field
 ///
 /// @ingroup optimizer
-void recordWriteAccess(std::unordered_map<int, iir::Field>& inputOutputFields,
-                       std::unordered_map<int, iir::Field>& inputFields,
-                       std::unordered_map<int, iir::Field>& outputFields, int AccessID,
+void recordWriteAccess(iir::FieldMap& inputOutputFields, iir::FieldMap& inputFields,
+                       iir::FieldMap& outputFields, int AccessID,
                        const std::optional<iir::Extents>& extents,
                        iir::Interval const& doMethodInterval,
                        ast::FieldDimensions&& fieldDimensions);
@@ -39,9 +37,8 @@ void recordWriteAccess(std::unordered_map<int, iir::Field>& inputOutputFields,
 /// depending on previous accesses to the same field
 ///
 /// @ingroup optimizer
-void recordReadAccess(std::unordered_map<int, iir::Field>& inputOutputFields,
-                      std::unordered_map<int, iir::Field>& inputFields,
-                      std::unordered_map<int, iir::Field>& outputFields, int AccessID,
+void recordReadAccess(iir::FieldMap& inputOutputFields, iir::FieldMap& inputFields,
+                      iir::FieldMap& outputFields, int AccessID,
                       const std::optional<iir::Extents>& extents,
                       iir::Interval const& doMethodInterval,
                       ast::FieldDimensions&& fieldDimensions);
@@ -53,52 +53,39 @@ bool Accesses::operator==(const Accesses& rhs) const {
 bool Accesses::operator!=(const Accesses& rhs) const { return !(*this == rhs); }
 
 void Accesses::mergeReadOffset(int AccessID, const ast::Offsets& offset) {
-  auto it = readAccesses_.find(AccessID);
-  if(it != readAccesses_.end()) {
+  auto [it, inserted] = readAccesses_.try_emplace(AccessID, offset);
+  if(!inserted)
     it->second.merge(offset);
-  } else {
-    readAccesses_.emplace(AccessID, Extents(offset));
-  }
 }
 
 void Accesses::mergeReadExtent(int AccessID, const Extents& extent) {
-  auto it = readAccesses_.find(AccessID);
-  if(it != readAccesses_.end())
+  auto [it, inserted] = readAccesses_.try_emplace(AccessID, extent);
+  if(!inserted)
     it->second.merge(extent);
-  else
-    readAccesses_.emplace(AccessID, extent);
 }
 
 void Accesses::mergeWriteOffset(int AccessID, const ast::Offsets& offset) {
-  auto it = writeAccesses_.find(AccessID);
-  if(it != writeAccesses_.end())
+  auto [it, inserted] = writeAccesses_.try_emplace(AccessID, offset);
+  if(!inserted)
     it->second.merge(offset);
-  else
-    writeAccesses_.emplace(AccessID, Extents(offset));
 }
 
 void Accesses::mergeWriteExtent(int AccessID, const Extents& extent) {
-  auto it = writeAccesses_.find(AccessID);
-  if(it != writeAccesses_.end())
+  auto [it, inserted] = writeAccesses_.try_emplace(AccessID, extent);
+  if(!inserted)
     it->second.merge(extent);
-  else
-    writeAccesses_.emplace(AccessID, extent);
 }
 
 void Accesses::addReadExtent(int AccessID, const Extents& extent) {
-  auto it = readAccesses_.find(AccessID);
-  if(it != readAccesses_.end())
+  auto [it, inserted] = readAccesses_.try_emplace(AccessID, extent);
+  if(!inserted)
     it->second += extent;
-  else
-    readAccesses_.emplace(AccessID, extent);
 }
 
 void Accesses::addWriteExtent(int AccessID, const Extents& extent) {
-  auto it = writeAccesses_.find(AccessID);
-  if(it != writeAccesses_.end())
+  auto [it, inserted] = writeAccesses_.try_emplace(AccessID, extent);
+  if(!inserted)
     it->second += extent;
-  else
-    writeAccesses_.emplace(AccessID, extent);
 }
 
 bool Accesses::hasReadAccess(int accessID) const { return readAccesses_.count(accessID); }
@@ -139,7 +126,7 @@ std::string Accesses::toString(std::function<std::string(int)>&& accessIDToStrin
   std::stringstream ss;
   std::string indent(initialIndent, ' ');
 
-  auto printMap = [&](const std::unordered_map<int, Extents>& map) {
+  auto printMap = [&](const AccessMap& map) {
     for(auto const& [accessID, access] : map)
       ss << indent << "  " << accessIDToStringFunction(accessID) << " : " << access << "\n";
   };
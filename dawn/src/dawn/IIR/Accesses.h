@@ -16,8 +16,8 @@
 
 #include "dawn/AST/Offsets.h"
 #include "dawn/IIR/Extents.h"
+#include "dawn/Support/FlatMap.h"
 #include <functional>
-#include <unordered_map>
 
 namespace dawn {
 namespace iir {
@@ -25,13 +25,16 @@ namespace iir {
 class StencilFunctionInstantiation;
 class StencilMetaInformation;
 
+/// @brief Extents of the accessed fields, by AccessID
+using AccessMap = FlatMap<int, Extents>;
+
 /// @brief Read and write accesses of a statement
 ///
 /// Accesses are either part of a `StencilInstantiation` or `StencilFunctionInstantiation`.
 /// @ingroup optimizer
 class Accesses {
-  std::unordered_map<int, Extents> writeAccesses_;
-  std::unordered_map<int, Extents> readAccesses_;
+  AccessMap writeAccesses_;
+  AccessMap readAccesses_;
 
 public:
   Accesses() = default;
@@ -77,11 +80,11 @@ public:
   const Extents& getWriteAccess(int AccessID) const;
 
   /// @brief Get the accesses maps
-  std::unordered_map<int, Extents>& getReadAccesses() { return readAccesses_; }
-  const std::unordered_map<int, Extents>& getReadAccesses() const { return readAccesses_; }
+  AccessMap& getReadAccesses() { return readAccesses_; }
+  const AccessMap& getReadAccesses() const { return readAccesses_; }
 
-  std::unordered_map<int, Extents>& getWriteAccesses() { return writeAccesses_; }
-  const std::unordered_map<int, Extents>& getWriteAccesses() const { return writeAccesses_; }
+  AccessMap& getWriteAccesses() { return writeAccesses_; }
+  const AccessMap& getWriteAccesses() const { return writeAccesses_; }
 
   /// @brief Convert the accesses of a stencil or stencil-function instantiation to string
   /// @{
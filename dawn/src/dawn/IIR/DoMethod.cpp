@@ -44,7 +44,7 @@ public:
   void visit(const std::shared_ptr<ast::VarDeclStmt>& stmt) override {
     auto data = stmt->getData<iir::IIRStmtData>();
     auto accesses = data.CallerAccesses;
-    auto accessmap = accesses->getWriteAccesses();
+    const auto& accessmap = accesses->getWriteAccesses();
     DAWN_ASSERT_MSG(accessmap.size() == 1, "can only be one write access");
     std::string realName = metadata_.getNameFromAccessID(accessmap.begin()->first);
     stmt->getName() = realName;
@@ -137,8 +137,7 @@ void DoMethod::clearDerivedInfo() { derivedInfo_.clear(); }
 
 namespace {
 json::json print(const StencilMetaInformation& metadata,
-                 const AccessToNameMapper& accessToNameMapper,
-                 const std::unordered_map<int, Extents>& accesses) {
+                 const AccessToNameMapper& accessToNameMapper, const AccessMap& accesses) {
   json::json node;
   for(const auto& accessPair : accesses) {
     json::json accessNode;
@@ -217,9 +216,9 @@ void DoMethod::updateLevel() {
   //        +----------> | InputOutput | <----------+
   //                     +-------------+
   //
-  std::unordered_map<int, Field> inputOutputFields;
-  std::unordered_map<int, Field> inputFields;
-  std::unordered_map<int, Field> outputFields;
+  FieldMap inputOutputFields;
+  FieldMap inputFields;
+  FieldMap outputFields;
 
   for(const auto& stmt : getAST().getStatements()) {
     const auto& access = stmt->getData<iir::IIRStmtData>().CallerAccesses;
@@ -43,7 +43,7 @@ class DoMethod : public IIRNode<Stage, DoMethod, void> {
     void clear();
 
     /// Declaration of the fields of this doMethod
-    std::unordered_map<int, Field> fields_;
+    FieldMap fields_;
     std::optional<DependencyGraphAccesses> dependencyGraph_;
   };
 
@@ -103,7 +103,7 @@ public:
   /// `Input`
   ///
   /// The fields are computed during `DoMethod::update`.
-  const std::unordered_map<int, Field>& getFields() const { return derivedInfo_.fields_; }
+  const FieldMap& getFields() const { return derivedInfo_.fields_; }
 
   /// @brief Get a map from field name to its dimensions for each field referenced in the DoMethod
   ///
@@ -16,6 +16,7 @@
 #include "dawn/AST/GridType.h"
 #include "dawn/Support/HashCombine.h"
 #include "dawn/Support/Unreachable.h"
+#include <utility>
 
 namespace dawn::iir {
 
@@ -89,7 +90,6 @@ HorizontalExtentImpl& HorizontalExtentImpl::operator+=(HorizontalExtentImpl cons
   addImpl(other);
   return *this;
 }
-std::unique_ptr<HorizontalExtentImpl> HorizontalExtentImpl::clone() const { return cloneImpl(); }
 void HorizontalExtentImpl::merge(HorizontalExtentImpl const& other) { mergeImpl(other); }
 void HorizontalExtentImpl::addCenter() { addCenterImpl(); }
 bool HorizontalExtentImpl::operator==(HorizontalExtentImpl const& other) const {
@@ -127,10 +127,6 @@ bool CartesianExtent::equalsImpl(HorizontalExtentImpl const& other) const {
   return extents_[0] == otherCartesian.extents_[0] && extents_[1] == otherCartesian.extents_[1];
 }
 
-std::unique_ptr<HorizontalExtentImpl> CartesianExtent::cloneImpl() const {
-  return std::make_unique<CartesianExtent>(extents_[0].minus(), extents_[0].plus(),
-                                           extents_[1].minus(), extents_[1].plus());
-}
 bool CartesianExtent::isPointwiseImpl() const {
   return extents_[0].isPointwise() && extents_[1].isPointwise();
 }
@@ -163,10 +159,6 @@ bool UnstructuredExtent::equalsImpl(HorizontalExtentImpl const& other) const {
   return hasExtent_ == otherUnstructured.hasExtent_;
 }
 
-std::unique_ptr<HorizontalExtentImpl> UnstructuredExtent::cloneImpl() const {
-  return std::make_unique<UnstructuredExtent>(hasExtent_);
-}
-
 bool UnstructuredExtent::isPointwiseImpl() const { return !hasExtent_; }
 
 void UnstructuredExtent::limitImpl(HorizontalExtentImpl const& other) {
@@ -187,70 +179,68 @@ HorizontalExtent::HorizontalExtent(ast::HorizontalOffset const& hOffset) {
       },
       []() { return HorizontalExtent(); });
 }
-HorizontalExtent::HorizontalExtent(ast::cartesian_) : impl_(std::make_unique<CartesianExtent>()) {}
+HorizontalExtent::HorizontalExtent(ast::cartesian_) : impl_(CartesianExtent()) {}
 HorizontalExtent::HorizontalExtent(ast::cartesian_, int iMinus, int iPlus, int jMinus, int jPlus)
-    : impl_(std::make_unique<CartesianExtent>(iMinus, iPlus, jMinus, jPlus)) {}
+    : impl_(CartesianExtent(iMinus, iPlus, jMinus, jPlus)) {}
 
-HorizontalExtent::HorizontalExtent(ast::unstructured_)
-    : impl_(std::make_unique<UnstructuredExtent>()) {}
+HorizontalExtent::HorizontalExtent(ast::unstructured_) : impl_(UnstructuredExtent()) {}
 HorizontalExtent::HorizontalExtent(ast::unstructured_, bool hasExtent)
-    : impl_(std::make_unique<UnstructuredExtent>(hasExtent)) {}
+    : impl_(UnstructuredExtent(hasExtent)) {}
 
-HorizontalExtent::HorizontalExtent(HorizontalExtent const& other)
-    : impl_(other.impl_ ? other.impl_->clone() : nullptr) {}
-HorizontalExtent& HorizontalExtent::operator=(HorizontalExtent const& other) {
-  if(other.impl_)
-    impl_ = other.impl_->clone();
-  else
-    impl_ = nullptr;
-  return *this;
+HorizontalExtentImpl* HorizontalExtent::impl() {
+  return const_cast<HorizontalExtentImpl*>(std::as_const(*this).impl());
+}
+HorizontalExtentImpl const* HorizontalExtent::impl() const {
+  if(auto cartesianExtent = std::get_if<CartesianExtent>(&impl_))
+    return cartesianExtent;
+  if(auto unstructuredExtent = std::get_if<UnstructuredExtent>(&impl_))
+    return unstructuredExtent;
+  return nullptr;
 }
 
-HorizontalExtent::HorizontalExtent(std::unique_ptr<HorizontalExtentImpl> impl)
-    : impl_(std::move(impl)) {}
 bool HorizontalExtent::operator==(HorizontalExtent const& other) const {
-  if(impl_ && other.impl_)
-    return *impl_ == *other.impl_;
-  else if(impl_)
+  if(impl() && other.impl())
+    return *impl() == *other.impl();
+  else if(impl())
     return isPointwise();
-  else if(other.impl_)
+  else if(other.impl())
     return other.isPointwise();
   else
     return true;
 }
 bool HorizontalExtent::operator!=(HorizontalExtent const& other) const { return !(*this == other); }
 HorizontalExtent& HorizontalExtent::operator+=(HorizontalExtent const& other) {
-  if(impl_ && other.impl_)
-    *impl_ += *other.impl_;
-  else if(other.impl_)
+  if(impl() && other.impl())
+    *impl() += *other.impl();
+  else if(other.impl())
     *this = other;
 
   return *this;
 }
 void HorizontalExtent::merge(HorizontalExtent const& other) {
-  if(impl_ && other.impl_)
-    impl_->merge(*other.impl_);
-  else if(impl_)
-    impl_->addCenter();
-  else if(other.impl_) {
+  if(impl() && other.impl())
+    impl()->merge(*other.impl());
+  else if(impl())
+    impl()->addCenter();
+  else if(other.impl()) {
     *this = other;
-    impl_->addCenter();
+    impl()->addCenter();
   }
 }
 void HorizontalExtent::merge(ast::HorizontalOffset const& other) { merge(HorizontalExtent{other}); }
-bool HorizontalExtent::isPointwise() const { return !impl_ || impl_->isPointwise(); }
+bool HorizontalExtent::isPointwise() const { return !impl() || impl()->isPointwise(); }
 void HorizontalExtent::limit(HorizontalExtent const& other) {
-  if(impl_ && other.impl_)
-    impl_->limit(*other.impl_);
-  else if(!other.impl_)
+  if(impl() && other.impl())
+    impl()->limit(*other.impl());
+  else if(!other.impl())
     *this = other;
 }
 
-bool HorizontalExtent::hasType() const { return impl_ != nullptr; }
+bool HorizontalExtent::hasType() const { return impl() != nullptr; }
 
 ast::GridType HorizontalExtent::getType() const {
   DAWN_ASSERT(hasType());
-  if(dynamic_cast<CartesianExtent*>(impl_.get())) {
+  if(std::holds_alternative<CartesianExtent>(impl_)) {
     return ast::GridType::Cartesian;
   } else {
     return ast::GridType::Unstructured;
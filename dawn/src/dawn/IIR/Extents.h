@@ -33,6 +33,7 @@
 #include <array>
 #include <iosfwd>
 #include <optional>
+#include <variant>
 
 namespace dawn {
 namespace iir {
@@ -95,7 +96,6 @@ public:
   virtual ~HorizontalExtentImpl() = default;
 
   HorizontalExtentImpl& operator+=(HorizontalExtentImpl const& other);
-  std::unique_ptr<HorizontalExtentImpl> clone() const;
 
   void merge(HorizontalExtentImpl const& other);
   void addCenter();
@@ -108,7 +108,6 @@ protected:
   virtual void mergeImpl(HorizontalExtentImpl const& other) = 0;
   virtual void addCenterImpl() = 0;
   virtual bool equalsImpl(HorizontalExtentImpl const& other) const = 0;
-  virtual std::unique_ptr<HorizontalExtentImpl> cloneImpl() const = 0;
   virtual bool isPointwiseImpl() const = 0;
   virtual void limitImpl(HorizontalExtentImpl const& other) = 0;
 };
@@ -131,7 +130,6 @@ protected:
   void mergeImpl(HorizontalExtentImpl const& other) override;
   void addCenterImpl() override;
   bool equalsImpl(HorizontalExtentImpl const& other) const override;
-  std::unique_ptr<HorizontalExtentImpl> cloneImpl() const override;
 
   bool isPointwiseImpl() const override;
   void limitImpl(HorizontalExtentImpl const& other) override;
@@ -152,7 +150,6 @@ protected:
   void mergeImpl(HorizontalExtentImpl const& other) override;
   void addCenterImpl() override;
   bool equalsImpl(HorizontalExtentImpl const& other) const override;
-  std::unique_ptr<HorizontalExtentImpl> cloneImpl() const override;
   bool isPointwiseImpl() const override;
   void limitImpl(HorizontalExtentImpl const& other) override;
 
@@ -174,13 +171,6 @@ public:
   HorizontalExtent(ast::unstructured_);
   HorizontalExtent(ast::unstructured_, bool hasExtent);
 
-  HorizontalExtent(HorizontalExtent const& other);
-  HorizontalExtent(HorizontalExtent&& other) = default;
-  HorizontalExtent& operator=(HorizontalExtent const& other);
-  HorizontalExtent& operator=(HorizontalExtent&& other) = default;
-
-  HorizontalExtent(std::unique_ptr<HorizontalExtentImpl> impl);
-
   template <typename T>
   friend T extent_cast(HorizontalExtent const&);
   template <typename CartFn, typename UnstructuredFn, typename ZeroFn>
@@ -199,7 +189,15 @@ public:
   ast::GridType getType() const;
 
 private:
-  std::unique_ptr<HorizontalExtentImpl> impl_;
+  /// @brief The extent implementation, `nullptr` for the null-extent
+  /// @{
+  HorizontalExtentImpl* impl();
+  HorizontalExtentImpl const* impl() const;
+  /// @}
+
+  // The extent is stored inline: extents are copied and merged for every access when updating the
+  // derived info of the IIR
+  std::variant<std::monostate, CartesianExtent, UnstructuredExtent> impl_;
 };
 
 /**
@@ -213,7 +211,7 @@ T extent_cast(HorizontalExtent const& extent) {
                 "Can only be cast to a valid horizontal extent implementation");
   static_assert(std::is_const_v<PlainT>, "Can only be cast to const");
   static PlainT nullExtent{};
-  return extent.impl_ ? dynamic_cast<T>(*extent.impl_) : nullExtent;
+  return extent.impl() ? dynamic_cast<T>(*extent.impl()) : nullExtent;
 }
 
 /**
@@ -236,7 +234,7 @@ auto extent_dispatch(HorizontalExtent const& hExtent, CartFn const& cartFn,
   if(hExtent.isPointwise())
     return zeroFn();
 
-  HorizontalExtentImpl* ptr = hExtent.impl_.get();
+  HorizontalExtentImpl const* ptr = hExtent.impl();
   if(auto cartesianExtent = dynamic_cast<CartesianExtent const*>(ptr)) {
     return cartFn(*cartesianExtent);
   } else if(auto unstructuredExtent = dynamic_cast<UnstructuredExtent const*>(ptr)) {
@@ -56,8 +56,7 @@ void mergeField(const Field& sField, Field& dField) {
   dField.extendInterval(sField.getInterval());
 }
 
-void mergeFields(std::unordered_map<int, Field> const& sourceFields,
-                 std::unordered_map<int, Field>& destinationFields,
+void mergeFields(FieldMap const& sourceFields, FieldMap& destinationFields,
                  std::optional<Extents> baseExtents) {
 
   for(const auto& fieldPair : sourceFields) {
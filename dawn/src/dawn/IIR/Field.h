@@ -18,6 +18,7 @@
 #include "dawn/IIR/Extents.h"
 #include "dawn/IIR/FieldAccessExtents.h"
 #include "dawn/IIR/Interval.h"
+#include "dawn/Support/FlatMap.h"
 #include "dawn/Support/Json.h"
 #include <memory>
 #include <optional>
@@ -137,12 +138,14 @@ public:
   }
 };
 
+/// @brief Fields of a node of the IIR, by AccessID
+using FieldMap = FlatMap<int, Field>;
+
 /// @brief merges all the fields from sourceFields into destinationFields
 /// If a baseExtent is provided (optionally), the extent of each sourceField is expanded with the
 /// baseExtent (in order to account for redundant block computations where the accesses were
 /// recorded)
-void mergeFields(std::unordered_map<int, Field> const& sourceFields,
-                 std::unordered_map<int, Field>& destinationFields,
+void mergeFields(FieldMap const& sourceFields, FieldMap& destinationFields,
                  std::optional<Extents> baseExtents = std::optional<Extents>());
 
 void mergeField(const Field& sField, Field& dField);
@@ -69,7 +69,7 @@ json::json IIR::jsonDump() const {
   json::json node;
 
   json::json fieldsJson;
-  for(const auto& f : derivedInfo_.fields_) {
+  for(const auto& f : getFields()) {
     fieldsJson[f.second.Name] = f.second.jsonDump();
   }
   node["Fields"] = fieldsJson;
@@ -72,10 +72,11 @@ public:
   virtual void updateFromChildren() override;
 
   /// @brief returns true if the accessid is used within the stencil
-  bool hasFieldAccessID(const int accessID) const { return derivedInfo_.fields_.count(accessID); }
+  bool hasFieldAccessID(const int accessID) const { return getFields().count(accessID); }
 
   /// @brief Get the pair <AccessID, field> for the fields used within the multi-stage
   const std::unordered_map<int, Stencil::FieldInfo>& getFields() const {
+    ensureDerivedInfo();
     return derivedInfo_.fields_;
   }
 
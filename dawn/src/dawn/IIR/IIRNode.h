@@ -58,11 +58,19 @@ class IIRNode {
 protected:
   /// @brief constructors
   /// @{
-  virtual ~IIRNode() = default;
+  virtual ~IIRNode() {
+    // the root of a tree with dirty nodes is registered in the active scope, which must not call
+    // into it once it is gone
+    if(DeferredUpdateScope::isActive())
+      DeferredUpdateScope::removeDirtyRoot(this);
+  }
   /// @}
 
   const std::unique_ptr<Parent>* parent_ = nullptr;
 
+  /// derived info needs to be recomputed from the children (see DeferredUpdateScope)
+  bool derivedInfoDirty_ = false;
+
   template <class T>
   using SmartPtr = typename std::conditional<std::is_void<Child>::value, std::shared_ptr<T>,
                                              std::unique_ptr<T>>::type;
@@ -422,6 +430,66 @@ public:
     }
   }
 
+  /// @brief mark the derived info of this node and of the tree above as dirty, the root of the tree
+  /// is registered in the active DeferredUpdateScope
+  template <typename TNodeType>
+  inline void markDirtyRec(
+      typename std::enable_if<std::is_void<typename TNodeType::ParentType>::value>::type* = 0) {
+    if(derivedInfoDirty_)
+      return;
+    derivedInfoDirty_ = true;
+    DeferredUpdateScope::addDirtyRoot(this, [this]() { updateDirtyRec<Child>(); });
+  }
+
+  /// @brief mark the derived info of this node and of the tree above as dirty, the root of the tree
+  /// is registered in the active DeferredUpdateScope
+  template <typename TNodeType>
+  inline void markDirtyRec(
+      typename std::enable_if<!std::is_void<typename TNodeType::ParentType>::value>::type* = 0) {
+    if(derivedInfoDirty_)
+      return;
+    derivedInfoDirty_ = true;
+
+    auto parentPtr = getParentPtr();
+    if(parentPtr) {
+      (*parentPtr)->template markDirtyRec<typename TNodeType::ParentType>();
+    } else {
+      DeferredUpdateScope::addDirtyRoot(this, [this]() { updateDirtyRec<Child>(); });
+    }
+  }
+
+  /// @brief recompute the dirty nodes of the tree below (children first)
+  template <typename TChild>
+  inline void updateDirtyRec(typename std::enable_if<std::is_void<TChild>::value>::type* = 0) {
+    derivedInfoDirty_ = false;
+  }
+
+  /// @brief recompute the dirty nodes of the tree below (children first)
+  template <typename TChild>
+  inline void updateDirtyRec(typename std::enable_if<!std::is_void<TChild>::value>::type* = 0) {
+    PROTECT_TEMPLATE(TChild, Child)
+    if(!derivedInfoDirty_)
+      return;
+    // cleared first, updateFromChildren may query the derived info of this node
+    derivedInfoDirty_ = false;
+    for(const auto& child : children_) {
+      child->template updateDirtyRec<typename Child::ChildType>();
+    }
+    clearDerivedInfo();
+    updateFromChildren();
+  }
+
+  /// @brief true if the derived info waits to be recomputed by a DeferredUpdateScope
+  bool isDerivedInfoDirty() const { return derivedInfoDirty_; }
+
+  /// @brief recompute the derived info of this node (and of its dirty descendants) if it was left
+  /// dirty by the active DeferredUpdateScope. Called by all the getters of derived info
+  void ensureDerivedInfo() const {
+    if(derivedInfoDirty_) {
+      const_cast<IIRNode*>(this)->template updateDirtyRec<Child>();
+    }
+  }
+
   /// @brief update the derived info of the node
   /// @param updateType determines if the update should be applied to this tree level (only) or
   /// propagate it to the top or bottom of the tree
@@ -434,8 +502,13 @@ public:
       }
     }
     if(impl::updateTreeAbove(updateType)) {
-      clearDerivedInfoRec<NodeType>();
-      updateFromChildrenRec<NodeType>();
+      if(DeferredUpdateScope::isActive()) {
+        updateFromChildren();
+        markParentDirty<NodeType>();
+      } else {
+        clearDerivedInfoRec<NodeType>();
+        updateFromChildrenRec<NodeType>();
+      }
     }
     if(impl::updateTreeBelow(updateType)) {
       dawn_unreachable("node update type tree below not supported");
@@ -446,6 +519,19 @@ public:
   virtual void clearDerivedInfo() {}
 
 private:
+  template <typename TNodeType>
+  inline void markParentDirty(
+      typename std::enable_if<std::is_void<typename TNodeType::ParentType>::value>::type* = 0) {}
+
+  template <typename TNodeType>
+  inline void markParentDirty(
+      typename std::enable_if<!std::is_void<typename TNodeType::ParentType>::value>::type* = 0) {
+    auto parentPtr = getParentPtr();
+    if(parentPtr) {
+      (*parentPtr)->template markDirtyRec<typename TNodeType::ParentType>();
+    }
+  }
+
   /// @brief fix the tree structure after the erase of a child
   inline void fixAfterErase() {
     // since we have removed a child, the pointers of other siblings might have change,
@@ -31,6 +31,7 @@ MultiStage::MultiStage(StencilMetaInformation& metadata, LoopOrderKind loopOrder
     : metadata_(metadata), loopOrder_(loopOrder), id_(UIDGenerator::getInstance()->get()) {}
 
 std::unique_ptr<MultiStage> MultiStage::clone() const {
+  ensureDerivedInfo();
   auto cloneMS = std::make_unique<MultiStage>(metadata_, loopOrder_);
 
   cloneMS->id_ = id_;
@@ -355,8 +356,8 @@ std::optional<Interval> MultiStage::getEnclosingAccessIntervalTemporaries() cons
   return interval;
 }
 
-std::unordered_map<int, Field> MultiStage::computeFieldsOnTheFly() const {
-  std::unordered_map<int, Field> fields;
+FieldMap MultiStage::computeFieldsOnTheFly() const {
+  FieldMap fields;
 
   for(const auto& stagePtr : children_) {
     mergeFields(stagePtr->getFields(), fields, stagePtr->getExtents());
@@ -369,9 +370,12 @@ void MultiStage::DerivedInfo::clear() { fields_.clear(); }
 
 void MultiStage::clearDerivedInfo() { derivedInfo_.clear(); }
 
-const std::unordered_map<int, Field>& MultiStage::getFields() const { return derivedInfo_.fields_; }
+const FieldMap& MultiStage::getFields() const {
+  ensureDerivedInfo();
+  return derivedInfo_.fields_;
+}
 std::map<int, Field> MultiStage::getOrderedFields() const {
-  return support::orderMap(derivedInfo_.fields_);
+  return support::orderMap(getFields());
 }
 
 void MultiStage::updateFromChildren() {
@@ -381,6 +385,7 @@ void MultiStage::updateFromChildren() {
 }
 
 const Field& MultiStage::getField(int accessID) const {
+  ensureDerivedInfo();
   DAWN_ASSERT(derivedInfo_.fields_.count(accessID));
   return derivedInfo_.fields_.at(accessID);
 }
@@ -395,7 +400,7 @@ json::json MultiStage::jsonDump() const {
   node["ID"] = id_;
   node["Loop"] = loopOrderToString(loopOrder_);
   json::json fieldsJson;
-  for(const auto& field : derivedInfo_.fields_) {
+  for(const auto& field : getFields()) {
     fieldsJson[metadata_.getNameFromAccessID(field.first)] = field.second.jsonDump();
   }
   node["Fields"] = fieldsJson;
@@ -415,7 +420,7 @@ json::json MultiStage::jsonDump() const {
 }
 
 bool MultiStage::hasMemAccessTemporaries() const {
-  for(const auto& field : derivedInfo_.fields_) {
+  for(const auto& field : getFields()) {
     if(isMemAccessTemporary(field.first)) {
       return true;
     }
@@ -430,7 +435,7 @@ bool MultiStage::isMemAccessTemporary(const int accessID) const {
     return true;
   return (derivedInfo_.caches_.at(accessID).requiresMemMemoryAccess());
 }
-bool MultiStage::hasField(const int accessID) const { return derivedInfo_.fields_.count(accessID); }
+bool MultiStage::hasField(const int accessID) const { return getFields().count(accessID); }
 
 bool MultiStage::isEmptyOrNullStmt() const {
   for(const auto& stage : getChildren()) {
@@ -441,9 +446,8 @@ bool MultiStage::isEmptyOrNullStmt() const {
   return true;
 }
 
-std::unordered_map<int, Field>
-MultiStage::computeFieldsAtInterval(const iir::Interval& interval) const {
-  std::unordered_map<int, Field> fields;
+FieldMap MultiStage::computeFieldsAtInterval(const iir::Interval& interval) const {
+  FieldMap fields;
   for(const auto& stage : iterateIIROver<Stage>(*this)) {
     for(const auto& doMethod : stage->getChildren()) {
       if(!doMethod->getInterval().overlaps(interval))
@@ -55,7 +55,7 @@ class MultiStage : public IIRNode<Stencil, MultiStage, Stage, impl::StdList> {
     ///@brrief filled by PassSetCaches and PassSetNonTempCaches
     std::unordered_map<int, iir::Cache> caches_;
 
-    std::unordered_map<int, Field> fields_;
+    FieldMap fields_;
     void clear();
   };
 
@@ -148,11 +148,11 @@ public:
   Interval getEnclosingInterval() const;
 
   /// @brief Get the pair <AccessID, field> for the fields used within the multi-stage
-  const std::unordered_map<int, Field>& getFields() const;
+  const FieldMap& getFields() const;
   std::map<int, Field> getOrderedFields() const;
 
   /// @brief Compute and return the pairs <AccessID, field> used for a given interval
-  std::unordered_map<int, Field> computeFieldsAtInterval(const iir::Interval& interval) const;
+  FieldMap computeFieldsAtInterval(const iir::Interval& interval) const;
 
   /// @brief determines whether an accessID corresponds to a temporary that will perform accesses to
   /// main memory
@@ -168,7 +168,7 @@ public:
   const Field& getField(int accessID) const;
 
   /// @brief computes the collection of fields of the multistage on the fly (returns copy)
-  std::unordered_map<int, Field> computeFieldsOnTheFly() const;
+  FieldMap computeFieldsOnTheFly() const;
 
   /// @brief Get the enclosing interval of all access to temporaries
   std::optional<Interval> getEnclosingAccessIntervalTemporaries() const;
@@ -1,4 +1,8 @@
 #include "dawn/IIR/NodeUpdateType.h"
+#include "dawn/Support/Assert.h"
+#include <algorithm>
+#include <utility>
+#include <vector>
 
 namespace dawn {
 namespace iir {
@@ -10,5 +14,45 @@ bool updateLevel(NodeUpdateType updateType) {
 bool updateTreeAbove(NodeUpdateType updateType) { return static_cast<int>(updateType) > 0; }
 bool updateTreeBelow(NodeUpdateType updateType) { return static_cast<int>(updateType) < 0; }
 } // namespace impl
+
+namespace {
+struct DeferredUpdates {
+  int Depth = 0;
+  std::vector<std::pair<const void*, std::function<void()>>> DirtyRoots;
+};
+thread_local DeferredUpdates deferredUpdates;
+} // namespace
+
+DeferredUpdateScope::DeferredUpdateScope() { ++deferredUpdates.Depth; }
+
+DeferredUpdateScope::~DeferredUpdateScope() {
+  if(--deferredUpdates.Depth == 0)
+    flush();
+}
+
+bool DeferredUpdateScope::isActive() { return deferredUpdates.Depth > 0; }
+
+void DeferredUpdateScope::addDirtyRoot(const void* root, std::function<void()> updateDirtyNodes) {
+  auto& dirtyRoots = deferredUpdates.DirtyRoots;
+  if(std::none_of(dirtyRoots.begin(), dirtyRoots.end(),
+                  [&](const auto& dirtyRoot) { return dirtyRoot.first == root; }))
+    dirtyRoots.emplace_back(root, std::move(updateDirtyNodes));
+}
+
+void DeferredUpdateScope::removeDirtyRoot(const void* root) {
+  auto& dirtyRoots = deferredUpdates.DirtyRoots;
+  dirtyRoots.erase(std::remove_if(dirtyRoots.begin(), dirtyRoots.end(),
+                                  [&](const auto& dirtyRoot) { return dirtyRoot.first == root; }),
+                   dirtyRoots.end());
+}
+
+void DeferredUpdateScope::flush() {
+  auto dirtyRoots = std::move(deferredUpdates.DirtyRoots);
+  deferredUpdates.DirtyRoots.clear();
+  for(const auto& dirtyRoot : dirtyRoots)
+    dirtyRoot.second();
+  // recomputing derived info must not issue new (deferred) updates
+  DAWN_ASSERT(deferredUpdates.DirtyRoots.empty());
+}
 } // namespace iir
 } // namespace dawn
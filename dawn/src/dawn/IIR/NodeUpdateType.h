@@ -14,6 +14,8 @@
 
 #pragma once
 
+#include <functional>
+
 namespace dawn {
 namespace iir {
 
@@ -33,5 +35,34 @@ bool updateTreeAbove(NodeUpdateType updateType);
 /// @brief return true if the tree below the current level needs to be updated
 bool updateTreeBelow(NodeUpdateType updateType);
 } // namespace impl
+
+/// @brief Scope that batches the propagation of derived info to the tree above
+///
+/// While a scope is alive, `update(NodeUpdateType::treeAbove)` and
+/// `update(NodeUpdateType::levelAndTreeAbove)` only mark the ancestors of the node as dirty. When
+/// the outermost scope ends, the dirty nodes are recomputed bottom-up, each of them exactly once,
+/// instead of once per updated descendant. Querying the derived info of a dirty node recomputes it
+/// (and its dirty descendants) on the spot, so reads within a scope never observe stale data.
+class DeferredUpdateScope {
+public:
+  DeferredUpdateScope();
+  ~DeferredUpdateScope();
+
+  DeferredUpdateScope(const DeferredUpdateScope&) = delete;
+  DeferredUpdateScope& operator=(const DeferredUpdateScope&) = delete;
+
+  /// @brief true if updates of the tree above are currently deferred
+  static bool isActive();
+
+  /// @brief register the update of the root of a tree which has dirty nodes (once per root)
+  static void addDirtyRoot(const void* root, std::function<void()> updateDirtyNodes);
+
+  /// @brief forget a root, e.g. because it is destroyed before the scope ends
+  static void removeDirtyRoot(const void* root);
+
+  /// @brief recompute the dirty nodes registered so far
+  static void flush();
+};
+
 } // namespace iir
 } // namespace dawn
@@ -42,6 +42,7 @@ Stage::Stage(const StencilMetaInformation& metaData, int StageID, const Interval
 }
 
 json::json Stage::jsonDump(const StencilMetaInformation& metaData) const {
+  ensureDerivedInfo();
   json::json node;
   json::json fieldsJson;
   for(const auto& field : derivedInfo_.fields_) {
@@ -62,6 +63,7 @@ json::json Stage::jsonDump(const StencilMetaInformation& metaData) const {
 }
 
 std::unique_ptr<Stage> Stage::clone() const {
+  ensureDerivedInfo();
 
   auto cloneStage = std::make_unique<Stage>(metaData_, StageID_);
 
@@ -127,6 +129,7 @@ Interval Stage::getEnclosingInterval() const {
 }
 
 Extent Stage::getMaxVerticalExtent() const {
+  ensureDerivedInfo();
   Extent verticalExtent;
   std::for_each(derivedInfo_.fields_.begin(), derivedInfo_.fields_.end(),
                 [&](const std::pair<int, Field>& pair) {
@@ -164,7 +167,7 @@ bool Stage::overlaps(const Stage& other) const {
   return false;
 }
 
-bool Stage::overlaps(const Interval& interval, const std::unordered_map<int, Field>& fields) const {
+bool Stage::overlaps(const Interval& interval, const FieldMap& fields) const {
   for(const auto& doMethodPtr : getChildren()) {
     const Interval& thisInterval = doMethodPtr->getInterval();
 
@@ -255,19 +258,23 @@ void Stage::updateGlobalVariablesInfo() {
       derivedInfo_.globalVariablesFromStencilFunctionCalls_.end());
 }
 bool Stage::hasGlobalVariables() const {
+  ensureDerivedInfo();
   return (!derivedInfo_.globalVariables_.empty()) ||
          (!derivedInfo_.globalVariablesFromStencilFunctionCalls_.empty());
 }
 
 const std::unordered_set<int>& Stage::getGlobalVariables() const {
+  ensureDerivedInfo();
   return derivedInfo_.globalVariables_;
 }
 
 const std::unordered_set<int>& Stage::getGlobalVariablesFromStencilFunctionCalls() const {
+  ensureDerivedInfo();
   return derivedInfo_.globalVariablesFromStencilFunctionCalls_;
 }
 
 const std::unordered_set<int>& Stage::getAllGlobalVariables() const {
+  ensureDerivedInfo();
   return derivedInfo_.allGlobalVariables_;
 }
 
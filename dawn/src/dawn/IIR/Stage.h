@@ -60,7 +60,7 @@ class Stage : public IIRNode<MultiStage, Stage, DoMethod> {
     void clear();
 
     /// Declaration of the fields of this stage
-    std::unordered_map<int, Field> fields_;
+    FieldMap fields_;
 
     /// AccessIDs of the global variable accesses of this stage
     std::unordered_set<int> allGlobalVariables_;
@@ -142,7 +142,7 @@ public:
   ///
   /// @{
   bool overlaps(const Stage& other) const;
-  bool overlaps(const Interval& interval, const std::unordered_map<int, Field>& fields) const;
+  bool overlaps(const Interval& interval, const FieldMap& fields) const;
   /// @}
 
   /// @brief Get the maximal vertical extent of this stage
@@ -156,9 +156,12 @@ public:
   /// `Input`
   ///
   /// The fields are computed during `Stage::update`.
-  const std::unordered_map<int, Field>& getFields() const { return derivedInfo_.fields_; }
+  const FieldMap& getFields() const {
+    ensureDerivedInfo();
+    return derivedInfo_.fields_;
+  }
 
-  std::map<int, Field> getOrderedFields() const { return support::orderMap(derivedInfo_.fields_); }
+  std::map<int, Field> getOrderedFields() const { return support::orderMap(getFields()); }
 
   /// @brief Update the fields and global variables
   ///
@@ -91,7 +91,7 @@ json::json Stencil::jsonDump() const {
   json::json node;
   node["ID"] = std::to_string(StencilID_);
   json::json fieldsJson;
-  for(const auto& f : derivedInfo_.fields_) {
+  for(const auto& f : getFields()) {
     fieldsJson[f.second.Name] = f.second.jsonDump();
   }
   node["Fields"] = fieldsJson;
@@ -115,7 +115,7 @@ bool Stencil::containsRedundantComputations() const {
 
 void Stencil::updateFromChildren() {
   derivedInfo_.fields_.clear();
-  std::unordered_map<int, Field> fields;
+  FieldMap fields;
 
   for(const auto& MSPtr : children_) {
     mergeFields(MSPtr->getFields(), fields);
@@ -171,6 +171,7 @@ std::unordered_set<Interval> Stencil::getIntervals() const {
 }
 
 std::unique_ptr<Stencil> Stencil::clone() const {
+  ensureDerivedInfo();
   auto cloneStencil = std::make_unique<Stencil>(metadata_, stencilAttributes_, StencilID_);
 
   cloneStencil->derivedInfo_ = derivedInfo_;
@@ -244,8 +245,8 @@ void Stencil::updateFieldsImpl(int startStageIdx, int endStageIdx) {
   }
 }
 
-std::unordered_map<int, Field> Stencil::computeFieldsOnTheFly() const {
-  std::unordered_map<int, Field> fields;
+FieldMap Stencil::computeFieldsOnTheFly() const {
+  FieldMap fields;
 
   for(const auto& mssPtr : children_) {
     for(const auto& fieldPair : mssPtr->computeFieldsOnTheFly()) {
@@ -286,7 +287,7 @@ bool Stencil::compareDerivedInfo() const {
   auto fieldsOnTheFly = computeFieldsOnTheFly();
 
   bool equal = true;
-  for(auto it : derivedInfo_.fields_) {
+  for(auto it : getFields()) {
     const int accessID = it.first;
     const FieldInfo& fieldInfo = it.second;
     const Field& field = fieldInfo.field;
@@ -481,7 +482,7 @@ Stencil::Lifetime Stencil::getLifetime(const int AccessID) const {
         for(const auto& stmt : doMethod.getAST().getStatements()) {
           const Accesses& accesses = *stmt->getData<IIRStmtData>().CallerAccesses;
 
-          auto processAccessMap = [&](const std::unordered_map<int, Extents>& accessMap) {
+          auto processAccessMap = [&](const AccessMap& accessMap) {
             if(!accessMap.count(AccessID))
               return;
 
@@ -197,7 +197,7 @@ public:
   bool hasGlobalVariables() const;
 
   /// @brief returns true if the accessid is used within the stencil
-  bool hasFieldAccessID(const int accessID) const { return derivedInfo_.fields_.count(accessID); }
+  bool hasFieldAccessID(const int accessID) const { return getFields().count(accessID); }
 
   /// @brief Get the enclosing interval of accesses of temporaries used in this stencil
   std::optional<Interval> getEnclosingIntervalTemporaries() const;
@@ -284,14 +284,17 @@ public:
   void accept(ast::ASTVisitorNonConst& visitor) const;
 
   /// @brief Get the pair <AccessID, field> for the fields used within the multi-stage
-  const std::unordered_map<int, FieldInfo>& getFields() const { return derivedInfo_.fields_; }
+  const std::unordered_map<int, FieldInfo>& getFields() const {
+    ensureDerivedInfo();
+    return derivedInfo_.fields_;
+  }
 
   /// @brief Get the pair <AccessID, field> for the fields used within the multi-stage
   std::map<int, FieldInfo> getOrderedFields() const {
-    return support::orderMap(derivedInfo_.fields_);
+    return support::orderMap(getFields());
   }
 
-  std::unordered_map<int, Field> computeFieldsOnTheFly() const;
+  FieldMap computeFieldsOnTheFly() const;
 
   /// @brief update the derived info from children
   virtual void updateFromChildren() override;
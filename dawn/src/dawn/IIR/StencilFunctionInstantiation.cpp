@@ -378,9 +378,9 @@ void StencilFunctionInstantiation::update() {
   //        +----------> | InputOutput | <----------+
   //                     +-------------+
   //
-  std::unordered_map<int, Field> inputOutputFields;
-  std::unordered_map<int, Field> inputFields;
-  std::unordered_map<int, Field> outputFields;
+  FieldMap inputOutputFields;
+  FieldMap inputFields;
+  FieldMap outputFields;
 
   for(const auto& stmt : doMethod_->getAST().getStatements()) {
     const auto& access = stmt->getData<IIRStmtData>().CallerAccesses;
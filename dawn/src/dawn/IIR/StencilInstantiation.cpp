@@ -28,7 +28,10 @@
 #include "dawn/Support/RemoveIf.hpp"
 #include <fstream>
 #include <functional>
+#include <set>
 #include <string>
+#include <unordered_set>
+#include <vector>
 
 namespace dawn {
 namespace iir {
@@ -37,6 +40,28 @@ namespace iir {
 //     StencilInstantiation
 //===------------------------------------------------------------------------------------------===//
 
+void StencilInstantiation::StageExtentIndex::insert(int stageID, StageInfo info) {
+  erase(stageID);
+  for(const FieldAccess& field : info.Fields) {
+    Consumers[field.AccessID].insert(stageID);
+    if(field.Written)
+      Producers[field.AccessID].insert(stageID);
+  }
+  Stages.emplace(stageID, std::move(info));
+}
+
+void StencilInstantiation::StageExtentIndex::erase(int stageID) {
+  auto stageIt = Stages.find(stageID);
+  if(stageIt == Stages.end())
+    return;
+  for(const FieldAccess& field : stageIt->second.Fields) {
+    Consumers[field.AccessID].erase(stageID);
+    if(field.Written)
+      Producers[field.AccessID].erase(stageID);
+  }
+  Stages.erase(stageIt);
+}
+
 StencilInstantiation::StencilInstantiation(
     ast::GridType const gridType, std::shared_ptr<ast::GlobalVariableMap> globalVariables,
     std::vector<std::shared_ptr<sir::StencilFunction>> const& stencilFunctions)
@@ -302,73 +327,156 @@ void StencilInstantiation::reportAccesses(std::ostream& os) const {
 }
 
 void StencilInstantiation::computeDerivedInfo() {
-  // Update doMethod node types
-  for(const auto& doMethod : iterateIIROver<iir::DoMethod>(*(this->getIIR()))) {
-    doMethod->update(iir::NodeUpdateType::levelAndTreeAbove);
+  // Update doMethod node types, the ancestors are recomputed once at the end of the scope
+  {
+    iir::DeferredUpdateScope deferredUpdate;
+    for(const auto& doMethod : iterateIIROver<iir::DoMethod>(*(this->getIIR()))) {
+      doMethod->update(iir::NodeUpdateType::levelAndTreeAbove);
+    }
   }
 
   // Compute stage extents
+  std::unordered_set<int> stencilIDs;
   for(const auto& stencilPtr : this->getStencils()) {
     iir::Stencil& stencil = *stencilPtr;
+    stencilIDs.insert(stencil.getStencilID());
+    StageExtentIndex& index = stageExtentIndices_[stencil.getStencilID()];
+
+    std::vector<iir::Stage*> stages;
+    std::vector<int> stageIDs;
+    std::unordered_map<int, int> positions; // stage ID -> position in execution order
+    bool uniqueIDs = true;
+    for(const auto& stage : iterateIIROver<iir::Stage>(stencil)) {
+      uniqueIDs &= positions.emplace(stage->getStageID(), stages.size()).second;
+      stages.push_back(stage.get());
+      stageIDs.push_back(stage->getStageID());
+    }
+    // Clones keep the ID of a stage, the stages are then identified by (negative) positions, which
+    // recomputes all of them now and on the next call
+    if(!uniqueIDs) {
+      positions.clear();
+      for(std::size_t i = 0; i < stages.size(); ++i) {
+        stageIDs[i] = -static_cast<int>(i) - 1;
+        positions.emplace(stageIDs[i], i);
+      }
+    }
 
-    int numStages = stencil.getNumStages();
-
-    // backward loop over stages
-    for(int i = numStages - 1; i >= 0; --i) {
-      iir::Stage& fromStage = *(stencil.getStage(i));
+    // Removed stages do not constrain the extents anymore, reordered stages change the producers
+    // preceding every stage
+    bool reordered = false;
+    int lastPosition = -1;
+    for(int stageID : index.StageIDs) {
+      auto positionIt = positions.find(stageID);
+      if(positionIt == positions.end()) {
+        index.erase(stageID);
+        continue;
+      }
+      reordered |= positionIt->second < lastPosition;
+      lastPosition = positionIt->second;
+    }
+    index.StageIDs = stageIDs;
+
+    // The stages which are new or whose accesses, extents or iteration space changed
+    std::vector<bool> dirty(stages.size(), false);
+    std::vector<bool> hasIterationSpace(stages.size(), false);
+    for(std::size_t i = 0; i < stages.size(); ++i) {
+      StageExtentIndex::StageInfo info;
+      for(const auto& fieldPair : stages[i]->getFields())
+        info.Fields.push_back(StageExtentIndex::FieldAccess{
+            fieldPair.first, fieldPair.second.getIntend() != iir::Field::IntendKind::Input,
+            fieldPair.second.getExtents()});
+      info.StageExtents = stages[i]->getExtents();
       // If the stage has a global iterationspace set, we should never extend it since it is user
       // defined where this computation should happen
-      if(std::any_of(fromStage.getIterationSpace().cbegin(), fromStage.getIterationSpace().cend(),
-                     [](const auto& p) { return p.has_value(); })) {
-        fromStage.setExtents(iir::Extents());
-        continue;
+      info.HasIterationSpace =
+          std::any_of(stages[i]->getIterationSpace().cbegin(),
+                      stages[i]->getIterationSpace().cend(),
+                      [](const auto& p) { return p.has_value(); });
+      hasIterationSpace[i] = info.HasIterationSpace;
+
+      auto stageIt = index.Stages.find(stageIDs[i]);
+      if(reordered || stageIt == index.Stages.end() || stageIt->second != info) {
+        index.insert(stageIDs[i], std::move(info));
+        dirty[i] = true;
       }
+      if(hasIterationSpace[i])
+        stages[i]->setExtents(iir::Extents());
+    }
 
-      iir::Extents const& stageExtent = fromStage.getExtents();
-
-      // loop over all the input fields read in fromStage
-      for(const auto& fromFieldPair : fromStage.getFields()) {
-
-        const iir::Field& fromField = fromFieldPair.second;
-        auto&& fromFieldExtents = fromField.getExtents();
-
-        // notice that IO (if read happens before write) would also be a valid pattern
-        // to trigger the propagation of the stage extents, however this is not a legal
-        // pattern within a stage
-        // ===-----------------------------------------------------------------------------------===
-        //      Point one [ExtentComputationTODO]
-        // ===-----------------------------------------------------------------------------------===
+    // add the (read) extent of a field in `consumer` as an extent of the stage `producer`, returns
+    // true if the extent of `producer` grew
+    auto propagate = [&](int producer, int consumer, const iir::Field& field) {
+      // notice that IO (if read happens before write) would also be a valid pattern
+      // to trigger the propagation of the stage extents, however this is not a legal
+      // pattern within a stage
+      // ===-------------------------------------------------------------------------------------===
+      //      Point one [ExtentComputationTODO]
+      // ===-------------------------------------------------------------------------------------===
+      iir::Extents ext = stages[producer]->getExtents();
+      ext.merge(field.getExtents() + stages[consumer]->getExtents());
+      // this pass is computing the redundant computation in the horizontal, therefore we
+      // nullify the vertical component of the stage
+      ext.resetVerticalExtent();
+      if(ext == stages[producer]->getExtents())
+        return false;
+      stages[producer]->setExtents(ext);
+      return true;
+    };
+
+    // A modified stage may write fields accessed by unmodified later stages, which do not
+    // propagate their extents again
+    std::set<int, std::greater<int>> worklist;
+    for(int i = 0; i < static_cast<int>(stages.size()); ++i) {
+      if(!dirty[i])
+        continue;
+      worklist.insert(i);
+      if(hasIterationSpace[i])
+        continue;
+      for(const auto& fieldPair : stages[i]->getFields()) {
+        if(fieldPair.second.getIntend() == iir::Field::IntendKind::Input)
+          continue;
+        for(int consumerID : index.Consumers.at(fieldPair.first)) {
+          const int consumer = positions.at(consumerID);
+          if(consumer > i && !dirty[consumer] && !hasIterationSpace[consumer])
+            propagate(i, consumer, stages[consumer]->getFields().at(fieldPair.first));
+        }
+      }
+    }
 
-        iir::Extents fieldExtent = fromFieldExtents + stageExtent;
+    // Propagate backward from the latest stage in the worklist: the extent of a stage is final
+    // once all the (later) stages reading its outputs have been visited. Stages are only added
+    // for earlier stages, each stage is therefore visited at most once.
+    while(!worklist.empty()) {
+      const int i = *worklist.begin();
+      worklist.erase(worklist.begin());
+      if(hasIterationSpace[i])
+        continue;
 
-        // check which (previous) stage computes the field (read in fromStage)
-        for(int j = i - 1; j >= 0; --j) {
-          iir::Stage& toStage = *(stencil.getStage(j));
+      // loop over all the fields accessed in the stage and their producers
+      for(const auto& fieldPair : stages[i]->getFields()) {
+        auto producersIt = index.Producers.find(fieldPair.first);
+        if(producersIt == index.Producers.end())
+          continue;
+        for(int producerID : producersIt->second) {
+          const int producer = positions.at(producerID);
           // ===---------------------------------------------------------------------------------===
           //      Point two [ExtentComputationTODO]
           // ===---------------------------------------------------------------------------------===
-          auto fields = toStage.getFields();
-          auto it = std::find_if(fields.begin(), fields.end(),
-                                 [&](std::pair<int, iir::Field> const& pair) {
-                                   const auto& f = pair.second;
-                                   return (f.getIntend() != iir::Field::IntendKind::Input) &&
-                                          (f.getAccessID() == fromField.getAccessID());
-                                 });
-          if(it == fields.end())
-            continue;
-
-          // if found, add the (read) extent of the field as an extent of the stage
-          iir::Extents ext = toStage.getExtents();
-          ext.merge(fieldExtent);
-          // this pass is computing the redundant computation in the horizontal, therefore we
-          // nullify the vertical component of the stage
-          ext.resetVerticalExtent();
-          toStage.setExtents(ext);
+          if(producer < i && !hasIterationSpace[producer] &&
+             propagate(producer, i, fieldPair.second))
+            worklist.insert(producer);
         }
       }
     }
+
+    for(std::size_t i = 0; i < stages.size(); ++i)
+      index.Stages.at(stageIDs[i]).StageExtents = stages[i]->getExtents();
   }
 
+  for(auto it = stageExtentIndices_.begin(); it != stageExtentIndices_.end();)
+    it = stencilIDs.count(it->first) ? std::next(it) : stageExtentIndices_.erase(it);
+
+  iir::DeferredUpdateScope deferredUpdate;
   for(const auto& MS : iterateIIROver<iir::MultiStage>(*(this->getIIR()))) {
     MS->update(iir::NodeUpdateType::levelAndTreeAbove);
   }
@@ -27,6 +27,8 @@
 #include <set>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 namespace dawn {
 namespace iir {
@@ -39,6 +41,47 @@ class StencilInstantiation : NonCopyable {
   StencilMetaInformation metadata_;
   std::unique_ptr<IIR> IIR_;
 
+  /// @brief Accesses of the stages of a stencil as of the last stage-extent computation
+  ///
+  /// Stages are identified by their ID. The producers of a field are the stages writing it, its
+  /// consumers all the stages accessing it.
+  struct StageExtentIndex {
+    struct FieldAccess {
+      int AccessID;
+      bool Written;
+      Extents FieldExtents;
+
+      bool operator==(const FieldAccess& other) const {
+        return AccessID == other.AccessID && Written == other.Written &&
+               FieldExtents == other.FieldExtents;
+      }
+    };
+    struct StageInfo {
+      std::vector<FieldAccess> Fields;
+      Extents StageExtents;
+      bool HasIterationSpace = false;
+
+      bool operator==(const StageInfo& other) const {
+        return Fields == other.Fields && StageExtents == other.StageExtents &&
+               HasIterationSpace == other.HasIterationSpace;
+      }
+      bool operator!=(const StageInfo& other) const { return !(*this == other); }
+    };
+
+    /// @brief Replace the accesses of the stage `stageID`
+    void insert(int stageID, StageInfo info);
+    void erase(int stageID);
+
+    std::vector<int> StageIDs; // in execution order
+    std::unordered_map<int, StageInfo> Stages;
+    std::unordered_map<int, std::unordered_set<int>> Producers;
+    std::unordered_map<int, std::unordered_set<int>> Consumers;
+  };
+
+  /// Indices of the stencils (by ID), the extents are only propagated from the stages modified
+  /// since the last call to `computeDerivedInfo`
+  std::unordered_map<int, StageExtentIndex> stageExtentIndices_;
+
 public:
   /// @brief Dump the StencilInstantiation to stdout
   void dump(std::ostream& os) const;
@@ -120,6 +163,9 @@ public:
   /// node types and stage extents (associated to redundant computations)
   /// The method processes the stages of each multi-stage from the instantiation and
   /// stores the computation in the `Extent` member of the Stage (@see Stage)
+  ///
+  /// The extents are propagated from the stages whose accesses, extents or iteration space changed
+  /// since the last call (and from all stages if stages were reordered).
   void computeDerivedInfo();
 };
 } // namespace iir
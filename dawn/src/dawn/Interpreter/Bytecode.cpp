@@ -0,0 +1,577 @@
+//===--------------------------------------------------------------------------------*- C++ -*-===//
+//                          _
+//                         | |
+//                       __| | __ ___      ___ ___
+//                      / _` |/ _` \ \ /\ / / '_  |
+//                     | (_| | (_| |\ V  V /| | | |
+//                      \__,_|\__,_| \_/\_/ |_| |_| - Compiler Toolchain
+//
+//
+//  This file is distributed under the MIT License (MIT).
+//  See LICENSE.txt for details.
+//
+//===------------------------------------------------------------------------------------------===//
+
+#include "dawn/Interpreter/Bytecode.h"
+#include "dawn/AST/ASTVisitor.h"
+#include "dawn/AST/Offsets.h"
+#include "dawn/IIR/ASTExpr.h"
+#include "dawn/IIR/ASTStmt.h"
+#include "dawn/IIR/DoMethod.h"
+#include "dawn/IIR/StencilMetaInformation.h"
+#include "dawn/Support/Casting.h"
+#include "dawn/Support/Exception.h"
+#include "dawn/Support/Unreachable.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <optional>
+#include <sstream>
+
+namespace dawn {
+namespace interpreter {
+
+int SlotTable::getFieldSlot(int accessID) {
+  auto it = fieldSlots_.find(accessID);
+  if(it != fieldSlots_.end())
+    return it->second;
+  int slot = fieldAccessIDs_.size();
+  fieldSlots_.emplace(accessID, slot);
+  fieldAccessIDs_.push_back(accessID);
+  maxVerticalShift_.push_back(0);
+  return slot;
+}
+
+int SlotTable::getGlobalSlot(int accessID) {
+  auto it = globalSlots_.find(accessID);
+  if(it != globalSlots_.end())
+    return it->second;
+  int slot = globalAccessIDs_.size();
+  globalSlots_.emplace(accessID, slot);
+  globalAccessIDs_.push_back(accessID);
+  return slot;
+}
+
+int SlotTable::getChainSlot(const ast::UnstructuredIterationSpace& iterSpace) {
+  auto it = std::find(chains_.begin(), chains_.end(), iterSpace);
+  if(it != chains_.end())
+    return std::distance(chains_.begin(), it);
+  chains_.push_back(iterSpace);
+  return chains_.size() - 1;
+}
+
+void SlotTable::registerVerticalShift(int slot, int shift) {
+  maxVerticalShift_[slot] = std::max(maxVerticalShift_[slot], std::abs(shift));
+}
+
+namespace {
+
+std::optional<MathFn> getMathFn(const std::string& callee) {
+  // Math functions are usually fully qualified (e.g `gridtools::dawn::math::sqrt`)
+  auto pos = callee.rfind("::");
+  std::string name = pos == std::string::npos ? callee : callee.substr(pos + 2);
+
+  static const std::unordered_map<std::string, MathFn> functions = {
+      {"sqrt", MathFn::Sqrt},   {"fabs", MathFn::Fabs},         {"abs", MathFn::Fabs},
+      {"floor", MathFn::Floor}, {"ceil", MathFn::Ceil},         {"trunc", MathFn::Trunc},
+      {"exp", MathFn::Exp},     {"log", MathFn::Log},           {"sin", MathFn::Sin},
+      {"cos", MathFn::Cos},     {"tan", MathFn::Tan},           {"asin", MathFn::Asin},
+      {"acos", MathFn::Acos},   {"atan", MathFn::Atan},         {"isnan", MathFn::IsNan},
+      {"isinf", MathFn::IsInf}, {"isfinite", MathFn::IsFinite}, {"pow", MathFn::Pow},
+      {"fmod", MathFn::Fmod},   {"min", MathFn::Min},           {"max", MathFn::Max}};
+  auto it = functions.find(name);
+  if(it == functions.end())
+    return std::nullopt;
+  return it->second;
+}
+
+int getArity(MathFn fn) {
+  switch(fn) {
+  case MathFn::Pow:
+  case MathFn::Fmod:
+  case MathFn::Min:
+  case MathFn::Max:
+    return 2;
+  default:
+    return 1;
+  }
+}
+
+std::optional<OpCode> getBinaryOpCode(const std::string& op) {
+  static const std::unordered_map<std::string, OpCode> ops = {
+      {"+", OpCode::Add}, {"-", OpCode::Sub},  {"*", OpCode::Mul},  {"/", OpCode::Div},
+      {"%", OpCode::Mod}, {"==", OpCode::Eq},  {"!=", OpCode::Ne},  {"<", OpCode::Lt},
+      {"<=", OpCode::Le}, {">", OpCode::Gt},   {">=", OpCode::Ge},  {"&&", OpCode::And},
+      {"||", OpCode::Or}};
+  auto it = ops.find(op);
+  if(it == ops.end())
+    return std::nullopt;
+  return it->second;
+}
+
+bool isIntegral(BuiltinTypeID type) {
+  return type == BuiltinTypeID::Integer || type == BuiltinTypeID::Boolean;
+}
+
+/// @brief Translates the AST of a do-method into register based bytecode
+class BytecodeCompiler : public ast::ASTVisitorNonConst {
+  const iir::StencilMetaInformation& metadata_;
+  const ast::GridType gridType_;
+  SlotTable& slots_;
+  Program program_;
+
+  /// Register holding the value of the last visited expression
+  int result_ = -1;
+
+  /// Registers holding local variables (AccessID -> register)
+  std::unordered_map<int, int> locals_;
+  std::unordered_map<int, bool> localIsIntegral_;
+
+  /// Neighbor iteration we are currently in (reduction or loop statement)
+  std::optional<ast::UnstructuredIterationSpace> chain_;
+  bool inReduction_ = false;
+
+public:
+  BytecodeCompiler(const iir::StencilMetaInformation& metadata, ast::GridType gridType,
+                   SlotTable& slots)
+      : metadata_(metadata), gridType_(gridType), slots_(slots) {}
+
+  Program getProgram() { return std::move(program_); }
+
+  /// @name Statements
+  /// @{
+  void visit(const std::shared_ptr<ast::BlockStmt>& stmt) override {
+    for(const auto& s : stmt->getStatements())
+      s->accept(*this);
+  }
+
+  void visit(const std::shared_ptr<ast::ExprStmt>& stmt) override {
+    stmt->getExpr()->accept(*this);
+  }
+
+  void visit(const std::shared_ptr<ast::ReturnStmt>& stmt) override {
+    unsupported("return statements", stmt->getSourceLocation());
+  }
+
+  void visit(const std::shared_ptr<ast::VarDeclStmt>& stmt) override {
+    if(stmt->isArray())
+      unsupported("local arrays", stmt->getSourceLocation());
+
+    const int accessID = iir::getAccessID(stmt);
+    const int reg = newRegister();
+    locals_[accessID] = reg;
+    localIsIntegral_[accessID] = isIntegral(stmt->getType().getBuiltinTypeID());
+
+    if(stmt->hasInit()) {
+      stmt->getInitList().front()->accept(*this);
+      storeLocal(accessID, result_);
+    }
+  }
+
+  void visit(const std::shared_ptr<ast::VerticalRegionDeclStmt>& stmt) override {
+    unsupported("vertical region declarations", stmt->getSourceLocation());
+  }
+
+  void visit(const std::shared_ptr<ast::StencilCallDeclStmt>& stmt) override {
+    unsupported("stencil calls inside do-methods", stmt->getSourceLocation());
+  }
+
+  void visit(const std::shared_ptr<ast::BoundaryConditionDeclStmt>& stmt) override {
+    unsupported("boundary conditions", stmt->getSourceLocation());
+  }
+
+  void visit(const std::shared_ptr<ast::IfStmt>& stmt) override {
+    stmt->getCondExpr()->accept(*this);
+    program_.HasMasks = true;
+    emit({OpCode::PushMask, -1, result_});
+    stmt->getThenStmt()->accept(*this);
+    if(stmt->hasElse()) {
+      emit({OpCode::FlipMask});
+      stmt->getElseStmt()->accept(*this);
+    }
+    emit({OpCode::PopMask});
+  }
+
+  void visit(const std::shared_ptr<ast::LoopStmt>& stmt) override {
+    auto const* descr =
+        dynamic_cast<const ast::ChainIterationDescr*>(stmt->getIterationDescrPtr());
+    if(!descr)
+      unsupported("loops which do not iterate over a neighbor chain", stmt->getSourceLocation());
+
+    std::size_t begin = beginNeighborLoop(descr->getIterSpace(), false, stmt->getSourceLocation());
+    stmt->getBlockStmt()->accept(*this);
+    endNeighborLoop(begin);
+  }
+  /// @}
+
+  /// @name Expressions
+  /// @{
+  void visit(const std::shared_ptr<ast::ReductionOverNeighborExpr>& expr) override {
+    // The initial value and the weights are evaluated in the enclosing context
+    expr->getInit()->accept(*this);
+    const int acc = newRegister();
+    emit({OpCode::Move, acc, result_});
+
+    int firstWeight = -1;
+    if(expr->hasWeights()) {
+      std::vector<int> weights;
+      for(const auto& weight : *expr->getWeights()) {
+        weight->accept(*this);
+        weights.push_back(result_);
+      }
+      // Weights need to be in consecutive registers to be indexed by the neighbor index
+      firstWeight = program_.NumRegisters;
+      for(int w : weights)
+        emit({OpCode::Move, newRegister(), w});
+    }
+
+    std::size_t begin = beginNeighborLoop(expr->getIterSpace(), true, expr->getSourceLocation());
+
+    expr->getRhs()->accept(*this);
+    int value = result_;
+    if(firstWeight != -1) {
+      const int weight = newRegister();
+      emit({OpCode::Weight, weight, firstWeight});
+      value = binary(OpCode::Mul, weight, value);
+    }
+
+    int reduced;
+    if(expr->isArithmetic()) {
+      reduced = binary(*getBinaryOpCode(expr->getOp()), acc, value);
+    } else {
+      auto fn = getMathFn(expr->getOp());
+      if(!fn || getArity(*fn) != 2)
+        unsupported("reduction operator '" + expr->getOp() + "'", expr->getSourceLocation());
+      reduced = call(*fn, acc, value);
+    }
+    emit({OpCode::Move, acc, reduced});
+
+    endNeighborLoop(begin);
+    result_ = acc;
+  }
+
+  void visit(const std::shared_ptr<ast::UnaryOperator>& expr) override {
+    expr->getOperand()->accept(*this);
+    const std::string& op = expr->getOp();
+    if(op == "+")
+      return;
+    if(op != "-" && op != "!")
+      unsupported("unary operator '" + op + "'", expr->getSourceLocation());
+    const int dst = newRegister();
+    emit({op == "-" ? OpCode::Neg : OpCode::Not, dst, result_});
+    result_ = dst;
+  }
+
+  void visit(const std::shared_ptr<ast::BinaryOperator>& expr) override {
+    auto opCode = getBinaryOpCode(expr->getOp());
+    if(!opCode)
+      unsupported("binary operator '" + expr->getOp() + "'", expr->getSourceLocation());
+    expr->getLeft()->accept(*this);
+    const int lhs = result_;
+    expr->getRight()->accept(*this);
+    result_ = binary(*opCode, lhs, result_);
+  }
+
+  void visit(const std::shared_ptr<ast::AssignmentExpr>& expr) override {
+    expr->getRight()->accept(*this);
+    int value = result_;
+
+    const std::string& op = expr->getOp();
+    if(op != "=") {
+      auto opCode = getBinaryOpCode(op.substr(0, op.size() - 1));
+      if(!opCode)
+        unsupported("assignment operator '" + op + "'", expr->getSourceLocation());
+      expr->getLeft()->accept(*this);
+      value = binary(*opCode, result_, value);
+    }
+
+    if(auto field = dyn_pointer_cast<ast::FieldAccessExpr>(expr->getLeft())) {
+      Instruction store = fieldAccess(OpCode::Store, field);
+      store.A = value;
+      emit(store);
+    } else if(auto var = dyn_pointer_cast<ast::VarAccessExpr>(expr->getLeft())) {
+      const int accessID = iir::getAccessID(var);
+      if(!locals_.count(accessID))
+        unsupported("assignments to global variables", expr->getSourceLocation());
+      storeLocal(accessID, value);
+    } else {
+      unsupported("assignments to non-lvalues", expr->getSourceLocation());
+    }
+    result_ = value;
+  }
+
+  void visit(const std::shared_ptr<ast::TernaryOperator>& expr) override {
+    expr->getCondition()->accept(*this);
+    const int cond = result_;
+    expr->getLeft()->accept(*this);
+    const int lhs = result_;
+    expr->getRight()->accept(*this);
+    const int dst = newRegister();
+    emit({OpCode::Select, dst, cond, lhs, result_});
+    result_ = dst;
+  }
+
+  void visit(const std::shared_ptr<ast::FunCallExpr>& expr) override {
+    auto fn = getMathFn(expr->getCallee());
+    const auto& args = expr->getArguments();
+    if(!fn || getArity(*fn) != static_cast<int>(args.size()))
+      unsupported("function '" + expr->getCallee() + "'", expr->getSourceLocation());
+
+    args[0]->accept(*this);
+    const int a = result_;
+    int b = -1;
+    if(args.size() == 2) {
+      args[1]->accept(*this);
+      b = result_;
+    }
+    result_ = call(*fn, a, b);
+  }
+
+  void visit(const std::shared_ptr<ast::StencilFunCallExpr>& expr) override {
+    unsupported("stencil function calls (run the inlining pass group first)",
+                expr->getSourceLocation());
+  }
+
+  void visit(const std::shared_ptr<ast::StencilFunArgExpr>& expr) override {
+    unsupported("stencil function arguments", expr->getSourceLocation());
+  }
+
+  void visit(const std::shared_ptr<ast::VarAccessExpr>& expr) override {
+    if(expr->isArrayAccess())
+      unsupported("array accesses", expr->getSourceLocation());
+
+    const int accessID = iir::getAccessID(expr);
+    auto it = locals_.find(accessID);
+    if(it != locals_.end()) {
+      result_ = it->second;
+      return;
+    }
+    if(!metadata_.isAccessType(iir::FieldAccessType::GlobalVariable, accessID))
+      unsupported("access to undeclared variable '" + expr->getName() + "'",
+                  expr->getSourceLocation());
+
+    Instruction load{OpCode::Global, newRegister()};
+    load.Slot = slots_.getGlobalSlot(accessID);
+    emit(load);
+    result_ = load.Dst;
+  }
+
+  void visit(const std::shared_ptr<ast::FieldAccessExpr>& expr) override {
+    Instruction load = fieldAccess(OpCode::Load, expr);
+    load.Dst = newRegister();
+    emit(load);
+    result_ = load.Dst;
+  }
+
+  void visit(const std::shared_ptr<ast::LiteralAccessExpr>& expr) override {
+    Instruction load{OpCode::Const, newRegister()};
+    const std::string& value = expr->getValue();
+    if(value == "true")
+      load.Value = 1.0;
+    else if(value == "false")
+      load.Value = 0.0;
+    else
+      load.Value = std::strtod(value.c_str(), nullptr);
+    emit(load);
+    result_ = load.Dst;
+  }
+  /// @}
+
+private:
+  [[noreturn]] void unsupported(const std::string& what, SourceLocation loc) const {
+    throw SemanticError("interpreter: " + what + " are not supported", metadata_.getFileName(),
+                        loc);
+  }
+
+  int newRegister() { return program_.NumRegisters++; }
+
+  std::size_t emit(const Instruction& instruction) {
+    program_.Code.push_back(instruction);
+    return program_.Code.size() - 1;
+  }
+
+  int binary(OpCode op, int lhs, int rhs) {
+    const int dst = newRegister();
+    emit({op, dst, lhs, rhs});
+    return dst;
+  }
+
+  int call(MathFn fn, int a, int b) {
+    Instruction instr{OpCode::Call, newRegister(), a, b};
+    instr.Fn = fn;
+    emit(instr);
+    return instr.Dst;
+  }
+
+  void storeLocal(int accessID, int value) {
+    if(localIsIntegral_[accessID]) {
+      const int truncated = newRegister();
+      emit({OpCode::Trunc, truncated, value});
+      value = truncated;
+    }
+    emit({OpCode::Move, locals_.at(accessID), value});
+  }
+
+  std::size_t beginNeighborLoop(const ast::UnstructuredIterationSpace& iterSpace, bool isReduction,
+                                SourceLocation loc) {
+    if(gridType_ != ast::GridType::Unstructured)
+      unsupported("neighbor iterations on Cartesian grids", loc);
+    if(chain_)
+      unsupported("nested neighbor iterations", loc);
+    chain_ = iterSpace;
+    inReduction_ = isReduction;
+    program_.HasMasks = true;
+
+    Instruction begin{OpCode::NbhBegin};
+    begin.Slot = slots_.getChainSlot(iterSpace);
+    return emit(begin);
+  }
+
+  void endNeighborLoop(std::size_t begin) {
+    Instruction next{OpCode::NbhNext};
+    next.Target = begin + 1;
+    program_.Code[begin].Target = emit(next) + 1;
+    chain_.reset();
+    inReduction_ = false;
+  }
+
+  Instruction fieldAccess(OpCode op, const std::shared_ptr<ast::FieldAccessExpr>& expr) {
+    const ast::Offsets& offset = expr->getOffset();
+    if(offset.hasVerticalIndirection())
+      unsupported("vertical indirections", expr->getSourceLocation());
+    if(expr->hasArguments())
+      unsupported("field accesses with stencil function arguments", expr->getSourceLocation());
+
+    const int accessID = iir::getAccessID(expr);
+    Instruction instr{op};
+    instr.Slot = slots_.getFieldSlot(accessID);
+    instr.Offset[2] = offset.verticalShift();
+    slots_.registerVerticalShift(instr.Slot, offset.verticalShift());
+
+    if(gridType_ == ast::GridType::Cartesian) {
+      auto const& hOffset = ast::offset_cast<ast::CartesianOffset const&>(offset.horizontalOffset());
+      instr.Offset[0] = hOffset.offsetI();
+      instr.Offset[1] = hOffset.offsetJ();
+      return instr;
+    }
+
+    auto dims = metadata_.getFieldDimensions(accessID);
+    if(dims.isVertical())
+      return instr;
+
+    auto const& hDims = ast::dimension_cast<ast::UnstructuredFieldDimension const&>(
+        dims.getHorizontalFieldDimension());
+    const bool hasOffset =
+        ast::offset_cast<ast::UnstructuredOffset const&>(offset.horizontalOffset()).hasOffset();
+
+    if(hDims.isSparse()) {
+      if(!chain_)
+        unsupported("sparse field accesses outside of neighbor iterations",
+                    expr->getSourceLocation());
+      instr.Mode = AccessMode::Sparse;
+    } else if(chain_ && (hasOffset || (inReduction_ &&
+                                       hDims.getDenseLocationType() != chain_->Chain.front()))) {
+      instr.Mode = AccessMode::Neighbor;
+    }
+    return instr;
+  }
+};
+
+const char* toString(OpCode op) {
+  switch(op) {
+  case OpCode::Const:
+    return "const";
+  case OpCode::Global:
+    return "global";
+  case OpCode::Load:
+    return "load";
+  case OpCode::Store:
+    return "store";
+  case OpCode::Move:
+    return "move";
+  case OpCode::Trunc:
+    return "trunc";
+  case OpCode::Neg:
+    return "neg";
+  case OpCode::Not:
+    return "not";
+  case OpCode::Add:
+    return "add";
+  case OpCode::Sub:
+    return "sub";
+  case OpCode::Mul:
+    return "mul";
+  case OpCode::Div:
+    return "div";
+  case OpCode::Mod:
+    return "mod";
+  case OpCode::Eq:
+    return "eq";
+  case OpCode::Ne:
+    return "ne";
+  case OpCode::Lt:
+    return "lt";
+  case OpCode::Le:
+    return "le";
+  case OpCode::Gt:
+    return "gt";
+  case OpCode::Ge:
+    return "ge";
+  case OpCode::And:
+    return "and";
+  case OpCode::Or:
+    return "or";
+  case OpCode::Select:
+    return "select";
+  case OpCode::Call:
+    return "call";
+  case OpCode::PushMask:
+    return "pushmask";
+  case OpCode::FlipMask:
+    return "flipmask";
+  case OpCode::PopMask:
+    return "popmask";
+  case OpCode::NbhBegin:
+    return "nbhbegin";
+  case OpCode::NbhNext:
+    return "nbhnext";
+  case OpCode::Weight:
+    return "weight";
+  }
+  dawn_unreachable("invalid opcode");
+}
+
+} // namespace
+
+Program compile(const iir::DoMethod& doMethod, const iir::StencilMetaInformation& metadata,
+                ast::GridType gridType, SlotTable& slots) {
+  BytecodeCompiler compiler(metadata, gridType, slots);
+  for(const auto& stmt : doMethod.getAST().getStatements())
+    stmt->accept(compiler);
+  return compiler.getProgram();
+}
+
+std::string toString(const Program& program) {
+  std::stringstream ss;
+  for(std::size_t pc = 0; pc < program.Code.size(); ++pc) {
+    const Instruction& instr = program.Code[pc];
+    ss << pc << ": " << toString(instr.Op);
+    for(int reg : {instr.Dst, instr.A, instr.B, instr.C})
+      if(reg != -1)
+        ss << " r" << reg;
+    if(instr.Slot != -1)
+      ss << " slot=" << instr.Slot;
+    if(instr.Op == OpCode::Load || instr.Op == OpCode::Store)
+      ss << " offset=[" << instr.Offset[0] << "," << instr.Offset[1] << "," << instr.Offset[2]
+         << "] mode=" << static_cast<int>(instr.Mode);
+    if(instr.Op == OpCode::Const)
+      ss << " " << instr.Value;
+    if(instr.Target != -1)
+      ss << " -> " << instr.Target;
+    ss << "\n";
+  }
+  return ss.str();
+}
+
+} // namespace interpreter
+} // namespace dawn
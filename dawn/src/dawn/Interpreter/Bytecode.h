@@ -0,0 +1,173 @@
+//===--------------------------------------------------------------------------------*- C++ -*-===//
+//                          _
+//                         | |
+//                       __| | __ ___      ___ ___
+//                      / _` |/ _` \ \ /\ / / '_  |
+//                     | (_| | (_| |\ V  V /| | | |
+//                      \__,_|\__,_| \_/\_/ |_| |_| - Compiler Toolchain
+//
+//
+//  This file is distributed under the MIT License (MIT).
+//  See LICENSE.txt for details.
+//
+//===------------------------------------------------------------------------------------------===//
+
+#pragma once
+
+#include "dawn/AST/GridType.h"
+#include "dawn/AST/IterationSpace.h"
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace dawn {
+namespace iir {
+class DoMethod;
+class StencilMetaInformation;
+} // namespace iir
+
+namespace interpreter {
+
+/// @brief Operation codes of the interpreter bytecode
+///
+/// Every register holds one value per lane of the block being evaluated, i.e. a run of consecutive
+/// `i` at fixed `(j,k)` on Cartesian grids or a run of mesh elements at fixed `k` on unstructured
+/// grids. Instructions are applied to all lanes at once; side effects (`Store`, `Move`) only touch
+/// the lanes enabled by the current mask.
+///
+/// @ingroup interpreter
+enum class OpCode : std::uint8_t {
+  Const,    ///< Dst <- Value
+  Global,   ///< Dst <- globals[Slot]
+  Load,     ///< Dst <- fields[Slot](Offset, Mode)
+  Store,    ///< fields[Slot](Offset, Mode) <- A (masked)
+  Move,     ///< Dst <- A (masked)
+  Trunc,    ///< Dst <- int(A)
+  Neg,      ///< Dst <- -A
+  Not,      ///< Dst <- !A
+  Add,      ///< Dst <- A + B
+  Sub,      ///< Dst <- A - B
+  Mul,      ///< Dst <- A * B
+  Div,      ///< Dst <- A / B
+  Mod,      ///< Dst <- int(A) % int(B)
+  Eq,       ///< Dst <- A == B
+  Ne,       ///< Dst <- A != B
+  Lt,       ///< Dst <- A < B
+  Le,       ///< Dst <- A <= B
+  Gt,       ///< Dst <- A > B
+  Ge,       ///< Dst <- A >= B
+  And,      ///< Dst <- A && B
+  Or,       ///< Dst <- A || B
+  Select,   ///< Dst <- A ? B : C
+  Call,     ///< Dst <- Fn(A[, B])
+  PushMask, ///< mask <- mask && A
+  FlipMask, ///< mask <- parent mask && !mask (else branch)
+  PopMask,  ///< restore the parent mask
+  NbhBegin, ///< start iterating the neighbors of chain Slot, jump to Target if there are none
+  NbhNext,  ///< advance to the next neighbor, jump back to Target while neighbors remain
+  Weight,   ///< Dst <- register (A + index of the current neighbor)
+};
+
+/// @brief Math functions understood by `OpCode::Call`
+/// @ingroup interpreter
+enum class MathFn : std::uint8_t {
+  Sqrt,
+  Fabs,
+  Floor,
+  Ceil,
+  Trunc,
+  Exp,
+  Log,
+  Sin,
+  Cos,
+  Tan,
+  Asin,
+  Acos,
+  Atan,
+  IsNan,
+  IsInf,
+  IsFinite,
+  Pow,
+  Fmod,
+  Min,
+  Max
+};
+
+/// @brief How a field access is resolved relative to the lane's location
+///
+/// On Cartesian grids all accesses are `Center` accesses shifted by `Instruction::Offset`. On
+/// unstructured grids, inside a neighbor iteration, accesses either refer to the lane's element,
+/// to the current neighbor or to the sparse entry of the current neighbor.
+/// @ingroup interpreter
+enum class AccessMode : std::uint8_t { Center, Neighbor, Sparse };
+
+/// @brief A single bytecode instruction
+/// @ingroup interpreter
+struct Instruction {
+  OpCode Op;
+  int Dst = -1;
+  int A = -1;
+  int B = -1;
+  int C = -1;
+  int Slot = -1;
+  int Target = -1;
+  std::array<int, 3> Offset{{0, 0, 0}};
+  AccessMode Mode = AccessMode::Center;
+  MathFn Fn = MathFn::Sqrt;
+  double Value = 0.0;
+};
+
+/// @brief Bytecode of a single `DoMethod`
+/// @ingroup interpreter
+struct Program {
+  std::vector<Instruction> Code;
+  int NumRegisters = 0;
+  bool HasMasks = false;
+};
+
+/// @brief Maps the AccessIDs and neighbor chains referenced by the programs to dense slots
+///
+/// Slots are shared by all programs of a stencil instantiation such that storages and neighbor
+/// tables can be bound once per run.
+/// @ingroup interpreter
+class SlotTable {
+public:
+  int getFieldSlot(int accessID);
+  int getGlobalSlot(int accessID);
+  int getChainSlot(const ast::UnstructuredIterationSpace& iterSpace);
+
+  const std::vector<int>& getFieldAccessIDs() const { return fieldAccessIDs_; }
+  const std::vector<int>& getGlobalAccessIDs() const { return globalAccessIDs_; }
+  const std::vector<ast::UnstructuredIterationSpace>& getChains() const { return chains_; }
+
+  /// @brief Largest vertical offset (in absolute value) used to access a field slot
+  int getMaxVerticalShift(int slot) const { return maxVerticalShift_[slot]; }
+  void registerVerticalShift(int slot, int shift);
+
+private:
+  std::unordered_map<int, int> fieldSlots_;
+  std::vector<int> fieldAccessIDs_;
+  std::vector<int> maxVerticalShift_;
+  std::unordered_map<int, int> globalSlots_;
+  std::vector<int> globalAccessIDs_;
+  std::vector<ast::UnstructuredIterationSpace> chains_;
+};
+
+/// @brief Compile the statements of `doMethod` into bytecode
+///
+/// Throws a `SemanticError` if the AST contains constructs the interpreter can not evaluate, e.g.
+/// stencil function calls (run `PassGroup::Inlining` first), local arrays, vertical indirections or
+/// nested neighbor iterations.
+/// @ingroup interpreter
+Program compile(const iir::DoMethod& doMethod, const iir::StencilMetaInformation& metadata,
+                ast::GridType gridType, SlotTable& slots);
+
+/// @brief Human readable listing of a program (for debugging)
+/// @ingroup interpreter
+std::string toString(const Program& program);
+
+} // namespace interpreter
+} // namespace dawn
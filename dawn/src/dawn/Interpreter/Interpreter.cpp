@@ -0,0 +1,692 @@
+//===--------------------------------------------------------------------------------*- C++ -*-===//
+//                          _
+//                         | |
+//                       __| | __ ___      ___ ___
+//                      / _` |/ _` \ \ /\ / / '_  |
+//                     | (_| | (_| |\ V  V /| | | |
+//                      \__,_|\__,_| \_/\_/ |_| |_| - Compiler Toolchain
+//
+//
+//  This file is distributed under the MIT License (MIT).
+//  See LICENSE.txt for details.
+//
+//===------------------------------------------------------------------------------------------===//
+
+#include "dawn/Interpreter/Interpreter.h"
+#include "dawn/AST/FieldDimension.h"
+#include "dawn/IIR/ASTStmt.h"
+#include "dawn/IIR/IIRNodeIterator.h"
+#include "dawn/IIR/StencilMetaInformation.h"
+#include "dawn/Support/Casting.h"
+#include "dawn/Support/Exception.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <sstream>
+
+namespace dawn {
+namespace interpreter {
+
+namespace {
+
+/// @brief Storage of a field slot as seen by the executor
+struct BoundField {
+  double* Data = nullptr;
+  std::array<long, 3> Strides{{0, 0, 0}};
+};
+
+/// @brief Neighbors of all elements of a chain, padded with -1 to `MaxNeighbors` entries
+struct NeighborTable {
+  int MaxNeighbors = 0;
+  std::vector<int> Ids;
+};
+
+/// @brief Position of the lanes of a block
+struct Lanes {
+  int Count = 0;
+  int K = 0;
+  // Cartesian: the lanes are `i = I, ..., I + Count - 1` at fixed `J`
+  int I = 0;
+  int J = 0;
+  // Unstructured: the lanes are the elements `Elements[0], ..., Elements[Count - 1]`
+  const int* Elements = nullptr;
+};
+
+double applyMath(MathFn fn, double a, double b) {
+  switch(fn) {
+  case MathFn::Sqrt:
+    return std::sqrt(a);
+  case MathFn::Fabs:
+    return std::fabs(a);
+  case MathFn::Floor:
+    return std::floor(a);
+  case MathFn::Ceil:
+    return std::ceil(a);
+  case MathFn::Trunc:
+    return std::trunc(a);
+  case MathFn::Exp:
+    return std::exp(a);
+  case MathFn::Log:
+    return std::log(a);
+  case MathFn::Sin:
+    return std::sin(a);
+  case MathFn::Cos:
+    return std::cos(a);
+  case MathFn::Tan:
+    return std::tan(a);
+  case MathFn::Asin:
+    return std::asin(a);
+  case MathFn::Acos:
+    return std::acos(a);
+  case MathFn::Atan:
+    return std::atan(a);
+  case MathFn::IsNan:
+    return std::isnan(a);
+  case MathFn::IsInf:
+    return std::isinf(a);
+  case MathFn::IsFinite:
+    return std::isfinite(a);
+  case MathFn::Pow:
+    return std::pow(a, b);
+  case MathFn::Fmod:
+    return std::fmod(a, b);
+  case MathFn::Min:
+    return std::min(a, b);
+  case MathFn::Max:
+    return std::max(a, b);
+  }
+  dawn_unreachable("invalid math function");
+}
+
+/// @brief Evaluates programs on blocks of lanes
+class Executor {
+  const int width_;
+  const ast::GridType gridType_;
+  const std::vector<BoundField>& fields_;
+  const std::vector<double>& globals_;
+  const std::vector<NeighborTable>& tables_;
+
+  std::vector<double> registers_;
+  std::vector<std::vector<char>> masks_;
+  int maskDepth_ = 0;
+
+  // Current neighbor iteration
+  const NeighborTable* table_ = nullptr;
+  int neighbor_ = 0;
+
+public:
+  Executor(int width, ast::GridType gridType, const std::vector<BoundField>& fields,
+           const std::vector<double>& globals, const std::vector<NeighborTable>& tables)
+      : width_(width), gridType_(gridType), fields_(fields), globals_(globals), tables_(tables) {}
+
+  void run(const Program& program, const Lanes& lanes) {
+    const int n = lanes.Count;
+    registers_.assign(program.NumRegisters * width_, 0.0);
+    maskDepth_ = 0;
+    table_ = nullptr;
+
+    const auto& code = program.Code;
+    for(std::size_t pc = 0; pc < code.size(); ++pc) {
+      const Instruction& instr = code[pc];
+      double* dst = instr.Dst != -1 ? reg(instr.Dst) : nullptr;
+      const double* a = instr.A != -1 ? reg(instr.A) : nullptr;
+      const double* b = instr.B != -1 ? reg(instr.B) : nullptr;
+      const char* mask = maskDepth_ > 0 ? masks_[maskDepth_ - 1].data() : nullptr;
+
+      switch(instr.Op) {
+      case OpCode::Const:
+        std::fill(dst, dst + n, instr.Value);
+        break;
+      case OpCode::Global:
+        std::fill(dst, dst + n, globals_[instr.Slot]);
+        break;
+      case OpCode::Load:
+        load(instr, lanes, dst);
+        break;
+      case OpCode::Store:
+        store(instr, lanes, a, mask);
+        break;
+      case OpCode::Move:
+        for(int l = 0; l < n; ++l)
+          if(!mask || mask[l])
+            dst[l] = a[l];
+        break;
+      case OpCode::Trunc:
+        for(int l = 0; l < n; ++l)
+          dst[l] = static_cast<int>(a[l]);
+        break;
+      case OpCode::Neg:
+        for(int l = 0; l < n; ++l)
+          dst[l] = -a[l];
+        break;
+      case OpCode::Not:
+        for(int l = 0; l < n; ++l)
+          dst[l] = !a[l];
+        break;
+#define DAWN_INTERPRETER_BINARY(opcode, expression)                                                \
+  case OpCode::opcode:                                                                             \
+    for(int l = 0; l < n; ++l)                                                                     \
+      dst[l] = expression;                                                                         \
+    break;
+        DAWN_INTERPRETER_BINARY(Add, a[l] + b[l])
+        DAWN_INTERPRETER_BINARY(Sub, a[l] - b[l])
+        DAWN_INTERPRETER_BINARY(Mul, a[l] * b[l])
+        DAWN_INTERPRETER_BINARY(Div, a[l] / b[l])
+        DAWN_INTERPRETER_BINARY(Eq, a[l] == b[l])
+        DAWN_INTERPRETER_BINARY(Ne, a[l] != b[l])
+        DAWN_INTERPRETER_BINARY(Lt, a[l] < b[l])
+        DAWN_INTERPRETER_BINARY(Le, a[l] <= b[l])
+        DAWN_INTERPRETER_BINARY(Gt, a[l] > b[l])
+        DAWN_INTERPRETER_BINARY(Ge, a[l] >= b[l])
+        DAWN_INTERPRETER_BINARY(And, a[l] && b[l])
+        DAWN_INTERPRETER_BINARY(Or, a[l] || b[l])
+#undef DAWN_INTERPRETER_BINARY
+      case OpCode::Mod:
+        for(int l = 0; l < n; ++l) {
+          const int divisor = static_cast<int>(b[l]);
+          dst[l] = divisor != 0 ? static_cast<int>(a[l]) % divisor : 0;
+        }
+        break;
+      case OpCode::Select: {
+        const double* c = reg(instr.C);
+        for(int l = 0; l < n; ++l)
+          dst[l] = a[l] ? b[l] : c[l];
+        break;
+      }
+      case OpCode::Call:
+        for(int l = 0; l < n; ++l)
+          dst[l] = applyMath(instr.Fn, a[l], b ? b[l] : 0.0);
+        break;
+      case OpCode::PushMask: {
+        char* top = pushMask();
+        for(int l = 0; l < n; ++l)
+          top[l] = (!mask || mask[l]) && a[l] != 0.0;
+        break;
+      }
+      case OpCode::FlipMask: {
+        char* top = masks_[maskDepth_ - 1].data();
+        const char* parent = maskDepth_ > 1 ? masks_[maskDepth_ - 2].data() : nullptr;
+        for(int l = 0; l < n; ++l)
+          top[l] = (!parent || parent[l]) && !top[l];
+        break;
+      }
+      case OpCode::PopMask:
+        --maskDepth_;
+        break;
+      case OpCode::NbhBegin:
+        table_ = &tables_[instr.Slot];
+        neighbor_ = 0;
+        if(table_->MaxNeighbors == 0) {
+          table_ = nullptr;
+          pc = instr.Target - 1;
+        } else {
+          pushNeighborMask(lanes, mask);
+        }
+        break;
+      case OpCode::NbhNext:
+        --maskDepth_;
+        if(++neighbor_ < table_->MaxNeighbors) {
+          pushNeighborMask(lanes, maskDepth_ > 0 ? masks_[maskDepth_ - 1].data() : nullptr);
+          pc = instr.Target - 1;
+        } else {
+          table_ = nullptr;
+        }
+        break;
+      case OpCode::Weight: {
+        const double* weight = reg(instr.A + neighbor_);
+        std::copy(weight, weight + n, dst);
+        break;
+      }
+      }
+    }
+  }
+
+private:
+  double* reg(int r) { return registers_.data() + r * width_; }
+
+  char* pushMask() {
+    if(maskDepth_ == static_cast<int>(masks_.size()))
+      masks_.emplace_back(width_);
+    return masks_[maskDepth_++].data();
+  }
+
+  void pushNeighborMask(const Lanes& lanes, const char* parent) {
+    char* top = pushMask();
+    for(int l = 0; l < lanes.Count; ++l)
+      top[l] = (!parent || parent[l]) && neighborOf(lanes.Elements[l]) >= 0;
+  }
+
+  int neighborOf(int element) const {
+    return table_->Ids[element * table_->MaxNeighbors + neighbor_];
+  }
+
+  /// @brief Offset of the entry accessed by lane `l`, or -1 if the lane has no such entry
+  long index(const Instruction& instr, const BoundField& field, const Lanes& lanes, int l) const {
+    const auto& s = field.Strides;
+    if(gridType_ == ast::GridType::Cartesian)
+      return (lanes.I + l + instr.Offset[0]) * s[0] + (lanes.J + instr.Offset[1]) * s[1] +
+             (lanes.K + instr.Offset[2]) * s[2];
+
+    const long k = (lanes.K + instr.Offset[2]) * s[2];
+    const int element = lanes.Elements[l];
+    switch(instr.Mode) {
+    case AccessMode::Center:
+      return element * s[0] + k;
+    case AccessMode::Neighbor: {
+      const int neighbor = neighborOf(element);
+      return neighbor < 0 ? -1 : neighbor * s[0] + k;
+    }
+    case AccessMode::Sparse:
+      return neighborOf(element) < 0 ? -1 : element * s[0] + neighbor_ * s[1] + k;
+    }
+    dawn_unreachable("invalid access mode");
+  }
+
+  void load(const Instruction& instr, const Lanes& lanes, double* dst) const {
+    const BoundField& field = fields_[instr.Slot];
+    if(gridType_ == ast::GridType::Cartesian) {
+      const double* base = field.Data + index(instr, field, lanes, 0);
+      const long stride = field.Strides[0];
+      for(int l = 0; l < lanes.Count; ++l)
+        dst[l] = base[l * stride];
+      return;
+    }
+    for(int l = 0; l < lanes.Count; ++l) {
+      const long idx = index(instr, field, lanes, l);
+      dst[l] = idx < 0 ? 0.0 : field.Data[idx];
+    }
+  }
+
+  void store(const Instruction& instr, const Lanes& lanes, const double* value,
+             const char* mask) const {
+    const BoundField& field = fields_[instr.Slot];
+    for(int l = 0; l < lanes.Count; ++l) {
+      if(mask && !mask[l])
+        continue;
+      const long idx = index(instr, field, lanes, l);
+      if(idx >= 0)
+        field.Data[idx] = value[l];
+    }
+  }
+};
+
+/// @brief Bound of a vertical interval, follows the conventions of the naive C++ backends
+int getKBound(const iir::Interval& interval, iir::Interval::Bound bound, int kMin, int kMax) {
+  if(interval.levelIsEnd(bound))
+    return kMax + interval.offset(bound);
+  return kMin + interval.level(bound) + interval.offset(bound);
+}
+
+/// @brief Bound of a horizontal iteration space, follows `makeIntervalBoundExplicit`
+int getIterationSpaceBound(const iir::Interval& interval, iir::Interval::Bound bound, int minus,
+                           int size, int plus) {
+  if(interval.levelIsEnd(bound))
+    return size - plus + interval.offset(bound);
+  return minus + interval.level(bound) + interval.offset(bound);
+}
+
+const iir::Stencil& getStencil(const iir::StencilInstantiation& instantiation,
+                               const std::shared_ptr<ast::Stmt>& stmt) {
+  auto call = dyn_pointer_cast<ast::StencilCallDeclStmt>(stmt);
+  if(!call)
+    throw SemanticError("interpreter: only stencil calls are supported in the control flow",
+                        instantiation.getMetaData().getFileName(), stmt->getSourceLocation());
+  const int stencilID = instantiation.getMetaData().getStencilIDFromStencilCallStmt(call);
+  for(const auto& stencil : instantiation.getStencils())
+    if(stencil->getStencilID() == stencilID)
+      return *stencil;
+  throw LogicError("interpreter: no stencil with ID " + std::to_string(stencilID));
+}
+
+/// @brief Dimensions `(i, j, k)` of a field on a Cartesian grid
+std::array<bool, 3> getCartesianDimensions(const iir::StencilMetaInformation& metadata,
+                                           int accessID) {
+  const auto dims = metadata.getFieldDimensions(accessID);
+  std::array<bool, 3> mask{{false, false, dims.K()}};
+  if(!dims.isVertical()) {
+    auto const& hDims = ast::dimension_cast<ast::CartesianFieldDimension const&>(
+        dims.getHorizontalFieldDimension());
+    mask[0] = hDims.I();
+    mask[1] = hDims.J();
+  }
+  return mask;
+}
+
+/// @brief Throws if a stencil accesses fields outside of the halos of `domain`
+///
+/// The storages (and temporaries) span `[0, Size)`, the stages are evaluated on the compute domain
+/// grown by their extents and read with the offsets of their accesses.
+void checkHalos(const iir::StencilInstantiation& instantiation, const CartesianDomain& domain) {
+  const auto& metadata = instantiation.getMetaData();
+  for(const auto& stencil : instantiation.getStencils()) {
+    for(const auto& [accessID, fieldInfo] : stencil->getFields()) {
+      auto const& extent = iir::extent_cast<iir::CartesianExtent const&>(
+          fieldInfo.field.getExtentsRB().horizontalExtent());
+      const std::array<int, 2> minus{{-extent.iMinus(), -extent.jMinus()}};
+      const std::array<int, 2> plus{{extent.iPlus(), extent.jPlus()}};
+      for(int d = 0; d < 2; ++d)
+        if(minus[d] > domain.Minus[d] || plus[d] > domain.Plus[d])
+          throw LogicError("interpreter: field '" + metadata.getFieldNameFromAccessID(accessID) +
+                           "' is accessed with a halo of (" + std::to_string(minus[d]) + ", " +
+                           std::to_string(plus[d]) + ") in dimension " + std::to_string(d) +
+                           ", the domain only has (" + std::to_string(domain.Minus[d]) + ", " +
+                           std::to_string(domain.Plus[d]) + ")");
+    }
+  }
+}
+
+/// @brief Vertical intervals of a multi-stage, in execution order
+std::vector<iir::Interval> getPartition(const iir::MultiStage& multiStage) {
+  auto intervals = multiStage.getIntervals();
+  auto partition = iir::Interval::computePartition(
+      std::vector<iir::Interval>(intervals.begin(), intervals.end()));
+  if(multiStage.getLoopOrder() == iir::LoopOrderKind::Backward)
+    std::reverse(partition.begin(), partition.end());
+  return partition;
+}
+
+/// @brief Evaluate `body(k)` for all levels of `[lower, upper]` in the order of `multiStage`
+template <class Body>
+void forEachLevel(const iir::MultiStage& multiStage, int lower, int upper, Body&& body) {
+  if(multiStage.getLoopOrder() == iir::LoopOrderKind::Backward) {
+    for(int k = upper; k >= lower; --k)
+      body(k);
+  } else {
+    for(int k = lower; k <= upper; ++k)
+      body(k);
+  }
+}
+
+} // namespace
+
+Interpreter::Interpreter(const std::shared_ptr<iir::StencilInstantiation>& stencilInstantiation,
+                         int blockSize)
+    : stencilInstantiation_(stencilInstantiation), blockSize_(blockSize) {
+  DAWN_ASSERT_MSG(blockSize_ > 0, "block size must be positive");
+  const auto& metadata = stencilInstantiation_->getMetaData();
+  const auto gridType = stencilInstantiation_->getIIR()->getGridType();
+  for(const auto& doMethod : iterateIIROver<iir::DoMethod>(*stencilInstantiation_->getIIR()))
+    programs_.emplace(doMethod.get(), compile(*doMethod, metadata, gridType, slots_));
+
+  for(const auto& [name, global] : stencilInstantiation_->getIIR()->getGlobalVariableMap()) {
+    if(!global.has_value())
+      continue;
+    switch(global.getType()) {
+    case ast::Value::Kind::Boolean:
+      globalValues_[name] = global.getValue<bool>();
+      break;
+    case ast::Value::Kind::Integer:
+      globalValues_[name] = global.getValue<int>();
+      break;
+    case ast::Value::Kind::Float:
+      globalValues_[name] = global.getValue<float>();
+      break;
+    case ast::Value::Kind::Double:
+      globalValues_[name] = global.getValue<double>();
+      break;
+    case ast::Value::Kind::String:
+      break;
+    }
+  }
+}
+
+std::vector<std::string> Interpreter::getFieldNames() const {
+  const auto& metadata = stencilInstantiation_->getMetaData();
+  std::vector<std::string> names;
+  for(int accessID : metadata.getAPIFields())
+    names.push_back(metadata.getFieldNameFromAccessID(accessID));
+  return names;
+}
+
+std::array<bool, 3> Interpreter::getFieldDimensions(const std::string& name) const {
+  const auto& metadata = stencilInstantiation_->getMetaData();
+  if(stencilInstantiation_->getIIR()->getGridType() != ast::GridType::Cartesian)
+    throw LogicError("interpreter: stencil '" + metadata.getStencilName() +
+                     "' requires an unstructured mesh");
+  for(int accessID : metadata.getAPIFields())
+    if(metadata.getFieldNameFromAccessID(accessID) == name)
+      return getCartesianDimensions(metadata, accessID);
+  throw LogicError("interpreter: stencil '" + metadata.getStencilName() + "' has no field '" +
+                   name + "'");
+}
+
+void Interpreter::setGlobal(const std::string& name, double value) { globalValues_[name] = value; }
+
+std::string Interpreter::toString() const {
+  std::stringstream ss;
+  for(const auto& doMethod : iterateIIROver<iir::DoMethod>(*stencilInstantiation_->getIIR())) {
+    ss << "DoMethod " << doMethod->getID() << " " << doMethod->getInterval() << ":\n"
+       << interpreter::toString(programs_.at(doMethod.get()));
+  }
+  return ss.str();
+}
+
+void Interpreter::run(const CartesianDomain& domain,
+                      const std::map<std::string, FieldView>& fields) {
+  const auto& metadata = stencilInstantiation_->getMetaData();
+  if(stencilInstantiation_->getIIR()->getGridType() != ast::GridType::Cartesian)
+    throw LogicError("interpreter: stencil '" + metadata.getStencilName() +
+                     "' requires an unstructured mesh");
+  checkHalos(*stencilInstantiation_, domain);
+
+  // Bind the storages
+  std::vector<BoundField> bound(slots_.getFieldAccessIDs().size());
+  std::vector<std::vector<double>> temporaries;
+  for(std::size_t slot = 0; slot < bound.size(); ++slot) {
+    const int accessID = slots_.getFieldAccessIDs()[slot];
+    const auto& name = metadata.getFieldNameFromAccessID(accessID);
+    const auto mask = getCartesianDimensions(metadata, accessID);
+
+    BoundField& field = bound[slot];
+    if(metadata.isAccessType(iir::FieldAccessType::APIField, accessID)) {
+      auto it = fields.find(name);
+      if(it == fields.end() || !it->second.Data)
+        throw LogicError("interpreter: no storage bound to field '" + name + "'");
+      field.Data = it->second.Data;
+      for(int d = 0; d < 3; ++d)
+        field.Strides[d] = mask[d] ? it->second.Strides[d] : 0;
+    } else {
+      // Temporaries are padded in `k` by the largest vertical offset they are accessed with
+      const int pad = slots_.getMaxVerticalShift(slot);
+      std::array<long, 3> sizes{{mask[0] ? domain.Size[0] : 1, mask[1] ? domain.Size[1] : 1,
+                                 mask[2] ? domain.Size[2] + 2 * pad : 1}};
+      temporaries.emplace_back(sizes[0] * sizes[1] * sizes[2], 0.0);
+      field.Strides = {mask[0] ? 1 : 0, mask[1] ? sizes[0] : 0, mask[2] ? sizes[0] * sizes[1] : 0};
+      field.Data = temporaries.back().data() + pad * field.Strides[2];
+    }
+  }
+
+  std::vector<double> globals;
+  for(int accessID : slots_.getGlobalAccessIDs())
+    globals.push_back(globalValues_[metadata.getNameFromAccessID(accessID)]);
+
+  const std::vector<NeighborTable> tables;
+  Executor executor(blockSize_, ast::GridType::Cartesian, bound, globals, tables);
+
+  const int iMin = domain.Minus[0], iMax = domain.Size[0] - domain.Plus[0] - 1;
+  const int jMin = domain.Minus[1], jMax = domain.Size[1] - domain.Plus[1] - 1;
+  const int kMin = domain.Minus[2], kMax = domain.Size[2] - domain.Plus[2] - 1;
+
+  for(const auto& stmt : stencilInstantiation_->getIIR()->getControlFlowDescriptor().getStatements()) {
+    const iir::Stencil& stencil = getStencil(*stencilInstantiation_, stmt);
+    for(const auto& multiStage : stencil.getChildren()) {
+      for(const auto& interval : getPartition(*multiStage)) {
+        const int kLower = getKBound(interval, iir::Interval::Bound::lower, kMin, kMax);
+        const int kUpper = getKBound(interval, iir::Interval::Bound::upper, kMin, kMax);
+        forEachLevel(*multiStage, kLower, kUpper, [&](int k) {
+          for(const auto& stage : multiStage->getChildren()) {
+            auto const& extents = iir::extent_cast<iir::CartesianExtent const&>(
+                stage->getExtents().horizontalExtent());
+            int iLower = iMin + extents.iMinus(), iUpper = iMax + extents.iPlus();
+            int jLower = jMin + extents.jMinus(), jUpper = jMax + extents.jPlus();
+
+            // Restrict the loops to the iteration space of the stage (single rank)
+            const auto& iterationSpace = stage->getIterationSpace();
+            if(iterationSpace[0]) {
+              iLower = std::max(iLower, getIterationSpaceBound(*iterationSpace[0],
+                                                               iir::Interval::Bound::lower,
+                                                               domain.Minus[0], domain.Size[0],
+                                                               domain.Plus[0]));
+              iUpper = std::min(iUpper, getIterationSpaceBound(*iterationSpace[0],
+                                                               iir::Interval::Bound::upper,
+                                                               domain.Minus[0], domain.Size[0],
+                                                               domain.Plus[0]) -
+                                            1);
+            }
+            if(iterationSpace[1]) {
+              jLower = std::max(jLower, getIterationSpaceBound(*iterationSpace[1],
+                                                               iir::Interval::Bound::lower,
+                                                               domain.Minus[1], domain.Size[1],
+                                                               domain.Plus[1]));
+              jUpper = std::min(jUpper, getIterationSpaceBound(*iterationSpace[1],
+                                                               iir::Interval::Bound::upper,
+                                                               domain.Minus[1], domain.Size[1],
+                                                               domain.Plus[1]) -
+                                            1);
+            }
+
+            for(const auto& doMethod : stage->getChildren()) {
+              if(!doMethod->getInterval().overlaps(interval))
+                continue;
+              const Program& program = programs_.at(doMethod.get());
+              Lanes lanes;
+              lanes.K = k;
+              for(int j = jLower; j <= jUpper; ++j) {
+                lanes.J = j;
+                for(int i = iLower; i <= iUpper; i += blockSize_) {
+                  lanes.I = i;
+                  lanes.Count = std::min(blockSize_, iUpper - i + 1);
+                  executor.run(program, lanes);
+                }
+              }
+            }
+          }
+        });
+      }
+    }
+  }
+}
+
+void Interpreter::run(const UnstructuredMesh& mesh, int kSize,
+                      const std::map<std::string, FieldView>& fields) {
+  const auto& metadata = stencilInstantiation_->getMetaData();
+  if(stencilInstantiation_->getIIR()->getGridType() != ast::GridType::Unstructured)
+    throw LogicError("interpreter: stencil '" + metadata.getStencilName() +
+                     "' requires a Cartesian domain");
+  if(!mesh.Neighbors && !slots_.getChains().empty())
+    throw LogicError("interpreter: the mesh does not provide a neighbor function");
+
+  // Build the padded neighbor tables
+  std::vector<NeighborTable> tables;
+  for(const auto& chain : slots_.getChains()) {
+    const int numElements = mesh.NumElements[static_cast<int>(chain.Chain.front())];
+    std::vector<std::vector<int>> neighbors(numElements);
+    NeighborTable table;
+    for(int element = 0; element < numElements; ++element) {
+      neighbors[element] = mesh.Neighbors(chain, element);
+      table.MaxNeighbors = std::max<int>(table.MaxNeighbors, neighbors[element].size());
+    }
+    table.Ids.assign(numElements * table.MaxNeighbors, -1);
+    for(int element = 0; element < numElements; ++element)
+      std::copy(neighbors[element].begin(), neighbors[element].end(),
+                table.Ids.begin() + element * table.MaxNeighbors);
+    tables.push_back(std::move(table));
+  }
+
+  auto getMaxNeighbors = [&](const ast::UnstructuredIterationSpace& iterSpace) {
+    auto it = std::find(slots_.getChains().begin(), slots_.getChains().end(), iterSpace);
+    return it == slots_.getChains().end()
+               ? 0
+               : tables[std::distance(slots_.getChains().begin(), it)].MaxNeighbors;
+  };
+
+  // Bind the storages
+  std::vector<BoundField> bound(slots_.getFieldAccessIDs().size());
+  std::vector<std::vector<double>> temporaries;
+  for(std::size_t slot = 0; slot < bound.size(); ++slot) {
+    const int accessID = slots_.getFieldAccessIDs()[slot];
+    const auto& name = metadata.getFieldNameFromAccessID(accessID);
+    const auto dims = metadata.getFieldDimensions(accessID);
+    std::array<bool, 3> mask{{false, false, dims.K()}};
+    long numElements = 1, numSparse = 1;
+    if(!dims.isVertical()) {
+      auto const& hDims = ast::dimension_cast<ast::UnstructuredFieldDimension const&>(
+          dims.getHorizontalFieldDimension());
+      mask[0] = true;
+      mask[1] = hDims.isSparse();
+      numElements = mesh.NumElements[static_cast<int>(hDims.getDenseLocationType())];
+      if(hDims.isSparse())
+        numSparse = getMaxNeighbors(hDims.getIterSpace());
+    }
+
+    BoundField& field = bound[slot];
+    if(metadata.isAccessType(iir::FieldAccessType::APIField, accessID)) {
+      auto it = fields.find(name);
+      if(it == fields.end() || !it->second.Data)
+        throw LogicError("interpreter: no storage bound to field '" + name + "'");
+      field.Data = it->second.Data;
+      for(int d = 0; d < 3; ++d)
+        field.Strides[d] = mask[d] ? it->second.Strides[d] : 0;
+    } else {
+      const int pad = slots_.getMaxVerticalShift(slot);
+      const long numLevels = mask[2] ? kSize + 2 * pad : 1;
+      temporaries.emplace_back(numElements * numSparse * numLevels, 0.0);
+      field.Strides = {mask[0] ? numSparse : 0, mask[1] ? 1 : 0,
+                       mask[2] ? numElements * numSparse : 0};
+      field.Data = temporaries.back().data() + pad * field.Strides[2];
+    }
+  }
+
+  std::vector<double> globals;
+  for(int accessID : slots_.getGlobalAccessIDs())
+    globals.push_back(globalValues_[metadata.getNameFromAccessID(accessID)]);
+
+  Executor executor(blockSize_, ast::GridType::Unstructured, bound, globals, tables);
+
+  // Elements each location type iterates over
+  std::array<std::vector<int>, 3> elements = mesh.Elements;
+  for(int loc = 0; loc < 3; ++loc) {
+    if(elements[loc].empty()) {
+      elements[loc].resize(mesh.NumElements[loc]);
+      std::iota(elements[loc].begin(), elements[loc].end(), 0);
+    }
+  }
+
+  for(const auto& stmt : stencilInstantiation_->getIIR()->getControlFlowDescriptor().getStatements()) {
+    const iir::Stencil& stencil = getStencil(*stencilInstantiation_, stmt);
+    for(const auto& multiStage : stencil.getChildren()) {
+      for(const auto& interval : getPartition(*multiStage)) {
+        // Same bounds as the naive unstructured backend: `[lower, upper)`
+        const int kLower = getKBound(interval, iir::Interval::Bound::lower, 0, kSize);
+        const int kUpper = getKBound(interval, iir::Interval::Bound::upper, 0, kSize) - 1;
+        forEachLevel(*multiStage, kLower, kUpper, [&](int k) {
+          for(const auto& stage : multiStage->getChildren()) {
+            DAWN_ASSERT_MSG(stage->getLocationType().has_value(),
+                            "Stage must have a location type");
+            if(stage->getUnstructuredIterationSpace())
+              throw SemanticError("interpreter: unstructured iteration spaces are not supported",
+                                  metadata.getFileName());
+            const auto& stageElements = elements[static_cast<int>(*stage->getLocationType())];
+
+            for(const auto& doMethod : stage->getChildren()) {
+              if(!doMethod->getInterval().overlaps(interval))
+                continue;
+              const Program& program = programs_.at(doMethod.get());
+              Lanes lanes;
+              lanes.K = k;
+              for(std::size_t first = 0; first < stageElements.size(); first += blockSize_) {
+                lanes.Elements = stageElements.data() + first;
+                lanes.Count = std::min<std::size_t>(blockSize_, stageElements.size() - first);
+                executor.run(program, lanes);
+              }
+            }
+          }
+        });
+      }
+    }
+  }
+}
+
+} // namespace interpreter
+} // namespace dawn
@@ -0,0 +1,115 @@
+//===--------------------------------------------------------------------------------*- C++ -*-===//
+//                          _
+//                         | |
+//                       __| | __ ___      ___ ___
+//                      / _` |/ _` \ \ /\ / / '_  |
+//                     | (_| | (_| |\ V  V /| | | |
+//                      \__,_|\__,_| \_/\_/ |_| |_| - Compiler Toolchain
+//
+//
+//  This file is distributed under the MIT License (MIT).
+//  See LICENSE.txt for details.
+//
+//===------------------------------------------------------------------------------------------===//
+
+#pragma once
+
+#include "dawn/AST/IterationSpace.h"
+#include "dawn/IIR/StencilInstantiation.h"
+#include "dawn/Interpreter/Bytecode.h"
+
+#include <array>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace dawn {
+namespace interpreter {
+
+/// @brief Non-owning view of a caller provided storage
+///
+/// The strides are given in number of elements. On Cartesian grids they refer to the `(i,j,k)`
+/// dimensions, on unstructured grids to the `(dense, sparse, k)` dimensions. Strides of dimensions
+/// the field does not have (e.g `k` of a 2D field) are ignored.
+/// @ingroup interpreter
+struct FieldView {
+  double* Data = nullptr;
+  std::array<long, 3> Strides{{0, 0, 0}};
+};
+
+/// @brief Cartesian domain, same convention as `gridtools::dawn::domain`
+///
+/// `Size` includes the halos, the compute domain of dimension `d` is
+/// `[Minus[d], Size[d] - Plus[d])`.
+/// @ingroup interpreter
+struct CartesianDomain {
+  std::array<int, 3> Size{{0, 0, 0}};
+  std::array<int, 3> Minus{{0, 0, 0}};
+  std::array<int, 3> Plus{{0, 0, 0}};
+};
+
+/// @brief Connectivity of an unstructured mesh
+///
+/// Elements are identified by their index into the storages (e.g `toylib::ToylibElement::id()`).
+/// @ingroup interpreter
+struct UnstructuredMesh {
+  /// Number of storage entries per location type (indexed by `ast::LocationType`)
+  std::array<int, 3> NumElements{{0, 0, 0}};
+
+  /// Elements a stage iterates over, per location type. An empty list means all elements.
+  std::array<std::vector<int>, 3> Elements;
+
+  /// Neighbors of `element` (of location type `iterSpace.Chain.front()`) along the chain
+  std::function<std::vector<int>(const ast::UnstructuredIterationSpace& iterSpace, int element)>
+      Neighbors;
+};
+
+/// @brief Evaluates a `StencilInstantiation` without generating code
+///
+/// The do-methods are compiled to bytecode once, at construction. A run then walks the IIR tree in
+/// the same order as the naive C++ backends (stencil calls, multi-stages, interval partitions, `k`,
+/// stages, `j`, `i`) and evaluates the bytecode on blocks of consecutive `i` (Cartesian) or mesh
+/// elements (unstructured), which amortizes the interpretation overhead over the block. All
+/// arithmetic is performed in double precision. Temporaries are allocated internally.
+///
+/// @ingroup interpreter
+class Interpreter {
+public:
+  /// @brief Compile all do-methods of `stencilInstantiation`
+  ///
+  /// @param blockSize  Number of lanes evaluated per bytecode instruction
+  Interpreter(const std::shared_ptr<iir::StencilInstantiation>& stencilInstantiation,
+              int blockSize = 64);
+
+  /// @brief Names of the API fields, in the order of the stencil arguments
+  std::vector<std::string> getFieldNames() const;
+
+  /// @brief Dimensions `(i, j, k)` the API field `name` has on a Cartesian grid
+  std::array<bool, 3> getFieldDimensions(const std::string& name) const;
+
+  /// @brief Override the value of a global variable
+  void setGlobal(const std::string& name, double value);
+
+  /// @brief Run the stencil on a Cartesian grid
+  void run(const CartesianDomain& domain, const std::map<std::string, FieldView>& fields);
+
+  /// @brief Run the stencil on an unstructured mesh with `kSize` vertical levels
+  void run(const UnstructuredMesh& mesh, int kSize,
+           const std::map<std::string, FieldView>& fields);
+
+  /// @brief Bytecode of all do-methods (for debugging)
+  std::string toString() const;
+
+private:
+  std::shared_ptr<iir::StencilInstantiation> stencilInstantiation_;
+  int blockSize_;
+  SlotTable slots_;
+  std::unordered_map<const iir::DoMethod*, Program> programs_;
+  std::map<std::string, double> globalValues_;
+};
+
+} // namespace interpreter
+} // namespace dawn
@@ -0,0 +1,301 @@
+//===--------------------------------------------------------------------------------*- C++ -*-===//
+//                          _
+//                         | |
+//                       __| | __ ___      ___ ___
+//                      / _` |/ _` \ \ /\ / / '_  |
+//                     | (_| | (_| |\ V  V /| | | |
+//                      \__,_|\__,_| \_/\_/ |_| |_| - Compiler Toolchain
+//
+//
+//  This file is distributed under the MIT License (MIT).
+//  See LICENSE.txt for details.
+//
+//===------------------------------------------------------------------------------------------===//
+
+#include "dawn/JIT/JIT.h"
+#include "dawn/CodeGen/Driver.h"
+#include "dawn/Support/Config.h"
+#include "dawn/Support/Exception.h"
+#include "dawn/Support/Logger.h"
+
+#include "dawn/Support/ClangCompat/CompilerInvocation.h"
+#include "dawn/Support/ClangCompat/OrcJIT.h"
+
+#include "clang/Basic/DiagnosticOptions.h"
+#include "clang/Basic/Version.h"
+#include "clang/CodeGen/CodeGenAction.h"
+#include "clang/Driver/Compilation.h"
+#include "clang/Driver/Driver.h"
+#include "clang/Frontend/CompilerInstance.h"
+#include "clang/Frontend/CompilerInvocation.h"
+#include "clang/Frontend/TextDiagnosticPrinter.h"
+#include "clang/Lex/PreprocessorOptions.h"
+#include "llvm/Bitcode/BitcodeReader.h"
+#include "llvm/Bitcode/BitcodeWriter.h"
+#include "llvm/IR/LLVMContext.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Host.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/TargetSelect.h"
+#include "llvm/Support/raw_ostream.h"
+#include "llvm/Support/xxhash.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+
+namespace dawn {
+namespace jit {
+
+namespace {
+
+/// Name of the (in memory) main file
+constexpr const char* InputFileName = "dawn-jit.cpp";
+
+std::string getExecutablePath() {
+  // This just needs to be some symbol in the binary
+  void* mainAddr = (void*)(intptr_t)getExecutablePath;
+  return llvm::sys::fs::getMainExecutable("dawn", mainAddr);
+}
+
+std::string getCachePath(const std::string& cacheDir, std::uint64_t hash) {
+  std::ostringstream fileName;
+  fileName << std::hex << std::setw(16) << std::setfill('0') << hash << ".bc";
+  llvm::SmallString<128> path(cacheDir);
+  llvm::sys::path::append(path, fileName.str());
+  return path.str().str();
+}
+
+std::unique_ptr<llvm::Module> loadBitcode(const std::string& path, llvm::LLVMContext& context) {
+  auto buffer = llvm::MemoryBuffer::getFile(path);
+  if(!buffer)
+    return nullptr;
+  auto module = llvm::parseBitcodeFile(buffer.get()->getMemBufferRef(), context);
+  if(!module) {
+    DAWN_LOG(WARNING) << "Ignoring corrupt JIT cache entry " << path << ": "
+                      << llvm::toString(module.takeError());
+    return nullptr;
+  }
+  return std::move(*module);
+}
+
+void storeBitcode(const std::string& path, const llvm::Module& module) {
+  // Write to a temporary first such that concurrent processes never read a partial file
+  const std::string tmpPath = path + ".tmp";
+  {
+    std::error_code ec;
+    llvm::raw_fd_ostream os(tmpPath, ec, llvm::sys::fs::OF_None);
+    if(ec) {
+      DAWN_LOG(WARNING) << "Cannot write JIT cache entry " << path << ": " << ec.message();
+      return;
+    }
+    llvm::WriteBitcodeToFile(module, os);
+  }
+  if(std::error_code ec = llvm::sys::fs::rename(tmpPath, path))
+    DAWN_LOG(WARNING) << "Cannot write JIT cache entry " << path << ": " << ec.message();
+}
+
+/// Fingerprint (path, size and modification time) of the files below the include directories
+/// (`-I<dir>`) of `arguments`
+std::uint64_t hashHeaders(const std::vector<std::string>& arguments) {
+  std::vector<std::string> entries;
+  for(const auto& arg : arguments) {
+    if(arg.compare(0, 2, "-I") != 0)
+      continue;
+    std::error_code ec;
+    for(llvm::sys::fs::recursive_directory_iterator it(arg.substr(2), ec), end; it != end && !ec;
+        it.increment(ec)) {
+      llvm::sys::fs::file_status status;
+      if(llvm::sys::fs::status(it->path(), status) || !llvm::sys::fs::is_regular_file(status))
+        continue;
+      entries.push_back(
+          it->path() + '\0' + std::to_string(status.getSize()) + '\0' +
+          std::to_string(status.getLastModificationTime().time_since_epoch().count()));
+    }
+  }
+  // the order of the directory entries is not specified
+  std::sort(entries.begin(), entries.end());
+  std::string key;
+  for(const auto& entry : entries) {
+    key += entry;
+    key.push_back('\0');
+  }
+  return llvm::xxHash64(key);
+}
+
+/// Compile `code` to LLVM IR, using the driver to set up the (host) system include paths
+std::unique_ptr<llvm::Module> compileToIR(const std::string& code,
+                                          const std::vector<std::string>& arguments,
+                                          llvm::LLVMContext& context) {
+  std::string diagnosticsMessage;
+  llvm::raw_string_ostream diagnosticsStream(diagnosticsMessage);
+
+  clang::IntrusiveRefCntPtr<clang::DiagnosticOptions> diagnosticOptions =
+      new clang::DiagnosticOptions;
+  auto* diagnosticClient = new clang::TextDiagnosticPrinter(diagnosticsStream, &*diagnosticOptions);
+  clang::IntrusiveRefCntPtr<clang::DiagnosticIDs> diagnosticID(new clang::DiagnosticIDs());
+  clang::DiagnosticsEngine diagnostics(diagnosticID, &*diagnosticOptions, diagnosticClient);
+
+  const std::string executablePath = getExecutablePath();
+  clang::driver::Driver driver(executablePath, llvm::sys::getProcessTriple(), diagnostics);
+  driver.setCheckInputsExist(false);
+
+  llvm::SmallVector<const char*, 16> args{executablePath.c_str()};
+  for(const auto& arg : arguments)
+    args.push_back(arg.c_str());
+  args.push_back("-c");
+  args.push_back(InputFileName);
+
+  std::unique_ptr<clang::driver::Compilation> compilation(driver.BuildCompilation(args));
+  if(!compilation || compilation->getJobs().size() != 1 ||
+     !llvm::isa<clang::driver::Command>(*compilation->getJobs().begin()))
+    throw CompileError("JIT: cannot set up the compilation\n" + diagnosticsStream.str());
+
+  const auto& command = llvm::cast<clang::driver::Command>(*compilation->getJobs().begin());
+  llvm::opt::ArgStringList ccArgs = command.getArguments();
+
+  // See gtclang::createCompilerInstance: the builtin headers are not found relative to our binary
+  ccArgs.push_back("-internal-isystem");
+  ccArgs.push_back(DAWN_CLANG_RESSOURCE_INCLUDE_PATH);
+
+  auto invocation = std::make_shared<clang::CompilerInvocation>();
+  if(!clang_compat::CompilerInvocation::CreateFromArgs(*invocation, ccArgs, diagnostics))
+    throw CompileError("JIT: invalid compiler arguments\n" + diagnosticsStream.str());
+  invocation->getFrontendOpts().DisableFree = false;
+  invocation->getPreprocessorOpts().addRemappedFile(
+      InputFileName, llvm::MemoryBuffer::getMemBufferCopy(code, InputFileName).release());
+
+  clang::CompilerInstance instance;
+  instance.setInvocation(invocation);
+  instance.createDiagnostics(
+      new clang::TextDiagnosticPrinter(diagnosticsStream, &instance.getDiagnosticOpts()), true);
+
+  clang::EmitLLVMOnlyAction action(&context);
+  if(!instance.ExecuteAction(action))
+    throw CompileError("JIT: compilation failed\n" + diagnosticsStream.str(), InputFileName);
+
+  std::unique_ptr<llvm::Module> module = action.takeModule();
+  if(!module)
+    throw CompileError("JIT: no module was generated\n" + diagnosticsStream.str(), InputFileName);
+  return module;
+}
+
+std::unique_ptr<llvm::orc::LLJIT> load(std::unique_ptr<llvm::Module> module,
+                                       std::unique_ptr<llvm::LLVMContext> context) {
+  auto jit = llvm::orc::LLJITBuilder().create();
+  if(!jit)
+    throw LogicError("JIT: cannot create the execution engine: " + llvm::toString(jit.takeError()));
+
+  // Resolve the C/C++ runtime against the symbols of the current process
+  clang_compat::orc::addProcessSymbols(**jit);
+
+  if(auto error = (*jit)->addIRModule(
+         llvm::orc::ThreadSafeModule(std::move(module), std::move(context))))
+    throw LogicError("JIT: cannot load the module: " + llvm::toString(std::move(error)));
+  if(auto error = clang_compat::orc::runInitializers(**jit))
+    throw LogicError("JIT: static initialization failed: " + llvm::toString(std::move(error)));
+  return std::move(*jit);
+}
+
+} // namespace
+
+CompiledModule::CompiledModule(std::uint64_t hash, std::unique_ptr<llvm::orc::LLJIT> jit)
+    : hash_(hash), jit_(std::move(jit)) {}
+
+CompiledModule::~CompiledModule() = default;
+
+void* CompiledModule::getSymbolAddress(const std::string& name) const {
+  auto address = clang_compat::orc::lookup(*jit_, name);
+  if(!address)
+    throw LogicError("JIT: symbol '" + name + "' not found: " + llvm::toString(address.takeError()));
+  return reinterpret_cast<void*>(static_cast<std::uintptr_t>(*address));
+}
+
+JIT::JIT(Options options) : options_(std::move(options)) {
+  llvm::InitializeNativeTarget();
+  llvm::InitializeNativeTargetAsmPrinter();
+
+  if(!options_.CacheDir.empty())
+    if(std::error_code ec = llvm::sys::fs::create_directories(options_.CacheDir))
+      throw LogicError("JIT: cannot create cache directory " + options_.CacheDir + ": " +
+                       ec.message());
+
+  headersHash_ = hashHeaders(getArguments());
+}
+
+JIT::~JIT() = default;
+
+std::vector<std::string> JIT::getArguments() const {
+  // the installed driver-includes, the ones of the source tree if dawn is run from its build tree
+  const std::string driverIncludePath =
+      llvm::sys::fs::is_directory(DAWN_DRIVER_INSTALL_INCLUDE_PATH "/driver-includes")
+          ? DAWN_DRIVER_INSTALL_INCLUDE_PATH
+          : DAWN_DRIVER_INCLUDE_PATH;
+  std::vector<std::string> arguments{"-I" + driverIncludePath};
+  for(const auto& dir : options_.IncludeDirs)
+    arguments.push_back("-I" + dir);
+  for(const auto& define : options_.Defines)
+    arguments.push_back("-D" + define);
+  arguments.insert(arguments.end(), options_.Flags.begin(), options_.Flags.end());
+  return arguments;
+}
+
+std::uint64_t JIT::hash(const std::string& code) const {
+  // The arguments are part of the key, a different include path or flag changes the result
+  std::string key = code;
+  for(const auto& arg : getArguments()) {
+    key.push_back('\0');
+    key += arg;
+  }
+  key.push_back('\0');
+  key += llvm::sys::getProcessTriple();
+  // as do the compiler and the included headers: upgrading dawn, Clang or a library invalidates
+  // the bitcode of the disk cache
+  for(const std::string& version :
+      {std::string(DAWN_FULL_VERSION_STR), std::string(CLANG_VERSION_STRING),
+       std::to_string(headersHash_)}) {
+    key.push_back('\0');
+    key += version;
+  }
+  return llvm::xxHash64(key);
+}
+
+std::shared_ptr<CompiledModule> JIT::compile(const std::string& code) {
+  const std::uint64_t key = hash(code);
+  auto it = cache_.find(key);
+  if(it != cache_.end())
+    return it->second;
+
+  auto context = std::make_unique<llvm::LLVMContext>();
+  std::unique_ptr<llvm::Module> module;
+
+  const std::string cachePath =
+      options_.CacheDir.empty() ? "" : getCachePath(options_.CacheDir, key);
+  if(!cachePath.empty())
+    module = loadBitcode(cachePath, *context);
+
+  if(module) {
+    DAWN_LOG(INFO) << "JIT: loaded " << cachePath << " from cache";
+  } else {
+    module = compileToIR(code, getArguments(), *context);
+    ++numCompiled_;
+    if(!cachePath.empty())
+      storeBitcode(cachePath, *module);
+  }
+
+  auto compiledModule = std::shared_ptr<CompiledModule>(
+      new CompiledModule(key, load(std::move(module), std::move(context))));
+  cache_.emplace(key, compiledModule);
+  return compiledModule;
+}
+
+std::shared_ptr<CompiledModule>
+JIT::compile(const std::unique_ptr<codegen::TranslationUnit>& translationUnit,
+             const std::string& entryPoints) {
+  return compile(codegen::generate(translationUnit) + "\n" + entryPoints);
+}
+
+} // namespace jit
+} // namespace dawn
@@ -0,0 +1,127 @@
+//===--------------------------------------------------------------------------------*- C++ -*-===//
+//                          _
+//                         | |
+//                       __| | __ ___      ___ ___
+//                      / _` |/ _` \ \ /\ / / '_  |
+//                     | (_| | (_| |\ V  V /| | | |
+//                      \__,_|\__,_| \_/\_/ |_| |_| - Compiler Toolchain
+//
+//
+//  This file is distributed under the MIT License (MIT).
+//  See LICENSE.txt for details.
+//
+//===------------------------------------------------------------------------------------------===//
+
+#pragma once
+
+#include "dawn/CodeGen/TranslationUnit.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace llvm {
+namespace orc {
+class LLJIT;
+} // namespace orc
+} // namespace llvm
+
+namespace dawn {
+namespace jit {
+
+/// @brief Options of the JIT compiler
+/// @ingroup jit
+struct Options {
+  /// Additional include directories (e.g GridTools or atlas). The dawn `driver-includes` are
+  /// always available.
+  std::vector<std::string> IncludeDirs;
+
+  /// Preprocessor definitions, `NAME` or `NAME=VALUE`
+  std::vector<std::string> Defines;
+
+  /// Remaining compiler flags
+  std::vector<std::string> Flags{"-std=c++17", "-O3"};
+
+  /// Directory of the on-disk cache of compiled modules. Disabled if empty.
+  std::string CacheDir;
+};
+
+/// @brief Code compiled by the JIT, kept alive as long as the module is alive
+/// @ingroup jit
+class CompiledModule {
+public:
+  ~CompiledModule();
+
+  /// @brief Address of the (unmangled, i.e `extern "C"`) symbol `name`
+  ///
+  /// @throws LogicError  The module does not define `name`
+  void* getSymbolAddress(const std::string& name) const;
+
+  /// @brief Typed access to the `extern "C"` function `name`
+  template <typename FunctionT>
+  FunctionT* getFunction(const std::string& name) const {
+    return reinterpret_cast<FunctionT*>(getSymbolAddress(name));
+  }
+
+  /// @brief Content hash of the compiled source and flags
+  std::uint64_t getHash() const { return hash_; }
+
+private:
+  friend class JIT;
+  CompiledModule(std::uint64_t hash, std::unique_ptr<llvm::orc::LLJIT> jit);
+
+  std::uint64_t hash_;
+  std::unique_ptr<llvm::orc::LLJIT> jit_;
+};
+
+/// @brief Compiles C++ in memory with the linked Clang and loads it with LLVM ORC
+///
+/// Replaces writing the generated code to disk and invoking an external toolchain. Compiled
+/// modules are cached by content hash: in memory for the lifetime of the `JIT` object and, if
+/// `Options::CacheDir` is set, on disk as LLVM bitcode, which skips parsing the (heavy) runtime
+/// headers on subsequent runs.
+///
+/// Generated stencils are C++ classes, callers therefore provide `extern "C"` entry points which
+/// instantiate and run them (see `compile(translationUnit, entryPoints)`).
+///
+/// @ingroup jit
+class JIT {
+public:
+  explicit JIT(Options options = {});
+  ~JIT();
+
+  /// @brief Compile `code`, or return the cached module if the same code was compiled before
+  ///
+  /// @throws CompileError  Clang failed to compile `code`, the message contains the diagnostics
+  std::shared_ptr<CompiledModule> compile(const std::string& code);
+
+  /// @brief Compile the generated code of `translationUnit` followed by `entryPoints`
+  std::shared_ptr<CompiledModule>
+  compile(const std::unique_ptr<codegen::TranslationUnit>& translationUnit,
+          const std::string& entryPoints);
+
+  /// @brief Content hash used as cache key for `code`
+  ///
+  /// Covers the compiler arguments, the dawn and Clang versions and the size and modification time
+  /// of the headers in the include directories, as of the construction of the `JIT`.
+  std::uint64_t hash(const std::string& code) const;
+
+  const Options& getOptions() const { return options_; }
+
+  /// @brief Number of modules compiled from source, i.e found in neither cache
+  std::size_t getNumCompiled() const { return numCompiled_; }
+
+private:
+  std::vector<std::string> getArguments() const;
+
+  Options options_;
+  std::unordered_map<std::uint64_t, std::shared_ptr<CompiledModule>> cache_;
+  std::size_t numCompiled_ = 0;
+  std::uint64_t headersHash_ = 0;
+};
+
+} // namespace jit
+} // namespace dawn
@@ -22,6 +22,8 @@
 #include "dawn/Support/Logger.h"
 #include "dawn/Support/StringSwitch.h"
 
+#include "dawn/Optimizer/PassCommonSubexpressionElimination.h"
+#include "dawn/Optimizer/PassConstantFolding.h"
 #include "dawn/Optimizer/PassDataLocalityMetric.h"
 #include "dawn/Optimizer/PassFieldVersioning.h"
 #include "dawn/Optimizer/PassFixVersionedInputFields.h"
@@ -247,6 +249,23 @@ run(const std::map<std::string, std::shared_ptr<iir::StencilInstantiation>>&
       // validation check
       passManager.pushBackPass<PassValidation>();
       break;
+    case PassGroup::CommonSubexpressionElimination:
+      passManager.pushBackPass<PassCommonSubexpressionElimination>();
+      // the new variables need a type, and are promoted to temporaries if needed
+      passManager.pushBackPass<PassLocalVarType>();
+      passManager.pushBackPass<PassTemporaryType>();
+      // validation check
+      passManager.pushBackPass<PassValidation>();
+      break;
+    case PassGroup::ConstantFolding:
+      passManager.pushBackPass<PassConstantFolding>();
+      // removed branches can turn variables into scalars and temporaries into local variables
+      passManager.pushBackPass<PassLocalVarType>();
+      passManager.pushBackPass<PassRemoveScalars>();
+      passManager.pushBackPass<PassTemporaryType>();
+      // validation check
+      passManager.pushBackPass<PassValidation>();
+      break;
     case PassGroup::MultiStageMerger:
       // set up the graphs for the analysis
       passManager.pushBackPass<PassSetStageGraph>();
@@ -649,6 +649,7 @@ void fillIIRFromSIR(std::shared_ptr<iir::StencilInstantiation> stencilInstantiat
     }
     stage.update(iir::NodeUpdateType::level);
   }
+  iir::DeferredUpdateScope deferredUpdate;
   for(const auto& MSPtr : iterateIIROver<iir::Stage>(*(stencilInstantiation->getIIR()))) {
     MSPtr->update(iir::NodeUpdateType::levelAndTreeAbove);
   }
@@ -675,8 +676,11 @@ void restoreIIR(std::shared_ptr<iir::StencilInstantiation> stencilInstantiation)
     }
     stage.update(iir::NodeUpdateType::level);
   }
-  for(const auto& MSPtr : iterateIIROver<iir::Stage>(*stencilInstantiation->getIIR())) {
-    MSPtr->update(iir::NodeUpdateType::levelAndTreeAbove);
+  {
+    iir::DeferredUpdateScope deferredUpdate;
+    for(const auto& MSPtr : iterateIIROver<iir::Stage>(*stencilInstantiation->getIIR())) {
+      MSPtr->update(iir::NodeUpdateType::levelAndTreeAbove);
+    }
   }
 
   // fix extents of stages since they are not stored in the iir but computed from the accesses
@@ -36,6 +36,8 @@ enum class PassGroup {
   SetBlockSize,
   DataLocalityMetric,
   SetLoopOrder,
+  CommonSubexpressionElimination,
+  ConstantFolding,
 };
 
 struct Options {
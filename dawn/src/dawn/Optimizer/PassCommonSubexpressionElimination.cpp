@@ -0,0 +1,444 @@
+//===--------------------------------------------------------------------------------*- C++ -*-===//
+//                          _
+//                         | |
+//                       __| | __ ___      ___ ___
+//                      / _` |/ _` \ \ /\ / / '_  |
+//                     | (_| | (_| |\ V  V /| | | |
+//                      \__,_|\__,_| \_/\_/ |_| |_| - Compiler Toolchain
+//
+//
+//  This file is distributed under the MIT License (MIT).
+//  See LICENSE.txt for details.
+//
+//===------------------------------------------------------------------------------------------===//
+
+#include "dawn/Optimizer/PassCommonSubexpressionElimination.h"
+#include "dawn/AST/ASTStringifier.h"
+#include "dawn/AST/ASTUtil.h"
+#include "dawn/IIR/ASTExpr.h"
+#include "dawn/IIR/ASTStmt.h"
+#include "dawn/IIR/AccessComputation.h"
+#include "dawn/IIR/DoMethod.h"
+#include "dawn/IIR/IIRNodeIterator.h"
+#include "dawn/IIR/StencilInstantiation.h"
+#include "dawn/IIR/StencilMetaInformation.h"
+#include "dawn/Support/HashCombine.h"
+#include "dawn/Support/Logger.h"
+
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+namespace dawn {
+namespace {
+
+/// @brief Occurrence of an expression in the top-level statement `StmtIndex` of a DoMethod
+struct Occurrence {
+  std::size_t StmtIndex;
+  std::shared_ptr<ast::Expr> Expr;
+};
+
+/// @brief Equal expressions which can share a single evaluation
+struct ExprGroup {
+  std::size_t Size;                    ///< Number of nodes of the expression
+  std::vector<int> AccessIDs;          ///< Fields and variables read by the expression
+  std::vector<Occurrence> Occurrences; ///< In statement order
+  BuiltinTypeID Type;                  ///< Type of the value of the expression
+  bool Available;                      ///< Further occurrences can still reuse the value
+};
+
+/// @brief Properties of a (sub-)expression
+struct ExprInfo {
+  std::size_t Hash = 0;
+  std::size_t Size = 1;
+  bool HasSideEffects = false;
+  bool Reusable = true; ///< The expression can be replaced by a local variable
+  bool ReadsField = false;
+  BuiltinTypeID Type = BuiltinTypeID::Invalid; ///< `Invalid` if it cannot be derived
+
+  void addChild(const ExprInfo& child) {
+    hash_combine(Hash, child.Hash);
+    Size += child.Size;
+    HasSideEffects |= child.HasSideEffects;
+    Reusable &= child.Reusable;
+    ReadsField |= child.ReadsField;
+  }
+};
+
+std::size_t hashString(const std::shared_ptr<ast::Expr>& expr) {
+  return std::hash<std::string>()(ast::ASTStringifier::toString(expr, 0, false));
+}
+
+bool isArithmeticType(BuiltinTypeID type) {
+  return type == BuiltinTypeID::Boolean || type == BuiltinTypeID::Integer ||
+         type == BuiltinTypeID::Float || type == BuiltinTypeID::Double;
+}
+
+/// @brief Type of the result of an arithmetic operation (usual arithmetic conversions), `Invalid`
+/// if the type of an operand is unknown
+BuiltinTypeID getCommonType(BuiltinTypeID lhs, BuiltinTypeID rhs) {
+  if(!isArithmeticType(lhs) || !isArithmeticType(rhs))
+    return BuiltinTypeID::Invalid;
+  if(lhs == BuiltinTypeID::Double || rhs == BuiltinTypeID::Double)
+    return BuiltinTypeID::Double;
+  if(lhs == BuiltinTypeID::Float || rhs == BuiltinTypeID::Float)
+    return BuiltinTypeID::Float;
+  return BuiltinTypeID::Integer;
+}
+
+void getAccessIDs(const std::shared_ptr<ast::Expr>& expr, std::vector<int>& accessIDs) {
+  if(isa<ast::FieldAccessExpr>(expr.get()) || isa<ast::VarAccessExpr>(expr.get()))
+    accessIDs.push_back(iir::getAccessID(expr));
+  for(const auto& child : expr->getChildren())
+    getAccessIDs(child, accessIDs);
+}
+
+void removeStencilFunctionInstantiations(iir::StencilMetaInformation& metadata,
+                                         const std::shared_ptr<ast::Expr>& expr) {
+  if(auto stencilFunCall = std::dynamic_pointer_cast<ast::StencilFunCallExpr>(expr)) {
+    metadata.removeStencilFunctionInstantiation(stencilFunCall);
+    return;
+  }
+  for(const auto& child : expr->getChildren())
+    removeStencilFunctionInstantiations(metadata, child);
+}
+
+/// @brief Groups the equal expressions of the top-level statements of a DoMethod
+class CommonSubexpressionFinder {
+  const iir::StencilMetaInformation& metadata_;
+  const ast::GlobalVariableMap& globalVariables_;
+  std::vector<ExprGroup> groups_;
+
+  /// Types of the local variables declared so far (AccessID -> type)
+  std::unordered_map<int, BuiltinTypeID> localVariableTypes_;
+
+  /// Available groups by the hash of their expression and by the AccessIDs they read
+  std::unordered_multimap<std::size_t, std::size_t> availableGroups_;
+  std::unordered_multimap<int, std::size_t> groupsReading_;
+
+  /// Reusable expressions of the current statement with their hash and type
+  std::vector<std::tuple<std::size_t, std::shared_ptr<ast::Expr>, BuiltinTypeID>> candidates_;
+
+public:
+  CommonSubexpressionFinder(const iir::StencilMetaInformation& metadata,
+                            const ast::GlobalVariableMap& globalVariables)
+      : metadata_(metadata), globalVariables_(globalVariables) {}
+
+  void run(const ast::BlockStmt& block) {
+    const auto& statements = block.getStatements();
+    for(std::size_t stmtIndex = 0; stmtIndex < statements.size(); ++stmtIndex) {
+      const auto& stmt = statements[stmtIndex];
+
+      // Only the right-hand sides of assignments and declarations are searched, any other
+      // statement may write to anything
+      std::vector<std::shared_ptr<ast::Expr>> roots;
+      bool isBarrier = false;
+      if(const auto& exprStmt = std::dynamic_pointer_cast<ast::ExprStmt>(stmt)) {
+        if(const auto& assignment = std::dynamic_pointer_cast<ast::AssignmentExpr>(
+               exprStmt->getExpr()))
+          roots.push_back(assignment->getRight());
+        else
+          isBarrier = true;
+      } else if(const auto& varDeclStmt = std::dynamic_pointer_cast<ast::VarDeclStmt>(stmt)) {
+        roots = varDeclStmt->getInitList();
+        localVariableTypes_[iir::getAccessID(varDeclStmt)] =
+            varDeclStmt->getType().getBuiltinTypeID();
+      } else {
+        isBarrier = true;
+      }
+
+      candidates_.clear();
+      for(const auto& root : roots)
+        isBarrier |= analyze(root).HasSideEffects;
+
+      if(isBarrier) {
+        for(auto& group : groups_)
+          group.Available = false;
+        availableGroups_.clear();
+        groupsReading_.clear();
+        continue;
+      }
+
+      for(const auto& candidate : candidates_)
+        addOccurrence(std::get<0>(candidate), Occurrence{stmtIndex, std::get<1>(candidate)},
+                      std::get<2>(candidate));
+
+      // The value of expressions reading what the statement writes can no longer be reused
+      const auto& accesses = stmt->getData<iir::IIRStmtData>().CallerAccesses;
+      for(const auto& writeAccess : accesses->getWriteAccesses()) {
+        auto range = groupsReading_.equal_range(writeAccess.first);
+        for(auto it = range.first; it != range.second; ++it)
+          groups_[it->second].Available = false;
+      }
+    }
+  }
+
+  /// @brief Get the largest expression evaluated at least twice (`nullptr` if there is none)
+  const ExprGroup* getLargestCommonSubexpression() const {
+    const ExprGroup* largest = nullptr;
+    for(const auto& group : groups_)
+      if(group.Occurrences.size() > 1 && (!largest || group.Size > largest->Size))
+        largest = &group;
+    return largest;
+  }
+
+private:
+  void addOccurrence(std::size_t hash, Occurrence&& occurrence, BuiltinTypeID type) {
+    std::vector<int> accessIDs;
+    getAccessIDs(occurrence.Expr, accessIDs);
+
+    auto range = availableGroups_.equal_range(hash);
+    for(auto it = range.first; it != range.second; ++it) {
+      ExprGroup& group = groups_[it->second];
+      if(group.Available && group.AccessIDs == accessIDs &&
+         group.Occurrences.front().Expr->equals(occurrence.Expr.get(), /*compareData=*/false)) {
+        group.Occurrences.push_back(std::move(occurrence));
+        return;
+      }
+    }
+
+    const std::size_t groupIndex = groups_.size();
+    for(int accessID : accessIDs)
+      groupsReading_.emplace(accessID, groupIndex);
+    availableGroups_.emplace(hash, groupIndex);
+
+    const std::size_t size = countNodes(occurrence.Expr);
+    groups_.push_back(
+        ExprGroup{size, std::move(accessIDs), {std::move(occurrence)}, type, true});
+  }
+
+  static std::size_t countNodes(const std::shared_ptr<ast::Expr>& expr) {
+    std::size_t size = 1;
+    for(const auto& child : expr->getChildren())
+      size += countNodes(child);
+    return size;
+  }
+
+  bool isSparseField(int accessID) const {
+    const auto dimensions = metadata_.getFieldDimensions(accessID);
+    if(dimensions.isVertical())
+      return false;
+    const auto& hDimensions = dimensions.getHorizontalFieldDimension();
+    return hDimensions.getType() == ast::GridType::Unstructured &&
+           ast::dimension_cast<const ast::UnstructuredFieldDimension&>(hDimensions).isSparse();
+  }
+
+  /// @brief Compute the properties of the sub-expressions of a reduction or of the arguments of a
+  /// stencil function call, which are never replaced on their own
+  static void analyzeOpaque(const std::shared_ptr<ast::Expr>& expr, ExprInfo& info) {
+    for(const auto& child : expr->getChildren()) {
+      ++info.Size;
+      if(isa<ast::AssignmentExpr>(child.get()))
+        info.HasSideEffects = true;
+      else if(const auto* unaryOp = dyn_cast<ast::UnaryOperator>(child.get()))
+        info.HasSideEffects |= unaryOp->getOp() == "++" || unaryOp->getOp() == "--";
+      else if(const auto* fieldAccess = dyn_cast<ast::FieldAccessExpr>(child.get())) {
+        info.ReadsField = true;
+        info.Reusable &= !fieldAccess->getOffset().hasVerticalIndirection();
+      }
+      analyzeOpaque(child, info);
+    }
+  }
+
+  /// @brief Compute the properties of `expr` and record it as candidate if it can be reused
+  ExprInfo analyze(const std::shared_ptr<ast::Expr>& expr) {
+    ExprInfo info;
+    hash_combine(info.Hash, static_cast<int>(expr->getKind()));
+    bool isCandidate = false;
+
+    switch(expr->getKind()) {
+    case ast::Expr::Kind::FieldAccessExpr: {
+      const auto& fieldAccess = std::static_pointer_cast<ast::FieldAccessExpr>(expr);
+      info.Hash = hashString(expr);
+      info.ReadsField = true;
+      info.Reusable = !fieldAccess->getOffset().hasVerticalIndirection() &&
+                      !isSparseField(iir::getAccessID(expr));
+      info.Type = BuiltinTypeID::Float;
+      return info;
+    }
+    case ast::Expr::Kind::VarAccessExpr: {
+      const auto& varAccess = std::static_pointer_cast<ast::VarAccessExpr>(expr);
+      info.Hash = hashString(expr);
+      if(varAccess->isExternal()) {
+        auto globalIt = globalVariables_.find(varAccess->getName());
+        if(globalIt != globalVariables_.end() &&
+           globalIt->second.getType() != ast::Value::Kind::String)
+          info.Type = ast::Value::typeToBuiltinTypeID(globalIt->second.getType());
+      } else {
+        auto localIt = localVariableTypes_.find(iir::getAccessID(expr));
+        if(localIt != localVariableTypes_.end())
+          info.Type = localIt->second;
+      }
+      return info;
+    }
+    case ast::Expr::Kind::LiteralAccessExpr:
+      info.Hash = hashString(expr);
+      info.Type = std::static_pointer_cast<ast::LiteralAccessExpr>(expr)->getBuiltinType();
+      return info;
+    case ast::Expr::Kind::NOPExpr:
+    case ast::Expr::Kind::StencilFunArgExpr:
+      info.Reusable = false;
+      return info;
+    case ast::Expr::Kind::ReductionOverNeighborExpr:
+    case ast::Expr::Kind::StencilFunCallExpr: {
+      // Reused as a whole: their operands are evaluated for each neighbor, respectively are
+      // arguments of the callee
+      info.Hash = hashString(expr);
+      analyzeOpaque(expr, info);
+      if(const auto& stencilFunCall = std::dynamic_pointer_cast<ast::StencilFunCallExpr>(expr)) {
+        for(const auto& argument : stencilFunCall->getArguments())
+          info.Reusable &= !isa<ast::StencilFunCallExpr>(argument.get());
+        info.Type = BuiltinTypeID::Float;
+      } else {
+        // The backends either accumulate in the type of the initial value or in a floating point
+        // value, they only agree on floating point reductions
+        const std::size_t numCandidates = candidates_.size();
+        const BuiltinTypeID initType =
+            analyze(std::static_pointer_cast<ast::ReductionOverNeighborExpr>(expr)->getInit())
+                .Type;
+        candidates_.resize(numCandidates);
+        if(initType == BuiltinTypeID::Float || initType == BuiltinTypeID::Double)
+          info.Type = initType;
+      }
+      isCandidate = true;
+      break;
+    }
+    case ast::Expr::Kind::UnaryOperator: {
+      const auto& op = std::static_pointer_cast<ast::UnaryOperator>(expr)->getOp();
+      hash_combine(info.Hash, op);
+      info.HasSideEffects = op == "++" || op == "--";
+      const ExprInfo operand =
+          analyze(std::static_pointer_cast<ast::UnaryOperator>(expr)->getOperand());
+      info.addChild(operand);
+      if(op == "!")
+        info.Type = BuiltinTypeID::Boolean;
+      else if(op == "-" || op == "+")
+        info.Type = getCommonType(operand.Type, operand.Type);
+      isCandidate = op == "-" && info.Size > 2;
+      break;
+    }
+    case ast::Expr::Kind::BinaryOperator:
+    case ast::Expr::Kind::AssignmentExpr: {
+      const auto& binaryOp = std::static_pointer_cast<ast::BinaryOperator>(expr);
+      const auto& op = binaryOp->getOp();
+      hash_combine(info.Hash, op);
+      info.HasSideEffects = isa<ast::AssignmentExpr>(expr.get());
+      const ExprInfo lhs = analyze(binaryOp->getLeft());
+      const ExprInfo rhs = analyze(binaryOp->getRight());
+      info.addChild(lhs);
+      info.addChild(rhs);
+      if(op == "+" || op == "-" || op == "*" || op == "/" || op == "%")
+        info.Type = getCommonType(lhs.Type, rhs.Type);
+      else if(op == "==" || op == "!=" || op == "<" || op == "<=" || op == ">" || op == ">=" ||
+              op == "&&" || op == "||")
+        info.Type = BuiltinTypeID::Boolean;
+      // Comparisons and logical operators are cheap, only their operands are reused
+      isCandidate = op == "+" || op == "-" || op == "*" || op == "/";
+      break;
+    }
+    case ast::Expr::Kind::TernaryOperator: {
+      const auto& ternaryOp = std::static_pointer_cast<ast::TernaryOperator>(expr);
+      info.addChild(analyze(ternaryOp->getCondition()));
+      const ExprInfo lhs = analyze(ternaryOp->getLeft());
+      const ExprInfo rhs = analyze(ternaryOp->getRight());
+      info.addChild(lhs);
+      info.addChild(rhs);
+      info.Type = lhs.Type == rhs.Type ? lhs.Type : getCommonType(lhs.Type, rhs.Type);
+      isCandidate = true;
+      break;
+    }
+    case ast::Expr::Kind::FunCallExpr: {
+      hash_combine(info.Hash, std::static_pointer_cast<ast::FunCallExpr>(expr)->getCallee());
+      // Math functions are only known to return the common type of floating point arguments
+      info.Type = BuiltinTypeID::Float;
+      for(const auto& child : expr->getChildren()) {
+        const ExprInfo argument = analyze(child);
+        info.addChild(argument);
+        if(argument.Type == BuiltinTypeID::Float || argument.Type == BuiltinTypeID::Double)
+          info.Type = getCommonType(info.Type, argument.Type);
+        else
+          info.Type = BuiltinTypeID::Invalid;
+      }
+      isCandidate = true;
+      break;
+    }
+    }
+
+    // The variable storing the value is declared with the type of the expression
+    if(isCandidate && info.Reusable && info.ReadsField && !info.HasSideEffects &&
+       info.Type != BuiltinTypeID::Invalid)
+      candidates_.emplace_back(info.Hash, expr, info.Type);
+    return info;
+  }
+};
+
+/// @brief Store the value of the expressions of `group` in a new local variable declared before
+/// the first of them, and replace them with accesses to the variable
+void hoistCommonSubexpression(iir::StencilMetaInformation& metadata, iir::DoMethod& doMethod,
+                              const ExprGroup& group) {
+  ast::BlockStmt& block = doMethod.getAST();
+  const Occurrence& first = group.Occurrences.front();
+
+  auto varDeclStmt =
+      metadata.declareVar(false, "cse", Type(group.Type, CVQualifier::Const), first.Expr);
+  varDeclStmt->getData<iir::IIRStmtData>().StackTrace =
+      block.getStatements()[first.StmtIndex]->getData<iir::IIRStmtData>().StackTrace;
+
+  std::vector<std::shared_ptr<ast::Stmt>> modifiedStmts{varDeclStmt};
+  for(const Occurrence& occurrence : group.Occurrences) {
+    const auto& stmt = block.getStatements()[occurrence.StmtIndex];
+
+    auto varAccessExpr = std::make_shared<ast::VarAccessExpr>(varDeclStmt->getName());
+    varAccessExpr->getData<iir::IIRAccessExprData>().AccessID =
+        std::make_optional(iir::getAccessID(varDeclStmt));
+    ast::replaceOldExprWithNewExprInStmt(stmt, occurrence.Expr, varAccessExpr);
+
+    // Only the first occurrence is still evaluated (by the declaration)
+    if(occurrence.Expr != first.Expr)
+      removeStencilFunctionInstantiations(metadata, occurrence.Expr);
+
+    if(modifiedStmts.back() != stmt)
+      modifiedStmts.push_back(stmt);
+  }
+
+  block.insert(block.getStatements().begin() + first.StmtIndex, modifiedStmts.begin(),
+               modifiedStmts.begin() + 1);
+  computeAccesses(metadata, modifiedStmts);
+}
+
+} // namespace
+
+bool PassCommonSubexpressionElimination::run(
+    const std::shared_ptr<iir::StencilInstantiation>& stencilInstantiation,
+    const Options& options) {
+  auto& metadata = stencilInstantiation->getMetaData();
+
+  for(const auto& doMethod : iterateIIROver<iir::DoMethod>(*stencilInstantiation->getIIR())) {
+    int numHoisted = 0;
+
+    // Hoist the largest common subexpression first, its sub-expressions are then only evaluated
+    // once and are no longer common
+    while(true) {
+      CommonSubexpressionFinder finder(metadata,
+                                       stencilInstantiation->getIIR()->getGlobalVariableMap());
+      finder.run(doMethod->getAST());
+      const ExprGroup* group = finder.getLargestCommonSubexpression();
+      if(!group)
+        break;
+
+      DAWN_LOG(INFO) << stencilInstantiation->getName() << ": DoMethod: " << doMethod->getID()
+                     << " evaluates "
+                     << ast::ASTStringifier::toString(group->Occurrences.front().Expr, 0, false)
+                     << " once instead of " << group->Occurrences.size() << " times";
+      hoistCommonSubexpression(metadata, *doMethod, *group);
+      ++numHoisted;
+    }
+
+    if(numHoisted)
+      doMethod->update(iir::NodeUpdateType::levelAndTreeAbove);
+  }
+
+  return true;
+}
+
+} // namespace dawn
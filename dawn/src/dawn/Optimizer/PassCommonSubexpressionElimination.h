@@ -0,0 +1,43 @@
+//===--------------------------------------------------------------------------------*- C++ -*-===//
+//                          _
+//                         | |
+//                       __| | __ ___      ___ ___
+//                      / _` |/ _` \ \ /\ / / '_  |
+//                     | (_| | (_| |\ V  V /| | | |
+//                      \__,_|\__,_| \_/\_/ |_| |_| - Compiler Toolchain
+//
+//
+//  This file is distributed under the MIT License (MIT).
+//  See LICENSE.txt for details.
+//
+//===------------------------------------------------------------------------------------------===//
+
+#pragma once
+
+#include "dawn/Optimizer/Pass.h"
+
+namespace dawn {
+
+/// @brief PassCommonSubexpressionElimination hoists expressions evaluated several times in a
+/// DoMethod into local variables
+///
+/// Expressions are compared structurally (same operators, fields, offsets and AccessIDs). Two
+/// occurrences are only merged if none of the fields or variables read by the expression is
+/// written in between. Only the top-level assignments and variable declarations of a DoMethod are
+/// considered, any other statement (e.g an `if`) ends the range in which an expression can be
+/// reused. Stencil function calls and reductions are merged as a whole, their arguments are left
+/// untouched.
+/// * Input:  any IIR with computed accesses
+/// * Output: same as input with the common subexpressions stored in (non-scalar) local variables,
+///           whose types are computed by PassLocalVarType
+/// @ingroup optimizer
+class PassCommonSubexpressionElimination : public Pass {
+public:
+  PassCommonSubexpressionElimination() : Pass("PassCommonSubexpressionElimination") {}
+
+  /// @brief Pass implementation
+  bool run(const std::shared_ptr<iir::StencilInstantiation>& stencilInstantiation,
+           const Options& options = {}) override;
+};
+
+} // namespace dawn
@@ -0,0 +1,519 @@
+//===--------------------------------------------------------------------------------*- C++ -*-===//
+//                          _
+//                         | |
+//                       __| | __ ___      ___ ___
+//                      / _` |/ _` \ \ /\ / / '_  |
+//                     | (_| | (_| |\ V  V /| | | |
+//                      \__,_|\__,_| \_/\_/ |_| |_| - Compiler Toolchain
+//
+//
+//  This file is distributed under the MIT License (MIT).
+//  See LICENSE.txt for details.
+//
+//===------------------------------------------------------------------------------------------===//
+
+#include "dawn/Optimizer/PassConstantFolding.h"
+#include "dawn/AST/ASTVisitor.h"
+#include "dawn/IIR/ASTExpr.h"
+#include "dawn/IIR/ASTStmt.h"
+#include "dawn/IIR/AccessComputation.h"
+#include "dawn/IIR/DoMethod.h"
+#include "dawn/IIR/IIRNodeIterator.h"
+#include "dawn/IIR/MultiStage.h"
+#include "dawn/IIR/Stage.h"
+#include "dawn/IIR/StencilInstantiation.h"
+#include "dawn/IIR/StencilMetaInformation.h"
+#include "dawn/Support/Logger.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <limits>
+#include <optional>
+#include <set>
+#include <sstream>
+#include <type_traits>
+#include <vector>
+
+namespace dawn {
+namespace {
+
+/// @brief Compile-time value of an expression
+///
+/// Booleans and integers are stored in `Integral`, floating point numbers in `Real`.
+struct Constant {
+  BuiltinTypeID Type;
+  long long Integral = 0;
+  double Real = 0.0;
+
+  bool isIntegral() const {
+    return Type == BuiltinTypeID::Boolean || Type == BuiltinTypeID::Integer;
+  }
+  double toReal() const { return isIntegral() ? Integral : Real; }
+  bool isTrue() const { return isIntegral() ? Integral != 0 : Real != 0.0; }
+};
+
+std::optional<Constant> makeBoolean(bool value) {
+  return Constant{BuiltinTypeID::Boolean, value};
+}
+
+/// @brief Returns nothing if `value` overflows an `int` (undefined behavior at runtime)
+std::optional<Constant> makeInteger(long long value) {
+  if(value < std::numeric_limits<int>::min() || value > std::numeric_limits<int>::max())
+    return std::nullopt;
+  return Constant{BuiltinTypeID::Integer, value};
+}
+
+/// @brief Returns nothing if `value` is not finite, it could not be written as a literal, or if it
+/// over- or underflows in single precision
+std::optional<Constant> makeReal(BuiltinTypeID type, double value) {
+  const float singleValue = static_cast<float>(value);
+  if(!std::isfinite(value) || !std::isfinite(singleValue) ||
+     (singleValue == 0.0f) != (value == 0.0))
+    return std::nullopt;
+  return Constant{type, 0, value};
+}
+
+/// @brief Applies `operation` to floating point operands
+///
+/// Floating point literals are emitted as `::dawn::float_type`, which is `float` or `double`
+/// depending on the precision the generated code is compiled with. The operation is evaluated in
+/// both precisions and only folded if the literal of the result is the same in both.
+template <typename Operation, typename... Args>
+std::optional<Constant> foldReal(BuiltinTypeID type, Operation operation, Args... args) {
+  const auto result = operation(args...);
+  const auto singleResult = operation(static_cast<float>(args)...);
+  if constexpr(std::is_same<std::decay_t<decltype(result)>, bool>::value) {
+    if(result != singleResult)
+      return std::nullopt;
+    return makeBoolean(result);
+  } else {
+    // Also false if either of them is NaN
+    if(!(static_cast<float>(result) == singleResult))
+      return std::nullopt;
+    return makeReal(type, result);
+  }
+}
+
+std::optional<Constant> parseLiteral(const ast::LiteralAccessExpr& expr) {
+  const std::string& value = expr.getValue();
+  if(value.empty())
+    return std::nullopt;
+
+  char* end = nullptr;
+  switch(expr.getBuiltinType()) {
+  case BuiltinTypeID::Boolean:
+    if(value != "true" && value != "false")
+      return std::nullopt;
+    return makeBoolean(value == "true");
+  case BuiltinTypeID::Integer: {
+    long long integral = std::strtoll(value.c_str(), &end, 0);
+    if(*end != '\0')
+      return std::nullopt;
+    return makeInteger(integral);
+  }
+  case BuiltinTypeID::Float:
+  case BuiltinTypeID::Double: {
+    double real = std::strtod(value.c_str(), &end);
+    if(*end != '\0')
+      return std::nullopt;
+    return makeReal(expr.getBuiltinType(), real);
+  }
+  default:
+    return std::nullopt;
+  }
+}
+
+std::string toString(const Constant& constant) {
+  switch(constant.Type) {
+  case BuiltinTypeID::Boolean:
+    return constant.Integral ? "true" : "false";
+  case BuiltinTypeID::Integer:
+    return std::to_string(constant.Integral);
+  default: {
+    std::ostringstream out;
+    out << std::setprecision(std::numeric_limits<double>::max_digits10) << constant.Real;
+    std::string str = out.str();
+    // Keep floating point literals recognizable as such (e.g `2` -> `2.0`)
+    if(str.find_first_of(".e") == std::string::npos)
+      str += ".0";
+    return str;
+  }
+  }
+}
+
+/// @brief Type of the result of an arithmetic operation (usual arithmetic conversions)
+BuiltinTypeID getCommonType(const Constant& lhs, const Constant& rhs) {
+  if(lhs.Type == BuiltinTypeID::Double || rhs.Type == BuiltinTypeID::Double)
+    return BuiltinTypeID::Double;
+  if(lhs.Type == BuiltinTypeID::Float || rhs.Type == BuiltinTypeID::Float)
+    return BuiltinTypeID::Float;
+  return BuiltinTypeID::Integer;
+}
+
+std::optional<Constant> foldUnaryOperator(const std::string& op, const Constant& operand) {
+  if(op == "!")
+    return makeBoolean(!operand.isTrue());
+  if(op == "+")
+    return operand.isIntegral() ? makeInteger(operand.Integral) : operand;
+  if(op == "-")
+    return operand.isIntegral()
+               ? makeInteger(-operand.Integral)
+               : foldReal(operand.Type, [](auto a) { return -a; }, operand.Real);
+  return std::nullopt;
+}
+
+std::optional<Constant> foldBinaryOperator(const std::string& op, const Constant& lhs,
+                                           const Constant& rhs) {
+  if(op == "&&")
+    return makeBoolean(lhs.isTrue() && rhs.isTrue());
+  if(op == "||")
+    return makeBoolean(lhs.isTrue() || rhs.isTrue());
+
+  const BuiltinTypeID type = getCommonType(lhs, rhs);
+  if(type == BuiltinTypeID::Integer) {
+    const long long a = lhs.Integral, b = rhs.Integral;
+    if(op == "+")
+      return makeInteger(a + b);
+    if(op == "-")
+      return makeInteger(a - b);
+    if(op == "*")
+      return makeInteger(a * b);
+    if(op == "/")
+      return b != 0 ? makeInteger(a / b) : std::nullopt;
+    if(op == "%")
+      return b != 0 ? makeInteger(a % b) : std::nullopt;
+    if(op == "==")
+      return makeBoolean(a == b);
+    if(op == "!=")
+      return makeBoolean(a != b);
+    if(op == "<")
+      return makeBoolean(a < b);
+    if(op == "<=")
+      return makeBoolean(a <= b);
+    if(op == ">")
+      return makeBoolean(a > b);
+    if(op == ">=")
+      return makeBoolean(a >= b);
+    return std::nullopt;
+  }
+
+  const double a = lhs.toReal(), b = rhs.toReal();
+  if(op == "+")
+    return foldReal(type, [](auto x, auto y) { return x + y; }, a, b);
+  if(op == "-")
+    return foldReal(type, [](auto x, auto y) { return x - y; }, a, b);
+  if(op == "*")
+    return foldReal(type, [](auto x, auto y) { return x * y; }, a, b);
+  if(op == "/")
+    return foldReal(type, [](auto x, auto y) { return x / y; }, a, b);
+  if(op == "==")
+    return foldReal(type, [](auto x, auto y) { return x == y; }, a, b);
+  if(op == "!=")
+    return foldReal(type, [](auto x, auto y) { return x != y; }, a, b);
+  if(op == "<")
+    return foldReal(type, [](auto x, auto y) { return x < y; }, a, b);
+  if(op == "<=")
+    return foldReal(type, [](auto x, auto y) { return x <= y; }, a, b);
+  if(op == ">")
+    return foldReal(type, [](auto x, auto y) { return x > y; }, a, b);
+  if(op == ">=")
+    return foldReal(type, [](auto x, auto y) { return x >= y; }, a, b);
+  return std::nullopt;
+}
+
+/// @brief Folds a call to a math function, the arguments are required to have the same type
+std::optional<Constant> foldMathFunction(const std::string& callee,
+                                         const std::vector<Constant>& args) {
+  // Math functions are usually qualified (e.g `math::sqrt`)
+  const auto pos = callee.rfind("::");
+  const std::string name = pos == std::string::npos ? callee : callee.substr(pos + 2);
+
+  if(args.empty() || args.size() > 2)
+    return std::nullopt;
+  const BuiltinTypeID type = args[0].Type;
+  for(const Constant& arg : args)
+    if(arg.Type != type || type == BuiltinTypeID::Boolean)
+      return std::nullopt;
+
+  if(type == BuiltinTypeID::Integer) {
+    if(args.size() == 1 && name == "abs")
+      return makeInteger(std::llabs(args[0].Integral));
+    if(args.size() == 2 && name == "min")
+      return makeInteger(std::min(args[0].Integral, args[1].Integral));
+    if(args.size() == 2 && name == "max")
+      return makeInteger(std::max(args[0].Integral, args[1].Integral));
+    return std::nullopt;
+  }
+
+  if(args.size() == 1) {
+    // The overloads of both precisions are needed, hence the lambdas
+#define DAWN_MATH_FUNCTION(NAME, FUNCTION)                                                         \
+  if(name == NAME)                                                                                 \
+    return foldReal(type, [](auto x) { return FUNCTION(x); }, args[0].Real);
+    DAWN_MATH_FUNCTION("sqrt", std::sqrt)
+    DAWN_MATH_FUNCTION("exp", std::exp)
+    DAWN_MATH_FUNCTION("log", std::log)
+    DAWN_MATH_FUNCTION("sin", std::sin)
+    DAWN_MATH_FUNCTION("cos", std::cos)
+    DAWN_MATH_FUNCTION("tan", std::tan)
+    DAWN_MATH_FUNCTION("asin", std::asin)
+    DAWN_MATH_FUNCTION("acos", std::acos)
+    DAWN_MATH_FUNCTION("atan", std::atan)
+    DAWN_MATH_FUNCTION("fabs", std::fabs)
+    DAWN_MATH_FUNCTION("abs", std::fabs)
+    DAWN_MATH_FUNCTION("floor", std::floor)
+    DAWN_MATH_FUNCTION("ceil", std::ceil)
+    DAWN_MATH_FUNCTION("trunc", std::trunc)
+#undef DAWN_MATH_FUNCTION
+    return std::nullopt;
+  }
+
+  const double a = args[0].Real, b = args[1].Real;
+  if(name == "pow")
+    return foldReal(type, [](auto x, auto y) { return std::pow(x, y); }, a, b);
+  if(name == "fmod")
+    return foldReal(type, [](auto x, auto y) { return std::fmod(x, y); }, a, b);
+  if(name == "min")
+    return foldReal(type, [](auto x, auto y) { return std::min(x, y); }, a, b);
+  if(name == "max")
+    return foldReal(type, [](auto x, auto y) { return std::max(x, y); }, a, b);
+  return std::nullopt;
+}
+
+std::optional<Constant> getConstant(const std::shared_ptr<ast::Expr>& expr) {
+  if(auto literal = std::dynamic_pointer_cast<ast::LiteralAccessExpr>(expr))
+    return parseLiteral(*literal);
+  return std::nullopt;
+}
+
+/// @brief Unregisters the local variables and stencil function calls of removed code
+class RemovedCodeUnregisterer : public ast::ASTVisitorForwardingNonConst {
+  iir::StencilMetaInformation& metadata_;
+
+public:
+  RemovedCodeUnregisterer(iir::StencilMetaInformation& metadata) : metadata_(metadata) {}
+
+  void visit(const std::shared_ptr<ast::VarDeclStmt>& stmt) override {
+    ast::ASTVisitorForwardingNonConst::visit(stmt);
+    metadata_.removeAccessID(iir::getAccessID(stmt));
+  }
+
+  void visit(const std::shared_ptr<ast::StencilFunCallExpr>& expr) override {
+    // The arguments are part of the instantiation
+    metadata_.removeStencilFunctionInstantiation(expr);
+  }
+};
+
+/// @brief Folds the constant expressions and branches of a DoMethod (post-order, the operands are
+/// folded before their parent)
+class ConstantFolder : public ast::ASTVisitorPostOrder {
+  const iir::StencilInstantiation& instantiation_;
+  iir::StencilMetaInformation& metadata_;
+  int numFolded_ = 0;
+
+public:
+  ConstantFolder(const std::shared_ptr<iir::StencilInstantiation>& instantiation)
+      : instantiation_(*instantiation), metadata_(instantiation->getMetaData()) {}
+
+  int getNumFolded() const { return numFolded_; }
+
+  std::shared_ptr<ast::Expr>
+  postVisitNode(std::shared_ptr<ast::VarAccessExpr> const& expr) override {
+    if(!expr->isExternal() || expr->isArrayAccess())
+      return expr;
+
+    const ast::Global& value = instantiation_.getGlobalVariableValue(expr->getName());
+    if(!value.isConstexpr() || !value.has_value() || value.getType() == ast::Value::Kind::String)
+      return expr;
+
+    ++numFolded_;
+    return makeLiteral(value.toString(), ast::Value::typeToBuiltinTypeID(value.getType()),
+                       expr->getSourceLocation());
+  }
+
+  std::shared_ptr<ast::Expr>
+  postVisitNode(std::shared_ptr<ast::UnaryOperator> const& expr) override {
+    auto operand = getConstant(expr->getOperand());
+    if(!operand)
+      return expr;
+    return fold(expr, foldUnaryOperator(expr->getOp(), *operand));
+  }
+
+  std::shared_ptr<ast::Expr>
+  postVisitNode(std::shared_ptr<ast::BinaryOperator> const& expr) override {
+    auto lhs = getConstant(expr->getLeft());
+    auto rhs = getConstant(expr->getRight());
+    if(!lhs || !rhs)
+      return expr;
+    return fold(expr, foldBinaryOperator(expr->getOp(), *lhs, *rhs));
+  }
+
+  std::shared_ptr<ast::Expr>
+  postVisitNode(std::shared_ptr<ast::TernaryOperator> const& expr) override {
+    auto cond = getConstant(expr->getCondition());
+    if(!cond)
+      return expr;
+
+    ++numFolded_;
+    const bool isTrue = cond->isTrue();
+    unregister(isTrue ? expr->getRight() : expr->getLeft());
+    return isTrue ? expr->getLeft() : expr->getRight();
+  }
+
+  std::shared_ptr<ast::Expr>
+  postVisitNode(std::shared_ptr<ast::FunCallExpr> const& expr) override {
+    std::vector<Constant> args;
+    for(const auto& arg : expr->getArguments()) {
+      auto constant = getConstant(arg);
+      if(!constant)
+        return expr;
+      args.push_back(*constant);
+    }
+    return fold(expr, foldMathFunction(expr->getCallee(), args));
+  }
+
+  /// @brief Replaces the `if` statements with a constant condition by the taken branch
+  std::shared_ptr<ast::Stmt> postVisitNode(std::shared_ptr<ast::BlockStmt> const& stmt) override {
+    ast::BlockStmt::StatementList statements;
+    bool modified = false;
+    for(const auto& child : stmt->getStatements()) {
+      auto ifStmt = std::dynamic_pointer_cast<ast::IfStmt>(child);
+      auto cond = ifStmt ? getConstant(ifStmt->getCondExpr()) : std::nullopt;
+      if(!cond) {
+        statements.push_back(child);
+        continue;
+      }
+
+      ++numFolded_;
+      modified = true;
+      const auto& takenStmt = cond->isTrue() ? ifStmt->getThenStmt() : ifStmt->getElseStmt();
+      const auto& removedStmt = cond->isTrue() ? ifStmt->getElseStmt() : ifStmt->getThenStmt();
+      if(removedStmt)
+        unregister(removedStmt);
+      if(!takenStmt)
+        continue;
+
+      // The branch is inlined into the enclosing block unless it declares variables, which would
+      // then be visible (and possibly redeclared) in the enclosing block
+      auto takenBlock = std::dynamic_pointer_cast<ast::BlockStmt>(takenStmt);
+      if(takenBlock && std::none_of(takenBlock->getStatements().begin(),
+                                    takenBlock->getStatements().end(), [](const auto& s) {
+                                      return s->getKind() == ast::Stmt::Kind::VarDeclStmt;
+                                    }))
+        statements.insert(statements.end(), takenBlock->getStatements().begin(),
+                          takenBlock->getStatements().end());
+      else
+        statements.push_back(takenStmt);
+    }
+
+    if(modified) {
+      stmt->clear();
+      stmt->insert_back(statements);
+    }
+    return stmt;
+  }
+
+private:
+  std::shared_ptr<ast::Expr> fold(const std::shared_ptr<ast::Expr>& expr,
+                                  const std::optional<Constant>& constant) {
+    if(!constant)
+      return expr;
+    ++numFolded_;
+    return makeLiteral(toString(*constant), constant->Type, expr->getSourceLocation());
+  }
+
+  std::shared_ptr<ast::Expr> makeLiteral(const std::string& value, BuiltinTypeID type,
+                                         SourceLocation loc) {
+    auto literal = std::make_shared<ast::LiteralAccessExpr>(value, type, loc);
+    literal->getData<iir::IIRAccessExprData>().AccessID =
+        std::make_optional(metadata_.insertAccessOfType(iir::FieldAccessType::Literal, value));
+    return literal;
+  }
+
+  template <typename NodeType>
+  void unregister(const std::shared_ptr<NodeType>& node) {
+    RemovedCodeUnregisterer unregisterer(metadata_);
+    node->accept(unregisterer);
+  }
+};
+
+} // namespace
+
+bool PassConstantFolding::run(
+    const std::shared_ptr<iir::StencilInstantiation>& stencilInstantiation,
+    const Options& options) {
+  for(const auto& doMethod : iterateIIROver<iir::DoMethod>(*stencilInstantiation->getIIR())) {
+    ConstantFolder folder(stencilInstantiation);
+    doMethod->getASTPtr()->acceptAndReplace(folder);
+    if(!folder.getNumFolded())
+      continue;
+
+    DAWN_LOG(INFO) << stencilInstantiation->getName() << ": DoMethod: " << doMethod->getID()
+                   << " folded " << folder.getNumFolded() << " constant expression(s)";
+    // Removed below
+    if(doMethod->isEmptyOrNullStmt())
+      continue;
+
+    computeAccesses(stencilInstantiation->getMetaData(), doMethod->getAST().getStatements());
+    doMethod->update(iir::NodeUpdateType::levelAndTreeAbove);
+  }
+
+  // Removed branches can leave DoMethods without statements. PassRemoveScalars removes those too,
+  // but it skips the whole pass on unsupported statements (e.g compound assignments). The stages,
+  // multi-stages and stencils left without children are removed as well.
+  iir::IIR& IIR = *stencilInstantiation->getIIR();
+  std::set<int> emptyStencilIDs;
+  for(auto stencilIt = IIR.childrenBegin(); stencilIt != IIR.childrenEnd();) {
+    iir::Stencil& stencil = **stencilIt;
+    for(auto multiStageIt = stencil.childrenBegin(); multiStageIt != stencil.childrenEnd();) {
+      iir::MultiStage& multiStage = **multiStageIt;
+      for(auto stageIt = multiStage.childrenBegin(); stageIt != multiStage.childrenEnd();) {
+        iir::Stage& stage = **stageIt;
+        for(auto doMethodIt = stage.childrenBegin(); doMethodIt != stage.childrenEnd();) {
+          if((*doMethodIt)->isEmptyOrNullStmt()) {
+            DAWN_LOG(INFO) << stencilInstantiation->getName() << ": DoMethod: "
+                           << (*doMethodIt)->getID() << " is empty after folding, removing";
+            doMethodIt = stage.childrenErase(doMethodIt);
+          } else {
+            ++doMethodIt;
+          }
+        }
+
+        if(stage.childrenEmpty()) {
+          stageIt = multiStage.childrenErase(stageIt);
+        } else {
+          stage.update(iir::NodeUpdateType::level);
+          ++stageIt;
+        }
+      }
+
+      if(multiStage.childrenEmpty()) {
+        multiStageIt = stencil.childrenErase(multiStageIt);
+      } else {
+        multiStage.update(iir::NodeUpdateType::level);
+        ++multiStageIt;
+      }
+    }
+
+    if(stencil.childrenEmpty()) {
+      DAWN_LOG(INFO) << stencilInstantiation->getName() << ": Stencil: " << stencil.getStencilID()
+                     << " is empty after folding, removing";
+      emptyStencilIDs.insert(stencil.getStencilID());
+      stencilIt = IIR.childrenErase(stencilIt);
+    } else {
+      stencil.update(iir::NodeUpdateType::level);
+      ++stencilIt;
+    }
+  }
+  IIR.update(iir::NodeUpdateType::level);
+
+  // Calls of the removed stencils would refer to unknown stencil IDs
+  IIR.getControlFlowDescriptor().removeStencilCalls(emptyStencilIDs,
+                                                    stencilInstantiation->getMetaData());
+
+  return true;
+}
+
+} // namespace dawn
@@ -0,0 +1,43 @@
+//===--------------------------------------------------------------------------------*- C++ -*-===//
+//                          _
+//                         | |
+//                       __| | __ ___      ___ ___
+//                      / _` |/ _` \ \ /\ / / '_  |
+//                     | (_| | (_| |\ V  V /| | | |
+//                      \__,_|\__,_| \_/\_/ |_| |_| - Compiler Toolchain
+//
+//
+//  This file is distributed under the MIT License (MIT).
+//  See LICENSE.txt for details.
+//
+//===------------------------------------------------------------------------------------------===//
+
+#pragma once
+
+#include "dawn/Optimizer/Pass.h"
+
+namespace dawn {
+
+/// @brief PassConstantFolding specializes the DoMethods for the values of the constant (constexpr)
+/// globals and evaluates the expressions which only depend on literals at compile time
+///
+/// Arithmetic, comparison and logical operators as well as the usual math functions (`sqrt`,
+/// `exp`, `pow`, `min`, ...) are folded when all their operands are literals. Integer operations
+/// which would overflow or divide by zero and floating point results which are not finite are kept
+/// as they are. Ternary operators and `if` statements whose condition is constant are replaced by
+/// the taken branch, the code of the other branch is removed.
+/// * Input:  any IIR
+/// * Output: same as input with the constexpr globals replaced by literals and the constant
+///           expressions and branches folded. Scalar variables and temporaries have to be
+///           recomputed (PassLocalVarType, PassRemoveScalars, PassTemporaryType).
+/// @ingroup optimizer
+class PassConstantFolding : public Pass {
+public:
+  PassConstantFolding() : Pass("PassConstantFolding") {}
+
+  /// @brief Pass implementation
+  bool run(const std::shared_ptr<iir::StencilInstantiation>& stencilInstantiation,
+           const Options& options = {}) override;
+};
+
+} // namespace dawn
@@ -43,7 +43,7 @@ class ReadWriteCounter : public ast::ASTVisitorForwardingNonConst {
   const iir::MultiStage& multiStage_;
 
   /// Fields of the MultiStage
-  std::unordered_map<int, iir::Field> fields_;
+  iir::FieldMap fields_;
 
   /// Fields which are considered to be loaded into a register
   std::unordered_set<int> register_;
@@ -234,7 +234,7 @@ DAWN_ATTRIBUTE_UNUSED static std::pair<int, int>
 computeReadWriteAccessesLowerBound(iir::StencilInstantiation* instantiation,
                                    const iir::MultiStage& multiStage) {
   std::size_t numReads = 0, numWrites = 0;
-  std::unordered_map<int, iir::Field> fields = multiStage.getFields();
+  iir::FieldMap fields = multiStage.getFields();
 
   for(const auto& AccessIDFieldPair : fields) {
     int AccessID = AccessIDFieldPair.first;
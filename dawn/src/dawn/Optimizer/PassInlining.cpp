@@ -512,6 +512,7 @@ bool PassInlining::run(const std::shared_ptr<iir::StencilInstantiation>& stencil
 
     stage.update(iir::NodeUpdateType::level);
   }
+  iir::DeferredUpdateScope deferredUpdate;
   for(const auto& MSPtr : iterateIIROver<iir::Stage>(*(stencilInstantiation->getIIR()))) {
     MSPtr->update(iir::NodeUpdateType::levelAndTreeAbove);
   }
@@ -58,6 +58,7 @@ bool PassIntervalPartitioning::run(
     }
   }
 
+  iir::DeferredUpdateScope deferredUpdate;
   for(auto& doMethod : iterateIIROver<iir::DoMethod>(*(stencilInstantiation->getIIR()))) {
     doMethod->update(iir::NodeUpdateType::levelAndTreeAbove);
   }
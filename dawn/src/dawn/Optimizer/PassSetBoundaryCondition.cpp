@@ -312,8 +312,11 @@ bool PassSetBoundaryCondition::run(
     }
   }
 
-  for(const auto& doMethod : iterateIIROver<iir::DoMethod>(*(stencilInstantiation->getIIR()))) {
-    doMethod->update(iir::NodeUpdateType::levelAndTreeAbove);
+  {
+    iir::DeferredUpdateScope deferredUpdate;
+    for(const auto& doMethod : iterateIIROver<iir::DoMethod>(*(stencilInstantiation->getIIR()))) {
+      doMethod->update(iir::NodeUpdateType::levelAndTreeAbove);
+    }
   }
 
   // Output
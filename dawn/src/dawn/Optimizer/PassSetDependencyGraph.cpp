@@ -22,6 +22,7 @@ bool PassSetDependencyGraph::run(
     const std::shared_ptr<iir::StencilInstantiation>& stencilInstantiation,
     const Options& options) {
   const auto& IIR = stencilInstantiation->getIIR();
+  iir::DeferredUpdateScope deferredUpdate;
   for(const auto& doMethod : iterateIIROver<iir::DoMethod>(*IIR)) {
     // and do the update of the Graphs
     doMethod->update(iir::NodeUpdateType::levelAndTreeAbove);
@@ -1,5 +1,4 @@
 #include "dawn/Optimizer/PassSetLoopOrder.h"
-#include "dawn/IIR/DependencyGraphAccesses.h"
 #include "dawn/IIR/DoMethod.h"
 #include "dawn/IIR/IIRNodeIterator.h"
 #include "dawn/IIR/LoopOrder.h"
@@ -10,11 +9,11 @@
 namespace dawn {
 bool PassSetLoopOrder::run(const std::shared_ptr<iir::StencilInstantiation>& stencilInstantiation,
                            const Options& options) {
-  iir::DependencyGraphAccesses graph(stencilInstantiation->getMetaData());
   for(auto& multiStage : iterateIIROver<iir::MultiStage>(*(stencilInstantiation->getIIR()))) {
-    // analysis is on a multistage level, clear the graph for each new one
-    graph.clear();
+    // analysis is on a multistage level, start a new graph for each one
     auto userSpecifiedLoopOrder = multiStage->getLoopOrder();
+    ReadBeforeWriteConflictTracker graph(stencilInstantiation->getMetaData(),
+                                         userSpecifiedLoopOrder);
     // try for a parallel loop order. This will be reverted if we run into a conflict
     multiStage->setLoopOrder(iir::LoopOrderKind::Parallel);
     for(auto& doMethod : iterateIIROver<iir::DoMethod>(*(multiStage))) {
@@ -25,7 +24,7 @@ bool PassSetLoopOrder::run(const std::shared_ptr<iir::StencilInstantiation>& ste
         graph.insertStatement(stmt);
         // Check for read-before-write conflicts in the loop order and counter loop order.
         // Conflicts will assure us that the multi-stage can't be executed in  parallel.
-        auto conflict = hasVerticalReadBeforeWriteConflict(graph, userSpecifiedLoopOrder);
+        auto conflict = graph.getVerticalConflict();
         if(conflict.CounterLoopOrderConflict || conflict.LoopOrderConflict) {
           multiStage->setLoopOrder(userSpecifiedLoopOrder);
           break;
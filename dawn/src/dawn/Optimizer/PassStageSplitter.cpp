@@ -45,19 +45,21 @@ bool PassStageSplitter::run(const std::shared_ptr<iir::StencilInstantiation>& st
         std::deque<int> splitterIndices;
         std::deque<iir::DependencyGraphAccesses> graphs;
 
-        iir::DependencyGraphAccesses newGraph(stencilInstantiation->getMetaData());
-        auto oldGraph = newGraph;
+        const auto& statements = doMethod.getAST().getStatements();
+        ReadBeforeWriteConflictTracker newGraph(stencilInstantiation->getMetaData());
+
+        // Index of the last statement of the stage being built
+        int lastStmtIndex = statements.size() - 1;
 
         // Build the Dependency graph (bottom to top)
-        for(int stmtIndex = doMethod.getAST().getStatements().size() - 1; stmtIndex >= 0;
-            --stmtIndex) {
-          const auto& stmt = doMethod.getAST().getStatements()[stmtIndex];
+        for(int stmtIndex = lastStmtIndex; stmtIndex >= 0; --stmtIndex) {
+          const auto& stmt = statements[stmtIndex];
 
           newGraph.insertStatement(stmt);
 
           // If we have a horizontal read-before-write conflict, we record the current index for
           // splitting
-          if(hasHorizontalReadBeforeWriteConflict(newGraph)) {
+          if(newGraph.hasHorizontalConflict()) {
 
             // Check if the conflict is related to a conditional block
             if(isa<ast::IfStmt>(stmt.get())) {
@@ -74,6 +76,12 @@ bool PassStageSplitter::run(const std::shared_ptr<iir::StencilInstantiation>& st
               }
             }
 
+            // The graph of the statements before the current one is only needed once the stage is
+            // split, rebuild it instead of copying the graph after each statement
+            iir::DependencyGraphAccesses oldGraph(stencilInstantiation->getMetaData());
+            for(int i = lastStmtIndex; i > stmtIndex; --i)
+              oldGraph.insertStatement(statements[i]);
+
             if(options.DumpSplitGraphs)
               oldGraph.toDot(
                   format("stmt_hd_ms%i_s%i_%02i.dot", multiStageIndex, stageIndex, numSplit));
@@ -89,18 +97,17 @@ bool PassStageSplitter::run(const std::shared_ptr<iir::StencilInstantiation>& st
             // Clear the new graph an process the current statements again
             newGraph.clear();
             newGraph.insertStatement(stmt);
+            lastStmtIndex = stmtIndex;
 
             numSplit++;
           }
-
-          oldGraph = newGraph;
         }
 
         if(options.DumpSplitGraphs)
-          newGraph.toDot(
+          newGraph.getGraph().toDot(
               format("stmt_hd_ms%i_s%i_%02i.dot", multiStageIndex, stageIndex, numSplit));
 
-        graphs.push_front(newGraph);
+        graphs.push_front(newGraph.getGraph());
 
         // Perform the spliting of the stages and insert the stages *before* the stage we processed.
         // Note that the "old" stage will be erased (it was consumed in split(...) anyway)
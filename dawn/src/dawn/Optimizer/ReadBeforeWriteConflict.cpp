@@ -13,6 +13,8 @@
 //===------------------------------------------------------------------------------------------===//
 
 #include "dawn/Optimizer/ReadBeforeWriteConflict.h"
+#include "dawn/IIR/ASTStmt.h"
+#include "dawn/IIR/Accesses.h"
 #include "dawn/IIR/DependencyGraphAccesses.h"
 #include "dawn/IIR/Extents.h"
 #include "dawn/Support/Assert.h"
@@ -151,4 +153,76 @@ bool hasHorizontalReadBeforeWriteConflict(const iir::DependencyGraphAccesses& gr
       .LoopOrderConflict;
 }
 
+ReadBeforeWriteConflictTracker::ReadBeforeWriteConflictTracker(
+    const iir::StencilMetaInformation& metaData, iir::LoopOrderKind loopOrder)
+    : graph_(metaData), loopOrder_(loopOrder) {}
+
+void ReadBeforeWriteConflictTracker::insertStatement(const std::shared_ptr<ast::Stmt>& stmt) {
+  graph_.insertStatement(stmt);
+
+  const auto& adjacencyList = graph_.getAdjacencyList();
+  incomingEdges_.resize(adjacencyList.size());
+  isWritten_.resize(adjacencyList.size(), false);
+
+  std::vector<std::size_t> writtenVertexIDs;
+  getWrittenVertexIDs(stmt, writtenVertexIDs);
+
+  // The edges to the vertices written for the first time become conflicts
+  for(std::size_t VertexID : writtenVertexIDs) {
+    if(isWritten_[VertexID] || adjacencyList[VertexID].empty())
+      continue;
+    isWritten_[VertexID] = true;
+    for(const auto& fromConflictPair : incomingEdges_[VertexID])
+      count(fromConflictPair.second, 1);
+  }
+
+  // Only the outgoing edges of the written vertices were added or had their extents merged
+  for(std::size_t VertexID : writtenVertexIDs) {
+    for(const auto& edge : adjacencyList[VertexID]) {
+      const auto verticalAccess = edge.Data.getVerticalLoopOrderAccesses(loopOrder_);
+      const EdgeConflict conflict{!verticalAccess.CounterLoopOrder && verticalAccess.LoopOrder,
+                                  verticalAccess.CounterLoopOrder,
+                                  !edge.Data.isHorizontalPointwise()};
+
+      auto& incomingEdges = incomingEdges_[edge.ToVertexID];
+      auto it = incomingEdges.find(edge.FromVertexID);
+      if(it != incomingEdges.end() && isWritten_[edge.ToVertexID])
+        count(it->second, -1);
+      incomingEdges[edge.FromVertexID] = conflict;
+      if(isWritten_[edge.ToVertexID])
+        count(conflict, 1);
+    }
+  }
+}
+
+ReadBeforeWriteConflict ReadBeforeWriteConflictTracker::getVerticalConflict() const {
+  return ReadBeforeWriteConflict(numLoopOrderConflicts_ > 0, numCounterLoopOrderConflicts_ > 0);
+}
+
+void ReadBeforeWriteConflictTracker::clear() {
+  graph_.clear();
+  incomingEdges_.clear();
+  isWritten_.clear();
+  numLoopOrderConflicts_ = numCounterLoopOrderConflicts_ = numHorizontalConflicts_ = 0;
+}
+
+void ReadBeforeWriteConflictTracker::getWrittenVertexIDs(
+    const std::shared_ptr<ast::Stmt>& stmt, std::vector<std::size_t>& vertexIDs) const {
+  // Same traversal as `DependencyGraphAccesses::insertStatement`
+  if(!stmt->getChildren().empty()) {
+    for(const auto& s : stmt->getChildren())
+      getWrittenVertexIDs(s, vertexIDs);
+  } else {
+    const auto& callerAccesses = stmt->getData<iir::IIRStmtData>().CallerAccesses;
+    for(const auto& writeAccess : callerAccesses->getWriteAccesses())
+      vertexIDs.push_back(graph_.getVertexIDFromValue(writeAccess.first));
+  }
+}
+
+void ReadBeforeWriteConflictTracker::count(const EdgeConflict& conflict, int sign) {
+  numLoopOrderConflicts_ += sign * conflict.LoopOrder;
+  numCounterLoopOrderConflicts_ += sign * conflict.CounterLoopOrder;
+  numHorizontalConflicts_ += sign * conflict.Horizontal;
+}
+
 } // namespace dawn
@@ -14,14 +14,14 @@
 
 #pragma once
 
+#include "dawn/IIR/DependencyGraphAccesses.h"
 #include "dawn/IIR/LoopOrder.h"
+#include <memory>
+#include <unordered_map>
+#include <vector>
 
 namespace dawn {
 
-namespace iir {
-class DependencyGraphAccesses;
-}
-
 /// @brief Result of the vertical dependency analysis algorithm
 /// @ingroup optimizer
 struct ReadBeforeWriteConflict {
@@ -104,4 +104,69 @@ hasVerticalReadBeforeWriteConflict(const iir::DependencyGraphAccesses& graph,
 /// @ingroup optimizer
 bool hasHorizontalReadBeforeWriteConflict(const iir::DependencyGraphAccesses& graph);
 
+/// @brief Dependency graph built statement by statement which keeps track of its vertical and
+/// horizontal read-before-write conflicts
+///
+/// Only edges to a vertex which is written (i.e has outgoing edges) can conflict. Such an edge is a
+/// horizontal conflict if it is not pointwise in the horizontal, and a vertical conflict in the
+/// loop-order or counter-loop-order depending on its vertical accesses in `loopOrder` (an edge
+/// accessing both directions counts as a counter-loop-order conflict only), see
+/// `hasVerticalReadBeforeWriteConflict` and `hasHorizontalReadBeforeWriteConflict`. Inserting a
+/// statement only checks the edges it added or widened and the incoming edges of the vertices it
+/// writes for the first time, instead of traversing the whole graph again. This keeps passes
+/// checking the graph after each inserted statement linear in the number of statements.
+///
+/// @note Contrary to the full checks, edges of cycles which cannot be reached from an output vertex
+/// are reported as well (the full checks expect such graphs not to occur).
+///
+/// @ingroup optimizer
+class ReadBeforeWriteConflictTracker {
+public:
+  /// @param loopOrder  Loop order of the vertical conflicts
+  ReadBeforeWriteConflictTracker(const iir::StencilMetaInformation& metaData,
+                                 iir::LoopOrderKind loopOrder = iir::LoopOrderKind::Parallel);
+
+  /// @brief Insert the statement into the graph and update the conflicts
+  void insertStatement(const std::shared_ptr<ast::Stmt>& stmt);
+
+  /// @brief Vertical read-before-write conflicts of the graph
+  ReadBeforeWriteConflict getVerticalConflict() const;
+
+  /// @brief Check if the graph has a horizontal read-before-write conflict
+  bool hasHorizontalConflict() const { return numHorizontalConflicts_ > 0; }
+
+  /// @brief Get the dependency graph of the inserted statements
+  const iir::DependencyGraphAccesses& getGraph() const { return graph_; }
+
+  /// @brief Clear the graph and the conflicts
+  void clear();
+
+private:
+  struct EdgeConflict {
+    bool LoopOrder;
+    bool CounterLoopOrder;
+    bool Horizontal;
+  };
+
+  /// @brief Collect the VertexIDs of the vertices written by `stmt`
+  void getWrittenVertexIDs(const std::shared_ptr<ast::Stmt>& stmt,
+                           std::vector<std::size_t>& vertexIDs) const;
+
+  /// @brief Add (`sign = 1`) or remove (`sign = -1`) the conflicts of an edge
+  void count(const EdgeConflict& conflict, int sign);
+
+  iir::DependencyGraphAccesses graph_;
+  iir::LoopOrderKind loopOrder_;
+
+  /// Conflicts of the edges indexed by the VertexID of their `To` and `From` vertex
+  std::vector<std::unordered_map<std::size_t, EdgeConflict>> incomingEdges_;
+
+  /// Vertices with outgoing edges, only the edges to them are counted as conflicts
+  std::vector<bool> isWritten_;
+
+  int numLoopOrderConflicts_ = 0;
+  int numCounterLoopOrderConflicts_ = 0;
+  int numHorizontalConflicts_ = 0;
+};
+
 } // namespace dawn
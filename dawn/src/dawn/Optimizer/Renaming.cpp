@@ -73,16 +73,13 @@ public:
 };
 
 /// @brief Remap all accesses from `oldAccessID` to `newAccessID` in the `accessesMap`
-static void renameAccessesMaps(std::unordered_map<int, iir::Extents>& accessesMap, int oldAccessID,
-                               int newAccessID) {
-  for(auto it = accessesMap.begin(); it != accessesMap.end();) {
-    if(it->first == oldAccessID) {
-      accessesMap.emplace(newAccessID, it->second);
-      it = accessesMap.erase(it);
-    } else {
-      ++it;
-    }
-  }
+static void renameAccessesMaps(iir::AccessMap& accessesMap, int oldAccessID, int newAccessID) {
+  auto it = accessesMap.find(oldAccessID);
+  if(it == accessesMap.end())
+    return;
+  iir::Extents extents = std::move(it->second);
+  accessesMap.erase(it);
+  accessesMap.emplace(newAccessID, std::move(extents));
 }
 
 } // anonymous namespace
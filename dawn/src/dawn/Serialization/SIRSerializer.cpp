@@ -25,6 +25,7 @@
 #include <google/protobuf/util/json_util.h>
 #include <list>
 #include <memory>
+#include <mutex>
 #include <stdexcept>
 #include <tuple>
 
@@ -61,11 +62,15 @@ public:
   }
 
   /// @brief Push a `message` to the logging stack
-  void push(LogMessage message) { logStack_.emplace_back(std::move(message)); }
+  void push(LogMessage message) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    logStack_.emplace_back(std::move(message));
+  }
 
   /// @brief Get a dump of all error messages (in the order of occurence) and reset the internal
   /// logging stack
   std::string getErrorMessagesAndReset() {
+    std::lock_guard<std::mutex> lock(mutex_);
     std::string str = "Protobuf errors (most recent call last):\n\n";
     for(const LogMessage& msg : logStack_)
       if(std::get<0>(msg) >= google::protobuf::LOGLEVEL_ERROR)
@@ -76,10 +81,11 @@ public:
 
   /// @brief Initialize and register the Logger
   static void init() {
-    if(instance_)
-      return;
-    instance_ = new ProtobufLogger();
-    google::protobuf::SetLogHandler(ProtobufLogger::LogHandler);
+    static std::once_flag initialized;
+    std::call_once(initialized, [] {
+      instance_ = new ProtobufLogger();
+      google::protobuf::SetLogHandler(ProtobufLogger::LogHandler);
+    });
   }
 
   /// @brief Get the singleton instance of the logger
@@ -87,6 +93,7 @@ public:
 
 private:
   std::list<LogMessage> logStack_;
+  std::mutex mutex_;
 
   static ProtobufLogger* instance_;
 };
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "clang/Basic/Version.h"
+#include "llvm/ExecutionEngine/Orc/ExecutionUtils.h"
+#include "llvm/ExecutionEngine/Orc/LLJIT.h"
+
+#include <cstdint>
+
+namespace dawn::clang_compat::orc {
+#if CLANG_VERSION_MAJOR < 10
+inline void addProcessSymbols(::llvm::orc::LLJIT& jit) {
+  jit.getMainJITDylib().setGenerator(
+      ::llvm::cantFail(::llvm::orc::DynamicLibrarySearchGenerator::GetForCurrentProcess(
+          jit.getDataLayout().getGlobalPrefix())));
+}
+#else
+inline void addProcessSymbols(::llvm::orc::LLJIT& jit) {
+  jit.getMainJITDylib().addGenerator(
+      ::llvm::cantFail(::llvm::orc::DynamicLibrarySearchGenerator::GetForCurrentProcess(
+          jit.getDataLayout().getGlobalPrefix())));
+}
+#endif
+
+#if CLANG_VERSION_MAJOR < 11
+inline ::llvm::Error runInitializers(::llvm::orc::LLJIT& jit) { return jit.runConstructors(); }
+#else
+inline ::llvm::Error runInitializers(::llvm::orc::LLJIT& jit) {
+  return jit.initialize(jit.getMainJITDylib());
+}
+#endif
+
+#if CLANG_VERSION_MAJOR < 15
+inline ::llvm::Expected<std::uint64_t> lookup(::llvm::orc::LLJIT& jit, ::llvm::StringRef name) {
+  auto symbol = jit.lookup(name);
+  if(!symbol)
+    return symbol.takeError();
+  return symbol->getAddress();
+}
+#else
+inline ::llvm::Expected<std::uint64_t> lookup(::llvm::orc::LLJIT& jit, ::llvm::StringRef name) {
+  auto symbol = jit.lookup(name);
+  if(!symbol)
+    return symbol.takeError();
+  return symbol->getValue();
+}
+#endif
+} // namespace dawn::clang_compat::orc
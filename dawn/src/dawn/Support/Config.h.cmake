@@ -29,5 +29,12 @@
 // DAWN full version string
 #define DAWN_FULL_VERSION_STR "${DAWN_FULL_VERSION}"
 
+// Builtin include directory of the Clang used for JIT compilation
+#define DAWN_CLANG_RESSOURCE_INCLUDE_PATH "${CLANG_RESSOURCE_INCLUDE_PATH}"
 
+// Directory containing the `driver-includes` of the generated code, once installed
+#define DAWN_DRIVER_INSTALL_INCLUDE_PATH "${CMAKE_INSTALL_FULL_INCLUDEDIR}"
 
+// Directory containing the `driver-includes` of the generated code in the source tree, used by
+// builds which are not installed
+#define DAWN_DRIVER_INCLUDE_PATH "${PROJECT_SOURCE_DIR}/src"
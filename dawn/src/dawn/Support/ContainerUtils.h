@@ -19,9 +19,9 @@
 namespace dawn {
 namespace support {
 
-template <typename Key, typename Value>
-std::map<Key, Value> orderMap(const std::unordered_map<Key, Value>& umap) {
-  std::map<Key, Value> m;
+template <typename Map>
+std::map<typename Map::key_type, typename Map::mapped_type> orderMap(const Map& umap) {
+  std::map<typename Map::key_type, typename Map::mapped_type> m;
   for(const auto& f : umap)
     m.insert(f);
 
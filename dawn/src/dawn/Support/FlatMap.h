@@ -0,0 +1,160 @@
+//===--------------------------------------------------------------------------------*- C++ -*-===//
+//                          _
+//                         | |
+//                       __| | __ ___      ___ ___
+//                      / _` |/ _` \ \ /\ / / '_  |
+//                     | (_| | (_| |\ V  V /| | | |
+//                      \__,_|\__,_| \_/\_/ |_| |_| - Compiler Toolchain
+//
+//
+//  This file is distributed under the MIT License (MIT).
+//  See LICENSE.txt for details.
+//
+//===------------------------------------------------------------------------------------------===//
+
+#pragma once
+
+#include <algorithm>
+#include <initializer_list>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace dawn {
+
+/// @brief Associative container storing its elements in a vector sorted by key
+///
+/// The interface follows `std::map` (iteration is in increasing key order). Lookups are binary
+/// searches and insertions shift the trailing elements, which is faster and leaner than node based
+/// maps for the small maps keyed by AccessID of the IIR (accesses and fields of a statement,
+/// do-method or stage). Contrary to `std::map`, insertion and erasure invalidate iterators and
+/// references.
+///
+/// @ingroup support
+template <typename Key, typename T>
+class FlatMap {
+public:
+  using key_type = Key;
+  using mapped_type = T;
+  using value_type = std::pair<Key, T>;
+  using container_type = std::vector<value_type>;
+  using size_type = typename container_type::size_type;
+  using iterator = typename container_type::iterator;
+  using const_iterator = typename container_type::const_iterator;
+
+  FlatMap() = default;
+  FlatMap(std::initializer_list<value_type> init) { insert(init.begin(), init.end()); }
+  template <typename InputIt>
+  FlatMap(InputIt first, InputIt last) {
+    insert(first, last);
+  }
+
+  /// @name Iterators
+  /// @{
+  iterator begin() { return data_.begin(); }
+  const_iterator begin() const { return data_.begin(); }
+  const_iterator cbegin() const { return data_.cbegin(); }
+  iterator end() { return data_.end(); }
+  const_iterator end() const { return data_.end(); }
+  const_iterator cend() const { return data_.cend(); }
+  /// @}
+
+  /// @name Capacity
+  /// @{
+  bool empty() const { return data_.empty(); }
+  size_type size() const { return data_.size(); }
+  void reserve(size_type size) { data_.reserve(size); }
+  /// @}
+
+  /// @name Lookup
+  /// @{
+  iterator lower_bound(const Key& key) {
+    return std::lower_bound(data_.begin(), data_.end(), key, KeyCompare{});
+  }
+  const_iterator lower_bound(const Key& key) const {
+    return std::lower_bound(data_.begin(), data_.end(), key, KeyCompare{});
+  }
+
+  iterator find(const Key& key) {
+    auto it = lower_bound(key);
+    return it != end() && it->first == key ? it : end();
+  }
+  const_iterator find(const Key& key) const {
+    auto it = lower_bound(key);
+    return it != end() && it->first == key ? it : end();
+  }
+
+  size_type count(const Key& key) const { return find(key) != end(); }
+
+  T& at(const Key& key) {
+    auto it = find(key);
+    if(it == end())
+      throw std::out_of_range("FlatMap::at: invalid key");
+    return it->second;
+  }
+  const T& at(const Key& key) const {
+    auto it = find(key);
+    if(it == end())
+      throw std::out_of_range("FlatMap::at: invalid key");
+    return it->second;
+  }
+
+  T& operator[](const Key& key) { return try_emplace(key).first->second; }
+  /// @}
+
+  /// @name Modifiers
+  /// @{
+  template <typename... Args>
+  std::pair<iterator, bool> try_emplace(const Key& key, Args&&... args) {
+    auto it = lower_bound(key);
+    if(it != end() && it->first == key)
+      return {it, false};
+    it = data_.emplace(it, std::piecewise_construct, std::forward_as_tuple(key),
+                       std::forward_as_tuple(std::forward<Args>(args)...));
+    return {it, true};
+  }
+
+  template <typename... Args>
+  std::pair<iterator, bool> emplace(Args&&... args) {
+    value_type value(std::forward<Args>(args)...);
+    return try_emplace(value.first, std::move(value.second));
+  }
+
+  std::pair<iterator, bool> insert(const value_type& value) {
+    return try_emplace(value.first, value.second);
+  }
+  std::pair<iterator, bool> insert(value_type&& value) {
+    return try_emplace(value.first, std::move(value.second));
+  }
+  template <typename InputIt>
+  void insert(InputIt first, InputIt last) {
+    for(; first != last; ++first)
+      insert(*first);
+  }
+
+  iterator erase(const_iterator pos) { return data_.erase(pos); }
+  iterator erase(const_iterator first, const_iterator last) { return data_.erase(first, last); }
+  size_type erase(const Key& key) {
+    auto it = find(key);
+    if(it == end())
+      return 0;
+    data_.erase(it);
+    return 1;
+  }
+
+  void clear() { data_.clear(); }
+  /// @}
+
+  bool operator==(const FlatMap& other) const { return data_ == other.data_; }
+  bool operator!=(const FlatMap& other) const { return data_ != other.data_; }
+
+private:
+  struct KeyCompare {
+    bool operator()(const value_type& value, const Key& key) const { return value.first < key; }
+  };
+
+  container_type data_;
+};
+
+} // namespace dawn
@@ -14,6 +14,6 @@
 
 #include "dawn/Support/IndexGenerator.h"
 namespace dawn {
-std::unique_ptr<IndexGenerator> IndexGenerator::instance;
+thread_local std::unique_ptr<IndexGenerator> IndexGenerator::instance;
 
 } // namespace dawn
@@ -25,7 +25,8 @@ private:
   IndexGenerator(const IndexGenerator&) = delete;
   IndexGenerator& operator=(const IndexGenerator&) = delete;
 
-  static std::unique_ptr<IndexGenerator> instance;
+  // one generator per thread, such that independent compilations can run concurrently
+  static thread_local std::unique_ptr<IndexGenerator> instance;
 
   long unsigned int idx_ = 0;
 
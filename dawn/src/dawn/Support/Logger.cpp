@@ -81,14 +81,23 @@ DiagnosticProxy Logger::operator()(const std::string& file, int line, const std:
 }
 
 void Logger::doEnqueue(const std::string& message) {
-  data_.push_back(message);
+  Container& data = threadData();
+  data.push_back(message);
+
+  std::lock_guard<std::mutex> lock(mutex_);
   if(show_) {
-    *os_ << data_.back();
-    if(data_.back().back() != '\n')
+    *os_ << data.back();
+    if(data.back().back() != '\n')
       *os_ << '\n';
   }
 }
 
+Logger::Container& Logger::threadData() const {
+  // The containers are only modified by their own thread, the lock protects the map
+  std::lock_guard<std::mutex> lock(mutex_);
+  return data_[std::this_thread::get_id()];
+}
+
 void Logger::enqueue(std::string msg, const std::string& file, int line) {
   doEnqueue(msgFmt_(msg, file, line));
 }
@@ -107,17 +116,17 @@ void Logger::messageFormatter(const MessageFormatter& msgFmt) { msgFmt_ = msgFmt
 Logger::DiagnosticFormatter Logger::diagnosticFormatter() const { return diagFmt_; }
 void Logger::diagnosticFormatter(const DiagnosticFormatter& diagFmt) { diagFmt_ = diagFmt; }
 
-void Logger::clear() { data_.clear(); }
+void Logger::clear() { threadData().clear(); }
 
 void Logger::show() { show_ = true; }
 void Logger::hide() { show_ = false; }
 
 // Expose container of messages
-Logger::iterator Logger::begin() { return std::begin(data_); }
-Logger::iterator Logger::end() { return std::end(data_); }
-Logger::const_iterator Logger::begin() const { return std::begin(data_); }
-Logger::const_iterator Logger::end() const { return std::end(data_); }
-Logger::Container::size_type Logger::size() const { return std::size(data_); }
+Logger::iterator Logger::begin() { return std::begin(threadData()); }
+Logger::iterator Logger::end() { return std::end(threadData()); }
+Logger::const_iterator Logger::begin() const { return std::begin(threadData()); }
+Logger::const_iterator Logger::end() const { return std::end(threadData()); }
+Logger::Container::size_type Logger::size() const { return std::size(threadData()); }
 
 std::string createDiagnosticStackTrace(const std::string& prefix,
                                        const DiagnosticStack& inputStack) {
@@ -18,10 +18,13 @@
 #include <functional>
 #include <iostream>
 #include <list>
+#include <mutex>
 #include <sstream>
 #include <stack>
 #include <string>
+#include <thread>
 #include <tuple>
+#include <unordered_map>
 
 namespace dawn {
 
@@ -71,6 +74,9 @@ private:
 };
 
 /// @brief Logging interface
+///
+/// The messages are stored per thread: `clear()`, `size()` and the iterators only see the messages
+/// of the calling thread, such that concurrent compilations do not observe each other's errors.
 /// @ingroup support
 class Logger {
 public:
@@ -114,7 +120,7 @@ public:
   void diagnosticFormatter(const DiagnosticFormatter& fmt);
   /// }
 
-  /// @brief Reset storage
+  /// @brief Reset storage of the calling thread
   void clear();
 
   /// @brief Show or hide output from ostream -- still accessible in the container
@@ -123,7 +129,7 @@ public:
   void hide();
   /// }
 
-  // Expose container of messages
+  // Expose container of messages of the calling thread
   using iterator = Container::iterator;
   iterator begin();
   iterator end();
@@ -137,10 +143,15 @@ public:
 private:
   void doEnqueue(const std::string& message);
 
+  /// @brief Messages of the calling thread
+  Container& threadData() const;
+
+  /// Serializes the messages of concurrent compilations
+  mutable std::mutex mutex_;
   MessageFormatter msgFmt_;
   DiagnosticFormatter diagFmt_;
   std::ostream* os_;
-  Container data_;
+  mutable std::unordered_map<std::thread::id, Container> data_;
   bool show_;
 };
 
@@ -17,14 +17,14 @@
 namespace dawn {
 
 /* Null, because instance will be initialized on demand. */
-UIDGenerator* UIDGenerator::instance_ = 0;
+thread_local std::unique_ptr<UIDGenerator> UIDGenerator::instance_;
 
 UIDGenerator* UIDGenerator::getInstance() {
-  if(instance_ == 0) {
-    instance_ = new UIDGenerator();
+  if(!instance_) {
+    instance_.reset(new UIDGenerator());
   }
 
-  return instance_;
+  return instance_.get();
 }
 
 } // namespace dawn
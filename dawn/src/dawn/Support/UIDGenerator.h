@@ -15,14 +15,17 @@
 #pragma once
 
 #include "dawn/Support/NonCopyable.h"
+#include <memory>
 
 namespace dawn {
 
 /// @brief Unique identifier generator (starting from @b 1)
+///
+/// There is one generator per thread, such that independent compilations can run concurrently.
 /// @ingroup support
 class UIDGenerator : NonCopyable {
   int counter_;
-  static UIDGenerator* instance_;
+  static thread_local std::unique_ptr<UIDGenerator> instance_;
 
   UIDGenerator() : counter_(1) {}
 
@@ -119,11 +119,11 @@ public:
       : si_(std::make_shared<iir::StencilInstantiation>(gridType)) {}
 
   template <typename T>
-  GlobalVar globalvar(std::string const& name, T&& v) {
+  GlobalVar globalvar(std::string const& name, T&& v, bool isConstexpr = false) {
     DAWN_ASSERT(si_);
     int accessID =
         si_->getMetaData().insertAccessOfType(iir::FieldAccessType::GlobalVariable, name);
-    auto&& global = ast::Global(std::forward<T>(v));
+    auto&& global = ast::Global(std::forward<T>(v), isConstexpr);
     si_->getIIR()->insertGlobalVariable(name, std::move(global));
     return {accessID, name};
   }
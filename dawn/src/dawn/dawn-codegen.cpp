@@ -15,6 +15,7 @@
 #include "dawn/CodeGen/Driver.h"
 #include "dawn/IIR/StencilInstantiation.h"
 #include "dawn/Serialization/IIRSerializer.h"
+#include "dawn/Support/FileSystem.h"
 #include "dawn/Support/Logger.h"
 
 #include <cxxopts.hpp>
@@ -128,6 +129,10 @@ int main(int argc, char* argv[]) {
   codegenOptions.NAME = result[OPTION].as<TYPE>();
 #include "dawn/CodeGen/Options.inc"
 #undef OPT
+  // A relative path would be resolved relative to the generated file which includes the header
+  if(!codegenOptions.PrecompiledHeader.empty())
+    codegenOptions.PrecompiledHeader = fs::absolute(codegenOptions.PrecompiledHeader).string();
+
   auto translationUnit = dawn::codegen::run(stencilInstantiationMap, backend, codegenOptions);
 
   auto code = dawn::codegen::generate(translationUnit);
@@ -71,6 +71,10 @@ dawn::PassGroup parsePassGroup(const std::string& passGroup) {
     return dawn::PassGroup::MultiStageMerger;
   else if(passGroup == "SetLoopOrder" || passGroup == "set-loop-order")
     return dawn::PassGroup::SetLoopOrder;
+  else if(passGroup == "CommonSubexpressionElimination" || passGroup == "cse")
+    return dawn::PassGroup::CommonSubexpressionElimination;
+  else if(passGroup == "ConstantFolding" || passGroup == "constant-folding")
+    return dawn::PassGroup::ConstantFolding;
   else
     throw std::runtime_error(std::string("Unknown pass group: ") + passGroup);
 }
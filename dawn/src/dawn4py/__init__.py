@@ -28,6 +28,7 @@ from ._dawn4py import OptimizerOptions, CodeGenOptions
 from ._dawn4py import PassGroup, CodeGenBackend
 from ._dawn4py import LogLevel
 from ._dawn4py import default_pass_groups, set_verbosity
+from ._dawn4py import Interpreter, JIT
 
 try:
     import os
@@ -6,19 +6,36 @@
 
 #include "dawn/CodeGen/Driver.h"
 #include "dawn/Compiler/Driver.h"
+#include "dawn/Interpreter/Interpreter.h"
+#include "dawn/JIT/JIT.h"
 
 #include "dawn/Support/Exception.h"
+#include "dawn/Support/FileSystem.h"
 #include "dawn/Support/Logger.h"
 
+#include <algorithm>
+#include <array>
 #include <list>
 #include <map>
+#include <memory>
 #include <string>
+#include <vector>
 
+#include <pybind11/numpy.h>
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
 
 namespace py = ::pybind11;
 
+namespace {
+
+/// A relative path would be resolved relative to the generated file which includes the header
+std::string absolutePrecompiledHeader(const std::string& path) {
+  return path.empty() ? path : fs::absolute(path).string();
+}
+
+} // namespace
+
 PYBIND11_MODULE(_dawn4py, m) {
   m.doc() = "Dawn DSL toolchain"; // optional module docstring
 
@@ -56,6 +73,8 @@ PYBIND11_MODULE(_dawn4py, m) {
       .value("SetBlockSize", dawn::PassGroup::SetBlockSize)
       .value("DataLocalityMetric", dawn::PassGroup::DataLocalityMetric)
       .value("SetLoopOrder", dawn::PassGroup::SetLoopOrder)
+      .value("CommonSubexpressionElimination", dawn::PassGroup::CommonSubexpressionElimination)
+      .value("ConstantFolding", dawn::PassGroup::ConstantFolding)
       .export_values();
 
   py::enum_<dawn::codegen::Backend>(m, "CodeGenBackend")
@@ -183,7 +202,11 @@ PYBIND11_MODULE(_dawn4py, m) {
       .def(py::init([](int MaxHaloSize, bool UseParallelEP, bool RunWithSync, int MaxBlocksPerSM,
                        int nsms, int DomainSizeI, int DomainSizeJ, int DomainSizeK,
                        const std::string& OutputCHeader, const std::string& OutputFortranInterface,
-                       bool AtlasCompatible, int BlockSize, int LevelsPerThread) {
+                       bool AtlasCompatible, int BlockSize, int LevelsPerThread, bool SlimRuntime,
+                       const std::string& PrecompiledHeader, bool TmpMemoryPlanning,
+                       bool ReduceTmpDimensions, int FusedStencilTileSize, bool Vectorize,
+                       bool ParallelElementLoops, bool NeighborTables, bool ColumnMajorLoops,
+                       bool RawPointerAccess) {
              return dawn::codegen::Options{MaxHaloSize,
                                            UseParallelEP,
                                            RunWithSync,
@@ -196,14 +219,29 @@ PYBIND11_MODULE(_dawn4py, m) {
                                            OutputFortranInterface,
                                            AtlasCompatible,
                                            BlockSize,
-                                           LevelsPerThread};
+                                           LevelsPerThread,
+                                           SlimRuntime,
+                                           absolutePrecompiledHeader(PrecompiledHeader),
+                                           TmpMemoryPlanning,
+                                           ReduceTmpDimensions,
+                                           FusedStencilTileSize,
+                                           Vectorize,
+                                           ParallelElementLoops,
+                                           NeighborTables,
+                                           ColumnMajorLoops,
+                                           RawPointerAccess};
            }),
            py::arg("max_halo_size") = 3, py::arg("use_parallel_ep") = false,
            py::arg("run_with_sync") = true, py::arg("max_blocks_per_sm") = 0, py::arg("nsms") = 0,
            py::arg("domain_size_i") = 0, py::arg("domain_size_j") = 0, py::arg("domain_size_k") = 0,
            py::arg("output_c_header") = "", py::arg("output_fortran_interface") = "",
            py::arg("atlas_compatible") = false, py::arg("block_size") = 128,
-           py::arg("levels_per_thread") = 1)
+           py::arg("levels_per_thread") = 1, py::arg("slim_runtime") = false,
+           py::arg("precompiled_header") = "", py::arg("tmp_memory_planning") = false,
+           py::arg("reduce_tmp_dimensions") = false, py::arg("fused_stencil_tile_size") = 0,
+           py::arg("vectorize") = false, py::arg("parallel_element_loops") = false,
+           py::arg("neighbor_tables") = false, py::arg("column_major_loops") = false,
+           py::arg("raw_pointer_access") = false)
       .def_readwrite("max_halo_size", &dawn::codegen::Options::MaxHaloSize)
       .def_readwrite("use_parallel_ep", &dawn::codegen::Options::UseParallelEP)
       .def_readwrite("run_with_sync", &dawn::codegen::Options::RunWithSync)
@@ -217,6 +255,21 @@ PYBIND11_MODULE(_dawn4py, m) {
       .def_readwrite("atlas_compatible", &dawn::codegen::Options::AtlasCompatible)
       .def_readwrite("block_size", &dawn::codegen::Options::BlockSize)
       .def_readwrite("levels_per_thread", &dawn::codegen::Options::LevelsPerThread)
+      .def_readwrite("slim_runtime", &dawn::codegen::Options::SlimRuntime)
+      .def_property(
+          "precompiled_header",
+          [](const dawn::codegen::Options& self) { return self.PrecompiledHeader; },
+          [](dawn::codegen::Options& self, const std::string& path) {
+            self.PrecompiledHeader = absolutePrecompiledHeader(path);
+          })
+      .def_readwrite("tmp_memory_planning", &dawn::codegen::Options::TmpMemoryPlanning)
+      .def_readwrite("reduce_tmp_dimensions", &dawn::codegen::Options::ReduceTmpDimensions)
+      .def_readwrite("fused_stencil_tile_size", &dawn::codegen::Options::FusedStencilTileSize)
+      .def_readwrite("vectorize", &dawn::codegen::Options::Vectorize)
+      .def_readwrite("parallel_element_loops", &dawn::codegen::Options::ParallelElementLoops)
+      .def_readwrite("neighbor_tables", &dawn::codegen::Options::NeighborTables)
+      .def_readwrite("column_major_loops", &dawn::codegen::Options::ColumnMajorLoops)
+      .def_readwrite("raw_pointer_access", &dawn::codegen::Options::RawPointerAccess)
       .def("__repr__", [](const dawn::codegen::Options& self) {
         std::ostringstream ss;
         ss << "max_halo_size=" << self.MaxHaloSize << ",\n    "
@@ -235,7 +288,19 @@ PYBIND11_MODULE(_dawn4py, m) {
            << ",\n    "
            << "atlas_compatible=" << self.AtlasCompatible << ",\n    "
            << "block_size=" << self.BlockSize << ",\n    "
-           << "levels_per_thread=" << self.LevelsPerThread;
+           << "levels_per_thread=" << self.LevelsPerThread << ",\n    "
+           << "slim_runtime=" << self.SlimRuntime << ",\n    "
+           << "precompiled_header="
+           << "\"" << self.PrecompiledHeader << "\""
+           << ",\n    "
+           << "tmp_memory_planning=" << self.TmpMemoryPlanning << ",\n    "
+           << "reduce_tmp_dimensions=" << self.ReduceTmpDimensions << ",\n    "
+           << "fused_stencil_tile_size=" << self.FusedStencilTileSize << ",\n    "
+           << "vectorize=" << self.Vectorize << ",\n    "
+           << "parallel_element_loops=" << self.ParallelElementLoops << ",\n    "
+           << "neighbor_tables=" << self.NeighborTables << ",\n    "
+           << "column_major_loops=" << self.ColumnMajorLoops << ",\n    "
+           << "raw_pointer_access=" << self.RawPointerAccess;
         return "CodeGenOptions(\n    " + ss.str() + "\n)";
       });
 
@@ -294,4 +359,96 @@ PYBIND11_MODULE(_dawn4py, m) {
       py::arg("groups") = dawn::defaultPassGroups(), py::arg("optimizer_options") = dawn::Options(),
       py::arg("backend") = dawn::codegen::Backend::GridTools,
       py::arg("codegen_options") = dawn::codegen::Options());
+
+  // Interpreter
+  py::class_<dawn::interpreter::Interpreter>(m, "Interpreter")
+      .def(py::init([](const std::string& stencilInstantiation, dawn::IIRSerializer::Format format,
+                       int blockSize) {
+             return std::make_unique<dawn::interpreter::Interpreter>(
+                 dawn::IIRSerializer::deserializeFromString(stencilInstantiation, format),
+                 blockSize);
+           }),
+           "Compile a (serialized) stencil instantiation for evaluation without code generation.",
+           py::arg("stencil_instantiation"), py::arg("format") = dawn::IIRSerializer::Format::Byte,
+           py::arg("block_size") = 64)
+      .def("field_names", &dawn::interpreter::Interpreter::getFieldNames,
+           "Names of the API fields, in the order of the stencil arguments.")
+      .def("set_global", &dawn::interpreter::Interpreter::setGlobal,
+           "Override the value of a global variable.", py::arg("name"), py::arg("value"))
+      .def(
+          "run_cartesian",
+          [](dawn::interpreter::Interpreter& self,
+             std::map<std::string, py::object> fields, const std::array<int, 3>& size,
+             const std::array<int, 3>& minus, const std::array<int, 3>& plus) {
+            std::map<std::string, dawn::interpreter::FieldView> views;
+            for(auto& field : fields) {
+              // the stencil runs in place: a converted copy would silently lose the results
+              if(!py::isinstance<py::array>(field.second))
+                throw py::type_error("field '" + field.first + "' is not a numpy array");
+              auto array = py::reinterpret_borrow<py::array>(field.second);
+              if(array.dtype().kind() != 'f' || array.itemsize() != sizeof(double))
+                throw py::type_error("field '" + field.first + "' is not of dtype float64");
+              if(!array.writeable())
+                throw py::value_error("field '" + field.first + "' is read-only");
+              for(py::ssize_t dim = 0; dim < array.ndim(); ++dim)
+                if(array.strides(dim) % static_cast<py::ssize_t>(sizeof(double)) != 0)
+                  throw py::value_error("field '" + field.first +
+                                        "' has strides that are not a multiple of its item size");
+              // the array has one dimension per (i, j, k) dimension of the field, in this order
+              const auto dims = self.getFieldDimensions(field.first);
+              if(array.ndim() != std::count(dims.begin(), dims.end(), true))
+                throw py::value_error("field '" + field.first + "' expects an array with " +
+                                      std::to_string(std::count(dims.begin(), dims.end(), true)) +
+                                      " dimensions, got " + std::to_string(array.ndim()));
+              dawn::interpreter::FieldView view;
+              view.Data = array.mutable_data();
+              for(int dim = 0, arrayDim = 0; dim < 3; ++dim) {
+                if(!dims[dim])
+                  continue;
+                if(array.shape(arrayDim) < size[dim])
+                  throw py::value_error("field '" + field.first + "' has a shape of " +
+                                        std::to_string(array.shape(arrayDim)) + " in dimension " +
+                                        std::to_string(dim) + ", the domain a size of " +
+                                        std::to_string(size[dim]));
+                view.Strides[dim] =
+                    array.strides(arrayDim++) / static_cast<py::ssize_t>(sizeof(double));
+              }
+              views.emplace(field.first, view);
+            }
+            self.run(dawn::interpreter::CartesianDomain{size, minus, plus}, views);
+          },
+          "Run the stencil in place on numpy arrays of dtype float64 with one dimension per (i, j, "
+          "k) dimension of the field, raises if an array would need to be converted (other dtype, "
+          "read-only) or is smaller than the domain. 'size' includes the halos.",
+          py::arg("fields"), py::arg("size"), py::arg("minus") = std::array<int, 3>{{0, 0, 0}},
+          py::arg("plus") = std::array<int, 3>{{0, 0, 0}})
+      .def("__str__", &dawn::interpreter::Interpreter::toString);
+
+  // JIT
+  py::class_<dawn::jit::CompiledModule, std::shared_ptr<dawn::jit::CompiledModule>>(
+      m, "CompiledModule")
+      .def_property_readonly("hash", &dawn::jit::CompiledModule::getHash)
+      .def(
+          "symbol_address",
+          [](const dawn::jit::CompiledModule& self, const std::string& name) {
+            return reinterpret_cast<std::uintptr_t>(self.getSymbolAddress(name));
+          },
+          "Address of the extern \"C\" symbol 'name' (e.g. for ctypes.CFUNCTYPE).",
+          py::arg("name"));
+
+  py::class_<dawn::jit::JIT>(m, "JIT")
+      .def(py::init([](const std::vector<std::string>& includeDirs,
+                       const std::vector<std::string>& defines,
+                       const std::vector<std::string>& flags, const std::string& cacheDir) {
+             return std::make_unique<dawn::jit::JIT>(
+                 dawn::jit::Options{includeDirs, defines, flags, cacheDir});
+           }),
+           "In-memory C++ compiler for generated code, caching modules by content hash.",
+           py::arg("include_dirs") = std::vector<std::string>(),
+           py::arg("defines") = std::vector<std::string>(),
+           py::arg("flags") = dawn::jit::Options().Flags, py::arg("cache_dir") = "")
+      .def("compile", py::overload_cast<const std::string&>(&dawn::jit::JIT::compile),
+           "Compile C++ code (generated code followed by extern \"C\" entry points).",
+           py::arg("code"))
+      .def("hash", &dawn::jit::JIT::hash, "Cache key of 'code'.", py::arg("code"));
 }
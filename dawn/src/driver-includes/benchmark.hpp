@@ -0,0 +1,349 @@
+//===--------------------------------------------------------------------------------*- C++ -*-===//
+//                          _
+//                         | |
+//                       __| | __ ___      ___ ___
+//                      / _` |/ _` \ \ /\ / / '_  |
+//                     | (_| | (_| |\ V  V /| | | |
+//                      \__,_|\__,_| \_/\_/ |_| |_| - Compiler Toolchain
+//
+//
+//  This file is distributed under the MIT License (MIT).
+//  See LICENSE.txt for details.
+//
+//===------------------------------------------------------------------------------------------===//
+
+#pragma once
+
+#include "extent.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#ifdef __linux__
+#include <cstdlib>
+#include <cstring>
+#include <dirent.h>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace dawn {
+namespace driver {
+
+/**
+ * @brief Memory traffic of one field during one stencil run
+ *
+ * The effective bandwidth assumes every accessed element is moved once per read and once per
+ * write, i.e. perfect caching.
+ */
+struct field_footprint {
+  std::string name;
+  std::size_t elements;
+  std::size_t element_size;
+  bool read;
+  bool written;
+
+  std::size_t bytes() const {
+    return elements * element_size * ((read ? 1 : 0) + (written ? 1 : 0));
+  }
+};
+
+namespace detail {
+// Undefined (e.g 2D fields) extents are encoded as numeric_limits::min/max
+inline std::size_t extended_size(unsigned int size, int minus, int plus) {
+  const int bound = static_cast<int>(size);
+  minus = (minus < 0 && minus >= -bound) ? -minus : 0;
+  plus = (plus > 0 && plus <= bound) ? plus : 0;
+  return size + minus + plus;
+}
+} // namespace detail
+
+/**
+ * @brief Footprint of a Cartesian field accessed with `extent` (e.g `stencil::in_extent`) on a
+ * compute domain of `size`
+ */
+inline field_footprint cartesian_footprint(const std::string& name,
+                                           const std::array<unsigned int, 3>& size,
+                                           const cartesian_extent& extent,
+                                           std::size_t element_size, bool read, bool written) {
+  std::size_t elements = 1;
+  for(int d = 0; d < 3; ++d)
+    elements *= detail::extended_size(size[d], extent[d][0], extent[d][1]);
+  return field_footprint{name, elements, element_size, read, written};
+}
+
+/**
+ * @brief Footprint of an unstructured (dense or sparse) field
+ */
+inline field_footprint unstructured_footprint(const std::string& name, std::size_t num_elements,
+                                              std::size_t k_size, std::size_t sparse_size,
+                                              std::size_t element_size, bool read, bool written) {
+  return field_footprint{name, num_elements * k_size * std::max<std::size_t>(sparse_size, 1),
+                         element_size, read, written};
+}
+
+/**
+ * @brief Linux `perf_event` hardware counters of all threads of the process
+ *
+ * The counters are opened for the threads alive at construction (e.g the OpenMP pool started by
+ * the warmup runs) and inherited by the threads these create later. Counters which cannot be
+ * opened (no PMU in a VM, `perf_event_paranoid`, non-Linux) are skipped, `available()` is false if
+ * none could be opened. Values are scaled when the kernel multiplexes the counters.
+ */
+class perf_counters {
+public:
+  perf_counters() {
+#ifdef __linux__
+    std::vector<int> threads;
+    if(DIR* dir = opendir("/proc/self/task")) {
+      while(const dirent* entry = readdir(dir))
+        if(entry->d_name[0] != '.')
+          threads.push_back(std::atoi(entry->d_name));
+      closedir(dir);
+    }
+    add("cycles", PERF_COUNT_HW_CPU_CYCLES, threads);
+    add("instructions", PERF_COUNT_HW_INSTRUCTIONS, threads);
+    add("cache_references", PERF_COUNT_HW_CACHE_REFERENCES, threads);
+    add("cache_misses", PERF_COUNT_HW_CACHE_MISSES, threads);
+    add("branch_misses", PERF_COUNT_HW_BRANCH_MISSES, threads);
+#endif
+  }
+  ~perf_counters() {
+#ifdef __linux__
+    for(const counter& c : m_counters)
+      for(int fd : c.fds)
+        close(fd);
+#endif
+  }
+  perf_counters(const perf_counters&) = delete;
+  perf_counters& operator=(const perf_counters&) = delete;
+
+  bool available() const { return !m_counters.empty(); }
+
+  /**
+   * @brief Number of threads the counters were opened for (not counting inheriting threads)
+   */
+  std::size_t threads() const { return available() ? m_counters.front().fds.size() : 0; }
+
+  void start() {
+#ifdef __linux__
+    for(const counter& c : m_counters)
+      for(int fd : c.fds)
+        ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+#endif
+  }
+
+  void stop() {
+#ifdef __linux__
+    for(const counter& c : m_counters)
+      for(int fd : c.fds)
+        ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+#endif
+  }
+
+  /**
+   * @brief Counter values accumulated over all start/stop intervals
+   */
+  std::vector<std::pair<std::string, double>> read() const {
+    std::vector<std::pair<std::string, double>> values;
+#ifdef __linux__
+    for(const counter& c : m_counters) {
+      // sum of the threads, the kernel adds the counts of inherited counters
+      double sum = 0;
+      for(int fd : c.fds) {
+        std::uint64_t data[3] = {0, 0, 0}; // value, time enabled, time running
+        if(::read(fd, data, sizeof(data)) != sizeof(data))
+          continue;
+        double value = static_cast<double>(data[0]);
+        if(data[2] > 0 && data[2] < data[1])
+          value *= static_cast<double>(data[1]) / static_cast<double>(data[2]);
+        sum += value;
+      }
+      values.emplace_back(c.name, sum);
+    }
+#endif
+    return values;
+  }
+
+private:
+  struct counter {
+    std::string name;
+    std::vector<int> fds; // one per thread
+  };
+
+#ifdef __linux__
+  void add(const char* name, std::uint64_t config, const std::vector<int>& threads) {
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = config;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.inherit = 1;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    counter c{name, {}};
+    for(int tid : threads) {
+      // threads which exited in the meantime are skipped
+      const int fd = static_cast<int>(syscall(__NR_perf_event_open, &attr, tid, -1, -1, 0));
+      if(fd >= 0)
+        c.fds.push_back(fd);
+    }
+    if(!c.fds.empty())
+      m_counters.push_back(std::move(c));
+  }
+#endif
+
+  std::vector<counter> m_counters;
+};
+
+struct benchmark_options {
+  /// Untimed runs (first touch, caches, lazy initialization)
+  int warmup = 3;
+  /// Timed runs
+  int repetitions = 20;
+  /// Read the hardware counters (if available)
+  bool counters = true;
+};
+
+/**
+ * @brief Timings [s] of the individual repetitions and derived metrics
+ */
+struct benchmark_result {
+  std::string name;
+  std::vector<double> times;
+  /// Memory traffic [bytes] and floating point operations of one run (0 if unknown)
+  std::size_t bytes = 0;
+  double flops = 0;
+  /// Hardware counters, summed over all threads and averaged per run
+  std::vector<std::pair<std::string, double>> counters;
+  /// Threads the counters were opened for
+  std::size_t counter_threads = 0;
+
+  double min() const { return *std::min_element(times.begin(), times.end()); }
+  double max() const { return *std::max_element(times.begin(), times.end()); }
+  double mean() const {
+    double sum = 0;
+    for(double t : times)
+      sum += t;
+    return sum / times.size();
+  }
+  double stddev() const {
+    const double m = mean();
+    double sum = 0;
+    for(double t : times)
+      sum += (t - m) * (t - m);
+    return times.size() > 1 ? std::sqrt(sum / (times.size() - 1)) : 0.0;
+  }
+
+  /**
+   * @brief `p`-th percentile (0 <= p <= 100), linearly interpolated
+   */
+  double percentile(double p) const {
+    std::vector<double> sorted(times);
+    std::sort(sorted.begin(), sorted.end());
+    const double pos = p / 100.0 * (sorted.size() - 1);
+    const std::size_t lower = static_cast<std::size_t>(pos);
+    const std::size_t upper = std::min(lower + 1, sorted.size() - 1);
+    return sorted[lower] + (pos - lower) * (sorted[upper] - sorted[lower]);
+  }
+  double median() const { return percentile(50); }
+
+  /// Effective bandwidth [GB/s] of the median run
+  double bandwidth() const { return bytes / median() * 1e-9; }
+  /// Floating point throughput [GFLOP/s] of the median run
+  double gflops() const { return flops / median() * 1e-9; }
+
+  void to_json(std::ostream& os) const {
+    os << "{\"name\": \"";
+    for(char c : name) {
+      if(c == '"' || c == '\\')
+        os << '\\';
+      os << c;
+    }
+    os << "\", \"repetitions\": " << times.size() << ", \"time\": {\"min\": " << min()
+       << ", \"p10\": " << percentile(10) << ", \"median\": " << median()
+       << ", \"p90\": " << percentile(90) << ", \"max\": " << max() << ", \"mean\": " << mean()
+       << ", \"stddev\": " << stddev() << "}";
+    if(bytes > 0)
+      os << ", \"bytes\": " << bytes << ", \"bandwidth_gb_s\": " << bandwidth();
+    if(flops > 0)
+      os << ", \"flops\": " << flops << ", \"gflop_s\": " << gflops();
+    os << ", \"counters\": {";
+    for(std::size_t i = 0; i < counters.size(); ++i)
+      os << (i ? ", " : "") << "\"" << counters[i].first << "\": " << counters[i].second;
+    os << "}";
+    if(!counters.empty())
+      os << ", \"counter_threads\": " << counter_threads;
+    os << "}";
+  }
+};
+
+/**
+ * @brief Benchmark `run` (e.g `[&] { stencil.run(in, out); }`)
+ *
+ * @param footprints  Fields accessed by one run, used for the effective bandwidth
+ * @param flops       Floating point operations of one run, used for the throughput
+ */
+template <typename Run>
+benchmark_result run_benchmark(const std::string& name, Run&& run,
+                               const std::vector<field_footprint>& footprints = {},
+                               double flops = 0,
+                               const benchmark_options& options = benchmark_options()) {
+  using clock = std::chrono::steady_clock;
+
+  for(int i = 0; i < options.warmup; ++i)
+    run();
+
+  benchmark_result result;
+  result.name = name;
+  result.flops = flops;
+  for(const field_footprint& footprint : footprints)
+    result.bytes += footprint.bytes();
+
+  // opened after the warmup, which starts the worker threads of parallel runs
+  std::unique_ptr<perf_counters> counters(options.counters ? new perf_counters() : nullptr);
+  for(int i = 0; i < std::max(options.repetitions, 1); ++i) {
+    if(counters)
+      counters->start();
+    const clock::time_point start = clock::now();
+    run();
+    const clock::time_point end = clock::now();
+    if(counters)
+      counters->stop();
+    result.times.push_back(std::chrono::duration<double>(end - start).count());
+  }
+
+  if(counters) {
+    for(const auto& counter : counters->read())
+      result.counters.emplace_back(counter.first, counter.second / result.times.size());
+    result.counter_threads = counters->threads();
+  }
+  return result;
+}
+
+/**
+ * @brief Write `results` as `{"benchmarks": [...]}`
+ */
+inline void write_json(std::ostream& os, const std::vector<benchmark_result>& results) {
+  os << "{\"benchmarks\": [";
+  for(std::size_t i = 0; i < results.size(); ++i) {
+    os << (i ? ",\n  " : "\n  ");
+    results[i].to_json(os);
+  }
+  os << "\n]}\n";
+}
+
+} // namespace driver
+} // namespace dawn
@@ -0,0 +1,456 @@
+//===--------------------------------------------------------------------------------*- C++ -*-===//
+//                          _
+//                         | |
+//                       __| | __ ___      ___ ___
+//                      / _` |/ _` \ \ /\ / / '_  |
+//                     | (_| | (_| |\ V  V /| | | |
+//                      \__,_|\__,_| \_/\_/ |_| |_| - Compiler Toolchain
+//
+//
+//  This file is distributed under the MIT License (MIT).
+//  See LICENSE.txt for details.
+//
+//===------------------------------------------------------------------------------------------===//
+
+#pragma once
+
+#include "driver-includes/domain.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace dawn {
+namespace driver {
+
+/**
+ * @brief Decomposition of a Cartesian domain into `xcols` x `ycols` equally sized subdomains
+ *
+ * Rank `r` owns the subdomain in column `r % xcols` and row `r / xcols`, like the
+ * `computeGlobalOffsets` of the generated stencils (constructed with `rank`, `xcols` and `ycols`).
+ * Every rank stores its subdomain surrounded by a halo of `halo::value` points in i and j, its
+ * local indices of the compute domain start at `halo::value`.
+ */
+class cartesian_decomposition {
+public:
+  /**
+   * @param size        Global compute domain, must be divisible by `xcols` and `ycols`
+   * @param periodic_i  Neighbors wrap around in i (j), otherwise the halos at the boundary of the
+   *                    global domain are left alone
+   */
+  cartesian_decomposition(const std::array<unsigned int, 3>& size, int xcols, int ycols,
+                          bool periodic_i = false, bool periodic_j = false)
+      : m_size(size), m_xcols(xcols), m_ycols(ycols), m_periodic{{periodic_i, periodic_j}} {
+    if(xcols < 1 || ycols < 1 || size[0] % xcols != 0 || size[1] % ycols != 0)
+      throw std::invalid_argument("cartesian_decomposition: the domain is not divisible into "
+                                  "xcols x ycols equal subdomains");
+  }
+
+  int ranks() const { return m_xcols * m_ycols; }
+  int xcols() const { return m_xcols; }
+  int ycols() const { return m_ycols; }
+  int col(int rank) const { return rank % m_xcols; }
+  int row(int rank) const { return rank / m_xcols; }
+
+  /**
+   * @brief Rank of the neighbor `di` columns and `dj` rows away, -1 beyond a non-periodic boundary
+   */
+  int neighbor(int rank, int di, int dj) const {
+    int c = col(rank) + di;
+    int r = row(rank) + dj;
+    if(m_periodic[0])
+      c = (c % m_xcols + m_xcols) % m_xcols;
+    if(m_periodic[1])
+      r = (r % m_ycols + m_ycols) % m_ycols;
+    if(c < 0 || c >= m_xcols || r < 0 || r >= m_ycols)
+      return -1;
+    return r * m_xcols + c;
+  }
+
+  /// Size of the compute domain of every rank
+  std::array<unsigned int, 3> local_size() const {
+    return {{m_size[0] / m_xcols, m_size[1] / m_ycols, m_size[2]}};
+  }
+
+  /**
+   * @brief Offset from the local to the global indices of `rank` (see `computeGlobalOffsets`)
+   */
+  std::array<unsigned int, 2> global_offset(int rank) const {
+    const std::array<unsigned int, 3> size = local_size();
+    return {{col(rank) * size[0], row(rank) * size[1]}};
+  }
+
+  /**
+   * @brief Domain of a rank (to allocate its storages and construct its stencils)
+   */
+  gridtools::dawn::domain local_domain() const {
+    const std::array<unsigned int, 3> size = local_size();
+    return gridtools::dawn::domain(size[0] + 2 * halo(), size[1] + 2 * halo(), size[2]);
+  }
+
+  /**
+   * @brief Compute points of a rank which are at least `width` points away from its halo
+   *
+   * Stencils reading at most `width` points away can run on this domain before the halos are
+   * exchanged. The compute domain of the ranks needs to be at least `2 * width` points wide.
+   */
+  gridtools::dawn::domain inner_domain(unsigned int width) const {
+    check_width(width);
+    gridtools::dawn::domain dom = local_domain();
+    const unsigned int h = halo() + width;
+    dom.set_halos(h, h, h, h, 0, 0);
+    return dom;
+  }
+
+  /**
+   * @brief Compute points of a rank which are not in `inner_domain(width)`, as up to four strips
+   *
+   * The south and north strips span the whole compute domain in i, the west and east strips the
+   * rest in j.
+   */
+  std::vector<gridtools::dawn::domain> boundary_domains(unsigned int width) const {
+    check_width(width);
+    const std::array<unsigned int, 3> size = local_size();
+    const unsigned int h = halo();
+    const unsigned int w = width;
+    std::vector<gridtools::dawn::domain> strips;
+    if(w == 0)
+      return strips;
+    auto add = [&](unsigned int iminus, unsigned int iplus, unsigned int jminus,
+                   unsigned int jplus) {
+      gridtools::dawn::domain dom = local_domain();
+      dom.set_halos(iminus, iplus, jminus, jplus, 0, 0);
+      strips.push_back(dom);
+    };
+    add(h, h, h, h + size[1] - w);         // south
+    add(h, h, h + size[1] - w, h);         // north
+    add(h, h + size[0] - w, h + w, h + w); // west
+    add(h + size[0] - w, h, h + w, h + w); // east
+    return strips;
+  }
+
+  static unsigned int halo() { return gridtools::dawn::halo::value; }
+
+private:
+  // strips wider than half the compute domain would overlap
+  void check_width(unsigned int width) const {
+    const std::array<unsigned int, 3> size = local_size();
+    if(2 * width > std::min(size[0], size[1]))
+      throw std::invalid_argument("cartesian_decomposition: the compute domain of the ranks is "
+                                  "smaller than twice the width of the boundary");
+  }
+
+  std::array<unsigned int, 3> m_size;
+  int m_xcols;
+  int m_ycols;
+  std::array<bool, 2> m_periodic;
+};
+
+/**
+ * @brief Thrown by the operations of an aborted transport
+ */
+class transport_aborted : public std::runtime_error {
+public:
+  transport_aborted() : std::runtime_error("transport: aborted by a failing rank") {}
+};
+
+/**
+ * @brief Point-to-point messages between the ranks
+ *
+ * Implementations for other transports (e.g MPI) only need to provide these operations.
+ */
+class transport {
+public:
+  virtual ~transport() {}
+
+  /**
+   * @brief Send `bytes` from rank `from` to rank `to` without waiting for the receiver
+   *
+   * `data` can be reused as soon as the call returns. Messages with the same `from`, `to` and
+   * `tag` are received in the order they were sent.
+   */
+  virtual void send(int from, int to, int tag, const void* data, std::size_t bytes) = 0;
+
+  /**
+   * @brief Wait for the message `tag` from rank `from` to rank `to` and copy it to `data`
+   */
+  virtual void receive(int to, int from, int tag, void* data, std::size_t bytes) = 0;
+
+  /**
+   * @brief Wait until all ranks reached the barrier
+   */
+  virtual void barrier() = 0;
+
+  /**
+   * @brief Stop the communication after a rank failed
+   *
+   * The ranks waiting in `receive` or `barrier`, and the ones calling them later, throw
+   * `transport_aborted` instead of waiting for the failed rank.
+   */
+  virtual void abort() = 0;
+};
+
+/**
+ * @brief Transport between ranks running as threads of the same process
+ */
+class shared_memory_transport : public transport {
+public:
+  explicit shared_memory_transport(int ranks)
+      : m_mailboxes(ranks), m_ranks(ranks), m_arrived(0), m_generation(0), m_aborted(false) {}
+
+  void send(int from, int to, int tag, const void* data, std::size_t bytes) override {
+    const char* begin = static_cast<const char*>(data);
+    std::vector<char> message(begin, begin + bytes);
+    mailbox& box = m_mailboxes.at(to);
+    {
+      std::lock_guard<std::mutex> lock(box.mutex);
+      box.messages[std::make_pair(from, tag)].push_back(std::move(message));
+    }
+    box.arrived.notify_all();
+  }
+
+  void receive(int to, int from, int tag, void* data, std::size_t bytes) override {
+    mailbox& box = m_mailboxes.at(to);
+    std::unique_lock<std::mutex> lock(box.mutex);
+    std::deque<std::vector<char>>& queue = box.messages[std::make_pair(from, tag)];
+    box.arrived.wait(lock, [&] { return !queue.empty() || m_aborted; });
+    if(m_aborted)
+      throw transport_aborted();
+    if(queue.front().size() != bytes)
+      throw std::runtime_error("shared_memory_transport: unexpected message size");
+    std::memcpy(data, queue.front().data(), bytes);
+    queue.pop_front();
+  }
+
+  void barrier() override {
+    std::unique_lock<std::mutex> lock(m_barrierMutex);
+    if(m_aborted)
+      throw transport_aborted();
+    const unsigned long generation = m_generation;
+    if(++m_arrived == m_ranks) {
+      m_arrived = 0;
+      ++m_generation;
+      m_barrierReached.notify_all();
+    } else {
+      m_barrierReached.wait(lock, [&] { return m_generation != generation || m_aborted; });
+      if(m_generation == generation)
+        throw transport_aborted();
+    }
+  }
+
+  void abort() override {
+    // the flag is set while holding the mutex of each waiting condition, such that a rank can not
+    // miss the notification between checking the flag and starting to wait
+    for(mailbox& box : m_mailboxes) {
+      {
+        std::lock_guard<std::mutex> lock(box.mutex);
+        m_aborted = true;
+      }
+      box.arrived.notify_all();
+    }
+    {
+      std::lock_guard<std::mutex> lock(m_barrierMutex);
+      m_aborted = true;
+    }
+    m_barrierReached.notify_all();
+  }
+
+private:
+  struct mailbox {
+    std::mutex mutex;
+    std::condition_variable arrived;
+    std::map<std::pair<int, int>, std::deque<std::vector<char>>> messages;
+  };
+
+  std::vector<mailbox> m_mailboxes;
+  int m_ranks;
+  std::mutex m_barrierMutex;
+  std::condition_variable m_barrierReached;
+  int m_arrived;
+  unsigned long m_generation;
+  std::atomic<bool> m_aborted;
+};
+
+/**
+ * @brief Exchange of the halos of the fields of one rank with its (up to eight) neighbors
+ *
+ * Fields are accessed as `field(i, j, k)` in local indices (e.g a GridTools host view), halos of
+ * `width` points are exchanged for the levels `[0, ksize)` of the domain. The exchange is split
+ * such that work not depending on the halos can be done in between:
+ *
+ * @code
+ *   exchange.start(in);
+ *   inner_stencil.run(in, out);  // on decomposition.inner_domain(radius)
+ *   exchange.finish(in);
+ *   for(auto& stencil : boundary_stencils)  // on decomposition.boundary_domains(radius)
+ *     stencil.run(in, out);
+ * @endcode
+ */
+template <typename T>
+class halo_exchange {
+public:
+  halo_exchange(const cartesian_decomposition& decomposition, transport& transport, int rank,
+                unsigned int width = gridtools::dawn::halo::value)
+      : m_decomposition(decomposition), m_transport(transport), m_rank(rank),
+        m_width(std::min(width, cartesian_decomposition::halo())) {}
+
+  /**
+   * @brief Send the points of `field` which are in the halos of the neighbors
+   *
+   * @param tag  Distinguishes fields which are exchanged at the same time
+   */
+  template <typename Field>
+  void start(Field&& field, int tag = 0) {
+    for(int dir = 0; dir < 9; ++dir) {
+      const int to = neighbor(dir);
+      if(to < 0)
+        continue;
+      m_buffer.clear();
+      for_each_point(send_region(dir),
+                     [&](int i, int j, int k) { m_buffer.push_back(field(i, j, k)); });
+      m_transport.send(m_rank, to, message_tag(tag, dir), m_buffer.data(),
+                       m_buffer.size() * sizeof(T));
+    }
+  }
+
+  /**
+   * @brief Receive the halos of `field` sent by the `start` of the neighbors
+   */
+  template <typename Field>
+  void finish(Field&& field, int tag = 0) {
+    for(int dir = 0; dir < 9; ++dir) {
+      const int from = neighbor(dir);
+      if(from < 0)
+        continue;
+      const region recv = receive_region(dir);
+      m_buffer.resize(recv.points());
+      // the neighbor sent it in the opposite direction
+      m_transport.receive(m_rank, from, message_tag(tag, 8 - dir), m_buffer.data(),
+                          m_buffer.size() * sizeof(T));
+      std::size_t idx = 0;
+      for_each_point(recv, [&](int i, int j, int k) { field(i, j, k) = m_buffer[idx++]; });
+    }
+  }
+
+  /**
+   * @brief `start` and `finish` the exchange of `field`
+   */
+  template <typename Field>
+  void exchange(Field&& field, int tag = 0) {
+    start(field, tag);
+    finish(field, tag);
+  }
+
+private:
+  struct region {
+    std::array<int, 3> begin;
+    std::array<int, 3> end;
+    std::size_t points() const {
+      return std::size_t(end[0] - begin[0]) * (end[1] - begin[1]) * (end[2] - begin[2]);
+    }
+  };
+
+  // directions are numbered (di + 1) + 3 * (dj + 1), 4 being the rank itself
+  static int di(int dir) { return dir % 3 - 1; }
+  static int dj(int dir) { return dir / 3 - 1; }
+  static int message_tag(int tag, int dir) { return 9 * tag + dir; }
+
+  int neighbor(int dir) const {
+    return dir == 4 ? -1 : m_decomposition.neighbor(m_rank, di(dir), dj(dir));
+  }
+
+  // compute points within `width` of the boundary towards `dir`
+  region send_region(int dir) const {
+    const std::array<unsigned int, 3> size = m_decomposition.local_size();
+    const int h = cartesian_decomposition::halo();
+    const int w = m_width;
+    region r;
+    const int d[2] = {di(dir), dj(dir)};
+    for(int dim = 0; dim < 2; ++dim) {
+      const int n = size[dim];
+      r.begin[dim] = d[dim] > 0 ? h + n - w : h;
+      r.end[dim] = d[dim] < 0 ? h + w : h + n;
+    }
+    r.begin[2] = 0;
+    r.end[2] = size[2];
+    return r;
+  }
+
+  // halo points towards `dir`
+  region receive_region(int dir) const {
+    const std::array<unsigned int, 3> size = m_decomposition.local_size();
+    const int h = cartesian_decomposition::halo();
+    const int w = m_width;
+    region r;
+    const int d[2] = {di(dir), dj(dir)};
+    for(int dim = 0; dim < 2; ++dim) {
+      const int n = size[dim];
+      r.begin[dim] = d[dim] < 0 ? h - w : (d[dim] > 0 ? h + n : h);
+      r.end[dim] = d[dim] < 0 ? h : (d[dim] > 0 ? h + n + w : h + n);
+    }
+    r.begin[2] = 0;
+    r.end[2] = size[2];
+    return r;
+  }
+
+  template <typename Functor>
+  static void for_each_point(const region& r, Functor&& functor) {
+    for(int k = r.begin[2]; k < r.end[2]; ++k)
+      for(int j = r.begin[1]; j < r.end[1]; ++j)
+        for(int i = r.begin[0]; i < r.end[0]; ++i)
+          functor(i, j, k);
+  }
+
+  const cartesian_decomposition& m_decomposition;
+  transport& m_transport;
+  int m_rank;
+  int m_width;
+  std::vector<T> m_buffer;
+};
+
+/**
+ * @brief Run `body(rank)` for all `ranks`, each on its own thread, communicating over `transport`
+ *
+ * Storages should be allocated within `body` such that they are first touched by the thread of
+ * their rank. When a rank throws, `transport` is aborted such that the other ranks do not wait
+ * for it forever. The first exception thrown by a rank is rethrown once all ranks finished (the
+ * `transport_aborted` of the other ranks are dropped).
+ */
+template <typename Body>
+void run_ranks(int ranks, transport& transport, Body&& body) {
+  std::vector<std::thread> threads;
+  std::mutex error_mutex;
+  std::exception_ptr error;
+  threads.reserve(ranks);
+  for(int rank = 0; rank < ranks; ++rank)
+    threads.emplace_back([&, rank] {
+      try {
+        body(rank);
+      } catch(...) {
+        {
+          std::lock_guard<std::mutex> lock(error_mutex);
+          if(!error)
+            error = std::current_exception();
+        }
+        transport.abort();
+      }
+    });
+  for(std::thread& thread : threads)
+    thread.join();
+  if(error)
+    std::rethrow_exception(error);
+}
+
+} // namespace driver
+} // namespace dawn
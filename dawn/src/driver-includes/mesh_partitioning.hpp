@@ -0,0 +1,130 @@
+//===--------------------------------------------------------------------------------*- C++ -*-===//
+//                          _
+//                         | |
+//                       __| | __ ___      ___ ___
+//                      / _` |/ _` \ \ /\ / / '_  |
+//                     | (_| | (_| |\ V  V /| | | |
+//                      \__,_|\__,_| \_/\_/ |_| |_| - Compiler Toolchain
+//
+//
+//  This file is distributed under the MIT License (MIT).
+//  See LICENSE.txt for details.
+//
+//===------------------------------------------------------------------------------------------===//
+
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <numeric>
+#include <queue>
+#include <vector>
+
+namespace dawn {
+namespace driver {
+
+/**
+ * @brief Part of each element of one location type, between 0 and the number of parts - 1
+ */
+using partitioning = std::vector<int>;
+
+namespace detail {
+inline void bisect(const std::vector<double>& x, const std::vector<double>& y,
+                   std::vector<int>::iterator first, std::vector<int>::iterator last,
+                   int firstPart, int parts, partitioning& result) {
+  if(parts == 1 || first == last) {
+    for(auto it = first; it != last; ++it)
+      result[*it] = firstPart;
+    return;
+  }
+  auto extent = [&](const std::vector<double>& coord) {
+    auto bounds =
+        std::minmax_element(first, last, [&](int a, int b) { return coord[a] < coord[b]; });
+    return coord[*bounds.second] - coord[*bounds.first];
+  };
+  // cut across the longer side of the bounding box, in proportion to the parts on either side
+  const std::vector<double>& coord = extent(x) >= extent(y) ? x : y;
+  const int lowerParts = parts / 2;
+  const auto middle = first + (last - first) * lowerParts / parts;
+  std::nth_element(first, middle, last, [&](int a, int b) {
+    return coord[a] < coord[b] || (coord[a] == coord[b] && a < b);
+  });
+  bisect(x, y, first, middle, firstPart, lowerParts, result);
+  bisect(x, y, middle, last, firstPart + lowerParts, parts - lowerParts, result);
+}
+} // namespace detail
+
+/**
+ * @brief Partitioning of the elements at (`x`, `y`) into `parts` compact parts by recursive
+ * coordinate bisection
+ *
+ * The sizes of the parts differ by at most one element. The connectivity is not taken into
+ * account, the parts of a mesh with holes might not be connected.
+ */
+inline partitioning recursive_coordinate_bisection(const std::vector<double>& x,
+                                                   const std::vector<double>& y, int parts) {
+  assert(x.size() == y.size() && parts > 0);
+  std::vector<int> elements(x.size());
+  std::iota(elements.begin(), elements.end(), 0);
+  partitioning result(x.size(), 0);
+  detail::bisect(x, y, elements.begin(), elements.end(), 0, parts, result);
+  return result;
+}
+
+/**
+ * @brief Number of neighbors along the graph `adjacency` of the elements closest to `sources`,
+ * -1 for the elements further than `max`
+ */
+inline std::vector<int> graph_distance(const std::vector<std::vector<int>>& adjacency,
+                                       const std::vector<int>& sources, int max) {
+  std::vector<int> distance(adjacency.size(), -1);
+  std::queue<int> front;
+  for(int idx : sources) {
+    distance[idx] = 0;
+    front.push(idx);
+  }
+  while(!front.empty()) {
+    const int idx = front.front();
+    front.pop();
+    if(distance[idx] == max)
+      continue;
+    for(int nbh : adjacency[idx])
+      if(distance[nbh] < 0) {
+        distance[nbh] = distance[idx] + 1;
+        front.push(nbh);
+      }
+  }
+  return distance;
+}
+
+/**
+ * @brief Halo layer of the elements around part `part` of the graph `adjacency`
+ *
+ * The elements of the part are in layer 0, layer `l` are the elements of the other parts
+ * neighboring layer `l - 1`. The elements beyond layer `layers` are not in the halo (-1).
+ */
+inline std::vector<int> halo_layers(const std::vector<std::vector<int>>& adjacency,
+                                    const partitioning& parts, int part, int layers) {
+  assert(adjacency.size() == parts.size());
+  std::vector<int> owned;
+  for(std::size_t idx = 0; idx < parts.size(); ++idx)
+    if(parts[idx] == part)
+      owned.push_back(idx);
+  return graph_distance(adjacency, owned, layers);
+}
+
+/**
+ * @brief Number of neighbors in `adjacency` belonging to different parts, each pair counted once
+ */
+inline int edge_cut(const std::vector<std::vector<int>>& adjacency, const partitioning& parts) {
+  assert(adjacency.size() == parts.size());
+  int cut = 0;
+  for(std::size_t idx = 0; idx < adjacency.size(); ++idx)
+    for(int nbh : adjacency[idx])
+      if(parts[nbh] != parts[idx])
+        ++cut;
+  return cut / 2;
+}
+
+} // namespace driver
+} // namespace dawn
@@ -0,0 +1,245 @@
+//===--------------------------------------------------------------------------------*- C++ -*-===//
+//                          _
+//                         | |
+//                       __| | __ ___      ___ ___
+//                      / _` |/ _` \ \ /\ / / '_  |
+//                     | (_| | (_| |\ V  V /| | | |
+//                      \__,_|\__,_| \_/\_/ |_| |_| - Compiler Toolchain
+//
+//
+//  This file is distributed under the MIT License (MIT).
+//  See LICENSE.txt for details.
+//
+//===------------------------------------------------------------------------------------------===//
+
+#pragma once
+
+#include "unstructured_interface.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstdlib>
+#include <numeric>
+#include <queue>
+#include <vector>
+
+namespace dawn {
+namespace driver {
+
+/**
+ * @brief Renumbering of the elements of one location type
+ *
+ * Element `i` of the renumbered mesh is element `permutation[i]` of the original mesh.
+ */
+using permutation = std::vector<int>;
+
+/**
+ * @brief Position of each original element in the renumbered mesh
+ */
+inline permutation invert_permutation(const permutation& perm) {
+  permutation inverse(perm.size());
+  for(std::size_t i = 0; i < perm.size(); ++i)
+    inverse[perm[i]] = static_cast<int>(i);
+  return inverse;
+}
+
+/**
+ * @brief Data of the renumbered elements, `data` being indexed by the original elements
+ */
+template <typename T>
+std::vector<T> permute(const std::vector<T>& data, const permutation& perm) {
+  assert(data.size() == perm.size());
+  std::vector<T> result;
+  result.reserve(data.size());
+  for(int idx : perm)
+    result.push_back(data[idx]);
+  return result;
+}
+
+namespace detail {
+// Coordinates scaled to the integer grid [0, 2^bits) of their bounding box
+inline std::vector<std::pair<std::uint32_t, std::uint32_t>>
+quantize(const std::vector<double>& x, const std::vector<double>& y, int bits) {
+  assert(x.size() == y.size() && bits > 0 && bits <= 31);
+  std::vector<std::pair<std::uint32_t, std::uint32_t>> result;
+  if(x.empty())
+    return result;
+  const auto xBounds = std::minmax_element(x.begin(), x.end());
+  const auto yBounds = std::minmax_element(y.begin(), y.end());
+  const double extent =
+      std::max(*xBounds.second - *xBounds.first, *yBounds.second - *yBounds.first);
+  const double scale = extent > 0 ? ((1u << bits) - 1) / extent : 0;
+  result.reserve(x.size());
+  for(std::size_t i = 0; i < x.size(); ++i)
+    result.emplace_back(static_cast<std::uint32_t>((x[i] - *xBounds.first) * scale),
+                        static_cast<std::uint32_t>((y[i] - *yBounds.first) * scale));
+  return result;
+}
+
+// Elements sorted by `key`, ties keep the original order
+inline permutation sort_by_key(const std::vector<std::uint64_t>& key) {
+  permutation perm(key.size());
+  std::iota(perm.begin(), perm.end(), 0);
+  std::stable_sort(perm.begin(), perm.end(), [&](int a, int b) { return key[a] < key[b]; });
+  return perm;
+}
+
+inline std::uint64_t morton_index(std::uint32_t x, std::uint32_t y, int bits) {
+  std::uint64_t d = 0;
+  for(int b = 0; b < bits; ++b)
+    d |= (std::uint64_t((x >> b) & 1) << (2 * b)) | (std::uint64_t((y >> b) & 1) << (2 * b + 1));
+  return d;
+}
+
+inline std::uint64_t hilbert_index(std::uint32_t x, std::uint32_t y, int bits) {
+  const std::uint32_t n = 1u << bits;
+  std::uint64_t d = 0;
+  for(std::uint32_t s = n / 2; s > 0; s /= 2) {
+    const std::uint32_t rx = (x & s) > 0;
+    const std::uint32_t ry = (y & s) > 0;
+    d += std::uint64_t(s) * s * ((3 * rx) ^ ry);
+    // rotate the quadrant such that the curve enters and leaves it like the parent
+    if(ry == 0) {
+      if(rx == 1) {
+        x = n - 1 - x;
+        y = n - 1 - y;
+      }
+      std::swap(x, y);
+    }
+  }
+  return d;
+}
+} // namespace detail
+
+/**
+ * @brief Renumbering along a Morton (Z-order) curve through the elements at (`x`, `y`)
+ *
+ * @param bits  Resolution of the curve per dimension
+ */
+inline permutation morton_order(const std::vector<double>& x, const std::vector<double>& y,
+                                int bits = 16) {
+  std::vector<std::uint64_t> key;
+  for(const auto& p : detail::quantize(x, y, bits))
+    key.push_back(detail::morton_index(p.first, p.second, bits));
+  return detail::sort_by_key(key);
+}
+
+/**
+ * @brief Renumbering along a Hilbert curve through the elements at (`x`, `y`)
+ *
+ * Contrary to the Morton curve, consecutive elements along the Hilbert curve are always close.
+ *
+ * @param bits  Resolution of the curve per dimension
+ */
+inline permutation hilbert_order(const std::vector<double>& x, const std::vector<double>& y,
+                                 int bits = 16) {
+  std::vector<std::uint64_t> key;
+  for(const auto& p : detail::quantize(x, y, bits))
+    key.push_back(detail::hilbert_index(p.first, p.second, bits));
+  return detail::sort_by_key(key);
+}
+
+/**
+ * @brief Reverse Cuthill-McKee renumbering of the graph `adjacency` (neighbors of each element)
+ *
+ * Minimizes the bandwidth of the graph, i.e. the largest index distance between neighbors. Each
+ * connected component is traversed breadth first from one of its elements of lowest degree,
+ * visiting the neighbors by increasing degree.
+ */
+inline permutation reverse_cuthill_mckee_order(const std::vector<std::vector<int>>& adjacency) {
+  const int size = static_cast<int>(adjacency.size());
+  permutation byDegree(size);
+  std::iota(byDegree.begin(), byDegree.end(), 0);
+  auto degreeLess = [&](int a, int b) { return adjacency[a].size() < adjacency[b].size(); };
+  std::stable_sort(byDegree.begin(), byDegree.end(), degreeLess);
+
+  permutation perm;
+  perm.reserve(size);
+  std::vector<bool> visited(size, false);
+  std::vector<int> neighbors;
+  for(int start : byDegree) {
+    if(visited[start])
+      continue;
+    visited[start] = true;
+    std::queue<int> front;
+    front.push(start);
+    while(!front.empty()) {
+      const int idx = front.front();
+      front.pop();
+      perm.push_back(idx);
+      neighbors.clear();
+      for(int nbh : adjacency[idx])
+        if(!visited[nbh]) {
+          visited[nbh] = true;
+          neighbors.push_back(nbh);
+        }
+      std::stable_sort(neighbors.begin(), neighbors.end(), degreeLess);
+      for(int nbh : neighbors)
+        front.push(nbh);
+    }
+  }
+  std::reverse(perm.begin(), perm.end());
+  return perm;
+}
+
+/**
+ * @brief Largest index distance between neighbors of `adjacency` once renumbered by `perm`
+ */
+inline int graph_bandwidth(const std::vector<std::vector<int>>& adjacency,
+                           const permutation& perm) {
+  const permutation position = invert_permutation(perm);
+  int bandwidth = 0;
+  for(std::size_t idx = 0; idx < adjacency.size(); ++idx)
+    for(int nbh : adjacency[idx])
+      bandwidth = std::max(bandwidth, std::abs(position[idx] - position[nbh]));
+  return bandwidth;
+}
+
+namespace detail {
+template <typename Tag, typename Mesh, typename Elements>
+void add_element_neighbors(Tag tag, const Mesh& mesh, const Elements& elements,
+                           const std::vector<LocationType>& chain,
+                           std::vector<std::vector<int>>& adjacency) {
+  for(auto&& elem : elements) {
+    const int idx = elementIndex(tag, elem);
+    if(idx >= static_cast<int>(adjacency.size()))
+      adjacency.resize(idx + 1);
+    for(auto&& nbh : getNeighbors(tag, mesh, chain, elem)) {
+      const int nbhIdx = elementIndex(tag, nbh);
+      adjacency[idx].push_back(nbhIdx);
+      if(nbhIdx >= static_cast<int>(adjacency.size()))
+        adjacency.resize(nbhIdx + 1);
+    }
+  }
+}
+} // namespace detail
+
+/**
+ * @brief Graph of the elements of type `location` of any mesh of the unstructured interface,
+ * two elements being neighbors if they share an element of type `via`
+ *
+ * The graph is indexed like the fields of `location` (see `elementIndex`), indices without an
+ * element are isolated.
+ */
+template <typename Tag>
+std::vector<std::vector<int>> element_graph(Tag tag, const mesh_t<Tag>& mesh,
+                                            LocationType location, LocationType via) {
+  std::vector<std::vector<int>> adjacency;
+  const std::vector<LocationType> chain{location, via, location};
+  switch(location) {
+  case LocationType::Cells:
+    detail::add_element_neighbors(tag, mesh, getCells(tag, mesh), chain, adjacency);
+    break;
+  case LocationType::Edges:
+    detail::add_element_neighbors(tag, mesh, getEdges(tag, mesh), chain, adjacency);
+    break;
+  case LocationType::Vertices:
+    detail::add_element_neighbors(tag, mesh, getVertices(tag, mesh), chain, adjacency);
+    break;
+  }
+  return adjacency;
+}
+
+} // namespace driver
+} // namespace dawn
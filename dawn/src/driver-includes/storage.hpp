@@ -74,7 +74,9 @@
 
 // Include gridtools
 #ifndef GRIDTOOLS_DAWN_NO_INCLUDE
+#ifndef GRIDTOOLS_DAWN_SLIM_RUNTIME
 #include <gridtools/stencil_composition/stencil_composition.hpp>
+#endif
 #include <gridtools/storage/storage_facility.hpp>
 
 #include "storage_runtime.hpp"
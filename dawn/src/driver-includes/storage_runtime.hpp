@@ -23,8 +23,13 @@
 #define GRIDTOOLS_DAWN_META_DATA_T_DEFINED
 #define GRIDTOOLS_DAWN_STORAGE_T_DEFINED
 
+// The C++ backends only need storages and views (see codegen option `SlimRuntime`)
+#ifdef GRIDTOOLS_DAWN_SLIM_RUNTIME
+#include <gridtools/common/defs.hpp>
+#else
 #include <gridtools/stencil_composition/stencil_composition.hpp>
 #include <gridtools/stencil_composition/stencil_functions.hpp>
+#endif
 #include <gridtools/storage/storage_facility.hpp>
 
 namespace gridtools {
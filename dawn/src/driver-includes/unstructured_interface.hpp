@@ -17,6 +17,12 @@
 #include "defs.hpp"
 #include "extent.hpp"
 
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 namespace dawn {
@@ -81,4 +87,147 @@ auto deref(Tag, LocationType const* l) -> LocationType const* {
   return l;
 }
 
+// index of an element into the fields of its location type, specialize if needed
+template <typename Tag>
+int elementIndex(Tag, int idx) {
+  return idx;
+}
+
+namespace detail {
+template <typename Iterator, typename = void>
+struct isRandomAccess : std::false_type {};
+template <typename Iterator>
+struct isRandomAccess<
+    Iterator, typename std::enable_if<std::is_base_of<
+                  std::random_access_iterator_tag,
+                  typename std::iterator_traits<Iterator>::iterator_category>::value>::type>
+    : std::true_type {};
+
+template <typename Range>
+using rangeIterator = decltype(std::begin(std::declval<Range&>()));
+template <typename Range>
+using rangeElement = typename std::decay<decltype(*std::declval<rangeIterator<Range>>())>::type;
+} // namespace detail
+
+// elements of a range returned by getCells, getEdges or getVertices, indexable by their position
+// (for parallel loops): the range itself if its iterators are random access, a copy of its
+// elements otherwise
+template <typename Range>
+auto indexableRange(Range&& range)
+    -> typename std::enable_if<detail::isRandomAccess<detail::rangeIterator<Range>>::value,
+                               typename std::decay<Range>::type>::type {
+  return std::forward<Range>(range);
+}
+
+template <typename Range>
+auto indexableRange(Range&& range)
+    -> typename std::enable_if<!detail::isRandomAccess<detail::rangeIterator<Range>>::value,
+                               std::vector<detail::rangeElement<Range>>>::type {
+  std::vector<detail::rangeElement<Range>> elements;
+  for(auto&& element : range)
+    elements.push_back(element);
+  return elements;
+}
+
+// neighbors of one element along a chain, a view into a neighbor_table
+template <typename Element>
+class neighbor_span {
+public:
+  neighbor_span(const Element* first, const Element* last) : first_(first), last_(last) {}
+
+  const Element* begin() const { return first_; }
+  const Element* end() const { return last_; }
+  std::size_t size() const { return last_ - first_; }
+  const Element& operator[](std::size_t idx) const { return first_[idx]; }
+
+private:
+  const Element* first_;
+  const Element* last_;
+};
+
+// neighbors along a chain of all elements of its first location type, as returned by getNeighbors
+// (preceded by the element itself if the center is included), computed once and stored one
+// element after the other. Indexed like the fields (see elementIndex), a lookup does not allocate
+template <typename Element>
+class neighbor_table {
+public:
+  using value_type = Element;
+
+  neighbor_table() : offsets_(1, 0) {}
+  explicit neighbor_table(const std::vector<std::vector<Element>>& rows) : offsets_(1, 0) {
+    for(const auto& row : rows) {
+      neighbors_.insert(neighbors_.end(), row.begin(), row.end());
+      offsets_.push_back(neighbors_.size());
+    }
+  }
+
+  template <typename Tag>
+  neighbor_span<Element> operator()(Tag tag, const Element& elem) const {
+    const int idx = elementIndex(tag, elem);
+    assert(idx >= 0 && idx + 1 < static_cast<int>(offsets_.size()));
+    return {neighbors_.data() + offsets_[idx], neighbors_.data() + offsets_[idx + 1]};
+  }
+
+private:
+  std::vector<std::size_t> offsets_;
+  std::vector<Element> neighbors_;
+};
+
+template <typename Tag>
+using neighbor_table_t = neighbor_table<
+    detail::rangeElement<decltype(getCells(Tag{}, std::declval<const mesh_t<Tag>&>()))>>;
+
+namespace detail {
+template <typename Tag, typename Mesh, typename Elements, typename Element>
+void addNeighborRows(Tag tag, const Mesh& mesh, const Elements& elements,
+                     const std::vector<LocationType>& chain, bool includeCenter,
+                     std::vector<std::vector<Element>>& rows) {
+  for(auto&& elem : elements) {
+    const int idx = elementIndex(tag, elem);
+    if(idx >= static_cast<int>(rows.size()))
+      rows.resize(idx + 1);
+    if(includeCenter)
+      rows[idx].push_back(elem);
+    for(auto&& nbh : getNeighbors(tag, mesh, chain, elem))
+      rows[idx].push_back(nbh);
+  }
+}
+} // namespace detail
+
+// neighbor table of `chain` for any mesh of the interface (chain handle of the generated code)
+template <typename Tag>
+neighbor_table_t<Tag> makeNeighborTable(Tag tag, const mesh_t<Tag>& mesh,
+                                        const std::vector<LocationType>& chain,
+                                        bool includeCenter = false) {
+  std::vector<std::vector<typename neighbor_table_t<Tag>::value_type>> rows;
+  switch(chain.front()) {
+  case LocationType::Cells:
+    detail::addNeighborRows(tag, mesh, getCells(tag, mesh), chain, includeCenter, rows);
+    break;
+  case LocationType::Edges:
+    detail::addNeighborRows(tag, mesh, getEdges(tag, mesh), chain, includeCenter, rows);
+    break;
+  case LocationType::Vertices:
+    detail::addNeighborRows(tag, mesh, getVertices(tag, mesh), chain, includeCenter, rows);
+    break;
+  }
+  return neighbor_table_t<Tag>(rows);
+}
+
+// reductions over the neighbors looked up in a neighbor_table, like reduce of the interfaces
+template <typename Element, typename Init, typename Op>
+Init reduce(neighbor_span<Element> neighbors, Init init, Op&& op) {
+  for(const Element& nbh : neighbors)
+    op(init, nbh);
+  return init;
+}
+
+template <typename Element, typename Init, typename Op, typename Weights>
+Init reduce(neighbor_span<Element> neighbors, Init init, Op&& op, const Weights& weights) {
+  std::size_t i = 0;
+  for(const Element& nbh : neighbors)
+    op(init, nbh, weights[i++]);
+  return init;
+}
+
 } // namespace dawn
@@ -14,6 +14,7 @@
 
 #pragma once
 
+#include "../driver-includes/unstructured_domain.hpp"
 #include "../driver-includes/unstructured_interface.hpp"
 #include "../toylib/toylib.hpp"
 
@@ -70,6 +71,33 @@ inline std::vector<const toylib::ToylibElement*> getVertices(toylibTag, toylib::
   return ret;
 }
 
+// elements lo to hi - 1 in the order of the grid, which is the order of the ids for the grids of
+// toylib::decompose and toylib::reorder
+inline std::vector<const toylib::ToylibElement*> getCells(toylibTag, toylib::Grid const& m, int lo,
+                                                          int hi) {
+  assert(lo >= 0 && lo <= hi && hi <= int(m.faces().size()));
+  std::vector<const toylib::ToylibElement*> ret;
+  for(int i = lo; i < hi; ++i)
+    ret.push_back(&m.faces()[i]);
+  return ret;
+}
+inline std::vector<const toylib::ToylibElement*> getEdges(toylibTag, toylib::Grid const& m, int lo,
+                                                          int hi) {
+  assert(lo >= 0 && lo <= hi && hi <= int(m.edges().size()));
+  std::vector<const toylib::ToylibElement*> ret;
+  for(int i = lo; i < hi; ++i)
+    ret.push_back(&m.edges()[i].get());
+  return ret;
+}
+inline std::vector<const toylib::ToylibElement*> getVertices(toylibTag, toylib::Grid const& m,
+                                                             int lo, int hi) {
+  assert(lo >= 0 && lo <= hi && hi <= int(m.vertices().size()));
+  std::vector<const toylib::ToylibElement*> ret;
+  for(int i = lo; i < hi; ++i)
+    ret.push_back(&m.vertices()[i]);
+  return ret;
+}
+
 inline auto numVertices(toylibTag, toylib::Grid const& grid) { return grid.vertices().size(); }
 inline auto numCells(toylibTag, toylib::Grid const& grid) { return grid.faces().size(); }
 inline auto numEdges(toylibTag, toylib::Grid const& grid) { return grid.edges().size(); }
@@ -83,6 +111,8 @@ inline toylib::Edge const& deref(toylibTag, std::reference_wrapper<const toylib:
   return e; // implicit conversion
 }
 
+inline int elementIndex(toylibTag, const toylib::ToylibElement* elem) { return elem->id(); }
+
 typedef std::tuple<dawn::LocationType, dawn::LocationType> key_t;
 
 struct key_hash : public std::unary_function<key_t, std::size_t> {
@@ -322,4 +352,26 @@ auto reduce(toylibTag, toylib::Grid const& grid, toylib::ToylibElement const* id
   return init;
 }
 
-} // namespace toylibInterface
\ No newline at end of file
+//===------------------------------------------------------------------------------------------===//
+// partitioned grids
+//===------------------------------------------------------------------------------------------===//
+
+// sets the splitter indices of a stencil running on a subgrid of toylib::decompose. There is no
+// nudging zone, (Halo, -1) is the start of the rim and (Halo, l - 1) the start of halo layer l
+template <typename Stencil>
+void setSplitterIndices(Stencil& stencil, toylib::SubGrid const& subgrid) {
+  auto set = [&](dawn::LocationType loc, toylib::SubGrid::Layout const& layout) {
+    stencil.set_splitter_index(loc, dawn::UnstructuredSubdomain::LateralBoundary, 0, 0);
+    stencil.set_splitter_index(loc, dawn::UnstructuredSubdomain::Nudging, 0, layout.interior);
+    stencil.set_splitter_index(loc, dawn::UnstructuredSubdomain::Interior, 0, layout.interior);
+    stencil.set_splitter_index(loc, dawn::UnstructuredSubdomain::Halo, -1, layout.rim);
+    for(size_t layer = 0; layer < layout.halo.size(); ++layer)
+      stencil.set_splitter_index(loc, dawn::UnstructuredSubdomain::Halo, layer, layout.halo[layer]);
+    stencil.set_splitter_index(loc, dawn::UnstructuredSubdomain::End, 0, layout.end);
+  };
+  set(dawn::LocationType::Cells, subgrid.faces);
+  set(dawn::LocationType::Edges, subgrid.edges);
+  set(dawn::LocationType::Vertices, subgrid.vertices);
+}
+
+} // namespace toylibInterface
@@ -0,0 +1,98 @@
+//===--------------------------------------------------------------------------------*- C++ -*-===//
+//                          _
+//                         | |
+//                       __| | __ ___      ___ ___
+//                      / _` |/ _` \ \ /\ / / '_  |
+//                     | (_| | (_| |\ V  V /| | | |
+//                      \__,_|\__,_| \_/\_/ |_| |_| - Compiler Toolchain
+//
+//
+//  This file is distributed under the MIT License (MIT).
+//  See LICENSE.txt for details.
+//
+//===------------------------------------------------------------------------------------------===//
+
+#pragma once
+
+#include "dawn/Interpreter/Interpreter.h"
+#include "toylib_interface.hpp"
+
+#include <vector>
+
+// Glue between toylib meshes/fields and the IIR interpreter (dawn::interpreter::Interpreter)
+
+namespace toylibInterpreter {
+
+/// @brief Describe the connectivity of a toylib grid to the interpreter
+///
+/// Storages are indexed by element id, edges outside of the domain are skipped by the stages (as
+/// in the generated code).
+inline dawn::interpreter::UnstructuredMesh makeMesh(const toylib::Grid& grid) {
+  dawn::interpreter::UnstructuredMesh mesh;
+  mesh.NumElements = {static_cast<int>(grid.faces().size()),
+                      static_cast<int>(grid.all_edges().size()),
+                      static_cast<int>(grid.vertices().size())};
+  for(const toylib::Edge& edge : grid.edges())
+    mesh.Elements[static_cast<int>(dawn::ast::LocationType::Edges)].push_back(edge.id());
+
+  mesh.Neighbors = [&grid](const dawn::ast::UnstructuredIterationSpace& iterSpace, int element) {
+    const toylib::ToylibElement* elem = nullptr;
+    switch(iterSpace.Chain.front()) {
+    case dawn::ast::LocationType::Cells:
+      elem = &grid.faces()[element];
+      break;
+    case dawn::ast::LocationType::Edges:
+      elem = &grid.all_edges()[element];
+      break;
+    case dawn::ast::LocationType::Vertices:
+      elem = &grid.vertices()[element];
+      break;
+    }
+
+    std::vector<dawn::LocationType> chain;
+    for(auto loc : iterSpace.Chain)
+      chain.push_back(static_cast<dawn::LocationType>(loc));
+
+    std::vector<int> ids;
+    if(iterSpace.IncludeCenter)
+      ids.push_back(element);
+    for(auto neighbor : toylibInterface::getNeighbors(toylibInterface::toylibTag{}, grid, chain, elem))
+      ids.push_back(neighbor->id());
+    return ids;
+  };
+  return mesh;
+}
+
+/// @brief Contiguous copy of a dense toylib field, laid out as `[k][element]`
+///
+/// toylib stores every level in a separate vector, the interpreter needs strided storage.
+class Buffer {
+public:
+  template <typename O>
+  explicit Buffer(toylib::Data<O, double>& field) {
+    for(const auto& level : field) {
+      numElements_ = level.size();
+      data_.insert(data_.end(), level.begin(), level.end());
+    }
+  }
+
+  dawn::interpreter::FieldView view() {
+    return dawn::interpreter::FieldView{data_.data(), {1, 0, numElements_}};
+  }
+
+  /// @brief Write the (updated) values back to `field`
+  template <typename O>
+  void copyTo(toylib::Data<O, double>& field) const {
+    auto it = data_.begin();
+    for(auto& level : field) {
+      std::copy(it, it + level.size(), level.begin());
+      it += level.size();
+    }
+  }
+
+private:
+  std::vector<double> data_;
+  long numElements_ = 0;
+};
+
+} // namespace toylibInterpreter
@@ -14,16 +14,63 @@
 
 #include "toylib.hpp"
 
+#include "../driver-includes/mesh_partitioning.hpp"
+#include "../driver-includes/mesh_reordering.hpp"
 #include "../interface/toylib_interface.hpp"
 
 toylib::ToylibElement::~ToylibElement() {}
 
 namespace {
+// faces of periodic grids wrapping around the domain are not inner faces. Decided on the vertex
+// coordinates, the ids do not follow the raster order anymore once the grid is renumbered
 bool inner_face(toylib::Face const& f) {
-  return (f.color() == toylib::face_color::downward && f.vertex(0).id() < f.vertex(1).id() &&
-          f.vertex(0).id() < f.vertex(2).id()) ||
-         (f.color() == toylib::face_color::upward && f.vertex(1).id() > f.vertex(0).id() &&
-          f.vertex(1).id() > f.vertex(2).id());
+  return (f.color() == toylib::face_color::downward && f.vertex(0).x() < f.vertex(1).x() &&
+          f.vertex(0).y() < f.vertex(2).y()) ||
+         (f.color() == toylib::face_color::upward && f.vertex(1).y() > f.vertex(0).y() &&
+          f.vertex(1).x() > f.vertex(2).x());
+}
+
+void face_centers(toylib::Grid const& grid, std::vector<double>& x, std::vector<double>& y) {
+  for(auto const& f : grid.faces()) {
+    x.push_back((f.vertex(0).x() + f.vertex(1).x() + f.vertex(2).x()) / 3.);
+    y.push_back((f.vertex(0).y() + f.vertex(1).y() + f.vertex(2).y()) / 3.);
+  }
+}
+
+// regions of the elements of a subgrid, in the order of the subgrid
+enum region { lateral_boundary = 0, interior = 1, rim = 2, halo = 3 /* + layer - 1 */ };
+
+// elements of a subgrid (region >= 0) ordered by region and then by their index in the full grid
+std::vector<int> order_by_region(std::vector<int> const& regions, int halo_layers,
+                                 toylib::SubGrid::Layout& layout) {
+  std::vector<int> elements;
+  for(size_t idx = 0; idx < regions.size(); ++idx)
+    if(regions[idx] >= 0)
+      elements.push_back(idx);
+  std::stable_sort(elements.begin(), elements.end(),
+                   [&](int a, int b) { return regions[a] < regions[b]; });
+  auto start = [&](int r) {
+    return int(std::lower_bound(elements.begin(), elements.end(), r,
+                                [&](int idx, int value) { return regions[idx] < value; }) -
+               elements.begin());
+  };
+  layout.interior = start(interior);
+  layout.rim = start(rim);
+  layout.halo.clear();
+  for(int layer = 1; layer <= halo_layers; ++layer)
+    layout.halo.push_back(start(halo + layer - 1));
+  layout.end = elements.size();
+  return elements;
+}
+
+// links of the halo elements of a subgrid to their owners
+std::vector<toylib::HaloLink> halo_links(std::vector<int> const& global, int halo_start,
+                                         std::vector<int> const& parts,
+                                         std::vector<int> const& owned_position) {
+  std::vector<toylib::HaloLink> links;
+  for(int i = halo_start; i < int(global.size()); ++i)
+    links.push_back({i, parts[global[i]], owned_position[global[i]]});
+  return links;
 }
 } // namespace
 
@@ -154,4 +201,237 @@ std::ostream& toVtk(std::string const& name, VertexData<double> const& v_data, G
 }
 void Vertex::add_edge(Edge& e) { edges_.push_back(&e); }
 
+void Grid::renumber(GridPermutation const& perm) {
+  assert(perm.faces.size() == faces_.size() && perm.edges.size() == edges_.size() &&
+         perm.vertices.size() == vertices_.size());
+  *this = extract(perm);
+}
+
+Grid Grid::extract(GridPermutation const& perm) const {
+  // position of the elements in the extracted grid, -1 if not extracted
+  auto position = [](std::vector<int> const& elements, size_t size) {
+    std::vector<int> pos(size, -1);
+    for(size_t i = 0; i < elements.size(); ++i)
+      pos[elements[i]] = i;
+    return pos;
+  };
+  auto const face_pos = position(perm.faces, faces_.size());
+  auto const edge_pos = position(perm.edges, edges_.size());
+  auto const vertex_pos = position(perm.vertices, vertices_.size());
+
+  Grid result;
+  result.nx_ = nx_;
+  result.ny_ = ny_;
+  result.faces_.resize(perm.faces.size());
+  result.edges_.resize(perm.edges.size());
+  result.vertices_.resize(perm.vertices.size());
+  auto& faces = result.faces_;
+  auto& edges = result.edges_;
+  auto& vertices = result.vertices_;
+  auto new_face = [&](Face const* f) -> Face* {
+    const int pos = face_pos[f - faces_.data()];
+    return pos < 0 ? nullptr : &faces[pos];
+  };
+  auto new_edge = [&](Edge const* e) -> Edge* {
+    const int pos = edge_pos[e - edges_.data()];
+    return pos < 0 ? nullptr : &edges[pos];
+  };
+  auto new_vertex = [&](Vertex const* v) -> Vertex* {
+    const int pos = vertex_pos[v - vertices_.data()];
+    return pos < 0 ? nullptr : &vertices[pos];
+  };
+
+  for(size_t i = 0; i < faces.size(); ++i) {
+    auto const& old = faces_[perm.faces[i]];
+    faces[i] = Face(i, old.color());
+    for(auto e : old.edges())
+      if(auto edge = new_edge(e))
+        faces[i].add_edge(*edge);
+    for(auto v : old.vertices())
+      if(auto vertex = new_vertex(v))
+        faces[i].add_vertex(*vertex);
+  }
+  for(size_t i = 0; i < edges.size(); ++i) {
+    auto const& old = edges_[perm.edges[i]];
+    // edges outside of the domain stay invalid
+    if(!old)
+      continue;
+    edges[i] = Edge(i, old.color());
+    for(auto v : old.vertices())
+      if(auto vertex = new_vertex(v))
+        edges[i].add_vertex(*vertex);
+    for(auto f : old.faces())
+      if(auto face = new_face(f))
+        edges[i].add_face(*face);
+  }
+  for(size_t i = 0; i < vertices.size(); ++i) {
+    auto const& old = vertices_[perm.vertices[i]];
+    vertices[i] = Vertex(old.x(), old.y(), i);
+    for(auto e : old.edges())
+      if(auto edge = new_edge(e))
+        vertices[i].add_edge(*edge);
+    for(auto f : old.faces())
+      if(auto face = new_face(f))
+        vertices[i].add_face(*face);
+  }
+
+  for(auto const& e : edges) {
+    if(e.id() != -1)
+      result.valid_edges_.push_back(e);
+  }
+  return result;
+}
+
+GridPermutation reorder(Grid& grid, reordering kind) {
+  auto const& all_edges = grid.all_edges();
+  GridPermutation perm;
+  if(kind == reordering::reverse_cuthill_mckee) {
+    // cells and edges are neighbors through their vertices, vertices through their edges
+    toylibInterface::toylibTag tag;
+    perm.faces = dawn::driver::reverse_cuthill_mckee_order(
+        dawn::driver::element_graph(tag, grid, dawn::LocationType::Cells,
+                                    dawn::LocationType::Vertices));
+    perm.vertices = dawn::driver::reverse_cuthill_mckee_order(dawn::driver::element_graph(
+        tag, grid, dawn::LocationType::Vertices, dawn::LocationType::Edges));
+    auto edge_graph = dawn::driver::element_graph(tag, grid, dawn::LocationType::Edges,
+                                                  dawn::LocationType::Vertices);
+    edge_graph.resize(all_edges.size());
+    perm.edges = dawn::driver::reverse_cuthill_mckee_order(edge_graph);
+  } else {
+    auto order = [&](std::vector<double> const& x, std::vector<double> const& y) {
+      return kind == reordering::hilbert ? dawn::driver::hilbert_order(x, y)
+                                         : dawn::driver::morton_order(x, y);
+    };
+    std::vector<double> x, y;
+    face_centers(grid, x, y);
+    perm.faces = order(x, y);
+    x.clear();
+    y.clear();
+    for(auto const& e : all_edges) {
+      x.push_back(e ? (e.vertex(0).x() + e.vertex(1).x()) / 2. : 0.);
+      y.push_back(e ? (e.vertex(0).y() + e.vertex(1).y()) / 2. : 0.);
+    }
+    perm.edges = order(x, y);
+    x.clear();
+    y.clear();
+    for(auto const& v : grid.vertices()) {
+      x.push_back(v.x());
+      y.push_back(v.y());
+    }
+    perm.vertices = order(x, y);
+  }
+  // the valid edges first, edges outside of the domain are never accessed
+  std::stable_partition(perm.edges.begin(), perm.edges.end(),
+                        [&](int e) { return bool(all_edges[e]); });
+
+  grid.renumber(perm);
+  return perm;
+}
+
+std::vector<int> partition(Grid const& grid, int parts) {
+  std::vector<double> x, y;
+  face_centers(grid, x, y);
+  return dawn::driver::recursive_coordinate_bisection(x, y, parts);
+}
+
+std::vector<SubGrid> decompose(Grid const& grid, std::vector<int> const& face_parts,
+                               int halo_layers) {
+  assert(face_parts.size() == grid.faces().size() && halo_layers >= 1);
+  auto const& all_edges = grid.all_edges();
+  const int parts = *std::max_element(face_parts.begin(), face_parts.end()) + 1;
+
+  std::vector<int> edge_parts(all_edges.size(), -1);
+  std::vector<int> vertex_parts(grid.vertices().size(), -1);
+  auto own = [](int& owner, int part) { owner = owner < 0 ? part : std::min(owner, part); };
+  for(auto const& f : grid.faces()) {
+    for(auto e : f.edges())
+      own(edge_parts[e->id()], face_parts[f.id()]);
+    for(auto v : f.vertices())
+      own(vertex_parts[v->id()], face_parts[f.id()]);
+  }
+
+  toylibInterface::toylibTag tag;
+  auto const face_graph = dawn::driver::element_graph(tag, grid, dawn::LocationType::Cells,
+                                                     dawn::LocationType::Vertices);
+
+  std::vector<SubGrid::Layout> face_layouts(parts), edge_layouts(parts), vertex_layouts(parts);
+  std::vector<GridPermutation> globals(parts);
+  // position of each element in the subgrid of its owner
+  std::vector<int> face_position(grid.faces().size());
+  std::vector<int> edge_position(all_edges.size());
+  std::vector<int> vertex_position(grid.vertices().size());
+  for(int part = 0; part < parts; ++part) {
+    auto const layers = dawn::driver::halo_layers(face_graph, face_parts, part, halo_layers);
+    std::vector<int> first_layer;
+    for(size_t idx = 0; idx < layers.size(); ++idx)
+      if(layers[idx] == 1)
+        first_layer.push_back(idx);
+    auto const distance = dawn::driver::graph_distance(face_graph, first_layer, halo_layers);
+
+    std::vector<int> face_regions(grid.faces().size(), -1);
+    for(auto const& f : grid.faces()) {
+      const int layer = layers[f.id()];
+      if(layer > 0)
+        face_regions[f.id()] = halo + layer - 1;
+      else if(layer == 0)
+        face_regions[f.id()] = f.faces().size() < 3 ? lateral_boundary
+                               : distance[f.id()] > 0 ? rim
+                                                      : interior;
+    }
+
+    // edges and vertices follow the faces around them
+    auto region_of = [&](auto const& elem, int owner, bool on_boundary) -> int {
+      int region = -1;
+      int layer = -1;
+      bool next_to_rim = false;
+      for(auto f : elem.faces()) {
+        const int l = layers[f->id()];
+        if(l < 0)
+          continue;
+        layer = layer < 0 ? std::max(l, 1) : std::min(layer, std::max(l, 1));
+        next_to_rim = next_to_rim || l > 0 || face_regions[f->id()] == rim;
+      }
+      if(layer < 0)
+        return region;
+      if(owner != part)
+        return halo + layer - 1;
+      return on_boundary ? lateral_boundary : next_to_rim ? rim : interior;
+    };
+    std::vector<int> edge_regions(all_edges.size(), -1);
+    for(Edge const& e : grid.edges())
+      edge_regions[e.id()] = region_of(e, edge_parts[e.id()], e.faces().size() < 2);
+    std::vector<int> vertex_regions(grid.vertices().size(), -1);
+    for(auto const& v : grid.vertices())
+      vertex_regions[v.id()] = region_of(v, vertex_parts[v.id()], v.faces().size() < 6);
+
+    auto& global = globals[part];
+    global.faces = order_by_region(face_regions, halo_layers, face_layouts[part]);
+    global.edges = order_by_region(edge_regions, halo_layers, edge_layouts[part]);
+    global.vertices = order_by_region(vertex_regions, halo_layers, vertex_layouts[part]);
+    for(int i = 0; i < face_layouts[part].halo.front(); ++i)
+      face_position[global.faces[i]] = i;
+    for(int i = 0; i < edge_layouts[part].halo.front(); ++i)
+      edge_position[global.edges[i]] = i;
+    for(int i = 0; i < vertex_layouts[part].halo.front(); ++i)
+      vertex_position[global.vertices[i]] = i;
+  }
+
+  std::vector<SubGrid> subgrids;
+  subgrids.reserve(parts);
+  for(int part = 0; part < parts; ++part) {
+    auto& global = globals[part];
+    auto face_halo = halo_links(global.faces, face_layouts[part].halo.front(), face_parts,
+                                face_position);
+    auto edge_halo = halo_links(global.edges, edge_layouts[part].halo.front(), edge_parts,
+                                edge_position);
+    auto vertex_halo = halo_links(global.vertices, vertex_layouts[part].halo.front(),
+                                  vertex_parts, vertex_position);
+    subgrids.push_back(SubGrid{grid.extract(global), std::move(global),
+                               std::move(face_layouts[part]), std::move(edge_layouts[part]),
+                               std::move(vertex_layouts[part]), std::move(face_halo),
+                               std::move(edge_halo), std::move(vertex_halo)});
+  }
+  return subgrids;
+}
+
 } // namespace toylib
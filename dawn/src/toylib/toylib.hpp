@@ -126,6 +126,22 @@ private:
   std::vector<Face*> faces_;
 };
 
+// renumbering of the elements of a grid: element i of the renumbered grid is the element
+// faces[i] (edges[i], vertices[i]) of the original grid
+struct GridPermutation {
+  std::vector<int> faces;
+  std::vector<int> edges;
+  std::vector<int> vertices;
+};
+
+// element `local` of a subgrid is a copy of the element `remote` of the subgrid of part `part`,
+// which owns it (see SubGrid)
+struct HaloLink {
+  int local;
+  int part;
+  int remote;
+};
+
 class Grid {
 public:
   // generates a grid of right triangles, vertices are in [0,1] x [0,1]
@@ -348,7 +364,17 @@ public:
   auto nx() const { return nx_; }
   auto ny() const { return ny_; }
 
+  // renumbers (and reorders in memory) all elements, the order of the neighbors of each element
+  // is kept. Fields need to be renumbered accordingly (see Data::renumber)
+  void renumber(GridPermutation const& perm);
+
+  // grid made of the elements perm.faces (perm.edges, perm.vertices) only, element i of the result
+  // being element perm.faces[i] of this grid. Neighbors which are not extracted are dropped
+  Grid extract(GridPermutation const& perm) const;
+
 private:
+  Grid() = default;
+
   std::vector<Face> faces_;
   std::vector<Vertex> vertices_;
   std::vector<Edge> edges_;
@@ -380,7 +406,34 @@ public:
 
   int k_size() const { return data_.size(); }
 
+  // copies the halo elements from the fields of the parts owning them (see SubGrid), parts[p]
+  // being the field of part p or a pointer to it
+  template <typename Parts>
+  void update_halo(std::vector<HaloLink> const& halo, Parts const& parts) {
+    for(size_t k_level = 0; k_level < data_.size(); ++k_level)
+      for(auto const& link : halo)
+        data_[k_level][link.local] = levels(parts[link.part])[k_level][link.remote];
+  }
+
+  // follows the renumbering of the elements (perm is one of the GridPermutation)
+  void renumber(std::vector<int> const& perm) {
+    for(auto& level : data_) {
+      assert(level.size() == perm.size());
+      std::vector<T> renumbered;
+      renumbered.reserve(level.size());
+      for(int idx : perm)
+        renumbered.push_back(level[idx]);
+      level = std::move(renumbered);
+    }
+  }
+
 private:
+  static std::vector<std::vector<T>> const& levels(Data const& field) { return field.data_; }
+  template <typename Ptr>
+  static auto levels(Ptr const& field) -> decltype(levels(*field)) {
+    return levels(*field);
+  }
+
   std::vector<std::vector<T>> data_;
 };
 
@@ -432,6 +485,18 @@ public:
   }
   int k_size() const { return data_.size(); }
 
+  // follows the renumbering of the elements (perm is one of the GridPermutation)
+  void renumber(std::vector<int> const& perm) {
+    assert(perm.size() == dense_size_);
+    for(auto& level : data_) {
+      std::vector<std::vector<T>> renumbered;
+      renumbered.reserve(level.size());
+      for(int idx : perm)
+        renumbered.push_back(std::move(level[idx]));
+      level = std::move(renumbered);
+    }
+  }
+
 private:
   std::vector<std::vector<std::vector<T>>> data_;
   size_t dense_size_;
@@ -457,6 +522,57 @@ public:
       : SparseData<Edge, T>(k_size, grid.all_edges().size(), sparse_size) {}
 };
 
+//===------------------------------------------------------------------------------------------===//
+// locality-improving renumbering
+//===------------------------------------------------------------------------------------------===//
+
+enum class reordering {
+  hilbert,              // along a Hilbert curve through the element centers
+  morton,               // along a Morton (Z-order) curve through the element centers
+  reverse_cuthill_mckee // minimizing the index distance between neighbors
+};
+
+// renumbers the elements of the grid, returns the permutation applied such that fields can follow
+GridPermutation reorder(Grid& grid, reordering kind);
+
+//===------------------------------------------------------------------------------------------===//
+// partitioning
+//===------------------------------------------------------------------------------------------===//
+
+// one part of a partitioned grid, with its halo. The elements of each type are ordered like the
+// dawn::UnstructuredSubdomain scheme: the owned elements on the lateral boundary of the grid, the
+// other owned elements with the ones next to the halo (the rim) last, then the halo layer by layer
+struct SubGrid {
+  // first element of each region
+  struct Layout {
+    int interior;
+    int rim;
+    std::vector<int> halo; // one per layer
+    int end;
+  };
+
+  Grid grid;
+  // element i of the subgrid is element global.faces[i] (edges[i], vertices[i]) of the full grid
+  GridPermutation global;
+  Layout faces;
+  Layout edges;
+  Layout vertices;
+  // where the halo elements are owned, see Data::update_halo
+  std::vector<HaloLink> face_halo;
+  std::vector<HaloLink> edge_halo;
+  std::vector<HaloLink> vertex_halo;
+};
+
+// part of each face, in `parts` compact parts of equal size (recursive coordinate bisection)
+std::vector<int> partition(Grid const& grid, int parts);
+
+// splits the grid into the parts of the faces. Edges and vertices are owned by the lowest part of
+// their faces. Each subgrid has `halo_layers` layers of halo faces (sharing a vertex with the
+// previous layer) with their edges and vertices, such that the owned elements keep all their
+// neighbors. The rim are the owned elements up to `halo_layers` faces away from the halo
+std::vector<SubGrid> decompose(Grid const& grid, std::vector<int> const& face_parts,
+                               int halo_layers = 1);
+
 std::ostream& toVtk(Grid const& grid, int k_size, std::ostream& os = std::cout);
 std::ostream& toVtk(std::string const& name, FaceData<double> const& f_data, Grid const& grid,
                     std::ostream& os = std::cout);
@@ -202,6 +202,16 @@ int main() {
     DAWN_ASSERT_MSG(of, "couldn't open output file!\n");
     auto tu = dawn::codegen::run(stencilInstantiation, dawn::codegen::Backend::CXXNaiveIco);
     of << dawn::codegen::generate(tu) << std::endl;
+
+    // the same stencil with OpenMP parallel element loops (in sequential vertical loops)
+    stencilInstantiation->getMetaData().setStencilName("parallelTridiagonalSolve");
+    dawn::codegen::Options options;
+    options.ParallelElementLoops = true;
+    std::ofstream ofParallel("generated/generated_parallelTridiagonalSolve.hpp");
+    DAWN_ASSERT_MSG(ofParallel, "couldn't open output file!\n");
+    auto tuParallel =
+        dawn::codegen::run(stencilInstantiation, dawn::codegen::Backend::CXXNaiveIco, options);
+    ofParallel << dawn::codegen::generate(tuParallel) << std::endl;
   }
 
   {
@@ -243,6 +253,122 @@ int main() {
     DAWN_ASSERT_MSG(of, "couldn't open output file!\n");
     auto tu = dawn::codegen::run(stencilInstantiation, dawn::codegen::Backend::CXXNaiveIco);
     of << dawn::codegen::generate(tu) << std::endl;
+
+    // the same stencil with OpenMP parallel element loops (collapsed with the vertical loop)
+    stencilInstantiation->getMetaData().setStencilName("parallelDiffusion");
+    dawn::codegen::Options options;
+    options.ParallelElementLoops = true;
+    std::ofstream ofParallel("generated/generated_parallelDiffusion.hpp");
+    DAWN_ASSERT_MSG(ofParallel, "couldn't open output file!\n");
+    auto tuParallel =
+        dawn::codegen::run(stencilInstantiation, dawn::codegen::Backend::CXXNaiveIco, options);
+    ofParallel << dawn::codegen::generate(tuParallel) << std::endl;
+
+    // the same stencil in column-major order, with the neighbors of each cell looked up once for
+    // all levels, sequential and with OpenMP parallel element loops
+    stencilInstantiation->getMetaData().setStencilName("columnMajorDiffusion");
+    options.ParallelElementLoops = false;
+    options.NeighborTables = true;
+    options.ColumnMajorLoops = true;
+    std::ofstream ofColumnMajor("generated/generated_columnMajorDiffusion.hpp");
+    DAWN_ASSERT_MSG(ofColumnMajor, "couldn't open output file!\n");
+    auto tuColumnMajor =
+        dawn::codegen::run(stencilInstantiation, dawn::codegen::Backend::CXXNaiveIco, options);
+    ofColumnMajor << dawn::codegen::generate(tuColumnMajor) << std::endl;
+
+    stencilInstantiation->getMetaData().setStencilName("parallelColumnMajorDiffusion");
+    options.ParallelElementLoops = true;
+    std::ofstream ofParallelColumnMajor("generated/generated_parallelColumnMajorDiffusion.hpp");
+    DAWN_ASSERT_MSG(ofParallelColumnMajor, "couldn't open output file!\n");
+    auto tuParallelColumnMajor =
+        dawn::codegen::run(stencilInstantiation, dawn::codegen::Backend::CXXNaiveIco, options);
+    ofParallelColumnMajor << dawn::codegen::generate(tuParallelColumnMajor) << std::endl;
+  }
+
+  {
+    using namespace dawn::iir;
+    using LocType = dawn::ast::LocationType;
+
+    UnstructuredIIRBuilder b;
+    auto cell_f = b.field("cell_field", LocType::Cells);
+    auto edge_f = b.field("edge_field", LocType::Edges);
+    auto out_f = b.field("out_field", LocType::Cells);
+
+    std::string stencilName = "reductionInInit";
+
+    // the reduction over the edges is in the init expression, it runs on the cell of the stage
+    auto stencilInstantiation = b.build(
+        stencilName,
+        b.stencil(b.multistage(
+            LoopOrderKind::Parallel,
+            b.stage(LocType::Cells,
+                    b.doMethod(dawn::ast::Interval::Start, dawn::ast::Interval::End,
+                               b.stmt(b.assignExpr(
+                                   b.at(out_f),
+                                   b.reduceOverNeighborExpr(
+                                       Op::plus, b.at(cell_f, HOffsetType::withOffset, 0),
+                                       b.reduceOverNeighborExpr(
+                                           Op::plus, b.at(edge_f, HOffsetType::withOffset, 0),
+                                           b.lit(0.), {LocType::Cells, LocType::Edges}),
+                                       {LocType::Cells, LocType::Edges, LocType::Cells}))))))));
+
+    std::ofstream of("generated/generated_" + stencilName + ".hpp");
+    DAWN_ASSERT_MSG(of, "couldn't open output file!\n");
+    auto tu = dawn::codegen::run(stencilInstantiation, dawn::codegen::Backend::CXXNaiveIco);
+    of << dawn::codegen::generate(tu) << std::endl;
+
+    // the neighbors of both reductions are looked up once per cell
+    stencilInstantiation->getMetaData().setStencilName("columnMajorReductionInInit");
+    dawn::codegen::Options options;
+    options.NeighborTables = true;
+    options.ColumnMajorLoops = true;
+    std::ofstream ofColumnMajor("generated/generated_columnMajorReductionInInit.hpp");
+    DAWN_ASSERT_MSG(ofColumnMajor, "couldn't open output file!\n");
+    auto tuColumnMajor =
+        dawn::codegen::run(stencilInstantiation, dawn::codegen::Backend::CXXNaiveIco, options);
+    ofColumnMajor << dawn::codegen::generate(tuColumnMajor) << std::endl;
+  }
+
+  {
+    using namespace dawn::iir;
+    using LocType = dawn::ast::LocationType;
+
+    UnstructuredIIRBuilder b;
+    auto in_f = b.field("in_field", LocType::Cells);
+    auto out_f = b.field("out_field", LocType::Cells);
+    auto cnt = b.localvar("cnt", dawn::BuiltinTypeID::Integer, {}, LocalVariableType::OnCells);
+
+    // diffusion of the interior cells only (Interior to Halo), e.g. the owned cells of a subgrid
+    std::string stencilName = "interiorDiffusion";
+
+    auto stencilInstantiation = b.build(
+        stencilName,
+        b.stencil(b.multistage(
+            dawn::iir::LoopOrderKind::Parallel,
+            b.stage(
+                LocType::Cells, Interval(2000, 3000, 0, 0),
+                b.doMethod(dawn::ast::Interval::Start, dawn::ast::Interval::End, b.declareVar(cnt),
+                           b.stmt(b.assignExpr(
+                               b.at(cnt), b.reduceOverNeighborExpr(Op::plus, b.lit(1), b.lit(0),
+                                                                   {LocType::Cells, LocType::Edges,
+                                                                    LocType::Cells}))),
+                           b.stmt(b.assignExpr(
+                               b.at(out_f),
+                               b.reduceOverNeighborExpr(
+                                   Op::plus, b.at(in_f, HOffsetType::withOffset, 0),
+                                   b.binaryExpr(b.unaryExpr(b.at(cnt), Op::minus),
+                                                b.at(in_f, HOffsetType::noOffset, 0), Op::multiply),
+                                   {LocType::Cells, LocType::Edges, LocType::Cells}))),
+                           b.stmt(b.assignExpr(
+                               b.at(out_f),
+                               b.binaryExpr(b.at(in_f),
+                                            b.binaryExpr(b.lit(0.1), b.at(out_f), Op::multiply),
+                                            Op::plus))))))));
+
+    std::ofstream of("generated/generated_" + stencilName + ".hpp");
+    DAWN_ASSERT_MSG(of, "couldn't open output file!\n");
+    auto tu = dawn::codegen::run(stencilInstantiation, dawn::codegen::Backend::CXXNaiveIco);
+    of << dawn::codegen::generate(tu) << std::endl;
   }
 
   {
@@ -348,6 +474,16 @@ int main() {
     DAWN_ASSERT_MSG(of, "couldn't open output file!\n");
     auto tu = dawn::codegen::run(stencilInstantiation, dawn::codegen::Backend::CXXNaiveIco);
     of << dawn::codegen::generate(tu) << std::endl;
+
+    // the same stencil with its neighbors looked up in tables computed once
+    stencilInstantiation->getMetaData().setStencilName("neighborTableDiamondWeights");
+    dawn::codegen::Options options;
+    options.NeighborTables = true;
+    std::ofstream ofTables("generated/generated_neighborTableDiamondWeights.hpp");
+    DAWN_ASSERT_MSG(ofTables, "couldn't open output file!\n");
+    auto tuTables =
+        dawn::codegen::run(stencilInstantiation, dawn::codegen::Backend::CXXNaiveIco, options);
+    ofTables << dawn::codegen::generate(tuTables) << std::endl;
   }
 
   {
@@ -776,6 +912,16 @@ int main() {
     DAWN_ASSERT_MSG(of, "couldn't open output file!\n");
     auto tu = dawn::codegen::run(stencilInstantiation, dawn::codegen::Backend::CXXNaiveIco);
     of << dawn::codegen::generate(tu) << std::endl;
+
+    // the same stencil with its neighbors looked up in tables computed once
+    stencilInstantiation->getMetaData().setStencilName("neighborTableSparseAssignment5");
+    dawn::codegen::Options options;
+    options.NeighborTables = true;
+    std::ofstream ofTables("generated/generated_neighborTableSparseAssignment5.hpp");
+    DAWN_ASSERT_MSG(ofTables, "couldn't open output file!\n");
+    auto tuTables =
+        dawn::codegen::run(stencilInstantiation, dawn::codegen::Backend::CXXNaiveIco, options);
+    ofTables << dawn::codegen::generate(tuTables) << std::endl;
   }
 
   {
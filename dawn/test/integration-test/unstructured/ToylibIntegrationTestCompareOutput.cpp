@@ -31,6 +31,9 @@
 
 #include <gtest/gtest.h>
 
+#include <cmath>
+#include <memory>
+
 namespace {
 template <typename ValT, typename iteratorT, template <typename> class FieldT>
 void InitData(const iteratorT& iter, FieldT<ValT>& field, size_t kSize, ValT val) {
@@ -184,6 +187,236 @@ TEST(ToylibIntegrationTestCompareOutput, Diffusion) {
 }
 } // namespace
 
+namespace {
+#include <generated_parallelDiffusion.hpp>
+TEST(ToylibIntegrationTestCompareOutput, DiffusionParallel) {
+  toylib::Grid mesh(32, 32, false, 1., 1.);
+  size_t nb_levels = 4;
+
+  toylib::FaceData<double> in_ref(mesh, nb_levels);
+  toylib::FaceData<double> out_ref(mesh, nb_levels);
+  toylib::FaceData<double> in_gen(mesh, nb_levels);
+  toylib::FaceData<double> out_gen(mesh, nb_levels);
+
+  for(const auto& cell : mesh.faces()) {
+    auto [x, y] = cellMidpoint(cell);
+    for(size_t level = 0; level < nb_levels; ++level) {
+      in_ref(cell, level) = std::sin(x * (level + 1)) * std::cos(y);
+      in_gen(cell, level) = std::sin(x * (level + 1)) * std::cos(y);
+    }
+  }
+
+  // the element loops (and the vertical loop) of the generated stencil run on OpenMP threads
+  for(int i = 0; i < 5; ++i) {
+    dawn_generated::cxxnaiveico::reference_diffusion<toylibInterface::toylibTag>(
+        mesh, static_cast<int>(nb_levels), in_ref, out_ref)
+        .run();
+    dawn_generated::cxxnaiveico::parallelDiffusion<toylibInterface::toylibTag>(
+        mesh, static_cast<int>(nb_levels), in_gen, out_gen)
+        .run();
+
+    using std::swap;
+    swap(in_ref, out_ref);
+    swap(in_gen, out_gen);
+  }
+
+  {
+    UnstructuredVerifier v;
+    EXPECT_TRUE(v.compareToylibField(mesh.faces(), in_ref, in_gen, nb_levels))
+        << "while comparing output (on cells)";
+  }
+}
+} // namespace
+
+namespace {
+#include <generated_columnMajorDiffusion.hpp>
+#include <generated_parallelColumnMajorDiffusion.hpp>
+TEST(ToylibIntegrationTestCompareOutput, DiffusionColumnMajor) {
+  toylib::Grid mesh(32, 32, false, 1., 1.);
+  size_t nb_levels = 4;
+
+  toylib::FaceData<double> in_ref(mesh, nb_levels);
+  toylib::FaceData<double> out_ref(mesh, nb_levels);
+  toylib::FaceData<double> in_gen(mesh, nb_levels);
+  toylib::FaceData<double> out_gen(mesh, nb_levels);
+  toylib::FaceData<double> in_par(mesh, nb_levels);
+  toylib::FaceData<double> out_par(mesh, nb_levels);
+
+  for(const auto& cell : mesh.faces()) {
+    auto [x, y] = cellMidpoint(cell);
+    for(size_t level = 0; level < nb_levels; ++level) {
+      in_ref(cell, level) = std::sin(x * (level + 1)) * std::cos(y);
+      in_gen(cell, level) = std::sin(x * (level + 1)) * std::cos(y);
+      in_par(cell, level) = std::sin(x * (level + 1)) * std::cos(y);
+    }
+  }
+
+  // the generated stencils compute cell by cell on all levels, with the neighbors of each cell
+  // looked up once, the last one on OpenMP threads
+  for(int i = 0; i < 5; ++i) {
+    dawn_generated::cxxnaiveico::reference_diffusion<toylibInterface::toylibTag>(
+        mesh, static_cast<int>(nb_levels), in_ref, out_ref)
+        .run();
+    dawn_generated::cxxnaiveico::columnMajorDiffusion<toylibInterface::toylibTag>(
+        mesh, static_cast<int>(nb_levels), in_gen, out_gen)
+        .run();
+    dawn_generated::cxxnaiveico::parallelColumnMajorDiffusion<toylibInterface::toylibTag>(
+        mesh, static_cast<int>(nb_levels), in_par, out_par)
+        .run();
+
+    using std::swap;
+    swap(in_ref, out_ref);
+    swap(in_gen, out_gen);
+    swap(in_par, out_par);
+  }
+
+  {
+    UnstructuredVerifier v;
+    EXPECT_TRUE(v.compareToylibField(mesh.faces(), in_ref, in_gen, nb_levels))
+        << "while comparing output (on cells)";
+    EXPECT_TRUE(v.compareToylibField(mesh.faces(), in_ref, in_par, nb_levels))
+        << "while comparing parallel output (on cells)";
+  }
+}
+} // namespace
+
+namespace {
+#include <generated_columnMajorReductionInInit.hpp>
+#include <generated_reductionInInit.hpp>
+TEST(ToylibIntegrationTestCompareOutput, ReductionInInitColumnMajor) {
+  toylib::Grid mesh(16, 16, false, 1., 1.);
+  size_t nb_levels = 3;
+
+  toylib::FaceData<double> cells(mesh, nb_levels);
+  toylib::EdgeData<double> edges(mesh, nb_levels);
+  toylib::FaceData<double> out_ref(mesh, nb_levels);
+  toylib::FaceData<double> out_gen(mesh, nb_levels);
+
+  for(size_t level = 0; level < nb_levels; ++level) {
+    for(const auto& cell : mesh.faces()) {
+      auto [x, y] = cellMidpoint(cell);
+      cells(cell, level) = std::sin(x * (level + 1)) * std::cos(y);
+    }
+    for(const auto& edge : mesh.edges()) {
+      double x = 0.5 * (edge.get().vertex(0).x() + edge.get().vertex(1).x());
+      double y = 0.5 * (edge.get().vertex(0).y() + edge.get().vertex(1).y());
+      edges(edge, level) = std::cos(x) * std::sin(y * (level + 1));
+    }
+  }
+
+  // the neighbors of the reduction in the init expression are looked up for the cell of the stage
+  dawn_generated::cxxnaiveico::reductionInInit<toylibInterface::toylibTag>(
+      mesh, static_cast<int>(nb_levels), cells, edges, out_ref)
+      .run();
+  dawn_generated::cxxnaiveico::columnMajorReductionInInit<toylibInterface::toylibTag>(
+      mesh, static_cast<int>(nb_levels), cells, edges, out_gen)
+      .run();
+
+  {
+    UnstructuredVerifier v;
+    EXPECT_TRUE(v.compareToylibField(mesh.faces(), out_ref, out_gen, nb_levels))
+        << "while comparing output (on cells)";
+  }
+}
+} // namespace
+
+namespace {
+TEST(ToylibIntegrationTestCompareOutput, DiffusionReordered) {
+  // same results (up to the renumbering) on a grid renumbered for locality
+  for(auto kind : {toylib::reordering::hilbert, toylib::reordering::reverse_cuthill_mckee}) {
+    toylib::Grid mesh(16, 16, false, 1., 1.);
+    toylib::Grid reordered(16, 16, false, 1., 1.);
+    auto perm = toylib::reorder(reordered, kind);
+    size_t nb_levels = 1;
+
+    toylib::FaceData<double> in(mesh, nb_levels);
+    toylib::FaceData<double> out(mesh, nb_levels);
+    for(const auto& cell : mesh.faces()) {
+      auto [x, y] = cellMidpoint(cell);
+      in(cell, 0) = (x > 0.375 && x < 0.625 && y > 0.375 && y < 0.625) ? 1 : 0;
+    }
+    toylib::FaceData<double> in_reordered(in);
+    toylib::FaceData<double> out_reordered(out);
+    in_reordered.renumber(perm.faces);
+
+    dawn_generated::cxxnaiveico::diffusion<toylibInterface::toylibTag>(
+        mesh, static_cast<int>(nb_levels), in, out)
+        .run();
+    dawn_generated::cxxnaiveico::diffusion<toylibInterface::toylibTag>(
+        reordered, static_cast<int>(nb_levels), in_reordered, out_reordered)
+        .run();
+
+    out.renumber(perm.faces);
+    UnstructuredVerifier v;
+    EXPECT_TRUE(v.compareToylibField(reordered.faces(), out, out_reordered, nb_levels))
+        << "while comparing output (on cells)";
+  }
+}
+} // namespace
+
+namespace {
+#include <generated_interiorDiffusion.hpp>
+TEST(ToylibIntegrationTestCompareOutput, DiffusionPartitioned) {
+  // same results on the owned cells of the subgrids, with the interior computed before the halo
+  // exchange and the rim after it
+  toylib::Grid mesh(16, 16, false, 1., 1.);
+  size_t nb_levels = 1;
+  toylib::FaceData<double> in(mesh, nb_levels);
+  toylib::FaceData<double> out(mesh, nb_levels);
+  for(const auto& cell : mesh.faces()) {
+    auto [x, y] = cellMidpoint(cell);
+    in(cell, 0) = (x > 0.375 && x < 0.625 && y > 0.375 && y < 0.625) ? 1 : 0;
+  }
+  dawn_generated::cxxnaiveico::diffusion<toylibInterface::toylibTag>(
+      mesh, static_cast<int>(nb_levels), in, out)
+      .run();
+
+  const auto subgrids = toylib::decompose(mesh, toylib::partition(mesh, 4));
+  std::vector<toylib::FaceData<double>> in_parts;
+  std::vector<toylib::FaceData<double>> out_parts;
+  for(const auto& sub : subgrids) {
+    in_parts.emplace_back(sub.grid, nb_levels);
+    out_parts.emplace_back(sub.grid, nb_levels);
+    for(const auto& cell : sub.grid.faces())
+      in_parts.back()(cell, 0) =
+          cell.id() < sub.faces.halo[0] ? in(mesh.faces()[sub.global.faces[cell.id()]], 0) : -1;
+  }
+
+  using stencil_t = dawn_generated::cxxnaiveico::interiorDiffusion<toylibInterface::toylibTag>;
+  std::vector<std::unique_ptr<stencil_t>> interior;
+  std::vector<std::unique_ptr<stencil_t>> rim;
+  for(size_t part = 0; part < subgrids.size(); ++part) {
+    const auto& sub = subgrids[part];
+    interior.emplace_back(
+        new stencil_t(sub.grid, static_cast<int>(nb_levels), in_parts[part], out_parts[part]));
+    toylibInterface::setSplitterIndices(*interior.back(), sub);
+    interior.back()->set_splitter_index(dawn::LocationType::Cells,
+                                        dawn::UnstructuredSubdomain::Halo, 0, sub.faces.rim);
+    rim.emplace_back(
+        new stencil_t(sub.grid, static_cast<int>(nb_levels), in_parts[part], out_parts[part]));
+    toylibInterface::setSplitterIndices(*rim.back(), sub);
+    rim.back()->set_splitter_index(dawn::LocationType::Cells,
+                                   dawn::UnstructuredSubdomain::Interior, 0, sub.faces.rim);
+  }
+
+  for(auto& stencil : interior)
+    stencil->run();
+  for(size_t part = 0; part < subgrids.size(); ++part)
+    in_parts[part].update_halo(subgrids[part].face_halo, in_parts);
+  for(auto& stencil : rim)
+    stencil->run();
+
+  // the lateral boundary is not computed
+  for(size_t part = 0; part < subgrids.size(); ++part) {
+    const auto& sub = subgrids[part];
+    for(int i = sub.faces.interior; i < sub.faces.halo[0]; ++i)
+      EXPECT_EQ(out_parts[part](sub.grid.faces()[i], 0),
+                out(mesh.faces()[sub.global.faces[i]], 0))
+          << "on cell " << sub.global.faces[i];
+  }
+}
+} // namespace
+
 namespace {
 #include <generated_gradient.hpp>
 #include <reference_gradient.hpp>
@@ -304,6 +537,49 @@ TEST(ToylibIntegrationTestCompareOutput, DiamondWeights) {
 }
 } // namespace
 
+namespace {
+#include <generated_neighborTableDiamondWeights.hpp>
+TEST(ToylibIntegrationTestCompareOutput, DiamondWeightsNeighborTable) {
+  const int numCell = 10;
+  auto mesh = toylib::Grid(numCell, numCell, false, M_PI, M_PI, true);
+  const int nb_levels = 2;
+
+  toylib::EdgeData<double> ref_out(mesh, nb_levels);
+  toylib::EdgeData<double> gen_out(mesh, nb_levels);
+  toylib::EdgeData<double> inv_edge_length(mesh, nb_levels);
+  toylib::EdgeData<double> inv_vert_length(mesh, nb_levels);
+  toylib::VertexData<double> in(mesh, nb_levels);
+
+  for(const auto& v : mesh.vertices()) {
+    for(int k = 0; k < nb_levels; k++)
+      in(v, k) = sin(v.x()) * sin(v.y() * (k + 1));
+  }
+  for(const auto& e : mesh.edges()) {
+    double dx = e.get().vertex(0).x() - e.get().vertex(1).x();
+    double dy = e.get().vertex(0).y() - e.get().vertex(1).y();
+    double edgeLength = sqrt(dx * dx + dy * dy);
+    for(int k = 0; k < nb_levels; k++) {
+      inv_edge_length(e, k) = 1. / edgeLength;
+      inv_vert_length(e, k) = 1. / (0.5 * sqrt(3.) * edgeLength * 2);
+    }
+  }
+
+  // the weights are passed on the stack, the neighbors are looked up in a table
+  dawn_generated::cxxnaiveico::neighborTableDiamondWeights<toylibInterface::toylibTag>(
+      mesh, nb_levels, gen_out, inv_edge_length, inv_vert_length, in)
+      .run();
+  dawn_generated::cxxnaiveico::reference_diamondWeights<toylibInterface::toylibTag>(
+      mesh, nb_levels, ref_out, inv_edge_length, inv_vert_length, in)
+      .run();
+
+  {
+    UnstructuredVerifier v;
+    EXPECT_TRUE(v.compareToylibField(mesh.edges(), ref_out, gen_out, nb_levels))
+        << "while comparing output (on edges)";
+  }
+}
+} // namespace
+
 namespace {
 #include <generated_intp.hpp>
 #include <reference_intp.hpp>
@@ -376,6 +652,44 @@ TEST(ToylibIntegrationTestCompareOutput, verticalSolver) {
 }
 } // namespace
 
+namespace {
+#include <generated_parallelTridiagonalSolve.hpp>
+TEST(ToylibIntegrationTestCompareOutput, verticalSolverParallel) {
+  auto mesh = toylib::Grid(16, 16);
+  const int nb_levels = 5;
+
+  toylib::FaceData<double> a(mesh, nb_levels);
+  toylib::FaceData<double> b(mesh, nb_levels);
+  toylib::FaceData<double> c(mesh, nb_levels);
+  toylib::FaceData<double> d(mesh, nb_levels);
+
+  for(const auto& f : mesh.faces()) {
+    for(int k = 0; k < nb_levels; k++) {
+      a(f, k) = k + 1;
+      b(f, k) = k + 1;
+      c(f, k) = k + 2;
+    }
+
+    d(f, 0) = 5;
+    d(f, 1) = 15;
+    d(f, 2) = 31;
+    d(f, 3) = 53;
+    d(f, 4) = 45;
+  }
+
+  // the columns are solved on OpenMP threads, the levels of each one in order
+  dawn_generated::cxxnaiveico::parallelTridiagonalSolve<toylibInterface::toylibTag>(
+      mesh, nb_levels, a, b, c, d)
+      .run();
+
+  for(const auto& f : mesh.faces()) {
+    for(int k = 0; k < nb_levels; k++) {
+      EXPECT_TRUE(abs(d(f, k) - (k + 1)) < 1e3 * std::numeric_limits<double>::epsilon());
+    }
+  }
+}
+} // namespace
+
 namespace {
 #include <generated_nestedSimple.hpp>
 TEST(ToylibIntegrationTestCompareOutput, nestedSimple) {
@@ -691,6 +1005,39 @@ TEST(ToylibIntegrationTestCompareOutput, SparseAssignment5) {
 }
 } // namespace
 
+namespace {
+#include <generated_neighborTableSparseAssignment5.hpp>
+TEST(ToylibIntegrationTestCompareOutput, SparseAssignment5NeighborTable) {
+  auto mesh = toylib::Grid(10, 10);
+  const int edgesPerCell = 3;
+  const int nb_levels = 1;
+
+  toylib::SparseFaceData<double> ref_sparse_f(mesh, edgesPerCell, nb_levels);
+  toylib::SparseFaceData<double> gen_sparse_f(mesh, edgesPerCell, nb_levels);
+  toylib::VertexData<double> v_f(mesh, nb_levels);
+  toylib::FaceData<double> c_f(mesh, nb_levels);
+
+  for(const auto& v : mesh.vertices())
+    v_f(v, 0) = v.x() + 2. * v.y();
+  for(const auto& f : mesh.faces())
+    c_f(f, 0) = f.id();
+
+  // a loop over neighbors around nested reductions, all looked up in tables
+  dawn_generated::cxxnaiveico::sparseAssignment5<toylibInterface::toylibTag>(
+      mesh, nb_levels, ref_sparse_f, v_f, c_f)
+      .run();
+  dawn_generated::cxxnaiveico::neighborTableSparseAssignment5<toylibInterface::toylibTag>(
+      mesh, nb_levels, gen_sparse_f, v_f, c_f)
+      .run();
+
+  for(const auto& f : mesh.faces()) {
+    for(size_t sparse = 0; sparse < edgesPerCell; sparse++) {
+      EXPECT_EQ(ref_sparse_f(f, sparse, 0), gen_sparse_f(f, sparse, 0));
+    }
+  }
+}
+} // namespace
+
 namespace {
 #include <generated_sparseDimensionTwice.hpp>
 TEST(ToylibIntegrationTestCompareOutput, sparseDimensionsTwice) {
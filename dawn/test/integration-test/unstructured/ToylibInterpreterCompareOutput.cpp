@@ -0,0 +1,161 @@
+//===--------------------------------------------------------------------------------*- C++ -*-===//
+//                          _
+//                         | |
+//                       __| | __ ___      ___ ___
+//                      / _` |/ _` \ \ /\ / / '_  |
+//                     | (_| | (_| |\ V  V /| | | |
+//                      \__,_|\__,_| \_/\_/ |_| |_| - Compiler Toolchain
+//
+//
+//  This file is distributed under the MIT License (MIT).
+//  See LICENSE.txt for details.
+//
+//===------------------------------------------------------------------------------------------===//
+
+#include "dawn/AST/LocationType.h"
+#include "dawn/IIR/LocalVariable.h"
+#include "dawn/Interpreter/Interpreter.h"
+#include "dawn/Unittest/IIRBuilder.h"
+#include "interface/toylib_interface.hpp"
+#include "interface/toylib_interpreter.hpp"
+#include "toylib/toylib.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <tuple>
+#include <vector>
+
+namespace {
+#include <generated_diffusion.hpp>
+#include <generated_gradient.hpp>
+
+using namespace dawn::iir;
+using LocType = dawn::ast::LocationType;
+
+template <typename O>
+void expectEqual(const std::vector<O>& elements, const toylib::Data<O, double>& lhs,
+                 const toylib::Data<O, double>& rhs) {
+  for(int k = 0; k < lhs.k_size(); ++k)
+    for(const auto& elem : elements)
+      EXPECT_NEAR(lhs(elem, k), rhs(elem, k), 1e-12) << "element " << elem.id() << " level " << k;
+}
+
+std::tuple<double, double> cellMidpoint(const toylib::Face& f) {
+  auto v0 = f.vertex(0);
+  auto v1 = f.vertex(1);
+  auto v2 = f.vertex(2);
+  return {(v0.x() + v1.x() + v2.x()) / 3., (v0.y() + v1.y() + v2.y()) / 3.};
+}
+
+TEST(ToylibInterpreterCompareOutput, Diffusion) {
+  // same IIR as the generated diffusion stencil (GenerateUnstructuredStencils.cpp)
+  UnstructuredIIRBuilder b;
+  auto in_f = b.field("in_field", LocType::Cells);
+  auto out_f = b.field("out_field", LocType::Cells);
+  auto cnt = b.localvar("cnt", dawn::BuiltinTypeID::Integer, {}, LocalVariableType::OnCells);
+  auto stencil = b.build(
+      "diffusion",
+      b.stencil(b.multistage(
+          LoopOrderKind::Parallel,
+          b.stage(LocType::Cells,
+                  b.doMethod(
+                      dawn::ast::Interval::Start, dawn::ast::Interval::End, b.declareVar(cnt),
+                      b.stmt(b.assignExpr(b.at(cnt), b.reduceOverNeighborExpr(
+                                                         Op::plus, b.lit(1), b.lit(0),
+                                                         {LocType::Cells, LocType::Edges,
+                                                          LocType::Cells}))),
+                      b.stmt(b.assignExpr(
+                          b.at(out_f),
+                          b.reduceOverNeighborExpr(
+                              Op::plus, b.at(in_f, HOffsetType::withOffset, 0),
+                              b.binaryExpr(b.unaryExpr(b.at(cnt), Op::minus),
+                                           b.at(in_f, HOffsetType::noOffset, 0), Op::multiply),
+                              {LocType::Cells, LocType::Edges, LocType::Cells}))),
+                      b.stmt(b.assignExpr(
+                          b.at(out_f),
+                          b.binaryExpr(b.at(in_f),
+                                       b.binaryExpr(b.lit(0.1), b.at(out_f), Op::multiply),
+                                       Op::plus))))))));
+
+  toylib::Grid mesh(16, 16, false, 1., 1.);
+  const int nb_levels = 3;
+  toylib::FaceData<double> in(mesh, nb_levels);
+  toylib::FaceData<double> out_gen(mesh, nb_levels);
+  toylib::FaceData<double> out_int(mesh, nb_levels);
+  for(const auto& cell : mesh.faces()) {
+    auto [x, y] = cellMidpoint(cell);
+    for(int k = 0; k < nb_levels; ++k)
+      in(cell, k) = std::sin(x * (k + 1)) * std::cos(y);
+  }
+
+  dawn_generated::cxxnaiveico::diffusion<toylibInterface::toylibTag>(mesh, nb_levels, in, out_gen)
+      .run();
+
+  toylibInterpreter::Buffer inBuffer(in);
+  toylibInterpreter::Buffer outBuffer(out_int);
+  dawn::interpreter::Interpreter(stencil).run(
+      toylibInterpreter::makeMesh(mesh), nb_levels,
+      {{"in_field", inBuffer.view()}, {"out_field", outBuffer.view()}});
+  outBuffer.copyTo(out_int);
+
+  expectEqual(mesh.faces(), out_gen, out_int);
+}
+
+TEST(ToylibInterpreterCompareOutput, Gradient) {
+  // same IIR as the generated gradient stencil (GenerateUnstructuredStencils.cpp), the edges of
+  // the boundary are skipped
+  UnstructuredIIRBuilder b;
+  auto cell_f = b.field("cell_field", LocType::Cells);
+  auto edge_f = b.field("edge_field", LocType::Edges);
+  auto stencil = b.build(
+      "gradient",
+      b.stencil(b.multistage(
+          LoopOrderKind::Parallel,
+          b.stage(
+              LocType::Edges,
+              b.doMethod(dawn::ast::Interval::Start, dawn::ast::Interval::End,
+                         b.stmt(b.assignExpr(
+                             b.at(edge_f), b.reduceOverNeighborExpr<float>(
+                                               Op::plus, b.at(cell_f, HOffsetType::withOffset, 0),
+                                               b.lit(0.), {LocType::Edges, LocType::Cells},
+                                               std::vector<float>({1., -1.})))))),
+          b.stage(
+              LocType::Cells,
+              b.doMethod(dawn::ast::Interval::Start, dawn::ast::Interval::End,
+                         b.stmt(b.assignExpr(
+                             b.at(cell_f), b.reduceOverNeighborExpr<float>(
+                                               Op::plus, b.at(edge_f, HOffsetType::withOffset, 0),
+                                               b.lit(0.), {LocType::Cells, LocType::Edges},
+                                               std::vector<float>({0.5, 0., 0., 0.5})))))))));
+
+  toylib::Grid mesh(16, 16, false, M_PI, M_PI);
+  const int nb_levels = 2;
+  toylib::FaceData<double> cells_gen(mesh, nb_levels);
+  toylib::FaceData<double> cells_int(mesh, nb_levels);
+  toylib::EdgeData<double> edges_gen(mesh, nb_levels);
+  toylib::EdgeData<double> edges_int(mesh, nb_levels);
+  for(const auto& cell : mesh.faces()) {
+    auto [x, y] = cellMidpoint(cell);
+    for(int k = 0; k < nb_levels; ++k) {
+      cells_gen(cell, k) = std::sin(x) * std::sin(y * (k + 1));
+      cells_int(cell, k) = std::sin(x) * std::sin(y * (k + 1));
+    }
+  }
+
+  dawn_generated::cxxnaiveico::gradient<toylibInterface::toylibTag>(mesh, nb_levels, cells_gen,
+                                                                    edges_gen)
+      .run();
+
+  toylibInterpreter::Buffer cellBuffer(cells_int);
+  toylibInterpreter::Buffer edgeBuffer(edges_int);
+  dawn::interpreter::Interpreter(stencil).run(
+      toylibInterpreter::makeMesh(mesh), nb_levels,
+      {{"cell_field", cellBuffer.view()}, {"edge_field", edgeBuffer.view()}});
+  cellBuffer.copyTo(cells_int);
+  edgeBuffer.copyTo(edges_int);
+
+  expectEqual(mesh.faces(), cells_gen, cells_int);
+}
+
+} // namespace
@@ -0,0 +1,130 @@
+//===--------------------------------------------------------------------------------*- C++ -*-===//
+//                         _       _
+//                        | |     | |
+//                    __ _| |_ ___| | __ _ _ __   __ _
+//                   / _` | __/ __| |/ _` | '_ \ / _` |
+//                  | (_| | || (__| | (_| | | | | (_| |
+//                   \__, |\__\___|_|\__,_|_| |_|\__, | - GridTools Clang DSL
+//                    __/ |                       __/ |
+//                   |___/                       |___/
+//
+//
+//  This file is distributed under the MIT License (MIT).
+//  See LICENSE.txt for details.
+
+//===------------------------------------------------------------------------------------------===//
+//
+//  Strong scaling of the naive-ico diffusion stencil on a toylib grid split into 1, 2, 4, ...
+//  parts (up to the number of cores), one thread per part. Each step either exchanges the halo
+//  first, or computes the interior while exchanging and the rim afterwards. Usage:
+//  ToylibPartitionBenchmark [n [k_size]], results are written as JSON to stdout.
+//
+//===------------------------------------------------------------------------------------------===//
+
+#include "driver-includes/benchmark.hpp"
+#include "driver-includes/domain_decomposition.hpp"
+#include "driver-includes/unstructured_interface.hpp"
+#include "interface/toylib_interface.hpp"
+#include "toylib/toylib.hpp"
+
+#include <generated_interiorDiffusion.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace {
+
+using dawn::driver::benchmark_result;
+using dawn::driver::unstructured_footprint;
+using stencil_t = dawn_generated::cxxnaiveico::interiorDiffusion<toylibInterface::toylibTag>;
+
+void benchmarkParts(toylib::Grid const& mesh, int parts, int kSize,
+                    std::vector<benchmark_result>& results) {
+  const auto subgrids = toylib::decompose(mesh, toylib::partition(mesh, parts));
+  // allocated (first touched) by the thread of their part
+  std::vector<std::unique_ptr<toylib::FaceData<double>>> in(parts);
+  std::vector<std::unique_ptr<toylib::FaceData<double>>> out(parts);
+  dawn::driver::shared_memory_transport transport(parts);
+  dawn::driver::benchmark_options options;
+  // only the thread of part 0 would be counted
+  options.counters = false;
+  const std::size_t numCells = mesh.faces().size();
+  const std::vector<dawn::driver::field_footprint> footprint = {
+      unstructured_footprint("in", numCells, kSize, 0, sizeof(double), true, false),
+      unstructured_footprint("out", numCells, kSize, 0, sizeof(double), false, true)};
+
+  dawn::driver::run_ranks(parts, transport, [&](int part) {
+    const auto& sub = subgrids[part];
+    in[part].reset(new toylib::FaceData<double>(sub.grid, kSize));
+    out[part].reset(new toylib::FaceData<double>(sub.grid, kSize));
+    for(int k = 0; k < kSize; ++k)
+      for(const auto& f : sub.grid.faces()) {
+        double x = (f.vertex(0).x() + f.vertex(1).x() + f.vertex(2).x()) / 3.;
+        double y = (f.vertex(0).y() + f.vertex(1).y() + f.vertex(2).y()) / 3.;
+        (*in[part])(f, k) = std::sin(x) * std::sin(y);
+      }
+
+    stencil_t all(sub.grid, kSize, *in[part], *out[part]);
+    stencil_t interior(sub.grid, kSize, *in[part], *out[part]);
+    stencil_t rim(sub.grid, kSize, *in[part], *out[part]);
+    toylibInterface::setSplitterIndices(all, sub);
+    toylibInterface::setSplitterIndices(interior, sub);
+    interior.set_splitter_index(dawn::LocationType::Cells, dawn::UnstructuredSubdomain::Halo, 0,
+                                sub.faces.rim);
+    toylibInterface::setSplitterIndices(rim, sub);
+    rim.set_splitter_index(dawn::LocationType::Cells, dawn::UnstructuredSubdomain::Interior, 0,
+                           sub.faces.rim);
+    // the fields of all parts are allocated
+    transport.barrier();
+
+    auto exchangeFirst = [&] {
+      transport.barrier();
+      in[part]->update_halo(sub.face_halo, in);
+      all.run();
+      transport.barrier();
+    };
+    auto overlapped = [&] {
+      transport.barrier();
+      interior.run();
+      in[part]->update_halo(sub.face_halo, in);
+      rim.run();
+      transport.barrier();
+    };
+    const std::string name = "diffusion/" + std::to_string(parts) + "-parts/";
+    const std::vector<std::pair<std::string, std::function<void()>>> steps = {
+        {"exchange-first", exchangeFirst}, {"overlapped", overlapped}};
+    for(const auto& step : steps) {
+      if(part == 0) {
+        results.push_back(dawn::driver::run_benchmark(name + step.first, step.second, footprint, 0,
+                                                      options));
+      } else {
+        for(int i = 0; i < options.warmup + options.repetitions; ++i)
+          step.second();
+      }
+    }
+  });
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+  const int n = argc > 1 ? std::atoi(argv[1]) : 128;
+  const int kSize = argc > 2 ? std::atoi(argv[2]) : 10;
+  const int cores = std::max(1u, std::thread::hardware_concurrency());
+
+  toylib::Grid mesh(n, n, false, M_PI, M_PI);
+  std::vector<benchmark_result> results;
+  for(int parts = 1; parts <= cores; parts *= 2)
+    benchmarkParts(mesh, parts, kSize, results);
+
+  dawn::driver::write_json(std::cout, results);
+  return 0;
+}
@@ -0,0 +1,95 @@
+//===--------------------------------------------------------------------------------*- C++ -*-===//
+//                         _       _
+//                        | |     | |
+//                    __ _| |_ ___| | __ _ _ __   __ _
+//                   / _` | __/ __| |/ _` | '_ \ / _` |
+//                  | (_| | || (__| | (_| | | | | (_| |
+//                   \__, |\__\___|_|\__,_|_| |_|\__, | - GridTools Clang DSL
+//                    __/ |                       __/ |
+//                   |___/                       |___/
+//
+//
+//  This file is distributed under the MIT License (MIT).
+//  See LICENSE.txt for details.
+
+//===------------------------------------------------------------------------------------------===//
+//
+//  Benchmark of the naive-ico diffusion and gradient stencils on a toylib grid in its raster
+//  order and renumbered for locality. Usage: ToylibReorderingBenchmark [n [k_size]], results are
+//  written as JSON to stdout.
+//
+//===------------------------------------------------------------------------------------------===//
+
+#include "driver-includes/benchmark.hpp"
+#include "driver-includes/unstructured_interface.hpp"
+#include "interface/toylib_interface.hpp"
+#include "toylib/toylib.hpp"
+
+#include <generated_diffusion.hpp>
+#include <generated_gradient.hpp>
+
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+using dawn::driver::benchmark_result;
+using dawn::driver::run_benchmark;
+using dawn::driver::unstructured_footprint;
+
+void benchmarkGrid(const std::string& ordering, toylib::Grid const& mesh, int kSize,
+                   std::vector<benchmark_result>& results) {
+  toylib::FaceData<double> in(mesh, kSize);
+  toylib::FaceData<double> out(mesh, kSize);
+  toylib::EdgeData<double> edges(mesh, kSize);
+  for(int k = 0; k < kSize; ++k)
+    for(const auto& f : mesh.faces()) {
+      double x = (f.vertex(0).x() + f.vertex(1).x() + f.vertex(2).x()) / 3.;
+      double y = (f.vertex(0).y() + f.vertex(1).y() + f.vertex(2).y()) / 3.;
+      in(f, k) = std::sin(x) * std::sin(y);
+    }
+
+  const std::size_t numCells = mesh.faces().size();
+  const std::size_t numEdges = mesh.edges().size();
+  results.push_back(run_benchmark(
+      "diffusion/" + ordering,
+      [&] {
+        dawn_generated::cxxnaiveico::diffusion<toylibInterface::toylibTag>(mesh, kSize, in, out)
+            .run();
+      },
+      {unstructured_footprint("in", numCells, kSize, 0, sizeof(double), true, false),
+       unstructured_footprint("out", numCells, kSize, 0, sizeof(double), false, true)}));
+  results.push_back(run_benchmark(
+      "gradient/" + ordering,
+      [&] {
+        dawn_generated::cxxnaiveico::gradient<toylibInterface::toylibTag>(mesh, kSize, in, edges)
+            .run();
+      },
+      {unstructured_footprint("cells", numCells, kSize, 0, sizeof(double), true, true),
+       unstructured_footprint("edges", numEdges, kSize, 0, sizeof(double), true, true)}));
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+  const int n = argc > 1 ? std::atoi(argv[1]) : 64;
+  const int kSize = argc > 2 ? std::atoi(argv[2]) : 10;
+
+  std::vector<benchmark_result> results;
+  benchmarkGrid("raster", toylib::Grid(n, n, false, M_PI, M_PI), kSize, results);
+  const std::vector<std::pair<std::string, toylib::reordering>> orderings = {
+      {"hilbert", toylib::reordering::hilbert},
+      {"morton", toylib::reordering::morton},
+      {"rcm", toylib::reordering::reverse_cuthill_mckee}};
+  for(const auto& ordering : orderings) {
+    toylib::Grid mesh(n, n, false, M_PI, M_PI);
+    toylib::reorder(mesh, ordering.second);
+    benchmarkGrid(ordering.first, mesh, kSize, results);
+  }
+
+  dawn::driver::write_json(std::cout, results);
+  return 0;
+}
@@ -13,11 +13,19 @@
 //===------------------------------------------------------------------------------------------===//
 
 #include "Stencils.h"
+#include "dawn/CodeGen/CXXNaive/CXXNaiveCodeGen.h"
 #include "dawn/CodeGen/Options.h"
 #include "dawn/Serialization/IIRSerializer.h"
+#include "dawn/Support/Logger.h"
+#include "dawn/Unittest/IIRBuilder.h"
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
 namespace {
 
 constexpr auto backend = dawn::codegen::Backend::CXXNaive;
@@ -44,4 +52,199 @@ TEST(Naive, DzCStencil) {
           "reference/update_dz_c.cpp");
 }
 
+TEST(Naive, SlimRuntime) {
+  auto stencil = dawn::getLaplacianStencil();
+  dawn::codegen::Options options;
+  options.SlimRuntime = true;
+  auto tu = dawn::codegen::cxxnaive::run({{stencil->getName(), stencil}}, options);
+
+  const auto& ppDefines = tu->getPPDefines();
+  auto contains = [&](const std::string& str) {
+    return std::any_of(ppDefines.begin(), ppDefines.end(), [&](const std::string& line) {
+      return line.find(str) != std::string::npos;
+    });
+  };
+  EXPECT_TRUE(contains("#define GRIDTOOLS_DAWN_SLIM_RUNTIME"));
+  EXPECT_TRUE(contains("GRIDTOOLS_DAWN_HALO_EXTENT 3"));
+  EXPECT_FALSE(contains("BOOST_"));
+}
+
+TEST(Naive, PrecompiledHeader) {
+  const std::string header = testing::TempDir() + "cxxnaive_preamble.hpp";
+  std::remove(header.c_str());
+
+  auto stencil = dawn::getLaplacianStencil();
+  dawn::codegen::Options options;
+  options.PrecompiledHeader = header;
+  auto tu = dawn::codegen::cxxnaive::run({{stencil->getName(), stencil}}, options);
+
+  // The preamble is replaced by a single include which comes first
+  ASSERT_EQ(tu->getPPDefines().size(), 1);
+  EXPECT_EQ(tu->getPPDefines()[0], "#include \"" + header + "\"");
+
+  std::ifstream file(header);
+  std::stringstream content;
+  content << file.rdbuf();
+  EXPECT_EQ(content.str().rfind("#pragma once\n#define DAWN_GENERATED 1\n", 0), 0);
+  EXPECT_NE(content.str().find("#include <driver-includes/gridtools_includes.hpp>"),
+            std::string::npos);
+
+  // Generating another stencil with the same options must not change the header
+  auto other = dawn::getGlobalIndexStencil();
+  dawn::codegen::cxxnaive::run({{other->getName(), other}}, options);
+  std::ifstream otherFile(header);
+  std::stringstream otherContent;
+  otherContent << otherFile.rdbuf();
+  EXPECT_EQ(otherContent.str(), content.str());
+}
+
+TEST(Naive, TmpMemoryPlanning) {
+  using namespace dawn;
+  UIDGenerator::getInstance()->reset();
+
+  // `a` and `b` are alive in different multistages, `c` in both of them
+  iir::CartesianIIRBuilder b;
+  auto in = b.field("in", iir::FieldType::ijk);
+  auto out = b.field("out", iir::FieldType::ijk);
+  auto tmpA = b.tmpField("a", iir::FieldType::ijk);
+  auto tmpB = b.tmpField("b", iir::FieldType::ijk);
+  auto tmpC = b.tmpField("c", iir::FieldType::ijk);
+  auto stencil = b.build(
+      "generated",
+      b.stencil(b.multistage(iir::LoopOrderKind::Parallel,
+                             b.stage(b.doMethod(ast::Interval::Start, ast::Interval::End,
+                                                b.stmt(b.assignExpr(b.at(tmpA), b.at(in))),
+                                                b.stmt(b.assignExpr(b.at(tmpC), b.at(tmpA)))))),
+                b.multistage(iir::LoopOrderKind::Parallel,
+                             b.stage(b.doMethod(ast::Interval::Start, ast::Interval::End,
+                                                b.stmt(b.assignExpr(b.at(tmpB), b.at(tmpC))),
+                                                b.stmt(b.assignExpr(b.at(out), b.at(tmpB))))))));
+
+  std::ostringstream output;
+  dawn::log::info.stream(output);
+  dawn::log::setVerbosity(dawn::log::Level::All);
+
+  codegen::Options options;
+  options.TmpMemoryPlanning = true;
+  auto tu = codegen::cxxnaive::run({{stencil->getName(), stencil}}, options);
+  dawn::log::info.stream(std::cout);
+  dawn::log::setVerbosity(dawn::log::Level::Warnings);
+
+  // two temporaries alive in each multistage, three storages without planning, two with it
+  EXPECT_NE(output.str().find(
+                "at most 2 temporaries alive in a multistage, temporary storages reduced from 3 to 2"),
+            std::string::npos);
+  const std::string& code = tu->getStencils().at("generated");
+  auto contains = [&](const std::string& str) { return code.find(str) != std::string::npos; };
+
+  EXPECT_TRUE(contains("tmp_storage_t m_" + tmpA.name + ";"));
+  EXPECT_TRUE(contains("tmp_storage_t m_" + tmpC.name + ";"));
+  EXPECT_FALSE(contains("m_" + tmpB.name));
+  EXPECT_TRUE(contains(tmpB.name + "= gridtools::make_host_view(m_" + tmpA.name + ")"));
+  EXPECT_TRUE(contains(tmpC.name + "= gridtools::make_host_view(m_" + tmpC.name + ")"));
+}
+
+TEST(Naive, ReduceTmpDimensions) {
+  using namespace dawn;
+  UIDGenerator::getInstance()->reset();
+
+  // `a` is only accessed at the current level, `b` is read at the level below
+  iir::CartesianIIRBuilder b;
+  auto in = b.field("in", iir::FieldType::ijk);
+  auto out = b.field("out", iir::FieldType::ijk);
+  auto tmpA = b.tmpField("a", iir::FieldType::ijk);
+  auto tmpB = b.tmpField("b", iir::FieldType::ijk);
+  auto stencil = b.build(
+      "generated",
+      b.stencil(b.multistage(
+          iir::LoopOrderKind::Forward,
+          b.stage(b.doMethod(ast::Interval::Start, ast::Interval::End,
+                             b.stmt(b.assignExpr(b.at(tmpA), b.at(in))),
+                             b.stmt(b.assignExpr(b.at(tmpB), b.at(in))))),
+          b.stage(b.doMethod(
+              ast::Interval::Start, ast::Interval::End, 1, 0,
+              b.stmt(b.assignExpr(b.at(out), b.binaryExpr(b.at(tmpA, {1, 0, 0}),
+                                                          b.at(tmpB, {0, 0, -1})))))))));
+
+  codegen::Options options;
+  options.ReduceTmpDimensions = true;
+  auto tu = codegen::cxxnaive::run({{stencil->getName(), stencil}}, options);
+  const std::string& code = tu->getStencils().at("generated");
+  auto contains = [&](const std::string& str) { return code.find(str) != std::string::npos; };
+
+  EXPECT_TRUE(contains("tmp_plane_storage_t m_" + tmpA.name + ";"));
+  EXPECT_TRUE(contains("m_" + tmpA.name + "(m_tmp_plane_meta_data)"));
+  EXPECT_TRUE(contains("tmp_storage_t m_" + tmpB.name + ";"));
+  EXPECT_TRUE(contains(tmpA.name + "(i+0, j+0, 0) = in(i+0, j+0, k+0);"));
+  EXPECT_TRUE(contains(tmpA.name + "(i+1, j+0, 0)"));
+  EXPECT_TRUE(contains(tmpB.name + "(i+0, j+0, k+-1)"));
+}
+
+TEST(Naive, RawPointerAccess) {
+  using namespace dawn;
+  UIDGenerator::getInstance()->reset();
+
+  // out = in[i+1] + coeff[j-1], with coeff an ij-field
+  iir::CartesianIIRBuilder b;
+  auto in = b.field("in", iir::FieldType::ijk);
+  auto coeff = b.field("coeff", iir::FieldType::ij);
+  auto out = b.field("out", iir::FieldType::ijk);
+  auto stencil = b.build(
+      "generated",
+      b.stencil(b.multistage(
+          iir::LoopOrderKind::Parallel,
+          b.stage(b.doMethod(ast::Interval::Start, ast::Interval::End,
+                             b.stmt(b.assignExpr(b.at(out),
+                                                 b.binaryExpr(b.at(in, {1, 0, 0}),
+                                                              b.at(coeff, {0, -1, 0})))))))));
+
+  codegen::Options options;
+  options.RawPointerAccess = true;
+  auto tu = codegen::cxxnaive::run({{stencil->getName(), stencil}}, options);
+  const std::string& code = tu->getStencils().at("generated");
+  auto contains = [&](const std::string& str) { return code.find(str) != std::string::npos; };
+
+  EXPECT_TRUE(contains("::dawn::float_type* __restrict__ in_ptr = &in(0, 0, 0);"));
+  EXPECT_TRUE(contains("assert(in_.get_storage_info_ptr()->template stride<0>() == 1);"));
+  EXPECT_TRUE(contains("const int coeff_jstride = coeff_.get_storage_info_ptr()->template "
+                       "stride<1>();"));
+  EXPECT_FALSE(contains("coeff_kstride"));
+  EXPECT_TRUE(contains("out_ptr[(i+0) + (j+0)*out_jstride + (k+0)*out_kstride] = (in_ptr[(i+1) + "
+                       "(j+0)*in_jstride + (k+0)*in_kstride] + coeff_ptr[(i+0) + "
+                       "(j+-1)*coeff_jstride]);"));
+}
+
+TEST(Naive, DomainSize) {
+  using namespace dawn;
+  UIDGenerator::getInstance()->reset();
+
+  iir::CartesianIIRBuilder b;
+  auto in = b.field("in", iir::FieldType::ijk);
+  auto out = b.field("out", iir::FieldType::ijk);
+  auto stencil = b.build(
+      "generated",
+      b.stencil(b.multistage(
+          iir::LoopOrderKind::Parallel,
+          b.stage(b.doMethod(ast::Interval::Start, ast::Interval::End,
+                             b.stmt(b.assignExpr(b.at(out), b.at(in, {1, 0, 0}))))))));
+
+  codegen::Options options;
+  options.DomainSizeI = 64;
+  options.DomainSizeK = 80;
+  auto tu = codegen::cxxnaive::run({{stencil->getName(), stencil}}, options);
+  const std::string& code = tu->getStencils().at("generated");
+  auto contains = [&](const std::string& str) { return code.find(str) != std::string::npos; };
+
+  EXPECT_TRUE(contains("constexpr int iMin = gridtools::dawn::halo::value;"));
+  EXPECT_TRUE(contains("constexpr int iMax = 64 - gridtools::dawn::halo::value - 1;"));
+  EXPECT_TRUE(contains("int jMin = m_dom.jminus();"));
+  EXPECT_FALSE(contains("constexpr int jMin"));
+  EXPECT_TRUE(contains("constexpr int kMin = 0;"));
+  EXPECT_TRUE(contains("constexpr int kMax = 79;"));
+  EXPECT_TRUE(contains("assert(dom.isize() == 64 && dom.iminus() == gridtools::dawn::halo::value "
+                       "&& dom.iplus() == gridtools::dawn::halo::value);"));
+  EXPECT_TRUE(contains("assert(dom.ksize() == 80 && dom.kminus() == 0 && dom.kplus() == 0);"));
+  EXPECT_FALSE(contains("assert(dom.jsize() =="));
+}
+
 } // namespace
@@ -13,9 +13,14 @@
 //===------------------------------------------------------------------------------------------===//
 
 #include "Stencils.h"
+#include "dawn/CodeGen/CXXOpt/CXXOptCodeGen.h"
 #include "dawn/CodeGen/Options.h"
+#include "dawn/IIR/MultiStage.h"
+#include "dawn/Optimizer/PassStencilSplitter.h"
 #include "dawn/Serialization/IIRSerializer.h"
+#include "dawn/Unittest/IIRBuilder.h"
 
+#include <algorithm>
 #include <gtest/gtest.h>
 
 namespace {
@@ -26,4 +31,355 @@ TEST(Opt, LaplacianStencil) {
   runTest(dawn::getLaplacianStencil(), backend, "reference/laplacian_stencil_opt.cpp");
 }
 
+TEST(Opt, KCacheRingBuffer) {
+  using namespace dawn;
+  UIDGenerator::getInstance()->reset();
+
+  // out[k] = out[k-1] + in[k]
+  iir::CartesianIIRBuilder b;
+  auto in = b.field("in", iir::FieldType::ijk);
+  auto out = b.field("out", iir::FieldType::ijk);
+  auto stencil = b.build(
+      "generated",
+      b.stencil(b.multistage(
+          iir::LoopOrderKind::Forward,
+          b.stage(b.doMethod(ast::Interval::Start, ast::Interval::Start,
+                             b.stmt(b.assignExpr(b.at(out), b.at(in)))),
+                  b.doMethod(ast::Interval::Start, ast::Interval::End, 1, 0,
+                             b.stmt(b.assignExpr(
+                                 b.at(out), b.binaryExpr(b.at(out, {0, 0, -1}), b.at(in)))))))));
+
+  iir::MultiStage& ms = *stencil->getStencils().front()->getChildren().front();
+  const int outID = stencil->getMetaData().getAccessIDFromName("out");
+  const iir::Interval interval(0, ast::Interval::End);
+  ms.setCache(iir::Cache::CacheType::K, iir::Cache::IOPolicy::fill_and_flush, outID, interval,
+              interval, std::nullopt);
+
+  auto tu = codegen::cxxopt::run({{stencil->getName(), stencil}});
+  const std::string& code = tu->getStencils().at("generated");
+  auto contains = [&](const std::string& str) { return code.find(str) != std::string::npos; };
+
+  // columns are processed independently, `out` lives in a window of two levels
+  EXPECT_TRUE(contains("#pragma omp parallel for"));
+  EXPECT_TRUE(contains("::dawn::float_type out_kcache[2];"));
+  EXPECT_TRUE(
+      contains("if(k+-1 >= 0 && k+-1 < m_dom.ksize()) out_kcache[0] = out(i+0, j+0, k+-1);"));
+  EXPECT_TRUE(contains("out_kcache[1] = out(i+0, j+0, k+0);"));
+  EXPECT_TRUE(contains("out_kcache[1] = (out_kcache[0] + in(i+0, j+0, k+0));"));
+  EXPECT_TRUE(contains("out_kcache[0] = out_kcache[1];"));
+
+  // the level leaving the window is written back, unless it is in front of the cache interval,
+  // the rest of the window after the last level
+  EXPECT_TRUE(contains("if(k+-1 >= kMin + 0) out(i+0, j+0, k+-1) = out_kcache[0];"));
+  EXPECT_TRUE(contains("\n            out(i+0, j+0, k+-1) = out_kcache[0];"));
+  EXPECT_TRUE(contains("if(k == kMax + 0) {"));
+  EXPECT_TRUE(contains("out(i+0, j+0, k+0) = out_kcache[1];"));
+
+  // the previous level is only read from memory once per column
+  const std::string prevLevel = "= out(i+0, j+0, k+-1)";
+  EXPECT_EQ(code.find(prevLevel), code.rfind(prevLevel));
+}
+
+TEST(Opt, KCacheFlushInterval) {
+  using namespace dawn;
+  UIDGenerator::getInstance()->reset();
+
+  // `tmp` is flushed for a later multistage, only in the levels [2, end-2] it is computed in
+  iir::CartesianIIRBuilder b;
+  auto in = b.field("in", iir::FieldType::ijk);
+  auto out = b.field("out", iir::FieldType::ijk);
+  auto tmp = b.tmpField("tmp", iir::FieldType::ijk);
+  auto stencil = b.build(
+      "generated",
+      b.stencil(b.multistage(
+          iir::LoopOrderKind::Forward,
+          b.stage(b.doMethod(ast::Interval::Start, ast::Interval::End,
+                             b.stmt(b.assignExpr(b.at(out), b.at(in))))),
+          b.stage(b.doMethod(ast::Interval::Start, ast::Interval::End, 2, -2,
+                             b.stmt(b.assignExpr(b.at(tmp), b.at(in, {0, 0, 1}))),
+                             b.stmt(b.assignExpr(b.at(out), b.at(tmp, {0, 0, -1}))))))));
+
+  iir::MultiStage& ms = *stencil->getStencils().front()->getChildren().front();
+  const iir::Interval interval(2, ast::Interval::End, 0, -2);
+  ms.setCache(iir::Cache::CacheType::K, iir::Cache::IOPolicy::flush, tmp.id, interval, interval,
+              iir::Cache::window{});
+  const std::string name = stencil->getMetaData().getFieldNameFromAccessID(tmp.id);
+
+  auto tu = codegen::cxxopt::run({{stencil->getName(), stencil}});
+  const std::string& code = tu->getStencils().at("generated");
+  auto count = [&](const std::string& str) {
+    int n = 0;
+    for(auto pos = code.find(str); pos != std::string::npos; pos = code.find(str, pos + 1))
+      ++n;
+    return n;
+  };
+
+  // nothing is written back in the levels [0, 1] and [end-1, end]
+  EXPECT_EQ(count("if(k+-1 >= kMin + 2) " + name + "(i+0, j+0, k+-1) = " + name + "_kcache[0];"),
+            1);
+  EXPECT_EQ(count(name + "(i+0, j+0, k+-1) = " + name + "_kcache[0];"), 1);
+  EXPECT_EQ(count("if(k == kMax + -2) {"), 1);
+  EXPECT_EQ(count(name + "(i+0, j+0, k+0) = " + name + "_kcache[1];"), 1);
+}
+
+TEST(Opt, ReduceTmpDimensions) {
+  using namespace dawn;
+  UIDGenerator::getInstance()->reset();
+
+  // out[k] = out[k-1] + t[k-1], with t = in
+  iir::CartesianIIRBuilder b;
+  auto in = b.field("in", iir::FieldType::ijk);
+  auto out = b.field("out", iir::FieldType::ijk);
+  auto tmp = b.tmpField("t", iir::FieldType::ijk);
+  auto stencil = b.build(
+      "generated",
+      b.stencil(b.multistage(
+          iir::LoopOrderKind::Forward,
+          b.stage(b.doMethod(ast::Interval::Start, ast::Interval::End,
+                             b.stmt(b.assignExpr(b.at(tmp), b.at(in))))),
+          b.stage(b.doMethod(ast::Interval::Start, ast::Interval::Start,
+                             b.stmt(b.assignExpr(b.at(out), b.at(in)))),
+                  b.doMethod(ast::Interval::Start, ast::Interval::End, 1, 0,
+                             b.stmt(b.assignExpr(b.at(out),
+                                                 b.binaryExpr(b.at(out, {0, 0, -1}),
+                                                              b.at(tmp, {0, 0, -1})))))))));
+
+  iir::MultiStage& ms = *stencil->getStencils().front()->getChildren().front();
+  const int outID = stencil->getMetaData().getAccessIDFromName("out");
+  const iir::Interval interval(0, ast::Interval::End);
+  ms.setCache(iir::Cache::CacheType::K, iir::Cache::IOPolicy::fill_and_flush, outID, interval,
+              interval, std::nullopt);
+
+  codegen::Options options;
+  options.ReduceTmpDimensions = true;
+  auto tu = codegen::cxxopt::run({{stencil->getName(), stencil}}, options);
+  const std::string& code = tu->getStencils().at("generated");
+  auto contains = [&](const std::string& str) { return code.find(str) != std::string::npos; };
+
+  // the multistage is walked column by column, `t` only needs the levels of the current column
+  EXPECT_FALSE(contains("m_" + tmp.name));
+  EXPECT_TRUE(contains("std::vector<::dawn::float_type> " + tmp.name +
+                       "_column(m_dom.ksize() + 1);"));
+  EXPECT_TRUE(contains(tmp.name + "_column[k+1] = in(i+0, j+0, k+0);"));
+  EXPECT_TRUE(contains("out_kcache[1] = (out_kcache[0] + " + tmp.name + "_column[k+0]);"));
+
+  // the column buffer is allocated once per thread, the columns are shared out by `omp for`
+  const auto parallelPos = code.find("#pragma omp parallel\n");
+  const auto columnPos = code.find(tmp.name + "_column(");
+  const auto forPos = code.find("#pragma omp for\n");
+  ASSERT_NE(parallelPos, std::string::npos);
+  ASSERT_NE(forPos, std::string::npos);
+  EXPECT_LT(parallelPos, columnPos);
+  EXPECT_LT(columnPos, forPos);
+}
+
+TEST(Opt, ReduceTmpDimensionsWithoutKCache) {
+  using namespace dawn;
+  UIDGenerator::getInstance()->reset();
+
+  // out[k] = t[k-1], with t = in, nothing is k-cached
+  iir::CartesianIIRBuilder b;
+  auto in = b.field("in", iir::FieldType::ijk);
+  auto out = b.field("out", iir::FieldType::ijk);
+  auto tmp = b.tmpField("t", iir::FieldType::ijk);
+  auto stencil = b.build(
+      "generated",
+      b.stencil(b.multistage(
+          iir::LoopOrderKind::Forward,
+          b.stage(b.doMethod(ast::Interval::Start, ast::Interval::End,
+                             b.stmt(b.assignExpr(b.at(tmp), b.at(in))))),
+          b.stage(b.doMethod(ast::Interval::Start, ast::Interval::End, 1, 0,
+                             b.stmt(b.assignExpr(b.at(out), b.at(tmp, {0, 0, -1}))))))));
+
+  codegen::Options options;
+  options.ReduceTmpDimensions = true;
+  auto tu = codegen::cxxopt::run({{stencil->getName(), stencil}}, options);
+  const std::string& code = tu->getStencils().at("generated");
+  auto contains = [&](const std::string& str) { return code.find(str) != std::string::npos; };
+
+  // the multistage is still walked column by column for the sake of `t`
+  EXPECT_FALSE(contains("m_" + tmp.name));
+  EXPECT_FALSE(contains("_kcache"));
+  EXPECT_TRUE(contains("std::vector<::dawn::float_type> " + tmp.name +
+                       "_column(m_dom.ksize() + 1);"));
+  EXPECT_TRUE(contains("out(i+0, j+0, k+0) = " + tmp.name + "_column[k+0];"));
+}
+
+TEST(Opt, FusedStencilTileSize) {
+  using namespace dawn;
+  UIDGenerator::getInstance()->reset();
+
+  // mid = in, out = mid[i+1], split in two stencils
+  iir::CartesianIIRBuilder b;
+  auto in = b.field("in", iir::FieldType::ijk);
+  auto mid = b.field("mid", iir::FieldType::ijk);
+  auto out = b.field("out", iir::FieldType::ijk);
+  auto stencil = b.build(
+      "generated",
+      b.stencil(b.multistage(
+          iir::LoopOrderKind::Parallel,
+          b.stage(b.doMethod(ast::Interval::Start, ast::Interval::End,
+                             b.stmt(b.assignExpr(b.at(mid), b.at(in))))),
+          b.stage(b.doMethod(ast::Interval::Start, ast::Interval::End,
+                             b.stmt(b.assignExpr(b.at(out), b.at(mid, {1, 0, 0}))))))));
+
+  Options optimizerOptions;
+  optimizerOptions.SplitStencils = true;
+  PassStencilSplitter splitter(2);
+  splitter.run(stencil, optimizerOptions);
+  stencil->computeDerivedInfo();
+  ASSERT_EQ(stencil->getStencils().size(), 2);
+
+  codegen::Options options;
+  options.FusedStencilTileSize = 32;
+  auto tu = codegen::cxxopt::run({{stencil->getName(), stencil}}, options);
+  const std::string& code = tu->getStencils().at("generated");
+  auto contains = [&](const std::string& str) { return code.find(str) != std::string::npos; };
+
+  // both stencils are run tile after tile, the first one also computes the column of `mid` read
+  // at i+1 by the second one
+  EXPECT_TRUE(contains("for(int tileI = dom.iminus(); tileI <= dom.isize() - dom.iplus() - 1; "
+                       "tileI += 32)"));
+  EXPECT_TRUE(
+      contains("int iMax = std::min<int>(m_dom.isize() - m_dom.iplus() - 1, tileIMax + 1);"));
+  EXPECT_TRUE(
+      contains("int iMax = std::min<int>(m_dom.isize() - m_dom.iplus() - 1, tileIMax + 0);"));
+  EXPECT_TRUE(contains(".run_tile(in, mid, tileI, tileI + 31, tileJ, tileJ + 31);"));
+  EXPECT_TRUE(contains(".run_tile(mid, out, tileI, tileI + 31, tileJ, tileJ + 31);"));
+
+  // a single parallel region around the tile loops, the points of a tile are shared out by the
+  // loops of `run_tile`
+  const auto parallelRegion = code.find("#pragma omp parallel\n");
+  ASSERT_NE(parallelRegion, std::string::npos);
+  EXPECT_LT(parallelRegion, code.find("for(int tileJ"));
+  for(auto runTile = code.find("void run_tile("); runTile != std::string::npos;
+      runTile = code.find("void run_tile(", runTile + 1)) {
+    // up to the next stencil or the `run` method of the stencil wrapper
+    const auto end =
+        std::min(code.find("\n  struct ", runTile), code.find("\n  void run(", runTile));
+    const std::string body = code.substr(runTile, end - runTile);
+    EXPECT_NE(body.find("#pragma omp for\n"), std::string::npos);
+    EXPECT_EQ(body.find("#pragma omp parallel"), std::string::npos);
+  }
+}
+
+TEST(Opt, Vectorize) {
+  using namespace dawn;
+  UIDGenerator::getInstance()->reset();
+
+  // out = in[i+1] + coeff[j-1], with coeff an ij-field
+  iir::CartesianIIRBuilder b;
+  auto in = b.field("in", iir::FieldType::ijk);
+  auto coeff = b.field("coeff", iir::FieldType::ij);
+  auto out = b.field("out", iir::FieldType::ijk);
+  auto stencil = b.build(
+      "generated",
+      b.stencil(b.multistage(
+          iir::LoopOrderKind::Parallel,
+          b.stage(b.doMethod(ast::Interval::Start, ast::Interval::End,
+                             b.stmt(b.assignExpr(b.at(out),
+                                                 b.binaryExpr(b.at(in, {1, 0, 0}),
+                                                              b.at(coeff, {0, -1, 0})))))))));
+
+  codegen::Options options;
+  options.Vectorize = true;
+  auto tu = codegen::cxxopt::run({{stencil->getName(), stencil}}, options);
+  const std::string& code = tu->getStencils().at("generated");
+  auto contains = [&](const std::string& str) { return code.find(str) != std::string::npos; };
+
+  // the vectorized loop runs over i, fields are accessed through their pointer and strides
+  EXPECT_TRUE(contains("#pragma omp simd\nfor(int i = iMin+0; i  <=  iMax+0; ++i)"));
+  EXPECT_TRUE(contains("const int coeff_jstride = coeff_.get_storage_info_ptr()->template "
+                       "stride<1>();"));
+  EXPECT_FALSE(contains("coeff_kstride"));
+  EXPECT_TRUE(contains("out_ptr[(i+0) + (j+0)*out_jstride + (k+0)*out_kstride] = (in_ptr[(i+1) + "
+                       "(j+0)*in_jstride + (k+0)*in_kstride] + coeff_ptr[(i+0) + "
+                       "(j+-1)*coeff_jstride]);"));
+}
+
+TEST(Opt, DomainSize) {
+  using namespace dawn;
+  UIDGenerator::getInstance()->reset();
+
+  // out[k] = t[k-1], with t = in, kept in a column buffer
+  iir::CartesianIIRBuilder b;
+  auto in = b.field("in", iir::FieldType::ijk);
+  auto out = b.field("out", iir::FieldType::ijk);
+  auto tmp = b.tmpField("t", iir::FieldType::ijk);
+  auto stencil = b.build(
+      "generated",
+      b.stencil(b.multistage(
+          iir::LoopOrderKind::Forward,
+          b.stage(b.doMethod(ast::Interval::Start, ast::Interval::End,
+                             b.stmt(b.assignExpr(b.at(tmp), b.at(in))))),
+          b.stage(b.doMethod(ast::Interval::Start, ast::Interval::End, 1, 0,
+                             b.stmt(b.assignExpr(b.at(out), b.at(tmp, {0, 0, -1}))))))));
+
+  codegen::Options options;
+  options.ReduceTmpDimensions = true;
+  options.DomainSizeI = 64;
+  options.DomainSizeK = 80;
+  auto tu = codegen::cxxopt::run({{stencil->getName(), stencil}}, options);
+  const std::string& code = tu->getStencils().at("generated");
+  auto contains = [&](const std::string& str) { return code.find(str) != std::string::npos; };
+
+  EXPECT_TRUE(contains("constexpr int iMin = gridtools::dawn::halo::value;"));
+  EXPECT_TRUE(contains("constexpr int iMax = 64 - gridtools::dawn::halo::value - 1;"));
+  EXPECT_TRUE(contains("int jMin = m_dom.jminus();"));
+  EXPECT_FALSE(contains("constexpr int jMin"));
+  EXPECT_TRUE(contains("constexpr int kMin = 0;"));
+  EXPECT_TRUE(contains("constexpr int kMax = 79;"));
+  // the column buffer has a constant size too
+  EXPECT_TRUE(contains("std::vector<::dawn::float_type> " + tmp.name + "_column(80 + 1);"));
+  EXPECT_TRUE(contains("assert(dom.isize() == 64 && dom.iminus() == gridtools::dawn::halo::value "
+                       "&& dom.iplus() == gridtools::dawn::halo::value);"));
+  EXPECT_TRUE(contains("assert(dom.ksize() == 80 && dom.kminus() == 0 && dom.kplus() == 0);"));
+}
+
+TEST(Opt, DomainSizeFusedStencils) {
+  using namespace dawn;
+  UIDGenerator::getInstance()->reset();
+
+  // mid = in, out = mid[i+1], split in two stencils
+  iir::CartesianIIRBuilder b;
+  auto in = b.field("in", iir::FieldType::ijk);
+  auto mid = b.field("mid", iir::FieldType::ijk);
+  auto out = b.field("out", iir::FieldType::ijk);
+  auto stencil = b.build(
+      "generated",
+      b.stencil(b.multistage(
+          iir::LoopOrderKind::Parallel,
+          b.stage(b.doMethod(ast::Interval::Start, ast::Interval::End,
+                             b.stmt(b.assignExpr(b.at(mid), b.at(in))))),
+          b.stage(b.doMethod(ast::Interval::Start, ast::Interval::End,
+                             b.stmt(b.assignExpr(b.at(out), b.at(mid, {1, 0, 0}))))))));
+
+  Options optimizerOptions;
+  optimizerOptions.SplitStencils = true;
+  PassStencilSplitter splitter(2);
+  splitter.run(stencil, optimizerOptions);
+  stencil->computeDerivedInfo();
+  ASSERT_EQ(stencil->getStencils().size(), 2);
+
+  codegen::Options options;
+  options.FusedStencilTileSize = 32;
+  options.DomainSizeI = 64;
+  options.DomainSizeJ = 48;
+  auto tu = codegen::cxxopt::run({{stencil->getName(), stencil}}, options);
+  const std::string& code = tu->getStencils().at("generated");
+  auto contains = [&](const std::string& str) { return code.find(str) != std::string::npos; };
+
+  // the tile loops and the tile bounds are clamped to the constant domain
+  EXPECT_TRUE(contains("for(int tileJ = gridtools::dawn::halo::value; tileJ <= 48 - "
+                       "gridtools::dawn::halo::value - 1; tileJ += 32)"));
+  EXPECT_TRUE(contains("for(int tileI = gridtools::dawn::halo::value; tileI <= 64 - "
+                       "gridtools::dawn::halo::value - 1; tileI += 32)"));
+  EXPECT_TRUE(contains("int iMin = std::max<int>(gridtools::dawn::halo::value, tileIMin - 0);"));
+  EXPECT_TRUE(contains(
+      "int iMax = std::min<int>(64 - gridtools::dawn::halo::value - 1, tileIMax + 1);"));
+  EXPECT_TRUE(contains(
+      "int jMax = std::min<int>(48 - gridtools::dawn::halo::value - 1, tileJMax + 0);"));
+  EXPECT_TRUE(contains("int kMin = m_dom.kminus();"));
+}
+
 } // namespace
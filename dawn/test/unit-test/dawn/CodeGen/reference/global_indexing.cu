@@ -139,8 +139,9 @@ public:
     computeGlobalOffsets(int rank, const gridtools::dawn::domain& dom, int xcols, int ycols) {
       unsigned int rankOnDefaultFace = rank % (xcols * ycols);
       unsigned int row = rankOnDefaultFace / xcols;
-      unsigned int col = rankOnDefaultFace % ycols;
-      return {col * (dom.isize() - dom.iplus()), row * (dom.jsize() - dom.jplus())};
+      unsigned int col = rankOnDefaultFace % xcols;
+      return {col * (dom.isize() - 2 * gridtools::dawn::halo::value),
+              row * (dom.jsize() - 2 * gridtools::dawn::halo::value)};
     }
 
     // Temporary storage typedefs
@@ -12,6 +12,9 @@
 //
 //===------------------------------------------------------------------------------------------===//
 
+#include "dawn/IIR/ASTExpr.h"
+#include "dawn/IIR/ASTStmt.h"
+#include "dawn/IIR/AccessComputation.h"
 #include "dawn/IIR/IIR.h"
 #include "dawn/IIR/StencilInstantiation.h"
 #include "dawn/Serialization/IIRSerializer.h"
@@ -105,4 +108,35 @@ TEST(TestComputeStageExtents, test_stencil_04) {
   EXPECT_EQ(stencil->getStage(2)->getExtents(), iir::Extents(ast::cartesian));
 }
 
+TEST(TestComputeStageExtents, test_stencil_04_modified) {
+  /*
+    vertical_region(k_start, k_end) {
+      mid = in;
+      mid2 = mid[i + 1];
+      out = mid2[j - 1];  ->  out = mid2[j - 2];
+    } */
+  auto instantiation = IIRSerializer::deserialize("input/compute_extent_test_stencil_04.iir");
+  const auto& stencils = instantiation->getIIR()->getChildren();
+  ASSERT_TRUE((stencils.size() == 1));
+  const std::unique_ptr<iir::Stencil>& stencil = stencils[0];
+  instantiation->computeDerivedInfo();
+
+  // Only the last stage changes, its producers are updated from the extents computed before
+  const std::unique_ptr<iir::Stage>& lastStage = stencil->getStage(2);
+  std::vector<std::shared_ptr<ast::Stmt>> stmts;
+  for(const auto& stmt : iterateIIROverStmt(*lastStage)) {
+    const auto& assign = std::static_pointer_cast<ast::AssignmentExpr>(
+        std::static_pointer_cast<ast::ExprStmt>(stmt)->getExpr());
+    std::static_pointer_cast<ast::FieldAccessExpr>(assign->getRight())
+        ->setPureOffset(ast::Offsets(ast::cartesian, 0, -2, 0));
+    stmts.push_back(stmt);
+  }
+  computeAccesses(instantiation->getMetaData(), stmts);
+  instantiation->computeDerivedInfo();
+
+  EXPECT_EQ(stencil->getStage(0)->getExtents(), iir::Extents(ast::cartesian, 0, 1, -2, 0, 0, 0));
+  EXPECT_EQ(stencil->getStage(1)->getExtents(), iir::Extents(ast::cartesian, 0, 0, -2, 0, 0, 0));
+  EXPECT_EQ(stencil->getStage(2)->getExtents(), iir::Extents(ast::cartesian));
+}
+
 } // anonymous namespace
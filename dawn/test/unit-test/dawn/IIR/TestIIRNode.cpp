@@ -28,13 +28,38 @@ class Node2;
 class Node3;
 class Node4;
 
+template <typename Node>
+int sumOfChildren(const Node& node);
+
 class Node1 : public iir::IIRNode<void, Node1, Node2> {
 public:
   static constexpr const char* name = "Node1";
+  int updates_ = 0;
+  int sum_ = 0;
+  int getSum() const {
+    ensureDerivedInfo();
+    return sum_;
+  }
+  void clearDerivedInfo() override { sum_ = 0; }
+  void updateFromChildren() override {
+    ++updates_;
+    sum_ = sumOfChildren(*this);
+  }
 };
 class Node2 : public iir::IIRNode<Node1, Node2, Node3> {
 public:
   static constexpr const char* name = "Node2";
+  int updates_ = 0;
+  int sum_ = 0;
+  int getSum() const {
+    ensureDerivedInfo();
+    return sum_;
+  }
+  void clearDerivedInfo() override { sum_ = 0; }
+  void updateFromChildren() override {
+    ++updates_;
+    sum_ = sumOfChildren(*this);
+  }
 };
 
 template <typename T>
@@ -43,14 +68,34 @@ using myList = std::list<T, std::allocator<T>>;
 class Node3 : public iir::IIRNode<Node2, Node3, Node4, myList> {
 public:
   static constexpr const char* name = "Node3";
+  int updates_ = 0;
+  int sum_ = 0;
+  int getSum() const {
+    ensureDerivedInfo();
+    return sum_;
+  }
+  void clearDerivedInfo() override { sum_ = 0; }
+  void updateFromChildren() override {
+    ++updates_;
+    sum_ = sumOfChildren(*this);
+  }
 };
 class Node4 : public iir::IIRNode<Node3, Node4, void> {
 public:
   static constexpr const char* name = "Node4";
   Node4(int val) : val_(val) {}
   Node4(Node4&& other) : val_(other.val_) {}
+  int getSum() const { return val_; }
   int val_;
 };
+
+template <typename Node>
+int sumOfChildren(const Node& node) {
+  int sum = 0;
+  for(const auto& child : node.getChildren())
+    sum += child->getSum();
+  return sum;
+}
 } // namespace impl
 
 namespace {
@@ -339,4 +384,84 @@ TEST_F(IIRNode, ReverseIterators) {
 }
 
 TEST_F(IIRNode, getChild) {}
+
+TEST_F(IIRNode, deferredUpdate) {
+  auto resetUpdates = [&]() {
+    root_->updates_ = 0;
+    for(const auto& n2 : root_->getChildren()) {
+      n2->updates_ = 0;
+      for(const auto& n3 : n2->getChildren())
+        n3->updates_ = 0;
+    }
+  };
+
+  // every leaf update recomputes all of its ancestors
+  resetUpdates();
+  for(const auto& n4 : iterateIIROver<impl::Node4>(*root_))
+    n4->update(iir::NodeUpdateType::levelAndTreeAbove);
+  EXPECT_EQ(root_->updates_, 12);
+  EXPECT_EQ(root_->getChildren()[0]->updates_, 6);
+
+  // within a deferred scope, each ancestor is recomputed once when the scope ends
+  resetUpdates();
+  {
+    iir::DeferredUpdateScope deferredUpdate;
+    for(const auto& n4 : iterateIIROver<impl::Node4>(*root_))
+      n4->update(iir::NodeUpdateType::levelAndTreeAbove);
+    EXPECT_EQ(root_->updates_, 0);
+    EXPECT_TRUE(root_->isDerivedInfoDirty());
+    EXPECT_TRUE(root_->getChildren()[1]->getChildren().back()->isDerivedInfoDirty());
+  }
+  EXPECT_FALSE(root_->isDerivedInfoDirty());
+  EXPECT_EQ(root_->updates_, 1);
+  for(const auto& n2 : root_->getChildren()) {
+    EXPECT_EQ(n2->updates_, 1);
+    for(const auto& n3 : n2->getChildren()) {
+      EXPECT_EQ(n3->updates_, 1);
+      EXPECT_FALSE(n3->isDerivedInfoDirty());
+    }
+  }
+}
+
+TEST_F(IIRNode, deferredUpdateRead) {
+  const auto& n2 = root_->getChildren()[0];
+  const auto& n3 = n2->getChildren()[0];
+  const auto& n4 = *n3->childrenBegin();
+  EXPECT_EQ(root_->getSum(), 126);
+
+  {
+    iir::DeferredUpdateScope deferredUpdate;
+    n4->val_ = 102;
+    n4->update(iir::NodeUpdateType::levelAndTreeAbove);
+    EXPECT_TRUE(root_->isDerivedInfoDirty());
+
+    // reading the derived info of a dirty node recomputes it and its dirty descendants
+    EXPECT_EQ(n2->getSum(), 133);
+    EXPECT_FALSE(n2->isDerivedInfoDirty());
+    EXPECT_FALSE(n3->isDerivedInfoDirty());
+    EXPECT_TRUE(root_->isDerivedInfoDirty());
+    EXPECT_EQ(root_->getSum(), 226);
+    EXPECT_FALSE(root_->isDerivedInfoDirty());
+
+    // recomputed nodes are marked dirty again by the next update
+    n4->val_ = 2;
+    n4->update(iir::NodeUpdateType::levelAndTreeAbove);
+    EXPECT_TRUE(n3->isDerivedInfoDirty());
+    EXPECT_TRUE(root_->isDerivedInfoDirty());
+
+    // a dirty tree destroyed before the end of the scope is not updated by the scope
+    auto other = std::make_unique<impl::Node1>();
+    other->insertChild(std::make_unique<impl::Node2>(), other);
+    other->getChildren()[0]->insertChild(std::make_unique<impl::Node3>());
+    const auto& otherN3 = *other->getChildren()[0]->childrenBegin();
+    otherN3->insertChild(std::make_unique<impl::Node4>(1));
+    (*otherN3->childrenBegin())->update(iir::NodeUpdateType::levelAndTreeAbove);
+    EXPECT_TRUE(other->isDerivedInfoDirty());
+    other.reset();
+  }
+  EXPECT_FALSE(root_->isDerivedInfoDirty());
+  EXPECT_EQ(n3->getSum(), 5);
+  EXPECT_EQ(root_->getSum(), 126);
+}
+
 } // namespace
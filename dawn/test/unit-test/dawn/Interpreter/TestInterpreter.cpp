@@ -0,0 +1,274 @@
+//===--------------------------------------------------------------------------------*- C++ -*-===//
+//                          _
+//                         | |
+//                       __| | __ ___      ___ ___
+//                      / _` |/ _` \ \ /\ / / '_  |
+//                     | (_| | (_| |\ V  V /| | | |
+//                      \__,_|\__,_| \_/\_/ |_| |_| - Compiler Toolchain
+//
+//
+//  This file is distributed under the MIT License (MIT).
+//  See LICENSE.txt for details.
+//
+//===------------------------------------------------------------------------------------------===//
+
+#include "dawn/Interpreter/Interpreter.h"
+#include "dawn/Support/Exception.h"
+#include "dawn/Unittest/IIRBuilder.h"
+
+#include <gtest/gtest.h>
+#include <vector>
+
+using namespace dawn;
+using interpreter::CartesianDomain;
+using interpreter::FieldView;
+using interpreter::Interpreter;
+using interpreter::UnstructuredMesh;
+using LocType = ast::LocationType;
+
+namespace {
+
+/// Contiguous (i,j,k) storage with `i` as the fastest dimension
+struct Storage {
+  std::array<int, 3> size;
+  std::vector<double> data;
+
+  explicit Storage(std::array<int, 3> s, double value = 0.0)
+      : size(s), data(s[0] * s[1] * s[2], value) {}
+
+  double& operator()(int i, int j, int k) { return data[i + size[0] * (j + size[1] * k)]; }
+  FieldView view() { return FieldView{data.data(), {1, size[0], size[0] * size[1]}}; }
+};
+
+TEST(TestInterpreter, Laplacian) {
+  UIDGenerator::getInstance()->reset();
+  iir::CartesianIIRBuilder b;
+  auto in = b.field("in", iir::FieldType::ijk);
+  auto out = b.field("out", iir::FieldType::ijk);
+
+  auto stencil = b.build(
+      "laplacian",
+      b.stencil(b.multistage(
+          iir::LoopOrderKind::Parallel,
+          b.stage(b.doMethod(
+              ast::Interval::Start, ast::Interval::End,
+              b.stmt(b.assignExpr(
+                  b.at(out),
+                  b.binaryExpr(
+                      b.binaryExpr(b.binaryExpr(b.at(in, {1, 0, 0}), b.at(in, {-1, 0, 0})),
+                                   b.binaryExpr(b.at(in, {0, 1, 0}), b.at(in, {0, -1, 0}))),
+                      b.binaryExpr(b.lit(4.0), b.at(in), iir::Op::multiply), iir::Op::minus))))))));
+
+  CartesianDomain dom{{11, 7, 3}, {1, 1, 0}, {1, 1, 0}};
+  Storage inS(dom.Size), outS(dom.Size, -1.0);
+  for(int k = 0; k < 3; ++k)
+    for(int j = 0; j < 7; ++j)
+      for(int i = 0; i < 11; ++i)
+        inS(i, j, k) = i * i + 2 * j * j + k;
+
+  // Use a block size which does not divide the domain
+  Interpreter interpreter(stencil, 4);
+  interpreter.run(dom, {{"in", inS.view()}, {"out", outS.view()}});
+
+  for(int k = 0; k < 3; ++k)
+    for(int j = 0; j < 7; ++j)
+      for(int i = 0; i < 11; ++i) {
+        bool inside = i >= 1 && i < 10 && j >= 1 && j < 6;
+        EXPECT_DOUBLE_EQ(outS(i, j, k), inside ? 6.0 : -1.0) << i << " " << j << " " << k;
+      }
+}
+
+TEST(TestInterpreter, VerticalSolver) {
+  UIDGenerator::getInstance()->reset();
+  iir::CartesianIIRBuilder b;
+  auto in = b.field("in", iir::FieldType::ijk);
+  auto out = b.field("out", iir::FieldType::ijk);
+
+  // out[k] = sum_{l <= k} in[l]
+  auto stencil = b.build(
+      "prefix_sum",
+      b.stencil(b.multistage(
+          iir::LoopOrderKind::Forward,
+          b.stage(b.doMethod(ast::Interval::Start, ast::Interval::Start,
+                             b.stmt(b.assignExpr(b.at(out), b.at(in)))),
+                  b.doMethod(ast::Interval::Start, ast::Interval::End, 1, 0,
+                             b.stmt(b.assignExpr(
+                                 b.at(out), b.binaryExpr(b.at(out, {0, 0, -1}), b.at(in)))))))));
+
+  CartesianDomain dom{{3, 2, 6}};
+  Storage inS(dom.Size), outS(dom.Size);
+  for(int k = 0; k < 6; ++k)
+    for(int j = 0; j < 2; ++j)
+      for(int i = 0; i < 3; ++i)
+        inS(i, j, k) = k + 1;
+
+  Interpreter(stencil).run(dom, {{"in", inS.view()}, {"out", outS.view()}});
+
+  for(int k = 0; k < 6; ++k)
+    EXPECT_DOUBLE_EQ(outS(2, 1, k), (k + 1) * (k + 2) / 2);
+}
+
+TEST(TestInterpreter, IfStmtAndTemporaries) {
+  UIDGenerator::getInstance()->reset();
+  iir::CartesianIIRBuilder b;
+  auto in = b.field("in", iir::FieldType::ijk);
+  auto out = b.field("out", iir::FieldType::ijk);
+  auto tmp = b.tmpField("tmp", iir::FieldType::ijk);
+  auto factor = b.localvar("factor", BuiltinTypeID::Double);
+
+  // tmp = |in|; out = 2 * tmp
+  auto stencil = b.build(
+      "abs",
+      b.stencil(b.multistage(
+          iir::LoopOrderKind::Parallel,
+          b.stage(b.doMethod(
+              ast::Interval::Start, ast::Interval::End,
+              b.ifStmt(b.binaryExpr(b.at(in), b.lit(0.0), iir::Op::greater),
+                       b.stmt(b.assignExpr(b.at(tmp, iir::AccessType::rw), b.at(in))),
+                       b.stmt(b.assignExpr(b.at(tmp, iir::AccessType::rw),
+                                           b.unaryExpr(b.at(in), iir::Op::minus)))))),
+          b.stage(b.doMethod(ast::Interval::Start, ast::Interval::End, b.declareVar(factor),
+                             b.stmt(b.assignExpr(b.at(factor), b.lit(2.0))),
+                             b.stmt(b.assignExpr(b.at(out, iir::AccessType::rw),
+                                                 b.binaryExpr(b.at(factor), b.at(tmp),
+                                                              iir::Op::multiply))))))));
+
+  CartesianDomain dom{{5, 4, 2}};
+  Storage inS(dom.Size), outS(dom.Size);
+  for(int k = 0; k < 2; ++k)
+    for(int j = 0; j < 4; ++j)
+      for(int i = 0; i < 5; ++i)
+        inS(i, j, k) = (i - 2) * (j + 1);
+
+  Interpreter(stencil, 3).run(dom, {{"in", inS.view()}, {"out", outS.view()}});
+
+  for(int k = 0; k < 2; ++k)
+    for(int j = 0; j < 4; ++j)
+      for(int i = 0; i < 5; ++i)
+        EXPECT_DOUBLE_EQ(outS(i, j, k), 2.0 * std::abs((i - 2) * (j + 1)));
+}
+
+TEST(TestInterpreter, MissingField) {
+  UIDGenerator::getInstance()->reset();
+  iir::CartesianIIRBuilder b;
+  auto in = b.field("in", iir::FieldType::ijk);
+  auto out = b.field("out", iir::FieldType::ijk);
+  auto stencil = b.build(
+      "copy", b.stencil(b.multistage(
+                  iir::LoopOrderKind::Parallel,
+                  b.stage(b.doMethod(ast::Interval::Start, ast::Interval::End,
+                                     b.stmt(b.assignExpr(b.at(out), b.at(in))))))));
+
+  CartesianDomain dom{{2, 2, 2}};
+  Storage inS(dom.Size);
+  EXPECT_THROW(Interpreter(stencil).run(dom, {{"in", inS.view()}}), LogicError);
+}
+
+TEST(TestInterpreter, HaloTooSmall) {
+  UIDGenerator::getInstance()->reset();
+  iir::CartesianIIRBuilder b;
+  auto in = b.field("in", iir::FieldType::ijk);
+  auto out = b.field("out", iir::FieldType::ijk);
+  auto tmp = b.tmpField("tmp", iir::FieldType::ijk);
+
+  // tmp is computed on the extent i+1 of the second stage, which reads in at i+2
+  auto stencil = b.build(
+      "shift",
+      b.stencil(b.multistage(
+          iir::LoopOrderKind::Parallel,
+          b.stage(b.doMethod(ast::Interval::Start, ast::Interval::End,
+                             b.stmt(b.assignExpr(b.at(tmp, iir::AccessType::rw),
+                                                 b.at(in, {1, 0, 0}))))),
+          b.stage(b.doMethod(ast::Interval::Start, ast::Interval::End,
+                             b.stmt(b.assignExpr(b.at(out, iir::AccessType::rw),
+                                                 b.at(tmp, {1, 0, 0}))))))));
+
+  CartesianDomain tooSmall{{6, 1, 1}, {0, 0, 0}, {1, 0, 0}};
+  Storage inS(tooSmall.Size), outS(tooSmall.Size);
+  EXPECT_THROW(Interpreter(stencil).run(tooSmall, {{"in", inS.view()}, {"out", outS.view()}}),
+               LogicError);
+
+  CartesianDomain dom{{6, 1, 1}, {0, 0, 0}, {2, 0, 0}};
+  for(int i = 0; i < 6; ++i)
+    inS(i, 0, 0) = i;
+  Interpreter(stencil).run(dom, {{"in", inS.view()}, {"out", outS.view()}});
+  for(int i = 0; i < 4; ++i)
+    EXPECT_DOUBLE_EQ(outS(i, 0, 0), i + 2);
+}
+
+/// Two cells sharing edge 1: cell 0 = {e0, e1}, cell 1 = {e1, e2}
+UnstructuredMesh makeTwoCellMesh() {
+  UnstructuredMesh mesh;
+  mesh.NumElements = {2, 3, 0};
+  mesh.Neighbors = [](const ast::UnstructuredIterationSpace& iterSpace, int element) {
+    EXPECT_EQ(iterSpace.Chain, (ast::NeighborChain{LocType::Cells, LocType::Edges}));
+    return element == 0 ? std::vector<int>{0, 1} : std::vector<int>{1, 2};
+  };
+  return mesh;
+}
+
+TEST(TestInterpreter, WeightedReduction) {
+  UIDGenerator::getInstance()->reset();
+  iir::UnstructuredIIRBuilder b;
+  auto edges = b.field("edges", LocType::Edges);
+  auto cells = b.field("cells", LocType::Cells);
+
+  auto stencil = b.build(
+      "reduction",
+      b.stencil(b.multistage(
+          iir::LoopOrderKind::Parallel,
+          b.stage(LocType::Cells,
+                  b.doMethod(ast::Interval::Start, ast::Interval::End,
+                             b.stmt(b.assignExpr(
+                                 b.at(cells),
+                                 b.reduceOverNeighborExpr(iir::Op::plus, b.at(edges), b.at(cells),
+                                                          {LocType::Cells, LocType::Edges},
+                                                          std::vector<double>{1.0, -2.0}))))))));
+
+  const int kSize = 2;
+  std::vector<double> edgeData = {1, 10, 100, 2, 20, 200}; // [k][edge]
+  std::vector<double> cellData = {5, 6, 7, 8};              // [k][cell]
+  Interpreter(stencil).run(makeTwoCellMesh(), kSize,
+                           {{"edges", FieldView{edgeData.data(), {1, 0, 3}}},
+                            {"cells", FieldView{cellData.data(), {1, 0, 2}}}});
+
+  EXPECT_DOUBLE_EQ(cellData[0], 5 + 1 - 2 * 10);
+  EXPECT_DOUBLE_EQ(cellData[1], 6 + 10 - 2 * 100);
+  EXPECT_DOUBLE_EQ(cellData[2], 7 + 2 - 2 * 20);
+  EXPECT_DOUBLE_EQ(cellData[3], 8 + 20 - 2 * 200);
+}
+
+TEST(TestInterpreter, SparseLoop) {
+  UIDGenerator::getInstance()->reset();
+  iir::UnstructuredIIRBuilder b;
+  auto edges = b.field("edges", LocType::Edges, false);
+  auto cells = b.field("cells", LocType::Cells, false);
+  auto sparse = b.field("sparse", {LocType::Cells, LocType::Edges}, false);
+
+  // sparse(c, e) = cells(c) * edges(e)
+  auto stencil = b.build(
+      "sparse",
+      b.stencil(b.multistage(
+          iir::LoopOrderKind::Parallel,
+          b.stage(LocType::Cells,
+                  b.doMethod(ast::Interval::Start, ast::Interval::End,
+                             b.loopStmtChain(
+                                 b.stmt(b.assignExpr(
+                                     b.at(sparse),
+                                     b.binaryExpr(b.at(cells),
+                                                  b.at(edges, iir::HOffsetType::withOffset, 0),
+                                                  iir::Op::multiply))),
+                                 {LocType::Cells, LocType::Edges}))))));
+
+  std::vector<double> edgeData = {1, 2, 3};
+  std::vector<double> cellData = {10, 100};
+  std::vector<double> sparseData(4, 0.0); // [cell][neighbor]
+  Interpreter(stencil).run(makeTwoCellMesh(), 1,
+                           {{"edges", FieldView{edgeData.data(), {1, 0, 0}}},
+                            {"cells", FieldView{cellData.data(), {1, 0, 0}}},
+                            {"sparse", FieldView{sparseData.data(), {2, 1, 0}}}});
+
+  EXPECT_EQ(sparseData, (std::vector<double>{10, 20, 200, 300}));
+}
+
+} // namespace
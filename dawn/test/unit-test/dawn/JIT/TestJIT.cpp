@@ -0,0 +1,116 @@
+//===--------------------------------------------------------------------------------*- C++ -*-===//
+//                          _
+//                         | |
+//                       __| | __ ___      ___ ___
+//                      / _` |/ _` \ \ /\ / / '_  |
+//                     | (_| | (_| |\ V  V /| | | |
+//                      \__,_|\__,_| \_/\_/ |_| |_| - Compiler Toolchain
+//
+//
+//  This file is distributed under the MIT License (MIT).
+//  See LICENSE.txt for details.
+//
+//===------------------------------------------------------------------------------------------===//
+
+#include "dawn/JIT/JIT.h"
+#include "dawn/Support/Exception.h"
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+using namespace dawn;
+
+namespace {
+
+const std::string axpy = R"(
+extern "C" void axpy(int n, double a, const double* x, double* y) {
+  for(int i = 0; i < n; ++i)
+    y[i] += a * x[i];
+}
+)";
+
+TEST(TestJIT, CompileAndCall) {
+  jit::JIT compiler;
+  auto module = compiler.compile(axpy);
+
+  double x[] = {1, 2, 3};
+  double y[] = {1, 1, 1};
+  module->getFunction<void(int, double, const double*, double*)>("axpy")(3, 2.0, x, y);
+  EXPECT_DOUBLE_EQ(y[0], 3.0);
+  EXPECT_DOUBLE_EQ(y[1], 5.0);
+  EXPECT_DOUBLE_EQ(y[2], 7.0);
+
+  EXPECT_THROW(module->getSymbolAddress("undefined"), LogicError);
+}
+
+TEST(TestJIT, InMemoryCache) {
+  jit::JIT compiler;
+  auto first = compiler.compile(axpy);
+  EXPECT_EQ(compiler.compile(axpy), first);
+  EXPECT_EQ(compiler.getNumCompiled(), 1);
+  EXPECT_NE(compiler.compile(axpy + "\n// other"), first);
+}
+
+TEST(TestJIT, FlagsArePartOfTheKey) {
+  jit::JIT compiler;
+  jit::Options options;
+  options.Defines.push_back("VALUE=2");
+  jit::JIT other(options);
+  EXPECT_NE(compiler.hash(axpy), other.hash(axpy));
+  EXPECT_EQ(compiler.hash(axpy), jit::JIT().hash(axpy));
+}
+
+TEST(TestJIT, HeadersArePartOfTheKey) {
+  jit::Options options;
+  options.IncludeDirs.push_back(testing::TempDir() + "dawn-jit-include");
+  std::filesystem::remove_all(options.IncludeDirs.front());
+  std::filesystem::create_directories(options.IncludeDirs.front());
+  const std::string header = options.IncludeDirs.front() + "/value.hpp";
+  const std::string code = "#include \"value.hpp\"\nextern \"C\" int value() { return VALUE; }";
+
+  std::ofstream(header) << "#define VALUE 1\n";
+  const std::uint64_t hash = jit::JIT(options).hash(code);
+  EXPECT_EQ(jit::JIT(options).hash(code), hash);
+
+  // An updated library must not be served from the disk cache of the old one
+  std::ofstream(header) << "#define VALUE 42\n";
+  jit::JIT compiler(options);
+  EXPECT_NE(compiler.hash(code), hash);
+  EXPECT_EQ(compiler.compile(code)->getFunction<int()>("value")(), 42);
+}
+
+TEST(TestJIT, DiskCache) {
+  jit::Options options;
+  options.CacheDir = testing::TempDir() + "dawn-jit-cache";
+  std::filesystem::remove_all(options.CacheDir);
+  const std::string code = "extern \"C\" int answer() { return 42; }";
+
+  std::uint64_t hash;
+  {
+    jit::JIT compiler(options);
+    hash = compiler.hash(code);
+    EXPECT_EQ(compiler.compile(code)->getFunction<int()>("answer")(), 42);
+    EXPECT_EQ(compiler.getNumCompiled(), 1);
+  }
+  // A new JIT (e.g in a new process) picks up the bitcode instead of compiling again
+  jit::JIT compiler(options);
+  auto module = compiler.compile(code);
+  EXPECT_EQ(compiler.getNumCompiled(), 0);
+  EXPECT_EQ(module->getHash(), hash);
+  EXPECT_EQ(module->getFunction<int()>("answer")(), 42);
+}
+
+TEST(TestJIT, CompileError) {
+  jit::JIT compiler;
+  try {
+    compiler.compile("extern \"C\" int broken() { return undeclared; }");
+    FAIL() << "expected a CompileError";
+  } catch(const CompileError& error) {
+    EXPECT_NE(error.getMessage().find("undeclared"), std::string::npos);
+  }
+}
+
+} // namespace
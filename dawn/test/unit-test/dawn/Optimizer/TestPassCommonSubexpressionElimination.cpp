@@ -0,0 +1,179 @@
+//===--------------------------------------------------------------------------------*- C++ -*-===//
+//                          _
+//                         | |
+//                       __| | __ ___      ___ ___
+//                      / _` |/ _` \ \ /\ / / '_  |
+//                     | (_| | (_| |\ V  V /| | | |
+//                      \__,_|\__,_| \_/\_/ |_| |_| - Compiler Toolchain
+//
+//
+//  This file is distributed under the MIT License (MIT).
+//  See LICENSE.txt for details.
+//
+//===------------------------------------------------------------------------------------------===//
+#include "dawn/AST/ASTStringifier.h"
+#include "dawn/IIR/DoMethod.h"
+#include "dawn/IIR/IIRNodeIterator.h"
+#include "dawn/Optimizer/PassCommonSubexpressionElimination.h"
+#include "dawn/Optimizer/PassLocalVarType.h"
+#include "dawn/Unittest/IIRBuilder.h"
+
+#include <gtest/gtest.h>
+
+using namespace dawn;
+
+namespace {
+
+const ast::BlockStmt::StatementList& getStatements(const iir::StencilInstantiation& stencil) {
+  return (*iterateIIROver<iir::DoMethod>(*stencil.getIIR()).begin())->getAST().getStatements();
+}
+
+TEST(TestPassCommonSubexpressionElimination, SameStatement) {
+  using namespace dawn::iir;
+
+  CartesianIIRBuilder b;
+  auto in = b.field("in", FieldType::ijk);
+  auto out = b.field("out", FieldType::ijk);
+
+  /// out = (in[i+1] - in) * (in[i+1] - in);
+  auto stencil = b.build(
+      "generated",
+      b.stencil(b.multistage(
+          LoopOrderKind::Parallel,
+          b.stage(b.doMethod(
+              ast::Interval::Start, ast::Interval::End,
+              b.stmt(b.assignExpr(
+                  b.at(out), b.binaryExpr(b.binaryExpr(b.at(in, {1, 0, 0}), b.at(in), Op::minus),
+                                          b.binaryExpr(b.at(in, {1, 0, 0}), b.at(in), Op::minus),
+                                          Op::multiply))))))));
+
+  PassCommonSubexpressionElimination pass;
+  pass.run(stencil);
+
+  const auto& stmts = getStatements(*stencil);
+  ASSERT_EQ(stmts.size(), 2);
+  const auto varDeclStmt = std::dynamic_pointer_cast<ast::VarDeclStmt>(stmts[0]);
+  ASSERT_TRUE(varDeclStmt);
+  const std::string& var = varDeclStmt->getName();
+  EXPECT_EQ(ast::ASTStringifier::toString(varDeclStmt->getInitList()[0], 0, false),
+            "(in[1,0,0] - in[<no_horizontal_offset>,0])");
+  EXPECT_EQ(ast::ASTStringifier::toString(stmts[1], 0, false),
+            "out[<no_horizontal_offset>,0] = (" + var + " * " + var + ");");
+
+  // The variable is a field in the horizontal
+  PassLocalVarType passLocalVarType;
+  passLocalVarType.run(stencil);
+  EXPECT_EQ(stencil->getMetaData()
+                .getLocalVariableDataFromAccessID(iir::getAccessID(varDeclStmt))
+                .getType(),
+            LocalVariableType::OnIJ);
+}
+
+TEST(TestPassCommonSubexpressionElimination, LargestFirst) {
+  using namespace dawn::iir;
+
+  CartesianIIRBuilder b;
+  auto in = b.field("in", FieldType::ijk);
+  auto coeff = b.field("coeff", FieldType::ijk);
+  auto out1 = b.field("out1", FieldType::ijk);
+  auto out2 = b.field("out2", FieldType::ijk);
+
+  /// out1 = (in[i+1] - in) * coeff;
+  /// out2 = (in[i+1] - in) * coeff + in;
+  auto diffTimesCoeff = [&]() {
+    return b.binaryExpr(b.binaryExpr(b.at(in, {1, 0, 0}), b.at(in), Op::minus), b.at(coeff),
+                        Op::multiply);
+  };
+  auto stencil = b.build(
+      "generated",
+      b.stencil(b.multistage(
+          LoopOrderKind::Parallel,
+          b.stage(b.doMethod(
+              ast::Interval::Start, ast::Interval::End,
+              b.stmt(b.assignExpr(b.at(out1), diffTimesCoeff())),
+              b.stmt(b.assignExpr(b.at(out2), b.binaryExpr(diffTimesCoeff(), b.at(in)))))))));
+
+  PassCommonSubexpressionElimination pass;
+  pass.run(stencil);
+
+  // Only the product is stored, its difference is no longer evaluated twice
+  const auto& stmts = getStatements(*stencil);
+  ASSERT_EQ(stmts.size(), 3);
+  const auto varDeclStmt = std::dynamic_pointer_cast<ast::VarDeclStmt>(stmts[0]);
+  ASSERT_TRUE(varDeclStmt);
+  const std::string& var = varDeclStmt->getName();
+  EXPECT_EQ(ast::ASTStringifier::toString(varDeclStmt->getInitList()[0], 0, false),
+            "((in[1,0,0] - in[<no_horizontal_offset>,0]) * coeff[<no_horizontal_offset>,0])");
+  EXPECT_EQ(ast::ASTStringifier::toString(stmts[1], 0, false),
+            "out1[<no_horizontal_offset>,0] = " + var + ";");
+  EXPECT_EQ(ast::ASTStringifier::toString(stmts[2], 0, false),
+            "out2[<no_horizontal_offset>,0] = (" + var + " + in[<no_horizontal_offset>,0]);");
+}
+
+TEST(TestPassCommonSubexpressionElimination, WriteInBetween) {
+  using namespace dawn::iir;
+
+  CartesianIIRBuilder b;
+  auto in = b.field("in", FieldType::ijk);
+  auto out1 = b.field("out1", FieldType::ijk);
+  auto out2 = b.field("out2", FieldType::ijk);
+
+  /// out1 = in[k+1] - in;
+  /// in = out1;
+  /// out2 = in[k+1] - in;
+  auto stencil = b.build(
+      "generated",
+      b.stencil(b.multistage(
+          LoopOrderKind::Forward,
+          b.stage(b.doMethod(
+              ast::Interval::Start, ast::Interval::End,
+              b.stmt(b.assignExpr(b.at(out1),
+                                  b.binaryExpr(b.at(in, {0, 0, 1}), b.at(in), Op::minus))),
+              b.stmt(b.assignExpr(b.at(in), b.at(out1))),
+              b.stmt(b.assignExpr(b.at(out2),
+                                  b.binaryExpr(b.at(in, {0, 0, 1}), b.at(in), Op::minus))))))));
+
+  PassCommonSubexpressionElimination pass;
+  pass.run(stencil);
+
+  const auto& stmts = getStatements(*stencil);
+  ASSERT_EQ(stmts.size(), 3);
+  for(const auto& stmt : stmts)
+    EXPECT_FALSE(isa<ast::VarDeclStmt>(stmt.get()));
+}
+
+TEST(TestPassCommonSubexpressionElimination, IntegerExpression) {
+  using namespace dawn::iir;
+
+  CartesianIIRBuilder b;
+  auto in = b.field("in", FieldType::ijk);
+  auto out1 = b.field("out1", FieldType::ijk);
+  auto out2 = b.field("out2", FieldType::ijk);
+
+  /// out1 = (in > 0.0) * 2;
+  /// out2 = (in > 0.0) * 2 + in;
+  auto positiveTimesTwo = [&]() {
+    return b.binaryExpr(b.binaryExpr(b.at(in), b.lit(0.0), Op::greater), b.lit(2), Op::multiply);
+  };
+  auto stencil = b.build(
+      "generated",
+      b.stencil(b.multistage(
+          LoopOrderKind::Parallel,
+          b.stage(b.doMethod(
+              ast::Interval::Start, ast::Interval::End,
+              b.stmt(b.assignExpr(b.at(out1), positiveTimesTwo())),
+              b.stmt(b.assignExpr(b.at(out2), b.binaryExpr(positiveTimesTwo(), b.at(in)))))))));
+
+  PassCommonSubexpressionElimination pass;
+  pass.run(stencil);
+
+  // The variable has the type of the expression, not the type of the fields
+  const auto& stmts = getStatements(*stencil);
+  ASSERT_EQ(stmts.size(), 3);
+  const auto varDeclStmt = std::dynamic_pointer_cast<ast::VarDeclStmt>(stmts[0]);
+  ASSERT_TRUE(varDeclStmt);
+  EXPECT_EQ(varDeclStmt->getType().getBuiltinTypeID(), BuiltinTypeID::Integer);
+  EXPECT_TRUE(varDeclStmt->getType().isConst());
+}
+
+} // namespace
@@ -0,0 +1,237 @@
+//===--------------------------------------------------------------------------------*- C++ -*-===//
+//                          _
+//                         | |
+//                       __| | __ ___      ___ ___
+//                      / _` |/ _` \ \ /\ / / '_  |
+//                     | (_| | (_| |\ V  V /| | | |
+//                      \__,_|\__,_| \_/\_/ |_| |_| - Compiler Toolchain
+//
+//
+//  This file is distributed under the MIT License (MIT).
+//  See LICENSE.txt for details.
+//
+//===------------------------------------------------------------------------------------------===//
+#include "dawn/AST/ASTStringifier.h"
+#include "dawn/IIR/DoMethod.h"
+#include "dawn/IIR/IIRNodeIterator.h"
+#include "dawn/IIR/MultiStage.h"
+#include "dawn/Optimizer/Driver.h"
+#include "dawn/Unittest/IIRBuilder.h"
+
+#include <gtest/gtest.h>
+
+using namespace dawn;
+
+namespace {
+
+const iir::DoMethod& getDoMethod(const iir::StencilInstantiation& stencil) {
+  return **iterateIIROver<iir::DoMethod>(*stencil.getIIR()).begin();
+}
+
+/// @brief Runs the pass group, which also cleans up after the folding
+std::shared_ptr<iir::StencilInstantiation>
+runConstantFolding(const std::shared_ptr<iir::StencilInstantiation>& stencil) {
+  return run({{stencil->getName(), stencil}}, {PassGroup::ConstantFolding}).at(stencil->getName());
+}
+
+std::string toString(const std::shared_ptr<ast::Stmt>& stmt) {
+  return ast::ASTStringifier::toString(stmt, 0, false);
+}
+
+TEST(TestPassConstantFolding, ConstexprGlobals) {
+  using namespace dawn::iir;
+
+  CartesianIIRBuilder b;
+  auto in = b.field("in", FieldType::ijk);
+  auto out = b.field("out", FieldType::ijk);
+  auto dt = b.globalvar("dt", 2.0, /*isConstexpr=*/true);
+  auto scale = b.globalvar("scale", 3.0);
+
+  /// out = in * (dt * 0.5) + scale;
+  auto stencil = b.build(
+      "generated",
+      b.stencil(b.multistage(
+          LoopOrderKind::Parallel,
+          b.stage(b.doMethod(
+              ast::Interval::Start, ast::Interval::End,
+              b.stmt(b.assignExpr(
+                  b.at(out),
+                  b.binaryExpr(
+                      b.binaryExpr(b.at(in), b.binaryExpr(b.at(dt), b.lit(0.5), Op::multiply),
+                                   Op::multiply),
+                      b.at(scale), Op::plus))))))));
+
+  stencil = runConstantFolding(stencil);
+
+  const auto& stmts = getDoMethod(*stencil).getAST().getStatements();
+  ASSERT_EQ(stmts.size(), 1);
+  EXPECT_EQ(toString(stmts[0]), "out[<no_horizontal_offset>,0] = ((in[<no_horizontal_offset>,0] * "
+                                "double_type 1.0) + scale);");
+
+  // Only the global which can be changed at runtime is still read
+  const auto& accesses = *stmts[0]->getData<iir::IIRStmtData>().CallerAccesses;
+  EXPECT_FALSE(accesses.hasReadAccess(dt.id));
+  EXPECT_TRUE(accesses.hasReadAccess(scale.id));
+}
+
+TEST(TestPassConstantFolding, ConstantBranches) {
+  using namespace dawn::iir;
+
+  CartesianIIRBuilder b;
+  auto in = b.field("in", FieldType::ijk);
+  auto out = b.field("out", FieldType::ijk);
+  auto useUpwind = b.globalvar("useUpwind", false, /*isConstexpr=*/true);
+  auto varA = b.localvar("varA", BuiltinTypeID::Double, {b.lit(1.0)});
+
+  /// if(useUpwind) { double varA = 1.0; out = varA; } else { out = in; }
+  /// out = useUpwind ? in[i-1] : in[i+1];
+  auto stencil = b.build(
+      "generated",
+      b.stencil(b.multistage(
+          LoopOrderKind::Parallel,
+          b.stage(b.doMethod(
+              ast::Interval::Start, ast::Interval::End,
+              b.ifStmt(b.at(useUpwind),
+                       b.block(b.declareVar(varA), b.stmt(b.assignExpr(b.at(out), b.at(varA)))),
+                       b.block(b.stmt(b.assignExpr(b.at(out), b.at(in))))),
+              b.stmt(b.assignExpr(b.at(out), b.conditionalExpr(b.at(useUpwind),
+                                                                b.at(in, {-1, 0, 0}),
+                                                                b.at(in, {1, 0, 0})))))))));
+
+  stencil = runConstantFolding(stencil);
+
+  // The else branch is inlined, the variable of the removed branch is gone
+  const auto& stmts = getDoMethod(*stencil).getAST().getStatements();
+  ASSERT_EQ(stmts.size(), 2);
+  EXPECT_EQ(toString(stmts[0]), "out[<no_horizontal_offset>,0] = in[<no_horizontal_offset>,0];");
+  EXPECT_EQ(toString(stmts[1]), "out[<no_horizontal_offset>,0] = in[1,0,0];");
+  EXPECT_FALSE(stencil->getMetaData().getAccessIDToLocalVariableDataMap().count(varA.id));
+}
+
+TEST(TestPassConstantFolding, LiteralsOnly) {
+  using namespace dawn::iir;
+
+  CartesianIIRBuilder b;
+  auto out = b.field("out", FieldType::ijk);
+  auto outInt = b.field("outInt", FieldType::ijk);
+
+  auto sqrt = std::make_shared<ast::FunCallExpr>("math::sqrt");
+  sqrt->getArguments().push_back(b.lit(4.0));
+
+  /// out = math::sqrt(4.0) - 1.0;
+  /// outInt = 7 / 2;
+  /// outInt = 1 / 0;
+  auto stencil = b.build(
+      "generated",
+      b.stencil(b.multistage(
+          LoopOrderKind::Parallel,
+          b.stage(b.doMethod(
+              ast::Interval::Start, ast::Interval::End,
+              b.stmt(b.assignExpr(b.at(out), b.binaryExpr(sqrt, b.lit(1.0), Op::minus))),
+              b.stmt(b.assignExpr(b.at(outInt), b.binaryExpr(b.lit(7), b.lit(2), Op::divide))),
+              b.stmt(b.assignExpr(b.at(outInt),
+                                  b.binaryExpr(b.lit(1), b.lit(0), Op::divide))))))));
+
+  stencil = runConstantFolding(stencil);
+
+  const auto& stmts = getDoMethod(*stencil).getAST().getStatements();
+  ASSERT_EQ(stmts.size(), 3);
+  EXPECT_EQ(toString(stmts[0]), "out[<no_horizontal_offset>,0] = double_type 1.0;");
+  EXPECT_EQ(toString(stmts[1]), "outInt[<no_horizontal_offset>,0] = int_type 3;");
+  // Dividing by zero is left to the runtime
+  EXPECT_EQ(toString(stmts[2]),
+            "outInt[<no_horizontal_offset>,0] = (int_type 1 / int_type 0);");
+}
+
+TEST(TestPassConstantFolding, FloatingPointPrecision) {
+  using namespace dawn::iir;
+
+  CartesianIIRBuilder b;
+  auto out = b.field("out", FieldType::ijk);
+  auto outExact = b.field("outExact", FieldType::ijk);
+
+  /// out = 0.1 * 0.1;
+  /// outExact = 0.5 * 3.0;
+  auto stencil = b.build(
+      "generated",
+      b.stencil(b.multistage(
+          LoopOrderKind::Parallel,
+          b.stage(b.doMethod(
+              ast::Interval::Start, ast::Interval::End,
+              b.stmt(b.assignExpr(b.at(out), b.binaryExpr(b.lit(0.1), b.lit(0.1), Op::multiply))),
+              b.stmt(b.assignExpr(b.at(outExact),
+                                  b.binaryExpr(b.lit(0.5), b.lit(3.0), Op::multiply))))))));
+
+  stencil = runConstantFolding(stencil);
+
+  // The generated code can be compiled in single precision, where 0.1 * 0.1 rounds differently
+  const auto& stmts = getDoMethod(*stencil).getAST().getStatements();
+  ASSERT_EQ(stmts.size(), 2);
+  EXPECT_EQ(toString(stmts[0]),
+            "out[<no_horizontal_offset>,0] = (double_type 0.100000 * double_type 0.100000);");
+  EXPECT_EQ(toString(stmts[1]), "outExact[<no_horizontal_offset>,0] = double_type 1.5;");
+}
+
+TEST(TestPassConstantFolding, EmptyDoMethods) {
+  using namespace dawn::iir;
+
+  CartesianIIRBuilder b;
+  auto in = b.field("in", FieldType::ijk);
+  auto out = b.field("out", FieldType::ijk);
+  auto useUpwind = b.globalvar("useUpwind", false, /*isConstexpr=*/true);
+
+  /// if(useUpwind) { out = in[i-1]; }
+  /// out += in;
+  auto stencil = b.build(
+      "generated",
+      b.stencil(b.multistage(
+          LoopOrderKind::Parallel,
+          b.stage(b.doMethod(ast::Interval::Start, ast::Interval::End,
+                             b.ifStmt(b.at(useUpwind),
+                                      b.block(b.stmt(
+                                          b.assignExpr(b.at(out), b.at(in, {-1, 0, 0}))))))),
+          b.stage(b.doMethod(ast::Interval::Start, ast::Interval::End,
+                             b.stmt(b.assignExpr(b.at(out), b.at(in), Op::plus)))))));
+
+  stencil = runConstantFolding(stencil);
+
+  // The compound assignment makes PassRemoveScalars skip, the empty stage is removed nevertheless
+  const auto& multiStage = **iterateIIROver<iir::MultiStage>(*stencil->getIIR()).begin();
+  ASSERT_EQ(multiStage.getChildren().size(), 1);
+  const auto& stmts = getDoMethod(*stencil).getAST().getStatements();
+  ASSERT_EQ(stmts.size(), 1);
+  EXPECT_EQ(toString(stmts[0]),
+            "out[<no_horizontal_offset>,0] += in[<no_horizontal_offset>,0];");
+}
+
+TEST(TestPassConstantFolding, EmptyStencil) {
+  using namespace dawn::iir;
+
+  CartesianIIRBuilder b;
+  auto in = b.field("in", FieldType::ijk);
+  auto out = b.field("out", FieldType::ijk);
+  auto useUpwind = b.globalvar("useUpwind", false, /*isConstexpr=*/true);
+
+  /// if(useUpwind) { out = in[i-1]; }
+  /// (next multi-stage) if(useUpwind) { out = in[i+1]; }
+  auto upwind = [&](int offset) {
+    return b.stage(b.doMethod(
+        ast::Interval::Start, ast::Interval::End,
+        b.ifStmt(b.at(useUpwind),
+                 b.block(b.stmt(b.assignExpr(b.at(out), b.at(in, {offset, 0, 0})))))));
+  };
+  auto stencil = b.build("generated",
+                         b.stencil(b.multistage(LoopOrderKind::Parallel, upwind(-1)),
+                                   b.multistage(LoopOrderKind::Parallel, upwind(1))));
+  ASSERT_EQ(stencil->getIIR()->getControlFlowDescriptor().getStatements().size(), 1);
+
+  stencil = runConstantFolding(stencil);
+
+  // Neither the multi-stages nor the stencil and its call are left
+  EXPECT_TRUE(stencil->getIIR()->childrenEmpty());
+  EXPECT_TRUE(stencil->getIIR()->getControlFlowDescriptor().getStatements().empty());
+  const iir::StencilMetaInformation& metadata = stencil->getMetaData();
+  EXPECT_TRUE(metadata.getStencilIDToStencilCallMap().empty());
+}
+
+} // namespace
@@ -0,0 +1,97 @@
+//===--------------------------------------------------------------------------------*- C++ -*-===//
+//                          _
+//                         | |
+//                       __| | __ ___      ___ ___
+//                      / _` |/ _` \ \ /\ / / '_  |
+//                     | (_| | (_| |\ V  V /| | | |
+//                      \__,_|\__,_| \_/\_/ |_| |_| - Compiler Toolchain
+//
+//
+//  This file is distributed under the MIT License (MIT).
+//  See LICENSE.txt for details.
+//
+//===------------------------------------------------------------------------------------------===//
+#include "dawn/IIR/DoMethod.h"
+#include "dawn/IIR/IIRNodeIterator.h"
+#include "dawn/IIR/StencilInstantiation.h"
+#include "dawn/Optimizer/ReadBeforeWriteConflict.h"
+#include "dawn/Unittest/IIRBuilder.h"
+
+#include <gtest/gtest.h>
+#include <memory>
+
+using namespace dawn;
+
+namespace {
+
+class TestReadBeforeWriteConflict : public ::testing::Test {
+protected:
+  void SetUp() override {
+    UIDGenerator::getInstance()->reset();
+
+    // tmp = in; out = tmp[k-1]; out = tmp[k+1]; out2 = tmp[i+1]
+    iir::CartesianIIRBuilder b;
+    auto in = b.field("in", iir::FieldType::ijk);
+    auto out = b.field("out", iir::FieldType::ijk);
+    auto out2 = b.field("out2", iir::FieldType::ijk);
+    auto tmp = b.tmpField("tmp", iir::FieldType::ijk);
+    instantiation_ = b.build(
+        "generated",
+        b.stencil(b.multistage(
+            iir::LoopOrderKind::Forward,
+            b.stage(b.doMethod(ast::Interval::Start, ast::Interval::End,
+                               b.stmt(b.assignExpr(b.at(tmp), b.at(in))),
+                               b.stmt(b.assignExpr(b.at(out), b.at(tmp, {0, 0, -1}))),
+                               b.stmt(b.assignExpr(b.at(out), b.at(tmp, {0, 0, 1}))),
+                               b.stmt(b.assignExpr(b.at(out2), b.at(tmp, {1, 0, 0}))))))));
+  }
+
+  const ast::BlockStmt::StatementList& getStatements() const {
+    const auto& doMethod = *iterateIIROver<iir::DoMethod>(*instantiation_->getIIR()).begin();
+    return doMethod->getAST().getStatements();
+  }
+
+  /// @brief Insert the statements in the given order and compare the tracked conflicts to the
+  /// ones of the full checks after each insertion
+  void checkInsertion(const std::vector<int>& order, iir::LoopOrderKind loopOrder) {
+    ReadBeforeWriteConflictTracker tracker(instantiation_->getMetaData(), loopOrder);
+    for(int stmtIndex : order) {
+      tracker.insertStatement(getStatements()[stmtIndex]);
+
+      auto expected = hasVerticalReadBeforeWriteConflict(tracker.getGraph(), loopOrder);
+      auto conflict = tracker.getVerticalConflict();
+      EXPECT_EQ(conflict.LoopOrderConflict, expected.LoopOrderConflict);
+      EXPECT_EQ(conflict.CounterLoopOrderConflict, expected.CounterLoopOrderConflict);
+      EXPECT_EQ(tracker.hasHorizontalConflict(),
+                hasHorizontalReadBeforeWriteConflict(tracker.getGraph()));
+    }
+  }
+
+  std::shared_ptr<iir::StencilInstantiation> instantiation_;
+};
+
+TEST_F(TestReadBeforeWriteConflict, BottomToTop) {
+  checkInsertion({3, 2, 1, 0}, iir::LoopOrderKind::Forward);
+  checkInsertion({3, 2, 1, 0}, iir::LoopOrderKind::Backward);
+  checkInsertion({3, 2, 1, 0}, iir::LoopOrderKind::Parallel);
+}
+
+TEST_F(TestReadBeforeWriteConflict, TopToBottom) {
+  checkInsertion({0, 1, 2, 3}, iir::LoopOrderKind::Forward);
+  checkInsertion({0, 1, 2, 3}, iir::LoopOrderKind::Backward);
+}
+
+TEST_F(TestReadBeforeWriteConflict, Clear) {
+  ReadBeforeWriteConflictTracker tracker(instantiation_->getMetaData());
+  tracker.insertStatement(getStatements()[3]);
+  tracker.insertStatement(getStatements()[0]);
+  EXPECT_TRUE(tracker.hasHorizontalConflict());
+
+  tracker.clear();
+  EXPECT_TRUE(tracker.getGraph().empty());
+  tracker.insertStatement(getStatements()[3]);
+  EXPECT_FALSE(tracker.hasHorizontalConflict());
+  EXPECT_FALSE(tracker.getVerticalConflict().LoopOrderConflict);
+}
+
+} // namespace
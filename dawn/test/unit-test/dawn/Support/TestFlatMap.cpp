@@ -0,0 +1,74 @@
+//===--------------------------------------------------------------------------------*- C++ -*-===//
+//                          _
+//                         | |
+//                       __| | __ ___      ___ ___
+//                      / _` |/ _` \ \ /\ / / '_  |
+//                     | (_| | (_| |\ V  V /| | | |
+//                      \__,_|\__,_| \_/\_/ |_| |_| - Compiler Toolchain
+//
+//
+//  This file is distributed under the MIT License (MIT).
+//  See LICENSE.txt for details.
+//
+//===------------------------------------------------------------------------------------------===//
+
+#include "dawn/Support/FlatMap.h"
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace dawn {
+
+TEST(FlatMap, SortedIteration) {
+  FlatMap<int, std::string> map{{5, "e"}, {1, "a"}, {3, "c"}};
+  map.emplace(2, "b");
+  map[4] = "d";
+
+  std::vector<int> keys;
+  std::string values;
+  for(const auto& [key, value] : map) {
+    keys.push_back(key);
+    values += value;
+  }
+  ASSERT_EQ(keys, (std::vector<int>{1, 2, 3, 4, 5}));
+  ASSERT_EQ(values, "abcde");
+}
+
+TEST(FlatMap, Insert) {
+  FlatMap<int, std::string> map;
+  ASSERT_TRUE(map.insert({1, "a"}).second);
+  ASSERT_FALSE(map.insert({1, "b"}).second);
+  ASSERT_FALSE(map.try_emplace(1, "c").second);
+  ASSERT_EQ(map.at(1), "a");
+  ASSERT_EQ(map.size(), 1);
+}
+
+TEST(FlatMap, Lookup) {
+  FlatMap<int, int> map{{2, 20}, {4, 40}};
+  ASSERT_EQ(map.count(2), 1);
+  ASSERT_EQ(map.count(3), 0);
+  ASSERT_EQ(map.find(4)->second, 40);
+  ASSERT_TRUE(map.find(1) == map.end());
+  ASSERT_TRUE(map.find(5) == map.end());
+  ASSERT_THROW(map.at(3), std::out_of_range);
+}
+
+TEST(FlatMap, Erase) {
+  FlatMap<int, int> map{{1, 10}, {2, 20}, {3, 30}};
+  ASSERT_EQ(map.erase(2), 1);
+  ASSERT_EQ(map.erase(2), 0);
+  auto it = map.erase(map.find(1));
+  ASSERT_EQ(it->first, 3);
+  ASSERT_EQ(map.size(), 1);
+}
+
+TEST(FlatMap, Equality) {
+  FlatMap<int, int> map1{{1, 10}, {2, 20}};
+  FlatMap<int, int> map2{{2, 20}, {1, 10}};
+  ASSERT_TRUE(map1 == map2);
+  map2[2] = 21;
+  ASSERT_TRUE(map1 != map2);
+}
+
+} // namespace dawn
@@ -16,6 +16,7 @@
 #include <algorithm>
 #include <gtest/gtest.h>
 #include <sstream>
+#include <thread>
 
 using namespace dawn;
 
@@ -139,4 +140,21 @@ TEST(Logger, iterate) {
   EXPECT_EQ(iter->size(), 15);
 }
 
+TEST(Logger, per_thread_messages) {
+  std::ostringstream buffer;
+  Logger log(makeMessageFormatter(), makeDiagnosticFormatter(), buffer, false);
+  log("TestLogger.cpp", 42) << "A message";
+
+  // Another thread (e.g. a concurrent compilation) neither sees nor clears the messages of this one
+  std::thread other([&log] {
+    EXPECT_EQ(log.size(), 0);
+    log("TestLogger.cpp", 42) << "Another message";
+    EXPECT_EQ(log.size(), 1);
+    log.clear();
+  });
+  other.join();
+
+  EXPECT_EQ(log.size(), 1);
+}
+
 } // namespace
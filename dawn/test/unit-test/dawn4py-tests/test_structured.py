@@ -14,6 +14,7 @@
 
 import io
 
+import numpy as np
 import pytest
 
 import dawn4py
@@ -60,3 +61,64 @@ def test_compilation(grid_sir_with_reference_code):
             backend=backend,
         )
         # TODO There was not test here...
+
+
+def test_precompiled_header_is_absolute(tmp_path, monkeypatch):
+    monkeypatch.chdir(tmp_path)
+    options = dawn4py.CodeGenOptions(precompiled_header="preamble.hpp")
+    assert options.precompiled_header == str(tmp_path / "preamble.hpp")
+    options.precompiled_header = "other.hpp"
+    assert options.precompiled_header == str(tmp_path / "other.hpp")
+    assert dawn4py.CodeGenOptions().precompiled_header == ""
+
+
+def _copy_stencil_interpreter():
+    iir_map = dawn4py._dawn4py.run_optimizer_sir(
+        dawn4py.serialization.to_bytes(utils.make_copy_stencil_sir()),
+        dawn4py.SIRSerializerFormat.Byte,
+        [],
+        dawn4py.OptimizerOptions(),
+    )
+    (iir,) = iir_map.values()
+    return dawn4py.Interpreter(iir, dawn4py.IIRSerializerFormat.Json)
+
+
+def test_interpreter_in_place():
+    interpreter = _copy_stencil_interpreter()
+    shape = (6, 5, 4)
+    field_in = np.random.rand(*shape)
+    # non-contiguous views are written through their strides
+    field_out = np.zeros((6, 10, 4))[:, ::2, :]
+    interpreter.run_cartesian({"in": field_in, "out": field_out}, size=shape, plus=[1, 0, 0])
+    np.testing.assert_array_equal(field_out[:-1], field_in[1:])
+
+
+def test_interpreter_rejects_copies():
+    interpreter = _copy_stencil_interpreter()
+    shape = (6, 5, 4)
+    field_in = np.random.rand(*shape)
+    # arrays which would be converted to a temporary copy, losing the results
+    with pytest.raises(TypeError):
+        interpreter.run_cartesian(
+            {"in": field_in, "out": np.zeros(shape, dtype=np.float32)}, size=shape
+        )
+    with pytest.raises(TypeError):
+        interpreter.run_cartesian({"in": field_in, "out": np.zeros(shape).tolist()}, size=shape)
+    read_only = np.zeros(shape)
+    read_only.flags.writeable = False
+    with pytest.raises(ValueError):
+        interpreter.run_cartesian({"in": field_in, "out": read_only}, size=shape)
+
+
+def test_interpreter_rejects_small_arrays():
+    interpreter = _copy_stencil_interpreter()
+    shape = (6, 5, 4)
+    field_in = np.random.rand(*shape)
+    # the stencil would access the arrays out of bounds
+    with pytest.raises(ValueError):
+        interpreter.run_cartesian({"in": field_in, "out": np.zeros((6, 5, 3))}, size=shape)
+    with pytest.raises(ValueError):
+        interpreter.run_cartesian({"in": field_in, "out": np.zeros((6, 5))}, size=shape)
+    # the stencil reads "in" at i+1, outside of a domain without halo
+    with pytest.raises(dawn4py._dawn4py.LogicError):
+        interpreter.run_cartesian({"in": field_in, "out": np.zeros(shape)}, size=shape)
@@ -0,0 +1,111 @@
+//===--------------------------------------------------------------------------------*- C++ -*-===//
+//                          _
+//                         | |
+//                       __| | __ ___      ___ ___
+//                      / _` |/ _` \ \ /\ / / '_  |
+//                     | (_| | (_| |\ V  V /| | | |
+//                      \__,_|\__,_| \_/\_/ |_| |_| - Compiler Toolchain
+//
+//
+//  This file is distributed under the MIT License (MIT).
+//  See LICENSE.txt for details.
+//
+//===------------------------------------------------------------------------------------------===//
+
+#include "driver-includes/benchmark.hpp"
+
+#include <gtest/gtest.h>
+
+#include <condition_variable>
+#include <limits>
+#include <mutex>
+#include <sstream>
+#include <thread>
+
+namespace {
+
+using namespace dawn::driver;
+
+TEST(driver_includes_benchmark, Statistics) {
+  benchmark_result result;
+  result.times = {4, 1, 3, 2, 5};
+  EXPECT_DOUBLE_EQ(result.min(), 1);
+  EXPECT_DOUBLE_EQ(result.max(), 5);
+  EXPECT_DOUBLE_EQ(result.mean(), 3);
+  EXPECT_DOUBLE_EQ(result.median(), 3);
+  EXPECT_DOUBLE_EQ(result.percentile(10), 1.4);
+  EXPECT_DOUBLE_EQ(result.percentile(90), 4.6);
+
+  result.bytes = 6000000000;
+  EXPECT_DOUBLE_EQ(result.bandwidth(), 2);
+}
+
+TEST(driver_includes_benchmark, Footprint) {
+  // 2D field read with a halo of 1 in i and j
+  const int undefined = std::numeric_limits<int>::min();
+  cartesian_extent extent = {-1, 1, -1, 1, undefined, std::numeric_limits<int>::max()};
+  field_footprint in = cartesian_footprint("in", {{10, 20, 1}}, extent, 8, true, false);
+  EXPECT_EQ(in.elements, 12 * 22);
+  EXPECT_EQ(in.bytes(), 12 * 22 * 8);
+
+  field_footprint sparse = unstructured_footprint("sparse", 100, 5, 3, 8, true, true);
+  EXPECT_EQ(sparse.bytes(), 100 * 5 * 3 * 8 * 2);
+}
+
+TEST(driver_includes_benchmark, Run) {
+  int calls = 0;
+  benchmark_options options;
+  options.warmup = 2;
+  options.repetitions = 5;
+  benchmark_result result = run_benchmark(
+      "count", [&] { ++calls; }, {field_footprint{"f", 10, 8, true, true}}, 0, options);
+
+  EXPECT_EQ(calls, 7);
+  EXPECT_EQ(result.times.size(), 5);
+  EXPECT_EQ(result.bytes, 160);
+
+  std::ostringstream json;
+  write_json(json, {result});
+  EXPECT_EQ(json.str().find("{\"benchmarks\": [\n  {\"name\": \"count\", \"repetitions\": 5"), 0);
+  EXPECT_NE(json.str().find("\"bandwidth_gb_s\""), std::string::npos);
+}
+
+TEST(driver_includes_benchmark, CountersCoverAllThreads) {
+  // a worker started before the counters, like the OpenMP pool started by the warmup runs
+  std::mutex mutex;
+  std::condition_variable cv;
+  bool done = false;
+  std::thread worker([&] {
+    std::unique_lock<std::mutex> lock(mutex);
+    cv.wait(lock, [&] { return done; });
+  });
+
+  perf_counters counters;
+  if(counters.available())
+    EXPECT_GE(counters.threads(), 2);
+  else
+    EXPECT_EQ(counters.threads(), 0);
+
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    done = true;
+  }
+  cv.notify_one();
+  worker.join();
+}
+
+TEST(driver_includes_benchmark, CountersOnlyOnRequest) {
+  benchmark_options options;
+  options.warmup = 0;
+  options.repetitions = 2;
+  options.counters = false;
+  benchmark_result result = run_benchmark("noop", [] {}, {}, 0, options);
+  EXPECT_TRUE(result.counters.empty());
+  EXPECT_EQ(result.counter_threads, 0);
+
+  std::ostringstream json;
+  result.to_json(json);
+  EXPECT_EQ(json.str().find("counter_threads"), std::string::npos);
+}
+
+} // namespace
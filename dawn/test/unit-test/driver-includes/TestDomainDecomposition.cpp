@@ -0,0 +1,180 @@
+//===--------------------------------------------------------------------------------*- C++ -*-===//
+//                          _
+//                         | |
+//                       __| | __ ___      ___ ___
+//                      / _` |/ _` \ \ /\ / / '_  |
+//                     | (_| | (_| |\ V  V /| | | |
+//                      \__,_|\__,_| \_/\_/ |_| |_| - Compiler Toolchain
+//
+//
+//  This file is distributed under the MIT License (MIT).
+//  See LICENSE.txt for details.
+//
+//===------------------------------------------------------------------------------------------===//
+
+
+#include "driver-includes/domain_decomposition.hpp"
+
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+using namespace dawn::driver;
+
+// field of a rank, indexed like the storages of the generated code
+struct field {
+  explicit field(const gridtools::dawn::domain& dom)
+      : isize(dom.isize()), jsize(dom.jsize()),
+        data(dom.isize() * dom.jsize() * dom.ksize(), -1) {}
+  double& operator()(int i, int j, int k) { return data[(k * jsize + j) * isize + i]; }
+
+  int isize;
+  int jsize;
+  std::vector<double> data;
+};
+
+const int h = cartesian_decomposition::halo();
+
+double value(int gi, int gj, int k) { return 10000 * k + 100 * gi + gj; }
+
+// values of the compute domain from the global indices of the compute points (starting at 0)
+void fill(const cartesian_decomposition& decomposition, int rank, field& f) {
+  const auto size = decomposition.local_size();
+  const auto offset = decomposition.global_offset(rank);
+  for(int k = 0; k < int(size[2]); ++k)
+    for(int j = h; j < h + int(size[1]); ++j)
+      for(int i = h; i < h + int(size[0]); ++i)
+        f(i, j, k) = value(offset[0] + i - h, offset[1] + j - h, k);
+}
+
+TEST(driver_includes_domain_decomposition, Decomposition) {
+  cartesian_decomposition decomposition({{12, 8, 4}}, 3, 2);
+  EXPECT_EQ(decomposition.ranks(), 6);
+  EXPECT_EQ(decomposition.local_size(), (std::array<unsigned int, 3>{{4, 4, 4}}));
+  EXPECT_EQ(decomposition.global_offset(5), (std::array<unsigned int, 2>{{8, 4}}));
+  EXPECT_EQ(decomposition.neighbor(4, 1, 0), 5);
+  EXPECT_EQ(decomposition.neighbor(4, -1, -1), 0);
+  EXPECT_EQ(decomposition.neighbor(5, 1, 0), -1);
+  EXPECT_EQ(cartesian_decomposition({{12, 8, 4}}, 3, 2, true).neighbor(5, 1, 0), 3);
+  EXPECT_THROW(cartesian_decomposition({{10, 8, 4}}, 3, 2), std::invalid_argument);
+
+  // the inner and boundary domains cover the compute domain exactly once
+  auto dom = decomposition.local_domain();
+  EXPECT_EQ(dom.isize(), 4 + 2 * h);
+  std::vector<int> covered(dom.isize() * dom.jsize(), 0);
+  auto cover = [&](const gridtools::dawn::domain& d) {
+    for(unsigned int j = d.jminus(); j < d.jsize() - d.jplus(); ++j)
+      for(unsigned int i = d.iminus(); i < d.isize() - d.iplus(); ++i)
+        ++covered[j * dom.isize() + i];
+  };
+  cover(decomposition.inner_domain(1));
+  auto strips = decomposition.boundary_domains(1);
+  EXPECT_EQ(strips.size(), 4);
+  for(const auto& strip : strips)
+    cover(strip);
+  for(int j = 0; j < int(dom.jsize()); ++j)
+    for(int i = 0; i < int(dom.isize()); ++i) {
+      bool compute = i >= h && i < h + 4 && j >= h && j < h + 4;
+      EXPECT_EQ(covered[j * dom.isize() + i], compute ? 1 : 0) << i << ", " << j;
+    }
+}
+
+TEST(driver_includes_domain_decomposition, HaloExchange) {
+  for(bool periodic : {false, true}) {
+    cartesian_decomposition decomposition({{12, 8, 2}}, 3, 2, periodic, periodic);
+    shared_memory_transport transport(decomposition.ranks());
+    std::vector<field> fields(decomposition.ranks(), field(decomposition.local_domain()));
+    run_ranks(decomposition.ranks(), transport, [&](int rank) {
+      fill(decomposition, rank, fields[rank]);
+      halo_exchange<double> exchange(decomposition, transport, rank, 2);
+      exchange.exchange(fields[rank]);
+    });
+
+    for(int rank = 0; rank < decomposition.ranks(); ++rank) {
+      const auto offset = decomposition.global_offset(rank);
+      field& f = fields[rank];
+      for(int k = 0; k < 2; ++k)
+        for(int j = h - 2; j < h + 4 + 2; ++j)
+          for(int i = h - 2; i < h + 4 + 2; ++i) {
+            int gi = offset[0] + i - h;
+            int gj = offset[1] + j - h;
+            bool outside = gi < 0 || gi >= 12 || gj < 0 || gj >= 8;
+            double expected = periodic ? value((gi + 12) % 12, (gj + 8) % 8, k)
+                                       : (outside ? -1 : value(gi, gj, k));
+            EXPECT_EQ(f(i, j, k), expected) << "rank " << rank << " at " << i << ", " << j;
+          }
+      // beyond the exchanged width
+      EXPECT_EQ(f(0, h, 0), -1);
+    }
+  }
+}
+
+TEST(driver_includes_domain_decomposition, OverlappedStencil) {
+  // 5-point Laplacian of a periodic field, decomposed on 2x2 ranks
+  cartesian_decomposition global({{8, 8, 1}}, 1, 1, true, true);
+  cartesian_decomposition decomposition({{8, 8, 1}}, 2, 2, true, true);
+  auto laplacian = [](field& in, field& out, const gridtools::dawn::domain& d) {
+    for(unsigned int j = d.jminus(); j < d.jsize() - d.jplus(); ++j)
+      for(unsigned int i = d.iminus(); i < d.isize() - d.iplus(); ++i)
+        out(i, j, 0) = in(i + 1, j, 0) + in(i - 1, j, 0) + in(i, j + 1, 0) + in(i, j - 1, 0) -
+                       4 * in(i, j, 0);
+  };
+
+  field in(global.local_domain()), out(global.local_domain());
+  shared_memory_transport globalTransport(1);
+  fill(global, 0, in);
+  halo_exchange<double>(global, globalTransport, 0).exchange(in);
+  laplacian(in, out, global.local_domain());
+
+  shared_memory_transport transport(decomposition.ranks());
+  std::vector<field> outs(decomposition.ranks(), field(decomposition.local_domain()));
+  run_ranks(decomposition.ranks(), transport, [&](int rank) {
+    field in(decomposition.local_domain());
+    fill(decomposition, rank, in);
+    halo_exchange<double> exchange(decomposition, transport, rank, 1);
+    exchange.start(in);
+    laplacian(in, outs[rank], decomposition.inner_domain(1));
+    exchange.finish(in);
+    for(const auto& strip : decomposition.boundary_domains(1))
+      laplacian(in, outs[rank], strip);
+  });
+
+  for(int rank = 0; rank < decomposition.ranks(); ++rank) {
+    const auto offset = decomposition.global_offset(rank);
+    for(int j = h; j < h + 4; ++j)
+      for(int i = h; i < h + 4; ++i)
+        EXPECT_EQ(outs[rank](i, j, 0), out(offset[0] + i, offset[1] + j, 0));
+  }
+}
+
+TEST(driver_includes_domain_decomposition, FailingRank) {
+  // rank 0 fails before sending, the others wait for it in a receive and a barrier
+  shared_memory_transport transport(3);
+  std::vector<int> aborted(3, 0);
+  auto body = [&](int rank) {
+    if(rank == 0)
+      throw std::logic_error("rank 0 failed");
+    try {
+      if(rank == 1) {
+        double value;
+        transport.receive(1, 0, 0, &value, sizeof(value));
+      } else {
+        transport.barrier();
+      }
+    } catch(const transport_aborted&) {
+      aborted[rank] = 1;
+      throw;
+    }
+  };
+  EXPECT_THROW(run_ranks(3, transport, body), std::logic_error);
+  EXPECT_TRUE(aborted[1]);
+  EXPECT_TRUE(aborted[2]);
+
+  // later calls do not wait either
+  EXPECT_THROW(transport.barrier(), transport_aborted);
+}
+
+} // namespace
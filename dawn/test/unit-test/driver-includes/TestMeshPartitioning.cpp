@@ -0,0 +1,79 @@
+//===--------------------------------------------------------------------------------*- C++ -*-===//
+//                          _
+//                         | |
+//                       __| | __ ___      ___ ___
+//                      / _` |/ _` \ \ /\ / / '_  |
+//                     | (_| | (_| |\ V  V /| | | |
+//                      \__,_|\__,_| \_/\_/ |_| |_| - Compiler Toolchain
+//
+//
+//  This file is distributed under the MIT License (MIT).
+//  See LICENSE.txt for details.
+//
+//===------------------------------------------------------------------------------------------===//
+
+#include "driver-includes/mesh_partitioning.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+
+namespace {
+
+using namespace dawn::driver;
+
+// points of a nx x ny grid in raster order, neighbors along i and j
+void rasterGrid(int nx, int ny, std::vector<double>& x, std::vector<double>& y,
+                std::vector<std::vector<int>>& adjacency) {
+  for(int j = 0; j < ny; ++j)
+    for(int i = 0; i < nx; ++i) {
+      x.push_back(i);
+      y.push_back(j);
+      adjacency.emplace_back();
+      if(i > 0)
+        adjacency.back().push_back(j * nx + i - 1);
+      if(i < nx - 1)
+        adjacency.back().push_back(j * nx + i + 1);
+      if(j > 0)
+        adjacency.back().push_back((j - 1) * nx + i);
+      if(j < ny - 1)
+        adjacency.back().push_back((j + 1) * nx + i);
+    }
+}
+
+TEST(driver_includes_mesh_partitioning, RecursiveCoordinateBisection) {
+  std::vector<double> x, y;
+  std::vector<std::vector<int>> adjacency;
+  rasterGrid(8, 4, x, y, adjacency);
+
+  // cut across the longer side into two 4x4 halves, then across x again (ties): strips of 2x4
+  partitioning parts = recursive_coordinate_bisection(x, y, 4);
+  for(std::size_t idx = 0; idx < parts.size(); ++idx)
+    EXPECT_EQ(parts[idx], int(x[idx]) / 2);
+  EXPECT_EQ(edge_cut(adjacency, parts), 3 * 4);
+
+  // any number of parts, of sizes differing by at most one
+  for(int numParts = 1; numParts <= 7; ++numParts) {
+    parts = recursive_coordinate_bisection(x, y, numParts);
+    std::vector<int> sizes(numParts, 0);
+    for(int part : parts)
+      ++sizes[part];
+    auto bounds = std::minmax_element(sizes.begin(), sizes.end());
+    EXPECT_GE(*bounds.first, 32 / numParts);
+    EXPECT_LE(*bounds.second - *bounds.first, 1);
+  }
+}
+
+TEST(driver_includes_mesh_partitioning, HaloLayers) {
+  std::vector<double> x, y;
+  std::vector<std::vector<int>> adjacency;
+  rasterGrid(8, 1, x, y, adjacency);
+  // 0 0 0 1 1 1 2 2
+  partitioning parts = {0, 0, 0, 1, 1, 1, 2, 2};
+  EXPECT_EQ(halo_layers(adjacency, parts, 0, 2), (std::vector<int>{0, 0, 0, 1, 2, -1, -1, -1}));
+  EXPECT_EQ(halo_layers(adjacency, parts, 1, 1), (std::vector<int>{-1, -1, 1, 0, 0, 0, 1, -1}));
+  EXPECT_EQ(graph_distance(adjacency, {0, 7}, 2), (std::vector<int>{0, 1, 2, -1, -1, 2, 1, 0}));
+  EXPECT_EQ(edge_cut(adjacency, parts), 2);
+}
+
+} // namespace
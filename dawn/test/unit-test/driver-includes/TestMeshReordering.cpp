@@ -0,0 +1,87 @@
+//===--------------------------------------------------------------------------------*- C++ -*-===//
+//                          _
+//                         | |
+//                       __| | __ ___      ___ ___
+//                      / _` |/ _` \ \ /\ / / '_  |
+//                     | (_| | (_| |\ V  V /| | | |
+//                      \__,_|\__,_| \_/\_/ |_| |_| - Compiler Toolchain
+//
+//
+//  This file is distributed under the MIT License (MIT).
+//  See LICENSE.txt for details.
+//
+//===------------------------------------------------------------------------------------------===//
+
+
+#include "driver-includes/mesh_reordering.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+namespace {
+
+using namespace dawn::driver;
+
+bool isPermutation(permutation perm) {
+  std::sort(perm.begin(), perm.end());
+  for(std::size_t i = 0; i < perm.size(); ++i)
+    if(perm[i] != static_cast<int>(i))
+      return false;
+  return true;
+}
+
+// points of a 4x4 grid in raster order
+void rasterPoints(std::vector<double>& x, std::vector<double>& y) {
+  for(int j = 0; j < 4; ++j)
+    for(int i = 0; i < 4; ++i) {
+      x.push_back(i);
+      y.push_back(j);
+    }
+}
+
+TEST(driver_includes_mesh_reordering, Permute) {
+  permutation perm = {2, 0, 1};
+  EXPECT_EQ(invert_permutation(perm), (permutation{1, 2, 0}));
+  std::vector<char> data = {'a', 'b', 'c'};
+  EXPECT_EQ(permute(data, perm), (std::vector<char>{'c', 'a', 'b'}));
+}
+
+TEST(driver_includes_mesh_reordering, SpaceFillingCurves) {
+  std::vector<double> x, y;
+  rasterPoints(x, y);
+
+  // Z pattern within each quadrant, and quadrant by quadrant
+  permutation morton = morton_order(x, y, 2);
+  EXPECT_EQ(morton, (permutation{0, 1, 4, 5, 2, 3, 6, 7, 8, 9, 12, 13, 10, 11, 14, 15}));
+
+  // consecutive points of the Hilbert curve are neighbors on the grid
+  permutation hilbert = hilbert_order(x, y, 2);
+  ASSERT_TRUE(isPermutation(hilbert));
+  EXPECT_EQ(hilbert.front(), 0);
+  for(std::size_t i = 1; i < hilbert.size(); ++i)
+    EXPECT_EQ(std::abs(x[hilbert[i]] - x[hilbert[i - 1]]) +
+                  std::abs(y[hilbert[i]] - y[hilbert[i - 1]]),
+              1);
+}
+
+TEST(driver_includes_mesh_reordering, ReverseCuthillMcKee) {
+  // a path 0 - 1 - ... - 9 numbered in a scrambled way, plus an isolated element
+  const permutation path = {3, 7, 0, 9, 5, 1, 8, 2, 6, 4};
+  std::vector<std::vector<int>> adjacency(11);
+  for(std::size_t i = 1; i < path.size(); ++i) {
+    adjacency[path[i - 1]].push_back(path[i]);
+    adjacency[path[i]].push_back(path[i - 1]);
+  }
+  permutation identity(adjacency.size());
+  std::iota(identity.begin(), identity.end(), 0);
+  EXPECT_GT(graph_bandwidth(adjacency, identity), 1);
+
+  permutation rcm = reverse_cuthill_mckee_order(adjacency);
+  ASSERT_TRUE(isPermutation(rcm));
+  EXPECT_EQ(graph_bandwidth(adjacency, rcm), 1);
+}
+
+} // namespace
@@ -0,0 +1,129 @@
+//===--------------------------------------------------------------------------------*- C++ -*-===//
+//                          _
+//                         | |
+//                       __| | __ ___      ___ ___
+//                      / _` |/ _` \ \ /\ / / '_  |
+//                     | (_| | (_| |\ V  V /| | | |
+//                      \__,_|\__,_| \_/\_/ |_| |_| - Compiler Toolchain
+//
+//
+//  This file is distributed under the MIT License (MIT).
+//  See LICENSE.txt for details.
+//
+//===------------------------------------------------------------------------------------------===//
+
+#include "driver-includes/unstructured_interface.hpp"
+
+#include <gtest/gtest.h>
+
+#include <list>
+#include <type_traits>
+#include <vector>
+
+namespace mockInterface {
+
+// ring of `size` cells, cell i between the edges i and i + 1 (modulo the size), edges and vertices
+// coincide
+struct mockTag {};
+struct Mesh {
+  int size;
+};
+
+Mesh meshType(mockTag);
+
+inline std::vector<int> getElements(const Mesh& mesh) {
+  std::vector<int> elements;
+  for(int i = 0; i < mesh.size; ++i)
+    elements.push_back(i);
+  return elements;
+}
+inline std::vector<int> getCells(mockTag, const Mesh& mesh) { return getElements(mesh); }
+inline std::vector<int> getEdges(mockTag, const Mesh& mesh) { return getElements(mesh); }
+inline std::vector<int> getVertices(mockTag, const Mesh& mesh) { return getElements(mesh); }
+
+inline std::vector<int> getNeighbors(mockTag, const Mesh& mesh,
+                                     const std::vector<dawn::LocationType>& chain, int elem) {
+  // the previous and the next element along the ring, whatever the chain
+  (void)chain;
+  return {(elem + mesh.size - 1) % mesh.size, (elem + 1) % mesh.size};
+}
+
+} // namespace mockInterface
+
+namespace {
+
+// range with forward iterators only, like the ranges of the atlas interface
+struct Range {
+  struct iterator {
+    int idx;
+    iterator& operator++() {
+      ++idx;
+      return *this;
+    }
+    bool operator!=(const iterator& other) const { return idx != other.idx; }
+    int operator*() const { return idx; }
+  };
+  int size;
+  iterator begin() const { return {0}; }
+  iterator end() const { return {size}; }
+};
+
+TEST(driver_includes_unstructured_interface, IndexableRangeRandomAccess) {
+  std::vector<int> elements = {4, 2, 7};
+  const int* data = elements.data();
+  auto indexable = dawn::indexableRange(std::move(elements));
+
+  static_assert(std::is_same<decltype(indexable), std::vector<int>>::value, "");
+  // moved, not copied
+  ASSERT_EQ(indexable.data(), data);
+  ASSERT_EQ(indexable[2], 7);
+}
+
+TEST(driver_includes_unstructured_interface, IndexableRangeForward) {
+  auto indexable = dawn::indexableRange(Range{5});
+
+  static_assert(std::is_same<decltype(indexable), std::vector<int>>::value, "");
+  ASSERT_EQ(indexable, (std::vector<int>{0, 1, 2, 3, 4}));
+
+  const std::list<double> list = {1., 2.};
+  ASSERT_EQ(dawn::indexableRange(list), (std::vector<double>{1., 2.}));
+}
+
+TEST(driver_includes_unstructured_interface, NeighborTable) {
+  const std::vector<std::vector<int>> rows = {{1, 2}, {}, {0, 1, 2}};
+  const dawn::neighbor_table<int> table(rows);
+  mockInterface::mockTag tag;
+
+  for(int elem = 0; elem < static_cast<int>(rows.size()); ++elem) {
+    dawn::neighbor_span<int> neighbors = table(tag, elem);
+    ASSERT_EQ(std::vector<int>(neighbors.begin(), neighbors.end()), rows[elem]);
+    ASSERT_EQ(neighbors.size(), rows[elem].size());
+  }
+  ASSERT_EQ(table(tag, 2)[1], 1);
+}
+
+struct Sum {
+  void operator()(int& lhs, int nbh) const { lhs += nbh; }
+  void operator()(int& lhs, int nbh, int weight) const { lhs += weight * nbh; }
+};
+
+TEST(driver_includes_unstructured_interface, MakeNeighborTable) {
+  const mockInterface::Mesh mesh = {5};
+  mockInterface::mockTag tag;
+  const std::vector<dawn::LocationType> chain = {dawn::LocationType::Edges,
+                                                 dawn::LocationType::Cells};
+
+  const dawn::neighbor_table_t<mockInterface::mockTag> table =
+      dawn::makeNeighborTable(tag, mesh, chain);
+  dawn::neighbor_span<int> neighbors = table(tag, 0);
+  ASSERT_EQ(std::vector<int>(neighbors.begin(), neighbors.end()), (std::vector<int>{4, 1}));
+  ASSERT_EQ(dawn::reduce(table(tag, 2), 0, Sum{}), 1 + 3);
+  ASSERT_EQ(dawn::reduce(table(tag, 2), 0, Sum{}, std::array<int, 2>{{10, 1}}), 10 * 1 + 3);
+
+  // the center comes first
+  const auto withCenter = dawn::makeNeighborTable(tag, mesh, chain, /*include center*/ true);
+  neighbors = withCenter(tag, 4);
+  ASSERT_EQ(std::vector<int>(neighbors.begin(), neighbors.end()), (std::vector<int>{4, 3, 0}));
+}
+
+} // namespace
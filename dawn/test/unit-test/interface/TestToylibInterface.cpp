@@ -14,9 +14,13 @@
 
 #include <gtest/gtest.h>
 
+#include "driver-includes/mesh_reordering.hpp"
 #include "interface/toylib_interface.hpp"
 #include "toylib/toylib.hpp"
 
+#include <algorithm>
+#include <numeric>
+
 namespace {
 
 // compare two (partial neighborhoods)
@@ -185,4 +189,185 @@ TEST(TestToylibInterface, Intp) {
   ASSERT_TRUE(nbhsValidAndEqual(intpHi, intpHiRef));
 }
 
+TEST(TestToylibInterface, Reorder) {
+  for(auto kind : {toylib::reordering::hilbert, toylib::reordering::morton,
+                   toylib::reordering::reverse_cuthill_mckee}) {
+    toylib::Grid ref(8, 8, false, 1., 1.);
+    toylib::Grid mesh(8, 8, false, 1., 1.);
+    toylib::FaceData<double> f(mesh, 1);
+    toylib::EdgeData<double> e(mesh, 1);
+    for(const auto& face : mesh.faces())
+      f(face, 0) = face.id();
+    for(const toylib::Edge& edge : mesh.edges())
+      e(edge, 0) = edge.id();
+
+    auto perm = toylib::reorder(mesh, kind);
+    f.renumber(perm.faces);
+    e.renumber(perm.edges);
+
+    ASSERT_EQ(mesh.faces().size(), ref.faces().size());
+    ASSERT_EQ(mesh.edges().size(), ref.edges().size());
+    // the valid edges come first
+    for(size_t i = 0; i < mesh.edges().size(); ++i)
+      EXPECT_EQ(mesh.edges()[i].get().id(), static_cast<int>(i));
+
+    // same neighbors (in the same order), identified by their original id
+    for(const auto& face : mesh.faces()) {
+      const auto& refFace = ref.faces()[perm.faces[face.id()]];
+      EXPECT_EQ(f(face, 0), refFace.id());
+      EXPECT_EQ(face.color(), refFace.color());
+      for(size_t i = 0; i < 3; ++i) {
+        EXPECT_EQ(e(face.edge(i), 0), refFace.edge(i).id());
+        EXPECT_EQ(perm.vertices[face.vertex(i).id()], refFace.vertex(i).id());
+      }
+    }
+    for(const toylib::Edge& edge : mesh.edges()) {
+      const auto& refEdge = ref.all_edges()[perm.edges[edge.id()]];
+      ASSERT_EQ(edge.faces().size(), refEdge.faces().size());
+      for(size_t i = 0; i < edge.faces().size(); ++i)
+        EXPECT_EQ(f(edge.face(i), 0), refEdge.face(i).id());
+    }
+    for(const auto& vertex : mesh.vertices()) {
+      const auto& refVertex = ref.vertices()[perm.vertices[vertex.id()]];
+      EXPECT_EQ(vertex.x(), refVertex.x());
+      EXPECT_EQ(vertex.y(), refVertex.y());
+      ASSERT_EQ(vertex.edges().size(), refVertex.edges().size());
+      for(size_t i = 0; i < vertex.edges().size(); ++i)
+        EXPECT_EQ(e(vertex.edge(i), 0), refVertex.edge(i).id());
+    }
+  }
+}
+
+TEST(TestToylibInterface, ReorderBandwidth) {
+  // raster order with per-color interleaving: cells of neighboring rows are ~2*nx apart
+  toylib::Grid mesh(16, 16);
+  auto graph = [&] {
+    return dawn::driver::element_graph(toylibInterface::toylibTag{}, mesh,
+                                       dawn::LocationType::Cells, dawn::LocationType::Edges);
+  };
+  auto identity = [](size_t size) {
+    std::vector<int> perm(size);
+    std::iota(perm.begin(), perm.end(), 0);
+    return perm;
+  };
+  const int before = dawn::driver::graph_bandwidth(graph(), identity(mesh.faces().size()));
+  toylib::reorder(mesh, toylib::reordering::reverse_cuthill_mckee);
+  const int after = dawn::driver::graph_bandwidth(graph(), identity(mesh.faces().size()));
+  EXPECT_LT(after, before);
+}
+
+TEST(TestToylibInterface, Decompose) {
+  toylib::Grid mesh(12, 10, false, 1., 1.);
+  const int parts = 4;
+  auto faceParts = toylib::partition(mesh, parts);
+  auto subgrids = toylib::decompose(mesh, faceParts, 2);
+  ASSERT_EQ(subgrids.size(), parts);
+
+  std::vector<int> ownedFaces(mesh.faces().size(), 0);
+  std::vector<int> ownedEdges(mesh.all_edges().size(), 0);
+  std::vector<int> ownedVertices(mesh.vertices().size(), 0);
+  for(int part = 0; part < parts; ++part) {
+    const auto& sub = subgrids[part];
+    for(const auto* layout : {&sub.faces, &sub.edges, &sub.vertices}) {
+      ASSERT_EQ(layout->halo.size(), 2);
+      EXPECT_LE(0, layout->interior);
+      EXPECT_LE(layout->interior, layout->rim);
+      EXPECT_LT(layout->rim, layout->halo[0]);
+      EXPECT_LT(layout->halo[0], layout->halo[1]);
+      EXPECT_LT(layout->halo[1], layout->end);
+    }
+    ASSERT_EQ(sub.faces.end, sub.grid.faces().size());
+    ASSERT_EQ(sub.edges.end, sub.grid.edges().size());
+    ASSERT_EQ(sub.vertices.end, sub.grid.vertices().size());
+
+    // the owned elements keep all their neighbors (in the same order), identified by their
+    // global index
+    for(int i = 0; i < sub.faces.halo[0]; ++i) {
+      const auto& face = sub.grid.faces()[i];
+      const auto& ref = mesh.faces()[sub.global.faces[i]];
+      EXPECT_EQ(faceParts[ref.id()], part);
+      ++ownedFaces[ref.id()];
+      ASSERT_EQ(face.edges().size(), ref.edges().size());
+      ASSERT_EQ(face.vertices().size(), ref.vertices().size());
+      for(size_t n = 0; n < face.edges().size(); ++n)
+        EXPECT_EQ(sub.global.edges[face.edge(n).id()], ref.edge(n).id());
+      for(size_t n = 0; n < face.vertices().size(); ++n)
+        EXPECT_EQ(sub.global.vertices[face.vertex(n).id()], ref.vertex(n).id());
+    }
+    for(int i = 0; i < sub.edges.halo[0]; ++i) {
+      const toylib::Edge& edge = sub.grid.edges()[i];
+      const auto& ref = mesh.all_edges()[sub.global.edges[i]];
+      ++ownedEdges[ref.id()];
+      ASSERT_EQ(edge.faces().size(), ref.faces().size());
+      for(size_t n = 0; n < edge.faces().size(); ++n)
+        EXPECT_EQ(sub.global.faces[edge.face(n).id()], ref.face(n).id());
+    }
+    for(int i = 0; i < sub.vertices.halo[0]; ++i) {
+      const auto& vertex = sub.grid.vertices()[i];
+      const auto& ref = mesh.vertices()[sub.global.vertices[i]];
+      ++ownedVertices[ref.id()];
+      ASSERT_EQ(vertex.edges().size(), ref.edges().size());
+      ASSERT_EQ(vertex.faces().size(), ref.faces().size());
+      for(size_t n = 0; n < vertex.edges().size(); ++n)
+        EXPECT_EQ(sub.global.edges[vertex.edge(n).id()], ref.edge(n).id());
+    }
+
+    // halo elements are linked to the same element, owned by another subgrid
+    EXPECT_EQ(sub.face_halo.size(), sub.faces.end - sub.faces.halo[0]);
+    for(const auto& link : sub.face_halo) {
+      EXPECT_NE(link.part, part);
+      EXPECT_LT(link.remote, subgrids[link.part].faces.halo[0]);
+      EXPECT_EQ(sub.global.faces[link.local], subgrids[link.part].global.faces[link.remote]);
+    }
+    EXPECT_EQ(sub.edge_halo.size(), sub.edges.end - sub.edges.halo[0]);
+    for(const auto& link : sub.edge_halo)
+      EXPECT_EQ(sub.global.edges[link.local], subgrids[link.part].global.edges[link.remote]);
+    EXPECT_EQ(sub.vertex_halo.size(), sub.vertices.end - sub.vertices.halo[0]);
+    for(const auto& link : sub.vertex_halo)
+      EXPECT_EQ(sub.global.vertices[link.local],
+                subgrids[link.part].global.vertices[link.remote]);
+
+    // the iteration spaces of the stencils
+    auto rim = toylibInterface::getCells(toylibInterface::toylibTag{}, sub.grid, sub.faces.rim,
+                                         sub.faces.halo[0]);
+    ASSERT_EQ(rim.size(), sub.faces.halo[0] - sub.faces.rim);
+    EXPECT_EQ(rim.front()->id(), sub.faces.rim);
+  }
+
+  // each element is owned exactly once
+  EXPECT_TRUE(std::all_of(ownedFaces.begin(), ownedFaces.end(), [](int n) { return n == 1; }));
+  EXPECT_TRUE(std::all_of(ownedVertices.begin(), ownedVertices.end(),
+                          [](int n) { return n == 1; }));
+  for(const toylib::Edge& edge : mesh.edges())
+    EXPECT_EQ(ownedEdges[edge.id()], 1);
+}
+
+TEST(TestToylibInterface, UpdateHalo) {
+  toylib::Grid mesh(8, 8, true);
+  auto subgrids = toylib::decompose(mesh, toylib::partition(mesh, 3));
+  for(bool byPointer : {false, true}) {
+    std::vector<toylib::EdgeData<double>> fields;
+    for(const auto& sub : subgrids) {
+      fields.emplace_back(sub.grid, 2);
+      for(const toylib::Edge& edge : sub.grid.edges())
+        for(int k = 0; k < 2; ++k)
+          fields.back()(edge, k) =
+              edge.id() < sub.edges.halo[0] ? sub.global.edges[edge.id()] + 1000 * k : -1;
+    }
+    std::vector<toylib::EdgeData<double> const*> pointers;
+    for(const auto& field : fields)
+      pointers.push_back(&field);
+
+    for(size_t part = 0; part < subgrids.size(); ++part)
+      if(byPointer)
+        fields[part].update_halo(subgrids[part].edge_halo, pointers);
+      else
+        fields[part].update_halo(subgrids[part].edge_halo, fields);
+    for(size_t part = 0; part < subgrids.size(); ++part)
+      for(const toylib::Edge& edge : subgrids[part].grid.edges())
+        for(int k = 0; k < 2; ++k)
+          EXPECT_EQ(fields[part](edge, k), subgrids[part].global.edges[edge.id()] + 1000 * k);
+  }
+}
+
 } // namespace
\ No newline at end of file
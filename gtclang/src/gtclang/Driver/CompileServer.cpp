@@ -0,0 +1,150 @@
+//===--------------------------------------------------------------------------------*- C++ -*-===//
+//                         _       _
+//                        | |     | |
+//                    __ _| |_ ___| | __ _ _ __   __ _
+//                   / _` | __/ __| |/ _` | '_ \ / _` |
+//                  | (_| | || (__| | (_| | | | | (_| |
+//                   \__, |\__\___|_|\__,_|_| |_|\__, | - GridTools Clang DSL
+//                    __/ |                       __/ |
+//                   |___/                       |___/
+//
+//
+//  This file is distributed under the MIT License (MIT).
+//  See LICENSE.txt for details.
+//
+//===------------------------------------------------------------------------------------------===//
+
+#include "gtclang/Driver/CompileServer.h"
+#include "dawn/Support/Logger.h"
+#include "dawn/Support/UIDGenerator.h"
+#include "gtclang/Driver/CompilerInstance.h"
+#include "gtclang/Driver/Driver.h"
+#include "gtclang/Frontend/GTClangContext.h"
+#include "clang/Frontend/CompilerInstance.h"
+#include "clang/Frontend/FrontendActions.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/raw_ostream.h"
+#include <algorithm>
+#include <memory>
+
+namespace gtclang {
+
+CompileServer::CompileServer(const Options& options, llvm::ArrayRef<const char*> clangArgs,
+                             CompletionCallback onCompletion)
+    : options_(options), clangArgs_(clangArgs.begin(), clangArgs.end()),
+      onCompletion_(std::move(onCompletion)) {
+  if(options_.DSLPreamble)
+    dslPreamble_ = makeDSLPreamble();
+
+  const int numWorkers = std::max(1, options_.Jobs);
+  DAWN_LOG(INFO) << "Starting " << numWorkers << " compile worker(s)";
+  for(int i = 0; i < numWorkers; ++i)
+    workers_.emplace_back([this] { workerLoop(); });
+}
+
+CompileServer::~CompileServer() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    shutdown_ = true;
+  }
+  queueChanged_.notify_all();
+  for(auto& worker : workers_)
+    worker.join();
+
+  for(const auto& file : temporaryFiles_)
+    llvm::sys::fs::remove(file);
+}
+
+void CompileServer::submit(const std::string& file) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    queue_.push_back(file);
+    ++pending_;
+  }
+  queueChanged_.notify_all();
+}
+
+int CompileServer::wait() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  queueChanged_.wait(lock, [this] { return pending_ == 0; });
+  return exitCode_;
+}
+
+std::string CompileServer::makeDSLPreamble() {
+  llvm::SmallString<128> headerPath, preamblePath;
+  int headerFD;
+  if(llvm::sys::fs::createTemporaryFile("gtclang-dsl-preamble", "hpp", headerFD, headerPath) ||
+     llvm::sys::fs::createTemporaryFile("gtclang-dsl-preamble", "pch", preamblePath)) {
+    DAWN_LOG(WARNING) << "Unable to create the DSL preamble, the DSL headers are parsed for every "
+                         "input file";
+    return "";
+  }
+  temporaryFiles_.push_back(headerPath.str().str());
+  temporaryFiles_.push_back(preamblePath.str().str());
+
+  {
+    llvm::raw_fd_ostream header(headerFD, /*shouldClose=*/true);
+    header << "#include \"gtclang_dsl_defs/gtclang_dsl.hpp\"\n";
+  }
+
+  // The preamble is compiled with the same arguments as the input files, otherwise clang rejects
+  // it when validating the precompiled header
+  llvm::SmallVector<const char*, 16> args(clangArgs_.begin(), clangArgs_.end());
+  args.push_back(headerPath.c_str());
+  std::unique_ptr<clang::CompilerInstance> compiler(createCompilerInstance(args));
+  if(!compiler)
+    return "";
+
+  compiler->getFrontendOpts().OutputFile = preamblePath.str().str();
+  clang::GeneratePCHAction action;
+  if(!compiler->ExecuteAction(action)) {
+    DAWN_LOG(WARNING) << "Unable to precompile the DSL headers, they are parsed for every input "
+                         "file";
+    return "";
+  }
+
+  DAWN_LOG(INFO) << "Precompiled the DSL headers into " << preamblePath.str().str();
+  return preamblePath.str().str();
+}
+
+void CompileServer::workerLoop() {
+  while(true) {
+    std::string file;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      queueChanged_.wait(lock, [this] { return shutdown_ || !queue_.empty(); });
+      if(queue_.empty())
+        return;
+      file = std::move(queue_.front());
+      queue_.pop_front();
+    }
+
+    const int ret = compile(file);
+    if(onCompletion_)
+      onCompletion_(file, ret);
+
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if(ret)
+        exitCode_ = 1;
+      --pending_;
+    }
+    queueChanged_.notify_all();
+  }
+}
+
+int CompileServer::compile(const std::string& file) {
+  // Number the IR of every file from scratch, as if it was compiled by its own gtclang process
+  dawn::UIDGenerator::getInstance()->reset();
+
+  auto context = std::make_unique<GTClangContext>();
+  context->getOptions() = options_;
+
+  // The input file follows the program name, as on the command-line
+  llvm::SmallVector<const char*, 16> args(clangArgs_.begin(), clangArgs_.end());
+  args.insert(args.begin() + 1, file.c_str());
+  return gtclang::compile(context.get(), args, dslPreamble_).ExitCode;
+}
+
+} // namespace gtclang
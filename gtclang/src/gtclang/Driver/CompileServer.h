@@ -0,0 +1,90 @@
+//===--------------------------------------------------------------------------------*- C++ -*-===//
+//                         _       _
+//                        | |     | |
+//                    __ _| |_ ___| | __ _ _ __   __ _
+//                   / _` | __/ __| |/ _` | '_ \ / _` |
+//                  | (_| | || (__| | (_| | | | | (_| |
+//                   \__, |\__\___|_|\__,_|_| |_|\__, | - GridTools Clang DSL
+//                    __/ |                       __/ |
+//                   |___/                       |___/
+//
+//
+//  This file is distributed under the MIT License (MIT).
+//  See LICENSE.txt for details.
+//
+//===------------------------------------------------------------------------------------------===//
+
+#ifndef GTCLANG_DRIVER_COMPILESERVER_H
+#define GTCLANG_DRIVER_COMPILESERVER_H
+
+#include "dawn/Support/NonCopyable.h"
+#include "gtclang/Driver/Options.h"
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/SmallVector.h"
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace gtclang {
+
+/// @brief Compiles many DSL files in a single gtclang process
+///
+/// The DSL headers are parsed once into a precompiled preamble (`DSLPreamble`, disabled with
+/// `-fno-dsl-preamble`) which is shared by all the files. The files are compiled concurrently by
+/// `Jobs` worker threads, each of them with its own compiler instance and context. The input files
+/// are never modified, the state shared by the workers (the loggers, the Protobuf logger) is
+/// synchronized and the UID and index generators are per thread.
+///
+/// @ingroup driver
+class CompileServer : dawn::NonCopyable {
+public:
+  /// @brief Called with the input file and the exit code (`0` on success) of each compilation
+  using CompletionCallback = std::function<void(const std::string&, int)>;
+
+  /// @param options      Options shared by all the compilations
+  /// @param clangArgs    Arguments passed to the Clang Frontend, without any input file
+  /// @param onCompletion Called by the worker threads once a file is compiled
+  CompileServer(const Options& options, llvm::ArrayRef<const char*> clangArgs,
+                CompletionCallback onCompletion = nullptr);
+
+  /// @brief Waits for the pending files and removes the preamble
+  ~CompileServer();
+
+  /// @brief Queue `file` for compilation
+  void submit(const std::string& file);
+
+  /// @brief Wait until all the submitted files are compiled
+  /// @returns `0` if all of them compiled successfully, `1` otherwise
+  int wait();
+
+private:
+  /// @brief Parse the DSL headers into a precompiled header, returns its path (empty on failure)
+  std::string makeDSLPreamble();
+
+  void workerLoop();
+
+  int compile(const std::string& file);
+
+  const Options options_;
+  llvm::SmallVector<const char*, 16> clangArgs_;
+  CompletionCallback onCompletion_;
+
+  std::string dslPreamble_;
+  std::vector<std::string> temporaryFiles_;
+
+  std::mutex mutex_;
+  std::condition_variable queueChanged_;
+  std::deque<std::string> queue_;
+  int pending_ = 0;
+  int exitCode_ = 0;
+  bool shutdown_ = false;
+  std::vector<std::thread> workers_;
+};
+
+} // namespace gtclang
+
+#endif
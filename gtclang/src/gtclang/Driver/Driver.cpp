@@ -16,6 +16,7 @@
 
 #include "gtclang/Driver/Driver.h"
 #include "dawn/Support/Logger.h"
+#include "gtclang/Driver/CompileServer.h"
 #include "gtclang/Driver/CompilerInstance.h"
 #include "gtclang/Driver/OptionsParser.h"
 #include "gtclang/Frontend/GTClangASTAction.h"
@@ -23,14 +24,105 @@
 #include "gtclang/Frontend/GTClangIncludeChecker.h"
 #include "gtclang/Frontend/GTClangPreprocessorAction.h"
 #include "gtclang/Support/Logger.h"
+#include "clang/Driver/Types.h"
 #include "clang/Frontend/CompilerInstance.h"
+#include "clang/Lex/PreprocessorOptions.h"
 #include "llvm/Support/ManagedStatic.h"
+#include "llvm/Support/Path.h"
 #include "llvm/Support/PrettyStackTrace.h"
 #include "llvm/Support/Program.h"
 #include "llvm/Support/Signals.h"
+#include <algorithm>
+#include <iostream>
+#include <mutex>
 
 namespace gtclang {
 
+namespace {
+
+/// @brief Check if `arg` is a C++ source file, i.e. an input of gtclang
+bool isInputFile(llvm::StringRef arg) {
+  if(arg.startswith("-"))
+    return false;
+  llvm::StringRef extension = llvm::sys::path::extension(arg);
+  if(extension.empty())
+    return false;
+  namespace types = clang::driver::types;
+  types::ID type = types::lookupTypeForExtension(extension.drop_front());
+  return type != types::TY_INVALID && types::isCXX(type);
+}
+
+/// @brief Compile all `inputFiles` in this process, keep compiling the files read from stdin with
+/// `CompileServer`
+int runCompileServer(const Options& options, const llvm::SmallVectorImpl<const char*>& clangArgs,
+                     const llvm::SmallVectorImpl<const char*>& inputFiles) {
+  // The input files are passed to the server one by one
+  llvm::SmallVector<const char*, 16> commonArgs;
+  for(const char* arg : clangArgs) {
+    if(std::find(inputFiles.begin(), inputFiles.end(), arg) == inputFiles.end())
+      commonArgs.push_back(arg);
+  }
+
+  std::mutex outputMutex;
+  CompileServer::CompletionCallback reportStatus = nullptr;
+  if(options.CompileServer)
+    reportStatus = [&outputMutex](const std::string& file, int ret) {
+      std::lock_guard<std::mutex> lock(outputMutex);
+      llvm::outs() << file << ": " << (ret ? "error" : "ok") << "\n";
+      llvm::outs().flush();
+    };
+
+  CompileServer server(options, commonArgs, reportStatus);
+  for(const char* file : inputFiles)
+    server.submit(file);
+
+  if(options.CompileServer) {
+    std::string file;
+    while(std::getline(std::cin, file)) {
+      if(!file.empty())
+        server.submit(file);
+    }
+  }
+  return server.wait();
+}
+
+} // namespace
+
+ReturnValue compile(GTClangContext* context, llvm::SmallVectorImpl<const char*>& clangArgs,
+                    const std::string& dslPreamble) {
+  std::shared_ptr<dawn::SIR> returnSIR = nullptr;
+
+  GTClangIncludeChecker includeChecker;
+  if(clangArgs.size() > 1)
+    includeChecker.Update(clangArgs[1]);
+
+  // Create GTClang
+  std::unique_ptr<clang::CompilerInstance> GTClang(createCompilerInstance(clangArgs));
+
+  int ret = 0;
+  if(GTClang) {
+    if(!dslPreamble.empty())
+      GTClang->getPreprocessorOpts().ImplicitPCHInclude = dslPreamble;
+    includeChecker.Remap(GTClang->getPreprocessorOpts());
+
+    std::unique_ptr<clang::FrontendAction> PPAction(new GTClangPreprocessorAction(context));
+    ret |= !GTClang->ExecuteAction(*PPAction);
+
+    // From now on, the source manager (shared by both actions) holds the preprocessed main-file,
+    // which must not be remapped again to the copy of the include checker
+    GTClang->getPreprocessorOpts().clearRemappedFiles();
+
+    if(ret == 0) {
+      std::unique_ptr<GTClangASTAction> ASTAction(new GTClangASTAction(context));
+      ret |= !GTClang->ExecuteAction(*ASTAction);
+      returnSIR = ASTAction->getSIR();
+    }
+    DAWN_LOG(INFO) << "Compilation finished " << (ret ? "with errors" : "successfully");
+  }
+
+  return ReturnValue{ret, returnSIR};
+}
+
 bool Driver::isInitialized = false;
 
 ReturnValue Driver::run(const llvm::SmallVectorImpl<const char*>& args) {
@@ -72,28 +164,24 @@ ReturnValue Driver::run(const llvm::SmallVectorImpl<const char*>& args) {
   dawn::log::warn.diagnosticFormatter(makeGTClangDiagnosticFormatter("[WARNING]"));
   dawn::log::error.diagnosticFormatter(makeGTClangDiagnosticFormatter("[ERROR]"));
 
-  GTClangIncludeChecker includeChecker;
-  if(clangArgs.size() > 1)
-    includeChecker.Update(clangArgs[1]);
-
-  // Create GTClang
-  std::unique_ptr<clang::CompilerInstance> GTClang(createCompilerInstance(clangArgs));
-
-  int ret = 0;
-  if(GTClang) {
-    std::unique_ptr<clang::FrontendAction> PPAction(new GTClangPreprocessorAction(context.get()));
-    ret |= !GTClang->ExecuteAction(*PPAction);
+  ReturnValue ret{0, returnSIR};
+  llvm::SmallVector<const char*, 16> inputFiles;
+  for(std::size_t i = 1; i < clangArgs.size(); ++i) {
+    if(isInputFile(clangArgs[i]))
+      inputFiles.push_back(clangArgs[i]);
+  }
 
-    if(ret == 0) {
-      std::unique_ptr<GTClangASTAction> ASTAction(new GTClangASTAction(context.get()));
-      ret |= !GTClang->ExecuteAction(*ASTAction);
-      returnSIR = ASTAction->getSIR();
+  if(inputFiles.size() > 1 || context->getOptions().CompileServer) {
+    if(!context->getOptions().OutputFile.empty()) {
+      llvm::errs() << "error: cannot specify -o when compiling several input files\n";
+      ret.ExitCode = 1;
+    } else {
+      ret.ExitCode = runCompileServer(context->getOptions(), clangArgs, inputFiles);
     }
-    DAWN_LOG(INFO) << "Compilation finished " << (ret ? "with errors" : "successfully");
+  } else {
+    ret = compile(context.get(), clangArgs);
   }
 
-  includeChecker.Restore();
-
   // Reset formatters
   dawn::log::info.messageFormatter(infoMessageFormatter);
   dawn::log::warn.messageFormatter(warnMessageFormatter);
@@ -103,7 +191,7 @@ ReturnValue Driver::run(const llvm::SmallVectorImpl<const char*>& args) {
   dawn::log::warn.diagnosticFormatter(warnDiagnosticFormatter);
   dawn::log::error.diagnosticFormatter(errorDiagnosticFormatter);
 
-  return ReturnValue{ret, returnSIR};
+  return ret;
 }
 
 std::shared_ptr<dawn::SIR> run(const std::string& fileName, const ParseOptions& options) {
@@ -138,32 +226,8 @@ std::shared_ptr<dawn::SIR> run(const std::string& fileName, const ParseOptions&
   dawn::log::warn.diagnosticFormatter(makeGTClangDiagnosticFormatter("[WARNING]"));
   dawn::log::error.diagnosticFormatter(makeGTClangDiagnosticFormatter("[ERROR]"));
 
-  gtclang::GTClangIncludeChecker includeChecker;
-  if(clangArgs.size() > 1)
-    includeChecker.Update(clangArgs[1]);
-
-  // Create GTClang
-  std::unique_ptr<clang::CompilerInstance> GTClang(gtclang::createCompilerInstance(clangArgs));
-
   // Create SIR as return value
-  std::shared_ptr<dawn::SIR> stencilIR = nullptr;
-
-  int ret = 0;
-  if(GTClang) {
-    std::unique_ptr<clang::FrontendAction> PPAction(
-        new gtclang::GTClangPreprocessorAction(context.get()));
-    ret |= !GTClang->ExecuteAction(*PPAction);
-
-    if(ret == 0) {
-      std::unique_ptr<gtclang::GTClangASTAction> ASTAction(
-          new gtclang::GTClangASTAction(context.get()));
-      ret |= !GTClang->ExecuteAction(*ASTAction);
-      stencilIR = ASTAction->getSIR();
-    }
-    DAWN_LOG(INFO) << "Compilation finished " << (ret ? "with errors" : "successfully");
-  }
-
-  includeChecker.Restore();
+  std::shared_ptr<dawn::SIR> stencilIR = compile(context.get(), clangArgs).SIR;
 
   // Reset formatters
   dawn::log::info.messageFormatter(infoMessageFormatter);
@@ -26,6 +26,8 @@
 
 namespace gtclang {
 
+class GTClangContext;
+
 struct ReturnValue {
   int ExitCode;
   std::shared_ptr<dawn::SIR> SIR;
@@ -45,6 +47,14 @@ struct Driver : public dawn::NonCopyable {
   static bool isInitialized;
 };
 
+/// @brief Run the preprocessor and AST actions of gtclang on the single input file of `clangArgs`
+///
+/// @param dslPreamble  Precompiled header of the DSL headers (see `CompileServer`), empty if the
+///                     DSL headers are parsed with the input file
+/// @ingroup driver
+ReturnValue compile(GTClangContext* context, llvm::SmallVectorImpl<const char*>& clangArgs,
+                    const std::string& dslPreamble = "");
+
 /// @brief Driver for the gtclang parser
 /// @ingroup driver
 std::shared_ptr<dawn::SIR> run(const std::string& fileName, const ParseOptions& options = {});
@@ -22,7 +22,9 @@
 #include "gtclang/Support/Config.h"
 #include "gtclang/Support/StringUtil.h"
 #include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/SmallString.h"
 #include "llvm/ADT/StringRef.h"
+#include "llvm/Support/FileSystem.h"
 #include "llvm/Support/raw_ostream.h"
 
 namespace gtclang {
@@ -294,6 +296,13 @@ bool OptionsParser::parse(const llvm::SmallVectorImpl<const char*>& args,
       // Skip the next option as we already consumed it
       i += 1;
   }
+
+  // A relative path would be resolved relative to the generated file which includes the header
+  if(!options_->PrecompiledHeader.empty()) {
+    llvm::SmallString<128> path(options_->PrecompiledHeader);
+    llvm::sys::fs::make_absolute(path);
+    options_->PrecompiledHeader = path.str().str();
+  }
   return true;
 }
 
@@ -136,6 +136,10 @@ void GTClangASTConsumer::HandleTranslationUnit(clang::ASTContext& ASTContext) {
   if(context_->getOptions().PrintStencilGraph)
     passGroup.push_back(dawn::PassGroup::PrintStencilGraph);
 
+  // Folding first lets the other passes see the specialized stencils
+  if(context_->getOptions().ConstantFolding)
+    passGroup.push_back(dawn::PassGroup::ConstantFolding);
+
   if(context_->getOptions().SetStageName || context_->getOptions().DefaultOptimization)
     passGroup.push_back(dawn::PassGroup::SetStageName);
 
@@ -156,6 +160,9 @@ void GTClangASTConsumer::HandleTranslationUnit(clang::ASTContext& ASTContext) {
   if(context_->getOptions().Inlining)
     passGroup.push_back(dawn::PassGroup::Inlining);
 
+  if(context_->getOptions().CommonSubexpressionElimination)
+    passGroup.push_back(dawn::PassGroup::CommonSubexpressionElimination);
+
   if(context_->getOptions().IntervalPartitioning)
     passGroup.push_back(dawn::PassGroup::IntervalPartitioning);
 
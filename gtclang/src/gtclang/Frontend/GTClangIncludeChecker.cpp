@@ -15,12 +15,13 @@
 //===------------------------------------------------------------------------------------------===//
 
 #include "gtclang/Frontend/GTClangIncludeChecker.h"
-#include "dawn/Support/FileSystem.h"
+#include "clang/Lex/PreprocessorOptions.h"
+#include "llvm/Support/raw_ostream.h"
 #include <fstream>
 
 namespace gtclang {
 
-GTClangIncludeChecker::GTClangIncludeChecker() { updated_ = false; }
+GTClangIncludeChecker::GTClangIncludeChecker() {}
 
 void GTClangIncludeChecker::Update(const std::string& sourceFile) {
   using llvm::StringRef;
@@ -43,14 +44,14 @@ void GTClangIncludeChecker::Update(const std::string& sourceFile) {
   ScanHeader(PPCodeLines, includes, namespaces);
 
   if(includes.size() > 0 || namespaces.size() > 0)
-    WriteFile(PPCodeLines, includes, namespaces);
+    WriteBuffer(PPCodeLines, includes, namespaces);
 }
 
-void GTClangIncludeChecker::Restore() {
-  if(updated_) {
-    fs::copy(sourceFile_ + "~", sourceFile_, fs::copy_options::overwrite_existing);
-    std::remove((sourceFile_ + "~").c_str());
-  }
+void GTClangIncludeChecker::Remap(clang::PreprocessorOptions& PPOpts) const {
+  if(!buffer_)
+    return;
+  PPOpts.addRemappedFile(sourceFile_, buffer_.get());
+  PPOpts.RetainRemappedFileBuffers = true;
 }
 
 void GTClangIncludeChecker::ScanHeader(const llvm::SmallVector<llvm::StringRef, 100>& PPCodeLines,
@@ -83,28 +84,24 @@ void GTClangIncludeChecker::ScanHeader(const llvm::SmallVector<llvm::StringRef,
   }
 }
 
-void GTClangIncludeChecker::WriteFile(const llvm::SmallVector<llvm::StringRef, 100>& PPCodeLines,
-                                      std::vector<std::string>& includes,
-                                      std::vector<std::string>& namespaces) {
-
-  // Create a backup of the source file
-  std::error_code copyError;
-  fs::copy(sourceFile_, sourceFile_ + "~", fs::copy_options::overwrite_existing, copyError);
-  updated_ = !copyError;
-
-  // Rewrite the source file with the missing includes and namespaces added
-  if(updated_) {
-    std::ofstream ofs(sourceFile_);
-    for(const std::string& include : includes)
-      ofs << "#include \"" << include << "\"\n";
-    for(const std::string& nspace : namespaces)
-      ofs << "using namespace " << nspace << ";\n";
-
-    ofs << "\n";
-    for(int i = 0; i < PPCodeLines.size(); ++i)
-      ofs << PPCodeLines[i].str() << "\n";
-    ofs.close();
-  }
+void GTClangIncludeChecker::WriteBuffer(
+    const llvm::SmallVector<llvm::StringRef, 100>& PPCodeLines, std::vector<std::string>& includes,
+    std::vector<std::string>& namespaces) {
+
+  // Copy the source file with the missing includes and namespaces added
+  std::string code;
+  llvm::raw_string_ostream os(code);
+  for(const std::string& include : includes)
+    os << "#include \"" << include << "\"\n";
+  for(const std::string& nspace : namespaces)
+    os << "using namespace " << nspace << ";\n";
+
+  os << "\n";
+  for(int i = 0; i < PPCodeLines.size(); ++i)
+    os << PPCodeLines[i] << "\n";
+  os.flush();
+
+  buffer_ = llvm::MemoryBuffer::getMemBufferCopy(code, sourceFile_);
 }
 
 } // namespace gtclang
@@ -19,28 +19,41 @@
 
 #include <llvm/ADT/SmallVector.h>
 #include <llvm/ADT/StringRef.h>
+#include <llvm/Support/MemoryBuffer.h>
+#include <memory>
 #include <string>
 #include <vector>
 
+namespace clang {
+class PreprocessorOptions;
+}
+
 namespace gtclang {
 
 /// @brief Ensures that input file has necessary gtclang includes needed for stencil DSL
+///
+/// The missing includes and namespaces are added to a copy of the file held in memory, the file on
+/// disk is never modified such that several compilations can read it concurrently.
 /// @ingroup frontend
 class GTClangIncludeChecker {
 public:
   GTClangIncludeChecker();
   void Update(const std::string& sourceFile);
-  void Restore();
+
+  /// @brief Remap the source file to its updated copy, if it lacked any include or namespace
+  ///
+  /// The copy is owned by the checker which has to outlive the compilation.
+  void Remap(clang::PreprocessorOptions& PPOpts) const;
 
 protected:
   void ScanHeader(const llvm::SmallVector<llvm::StringRef, 100>& PPCodeLines,
                   std::vector<std::string>& includes, std::vector<std::string>& namespaces);
-  void WriteFile(const llvm::SmallVector<llvm::StringRef, 100>& PPCodeLines,
-                 std::vector<std::string>& includes, std::vector<std::string>& namespaces);
+  void WriteBuffer(const llvm::SmallVector<llvm::StringRef, 100>& PPCodeLines,
+                   std::vector<std::string>& includes, std::vector<std::string>& namespaces);
 
 private:
-  bool updated_;
   std::string sourceFile_;
+  std::unique_ptr<llvm::MemoryBuffer> buffer_;
 };
 
 } // namespace gtclang
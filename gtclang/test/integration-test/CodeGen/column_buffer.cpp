@@ -0,0 +1,36 @@
+//===--------------------------------------------------------------------------------*- C++ -*-===//
+//                         _       _
+//                        | |     | |
+//                    __ _| |_ ___| | __ _ _ __   __ _
+//                   / _` | __/ __| |/ _` | '_ \ / _` |
+//                  | (_| | || (__| | (_| | | | | (_| |
+//                   \__, |\__\___|_|\__,_|_| |_|\__, | - GridTools Clang DSL
+//                    __/ |                       __/ |
+//                   |___/                       |___/
+//
+//
+//  This file is distributed under the MIT License (MIT).
+//  See LICENSE.txt for details.
+//
+//===------------------------------------------------------------------------------------------===//
+
+#include "gtclang_dsl_defs/gtclang_dsl.hpp"
+
+using namespace gtclang::dsl;
+
+stencil column_buffer {
+  storage in, out;
+  var t, s;
+
+  Do {
+    vertical_region(k_start, k_end) { t = in * 2.0; }
+    vertical_region(k_start, k_start) {
+      s = t;
+      out = s;
+    }
+    vertical_region(k_start + 1, k_end) {
+      s = s[k - 1] * 0.5 + t;
+      out = s + t[k - 1];
+    }
+  }
+};
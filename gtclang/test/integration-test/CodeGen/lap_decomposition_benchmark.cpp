@@ -0,0 +1,184 @@
+//===--------------------------------------------------------------------------------*- C++ -*-===//
+//                         _       _
+//                        | |     | |
+//                    __ _| |_ ___| | __ _ _ __   __ _
+//                   / _` | __/ __| |/ _` | '_ \ / _` |
+//                  | (_| | || (__| | (_| | | | | (_| |
+//                   \__, |\__\___|_|\__,_|_| |_|\__, | - GridTools Clang DSL
+//                    __/ |                       __/ |
+//                   |___/                       |___/
+//
+//
+//  This file is distributed under the MIT License (MIT).
+//  See LICENSE.txt for details.
+#define DAWN_GENERATED 1
+#define GRIDTOOLS_DAWN_HALO_EXTENT 3
+#define GT_VECTOR_LIMIT_SIZE 30
+
+#undef FUSION_MAX_VECTOR_SIZE
+#undef FUSION_MAX_MAP_SIZE
+#define FUSION_MAX_VECTOR_SIZE GT_VECTOR_LIMIT_SIZE
+#define FUSION_MAX_MAP_SIZE FUSION_MAX_VECTOR_SIZE
+#define BOOST_MPL_LIMIT_VECTOR_SIZE FUSION_MAX_VECTOR_SIZE
+#define BOOST_MPL_CFG_NO_PREPROCESSED_HEADERS
+
+#include <gtest/gtest.h>
+#include "driver-includes/benchmark.hpp"
+#include "driver-includes/domain_decomposition.hpp"
+#include "driver-includes/verify.hpp"
+#include "test/integration-test/CodeGen/Options.hpp"
+#include "test/integration-test/CodeGen/generated/lap_c++-naive.cpp"
+#include "test/integration-test/CodeGen/generated/lap_c++-opt.cpp"
+
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <thread>
+
+using namespace dawn;
+
+namespace {
+
+// lap reads up to 3 points away (in[i+2] through tmp[i+1])
+const unsigned int radius = 3;
+
+/**
+ * @brief Storages and stencils of one rank, the halo exchange overlapped with the inner points
+ */
+struct lap_rank {
+  lap_rank(const driver::cartesian_decomposition& decomposition, driver::transport& transport,
+           int rank)
+      : meta_data(decomposition.local_domain().isize(), decomposition.local_domain().jsize(),
+                  decomposition.local_domain().ksize() + 1),
+        in(meta_data, "in"), out(meta_data, "out"),
+        exchange(decomposition, transport, rank, radius),
+        inner(decomposition.inner_domain(radius), rank, decomposition.xcols(),
+              decomposition.ycols()) {
+    for(const domain& strip : decomposition.boundary_domains(radius))
+      boundary.emplace_back(new dawn_generated::cxxopt::lap(strip, rank, decomposition.xcols(),
+                                                            decomposition.ycols()));
+  }
+
+  void step() {
+    auto view = make_host_view(in);
+    exchange.start(view);
+    inner.run(in, out);
+    exchange.finish(view);
+    for(auto& stencil : boundary)
+      stencil->run(in, out);
+  }
+
+  meta_data_t meta_data;
+  storage_t in;
+  storage_t out;
+  driver::halo_exchange<::dawn::float_type> exchange;
+  dawn_generated::cxxopt::lap inner;
+  std::vector<std::unique_ptr<dawn_generated::cxxopt::lap>> boundary;
+};
+
+std::array<unsigned int, 3> getSize() {
+  return {{static_cast<unsigned int>(Options::getInstance().m_size[0]),
+           static_cast<unsigned int>(Options::getInstance().m_size[1]),
+           static_cast<unsigned int>(Options::getInstance().m_size[2])}};
+}
+
+} // namespace
+
+TEST(lap_decomposition, test) {
+  // reference on the whole domain, large enough for subdomains at least twice as wide as `radius`
+  domain dom(24 + 2 * halo::value, 18 + 2 * halo::value, Options::getInstance().m_size[2]);
+  dom.set_halos(halo::value, halo::value, halo::value, halo::value, 0, 0);
+  verifier verif(dom);
+  meta_data_t meta_data(dom.isize(), dom.jsize(), dom.ksize() + 1);
+  storage_t in(meta_data, "in"), out_naive(meta_data, "out-naive");
+  verif.fillMath(8.0, 2.0, 1.5, 1.5, 2.0, 4.0, in);
+  verif.fill(-1.0, out_naive);
+  dawn_generated::cxxnaive::lap lap_naive(dom);
+  lap_naive.run(in, out_naive);
+
+  driver::cartesian_decomposition decomposition({{24, 18, dom.ksize()}}, 2, 3);
+  driver::shared_memory_transport transport(decomposition.ranks());
+  auto in_view = make_host_view(in);
+  auto out_naive_view = make_host_view(out_naive);
+  const auto local = decomposition.local_size();
+  const int h = halo::value;
+  std::vector<int> mismatches(decomposition.ranks(), 0);
+
+  driver::run_ranks(decomposition.ranks(), transport, [&](int rank) {
+    lap_rank r(decomposition, transport, rank);
+    const auto offset = decomposition.global_offset(rank);
+    auto view = make_host_view(r.in);
+    // the compute points and the halos at the boundary of the global domain, the others are
+    // exchanged
+    for(int k = 0; k < int(local[2]); ++k)
+      for(int j = 0; j < int(local[1]) + 2 * h; ++j)
+        for(int i = 0; i < int(local[0]) + 2 * h; ++i) {
+          const int gi = offset[0] + i;
+          const int gj = offset[1] + j;
+          const bool inner = i >= h && i < h + int(local[0]) && j >= h && j < h + int(local[1]);
+          const bool boundary =
+              gi < h || gi >= int(dom.isize()) - h || gj < h || gj >= int(dom.jsize()) - h;
+          view(i, j, k) = (inner || boundary) ? in_view(gi, gj, k) : -1.0;
+        }
+    r.step();
+
+    auto out_view = make_host_view(r.out);
+    for(int k = 0; k < int(local[2]); ++k)
+      for(int j = h; j < h + int(local[1]); ++j)
+        for(int i = h; i < h + int(local[0]); ++i)
+          if(std::abs(out_view(i, j, k) - out_naive_view(offset[0] + i, offset[1] + j, k)) >
+             1e-10)
+            ++mismatches[rank];
+  });
+
+  for(int rank = 0; rank < decomposition.ranks(); ++rank)
+    EXPECT_EQ(mismatches[rank], 0) << "on rank " << rank;
+}
+
+// Strong scaling of one step on 1, 2, 4, ... ranks (as long as the domain can be divided), the
+// results are written as JSON to stdout. Meaningful for larger domains than the ones of the tests,
+// e.g `lap_decomposition_test 512 512 80 --gtest_filter=*scaling`, with `OMP_NUM_THREADS=1` if
+// OpenMP is enabled such that the ranks are the only threads.
+TEST(lap_decomposition, scaling) {
+  const auto size = getSize();
+  const int cores = std::max(1u, std::thread::hardware_concurrency());
+  std::vector<driver::benchmark_result> results;
+  for(int ranks = 1; ranks <= cores; ranks *= 2) {
+    int xcols = 1;
+    while(xcols * xcols < ranks)
+      xcols *= 2;
+    const int ycols = ranks / xcols;
+    if(size[0] % xcols != 0 || size[1] % ycols != 0 || size[0] / xcols < 2 * radius ||
+       size[1] / ycols < 2 * radius)
+      break;
+
+    driver::cartesian_decomposition decomposition(size, xcols, ycols, true, true);
+    driver::shared_memory_transport transport(ranks);
+    driver::benchmark_options options;
+    // only the thread of rank 0 would be counted
+    options.counters = false;
+
+    driver::run_ranks(ranks, transport, [&](int rank) {
+      lap_rank r(decomposition, transport, rank);
+      auto step = [&] {
+        transport.barrier();
+        r.step();
+        transport.barrier();
+      };
+      if(rank == 0) {
+        const std::size_t points = std::size_t(size[0]) * size[1] * size[2];
+        results.push_back(driver::run_benchmark(
+            "lap/" + std::to_string(ranks) + "-ranks", step,
+            {driver::field_footprint{"in", points, sizeof(::dawn::float_type), true, false},
+             driver::field_footprint{"out", points, sizeof(::dawn::float_type), false, true}},
+            0, options));
+      } else {
+        for(int i = 0; i < options.warmup + options.repetitions; ++i)
+          step();
+      }
+    });
+  }
+
+  ASSERT_FALSE(results.empty());
+  driver::write_json(std::cout, results);
+}
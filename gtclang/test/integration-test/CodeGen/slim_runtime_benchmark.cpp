@@ -0,0 +1,44 @@
+//===--------------------------------------------------------------------------------*- C++ -*-===//
+//                         _       _
+//                        | |     | |
+//                    __ _| |_ ___| | __ _ _ __   __ _
+//                   / _` | __/ __| |/ _` | '_ \ / _` |
+//                  | (_| | || (__| | (_| | | | | (_| |
+//                   \__, |\__\___|_|\__,_|_| |_|\__, | - GridTools Clang DSL
+//                    __/ |                       __/ |
+//                   |___/                       |___/
+//
+//
+//  This file is distributed under the MIT License (MIT).
+//  See LICENSE.txt for details.
+//
+//===------------------------------------------------------------------------------------------===//
+#include "driver-includes/verify.hpp"
+#include "test/integration-test/CodeGen/Options.hpp"
+#include "test/integration-test/CodeGen/generated/hori_diff_stencil_01_c++-naive.cpp"
+
+// Generated with -fslim-runtime (see slim_runtime_stencil.cpp)
+void run_hori_diff_stencil_slim(const gridtools::dawn::domain& dom,
+                                gridtools::dawn::storage_t& u, gridtools::dawn::storage_t& out);
+
+using namespace dawn;
+TEST(slim_runtime, hori_diff_stencil_01) {
+  domain dom(Options::getInstance().m_size[0], Options::getInstance().m_size[1],
+             Options::getInstance().m_size[2]);
+  dom.set_halos(halo::value, halo::value, halo::value, halo::value, 0, 0);
+
+  verifier verif(dom);
+
+  meta_data_t meta_data(dom.isize(), dom.jsize(), dom.ksize() + 1);
+  storage_t u(meta_data, "u"), out_slim(meta_data, "out-slim"), out_naive(meta_data, "out-naive");
+
+  verif.fillMath(8.0, 2.0, 1.5, 1.5, 2.0, 4.0, u);
+  verif.fill(-1.0, out_slim, out_naive);
+
+  dawn_generated::cxxnaive::hori_diff_stencil hori_diff_naive(dom);
+
+  run_hori_diff_stencil_slim(dom, u, out_slim);
+  hori_diff_naive.run(u, out_naive);
+
+  ASSERT_TRUE(verif.verify(out_slim, out_naive));
+}
@@ -0,0 +1,31 @@
+//===--------------------------------------------------------------------------------*- C++ -*-===//
+//                         _       _
+//                        | |     | |
+//                    __ _| |_ ___| | __ _ _ __   __ _
+//                   / _` | __/ __| |/ _` | '_ \ / _` |
+//                  | (_| | || (__| | (_| | | | | (_| |
+//                   \__, |\__\___|_|\__,_|_| |_|\__, | - GridTools Clang DSL
+//                    __/ |                       __/ |
+//                   |___/                       |___/
+//
+//
+//  This file is distributed under the MIT License (MIT).
+//  See LICENSE.txt for details.
+//
+//===------------------------------------------------------------------------------------------===//
+// Compiled on its own: the slim runtime cannot share a translation unit with the full one
+#define DAWN_GENERATED 1
+#define GRIDTOOLS_DAWN_SLIM_RUNTIME 1
+#define GRIDTOOLS_DAWN_HALO_EXTENT 3
+
+#include "driver-includes/gridtools_includes.hpp"
+
+namespace {
+#include "test/integration-test/CodeGen/generated/hori_diff_stencil_01_c++-naive_slim.cpp"
+} // namespace
+
+void run_hori_diff_stencil_slim(const gridtools::dawn::domain& dom,
+                                gridtools::dawn::storage_t& u, gridtools::dawn::storage_t& out) {
+  dawn_generated::cxxnaive::hori_diff_stencil stencil(dom);
+  stencil.run(u, out);
+}
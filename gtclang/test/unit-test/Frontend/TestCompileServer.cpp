@@ -0,0 +1,83 @@
+//===--------------------------------------------------------------------------------*- C++ -*-===//
+//                         _       _
+//                        | |     | |
+//                    __ _| |_ ___| | __ _ _ __   __ _
+//                   / _` | __/ __| |/ _` | '_ \ / _` |
+//                  | (_| | || (__| | (_| | | | | (_| |
+//                   \__, |\__\___|_|\__,_|_| |_|\__, | - GridTools Clang DSL
+//                    __/ |                       __/ |
+//                   |___/                       |___/
+//
+//
+//  This file is distributed under the MIT License (MIT).
+//  See LICENSE.txt for details.
+//
+//===------------------------------------------------------------------------------------------===//
+
+#include "dawn/Support/Logger.h"
+#include "gtclang/Unittest/GTClang.h"
+#include "gtclang/Unittest/UnittestEnvironment.h"
+
+#include <algorithm>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <sstream>
+
+using namespace gtclang;
+
+namespace {
+
+std::string readFile(const std::string& filename) {
+  std::ifstream ifs(filename);
+  std::stringstream ss;
+  ss << ifs.rdbuf();
+  return ss.str();
+}
+
+bool hasMessage(const dawn::Logger& logger, const std::string& message) {
+  return std::any_of(logger.begin(), logger.end(), [&](const std::string& msg) {
+    return msg.find(message) != std::string::npos;
+  });
+}
+
+TEST(CompileServerTest, ConcurrentCompilation) {
+  auto flags = UnittestEnvironment::getSingleton().getFlagManager().getDefaultFlags();
+
+  // The file lacking the DSL include is compiled twice at the same time, the include is added to a
+  // copy in memory and the file on disk is left untouched
+  const std::string filename = "input/test_stencil_no_include.cpp";
+  const std::string code = readFile(filename);
+  auto [passed, sir] = GTClang::run(
+      {filename, "input/test_stencil_w_include.cpp", filename, "-j3", "-fno-codegen"}, flags);
+  EXPECT_TRUE(passed);
+  EXPECT_EQ(readFile(filename), code);
+  EXPECT_FALSE(std::ifstream(filename + "~").good());
+}
+
+TEST(CompileServerTest, DSLPreamble) {
+  auto flags = UnittestEnvironment::getSingleton().getFlagManager().getDefaultFlags();
+  const std::vector<std::string> files = {"input/test_stencil_w_include.cpp",
+                                          "input/test_stencil_no_include.cpp"};
+
+  // The preamble is compiled with the arguments of the input files, clang would reject it (and fail
+  // the compilations) otherwise
+  {
+    dawn::log::info.clear();
+    dawn::log::warn.clear();
+    auto [passed, sir] = GTClang::run({files[0], files[1], "-j2", "-fno-codegen"}, flags);
+    EXPECT_TRUE(passed);
+    EXPECT_TRUE(hasMessage(dawn::log::info, "Precompiled the DSL headers"));
+    EXPECT_FALSE(hasMessage(dawn::log::warn, "DSL preamble"));
+    EXPECT_FALSE(hasMessage(dawn::log::warn, "DSL headers"));
+  }
+
+  {
+    dawn::log::info.clear();
+    auto [passed, sir] =
+        GTClang::run({files[0], files[1], "-j2", "-fno-codegen", "-fno-dsl-preamble"}, flags);
+    EXPECT_TRUE(passed);
+    EXPECT_FALSE(hasMessage(dawn::log::info, "Precompiled the DSL headers"));
+  }
+}
+
+} // namespace